@@ -1,8 +1,9 @@
-uniform mat4 mMVP;
+#pragma objecttransforms
+uniform mat4 mPassViewProjection;
 
 void main()
 {
 	// texture coordinates
 	gl_TexCoord[0] =  gl_MultiTexCoord0;
-	gl_Position = mMVP * gl_Vertex;
+	gl_Position = mPassViewProjection * GetWorldMatrix() * gl_Vertex;
 }
@@ -1,4 +1,4 @@
-uniform vec2 vInvViewport;
+#pragma frameconstants
 
 uniform sampler2D sTexture;
 uniform sampler2D sDownSampledTexture;
@@ -1,11 +1,10 @@
-uniform vec2 vInvViewport;
+#pragma frameconstants
 
 uniform sampler2D sNormalSampler;
 uniform sampler2D sDepthSampler;
 
 uniform sampler2D sShadowMapSampler;
 
-uniform mat4 mInvProj;
 uniform mat4[4] mShadowMatrices;
 
 uniform vec4[4] vSphere;
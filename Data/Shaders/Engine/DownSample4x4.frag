@@ -1,17 +1,28 @@
+//DOF: the alpha channel carries the blur amount read from sBlurData
+#pragma feature DOF
+
 uniform vec2 vPixelSize;
 
 uniform sampler2D sTexture;
+#ifdef DOF
+uniform sampler2D sBlurData;
+#endif
 
 void main()
 {
 	vec4 vColor = vec4( 0.0 );
-
+	vec2 vTexCoord;
 	for ( float y = -1.5 ; y <=1.5 ; ++y )
 	{
 		for ( float x = -1.5 ; x <=1.5 ; ++x )
 		{
-			vColor += texture2D( sTexture, vec2( gl_TexCoord[0].x + x * vPixelSize.x, gl_TexCoord[0].y + y * vPixelSize.y ) );
+			vTexCoord = vec2( gl_TexCoord[0].x + x * vPixelSize.x, gl_TexCoord[0].y + y * vPixelSize.y );
+#ifdef DOF
+			vColor += vec4( texture2D( sTexture, vTexCoord ).rgb, texture2D( sBlurData, vTexCoord ).r );
+#else
+			vColor += texture2D( sTexture, vTexCoord );
+#endif
 		}
 	}
 	gl_FragColor = vColor / 16.0;
-}
\ No newline at end of file
+}
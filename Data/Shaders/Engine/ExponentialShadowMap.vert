@@ -1,10 +1,12 @@
 varying vec4 vPos;
-uniform mat4 mMVP;
+#pragma objecttransforms
+uniform mat4 mPassViewProjection;
 uniform mat4 mModelView;
 
 void main()
 {
-	gl_Position = mMVP * gl_Vertex;
-	vPos = mModelView * gl_Vertex;
+	vec4 vWorldPos = GetWorldMatrix() * gl_Vertex;
+	gl_Position = mPassViewProjection * vWorldPos;
+	vPos = mModelView * vWorldPos;
 	//vPos = gl_ModelViewMatrix * gl_Vertex;
 }
@@ -0,0 +1,51 @@
+//TAPS_10: ten taps instead of six, for the wider blurs
+#pragma feature TAPS_10
+
+uniform sampler2D sTexture;
+uniform vec2 vPixelSize;
+
+#ifdef TAPS_10
+	#define TAP_COUNT 10
+#else
+	#define TAP_COUNT 6
+#endif
+
+vec4 gaussianFilter()
+{
+	float vGaussianBlur[TAP_COUNT];
+#ifdef TAPS_10
+	vGaussianBlur[0] = 0.0882357;
+	vGaussianBlur[1] = 0.0957407;
+	vGaussianBlur[2] = 0.101786;
+	vGaussianBlur[3] = 0.106026;
+	vGaussianBlur[4] = 0.108212;
+	vGaussianBlur[5] = 0.108212;
+	vGaussianBlur[6] = 0.106026;
+	vGaussianBlur[7] = 0.101786;
+	vGaussianBlur[8] = 0.0957407;
+	vGaussianBlur[9] = 0.0882357;
+#else
+	vGaussianBlur[0] = 0.161041;
+	vGaussianBlur[1] = 0.16775;
+	vGaussianBlur[2] = 0.171209;
+	vGaussianBlur[3] = 0.171209;
+	vGaussianBlur[4] = 0.16775;
+	vGaussianBlur[5] = 0.161041;
+#endif
+
+	vec4 finalColor;
+	vec2 vTexCoord;
+
+	for(int i = 0; i < TAP_COUNT; i++)
+	{
+		float fOffSet = float( i ) - float( TAP_COUNT - 1 ) * 0.5;
+		vTexCoord = vec2( gl_TexCoord[0].x + fOffSet * vPixelSize.x, gl_TexCoord[0].y + fOffSet * vPixelSize.y );
+		finalColor += texture2D( sTexture, vTexCoord ) * vGaussianBlur[i];
+	}
+	return finalColor;
+}
+
+void main()
+{
+	gl_FragColor = gaussianFilter();
+}
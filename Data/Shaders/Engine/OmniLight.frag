@@ -1,10 +1,8 @@
-uniform vec2 vInvViewport;
+#pragma frameconstants
 
 uniform sampler2D sNormalSampler;
 uniform sampler2D sDepthSampler;
 
-uniform mat4 mInvProj;
-
 varying vec3 vVarColor;
 varying vec3 vVarLightPos;
 varying float fVarInverseRadius;
@@ -11,7 +11,7 @@ uniform sampler3D sLUT;
 
 uniform float fGlowMultiplier;
 
-uniform vec2 vInvViewport;
+#pragma frameconstants
 uniform int iDebug;
 
 
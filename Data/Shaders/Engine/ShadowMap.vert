@@ -1,6 +1,7 @@
-uniform mat4x4 mMVP;
+#pragma objecttransforms
+uniform mat4x4 mPassViewProjection;
 
 void main()
 {
-	gl_Position = mMVP * gl_Vertex;
+	gl_Position = mPassViewProjection * GetWorldMatrix() * gl_Vertex;
 }
@@ -1,9 +1,8 @@
-uniform vec2 vInvViewport;
+#pragma frameconstants
 
 uniform sampler2D sNormalSampler;
 uniform sampler2D sDepthSampler;
 uniform sampler2D sShadowMapSampler;
-uniform mat4 mInvProj;
 uniform mat4 mShadowMatrix;
 
 varying vec3 vVarColor;
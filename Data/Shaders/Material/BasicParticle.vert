@@ -8,7 +8,7 @@ varying vec2 OutTexCoord0;
 varying vec4 OutColor;
 
 uniform mat4 mMVP;
-uniform vec2 vInvViewport;
+#pragma frameconstants
   
 void main()
 {
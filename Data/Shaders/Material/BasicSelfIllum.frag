@@ -1,4 +1,4 @@
-uniform vec4 vDofParams;
+#pragma frameconstants
 //x = near blur; y = focal plane; z = far blur; w = blurriness cutoff
 
 uniform vec4 vColor;
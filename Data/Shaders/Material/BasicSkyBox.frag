@@ -1,7 +1,7 @@
 varying vec3 vPos;
 uniform samplerCube sCube;
 
-uniform vec4 vDofParams;
+#pragma frameconstants
 //x = near blur; y = focal plane; z = far blur; w = blurriness cutoff
 
 float ComputeDepthBlur( float fDepth )
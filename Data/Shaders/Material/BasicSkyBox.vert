@@ -1,7 +1,8 @@
 varying vec3 vPos;
-uniform mat4 mMVP;
+#pragma objecttransforms
+uniform mat4 mPassViewProjection;
 void main(void)
 {
 	vPos = vec3( gl_Vertex );
-	gl_Position = mMVP * gl_Vertex;
+	gl_Position = mPassViewProjection * GetWorldMatrix() * gl_Vertex;
 }
@@ -1,9 +1,19 @@
+#extension GL_EXT_texture_array : enable
+//TEXTURE_ARRAY: the diffuse map is a layer of a texture array, given by fDiffuseLayer
+#pragma feature TEXTURE_ARRAY
+
+#ifdef TEXTURE_ARRAY
+uniform sampler2DArray diffuseMap; // texture array: texture unit 0
+uniform float fDiffuseLayer;
+#define SampleDiffuseMap( vCoord ) texture2DArray( diffuseMap, vec3( vCoord, fDiffuseLayer ) )
+#else
 uniform sampler2D diffuseMap; // regular texture: texture unit 0
+#define SampleDiffuseMap( vCoord ) texture2D( diffuseMap, vCoord )
+#endif
 uniform sampler2D lightBuffer; // light from GBuffer: texture unit 6
 
-uniform vec2 vInvViewport;
+#pragma frameconstants
 
-uniform vec4 vDofParams;
 //x = near blur; y = focal plane; z = far blur; w = blurriness cutoff
 
 float ComputeDepthBlur( float fDepth )
@@ -36,7 +46,7 @@ void main()
 	//reconstructing specular
 	vec3 vChromacity = clamp( vLighting.rgb / ( dot( vLighting.rgb, vec3(0.2126, 0.7152, 0.0722 ) ) + 0.00001 ), 0.0, 1.0 );
 
-	vec4 vColor = texture2D( diffuseMap, vTexCoord );
+	vec4 vColor = SampleDiffuseMap( vTexCoord );
 
 	gl_FragData[0] = vec4( (vLighting.rgb + vChromacity * vLighting.a * vColor.a ),1.0) * vec4(vColor.rgb,1.0);
 
@@ -1,9 +1,10 @@
 varying vec3 vNormal;
-uniform mat4 mMVP;
+#pragma objecttransforms
+uniform mat4 mPassViewProjection;
 uniform mat4 mModelView;
 void main()
 {
 	//normal
-	vNormal = (mModelView * vec4(gl_Normal,0.0)).xyz;
-	gl_Position = mMVP * gl_Vertex;
+	vNormal = (mModelView * GetWorldMatrix() * vec4(gl_Normal,0.0)).xyz;
+	gl_Position = mPassViewProjection * GetWorldMatrix() * gl_Vertex;
 }
\ No newline at end of file
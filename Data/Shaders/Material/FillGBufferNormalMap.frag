@@ -1,10 +1,22 @@
-varying mat3 mTBN;
+#extension GL_EXT_texture_array : enable
+//TEXTURE_ARRAY: the normal map is a layer of a texture array, given by fNormalLayer
+#pragma feature TEXTURE_ARRAY
+
+#ifdef TEXTURE_ARRAY
+uniform sampler2DArray normalMap; // texture array: texture unit 1
+uniform float fNormalLayer;
+#define SampleNormalMap( vCoord ) texture2DArray( normalMap, vec3( vCoord, fNormalLayer ) )
+#else
 uniform sampler2D normalMap; // regular texture: texture unit 0
+#define SampleNormalMap( vCoord ) texture2D( normalMap, vCoord )
+#endif
+
+varying mat3 mTBN;
 
 void main()
 {
 	//getting back normal and gloss from normal map
-	vec4 vNormalAndGloss = texture2D( normalMap, gl_TexCoord[0].xy );
+	vec4 vNormalAndGloss = SampleNormalMap( gl_TexCoord[0].xy );
 	vec3 N = vNormalAndGloss.rgb;
 	//rescaling
 	N = N * 2.0 - 1.0;
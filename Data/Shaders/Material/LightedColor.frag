@@ -2,9 +2,8 @@ uniform sampler2D lightBuffer; // light accumulation buffer: texture unit 6
 
 uniform vec4 vColor;
 
-uniform vec2 vInvViewport;
+#pragma frameconstants
 
-uniform vec4 vDofParams;
 //x = near blur; y = focal plane; z = far blur; w = blurriness cutoff
 
 float ComputeDepthBlur( float fDepth )
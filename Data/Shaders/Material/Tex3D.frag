@@ -1,7 +1,7 @@
 uniform sampler3D diffuseMap; // regular texture: texture unit 0
 
 varying vec3 vPos;
-uniform vec4 vDofParams;
+#pragma frameconstants
 //x = near blur; y = focal plane; z = far blur; w = blurriness cutoff
 
 float ComputeDepthBlur( float fDepth )
@@ -1,6 +1,6 @@
 uniform sampler2D diffuseMap; // regular texture: texture unit 0
 
-uniform vec4 vDofParams;
+#pragma frameconstants
 //x = near blur; y = focal plane; z = far blur; w = blurriness cutoff
 
 float ComputeDepthBlur( float fDepth )
@@ -1,49 +1,122 @@
 #include "AbstractComponent.h"
 #include "CompositeComponent.h"
 
+#include "BurgerEngine/Core/Engine.h"
+#include "BurgerEngine/Core/TransformStore.h"
+#include "BurgerEngine/Core/ComponentScheduler.h"
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+AbstractComponent::AbstractComponent( CompositeComponent* a_pParent, ComponentType a_eType )
+	: m_eType(a_eType)
+	, m_pParentNode(a_pParent)
+{
+	m_iTransform = Engine::GrabInstance().GrabTransformStore().Add( a_pParent ? a_pParent->GetTransform() : TransformStore::s_iInvalidHandle );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+AbstractComponent::AbstractComponent(AbstractComponent const& a_rToCopy)
+	: m_eType(a_rToCopy.m_eType)
+	, m_pParentNode(NULL)
+{
+	m_iTransform = Engine::GrabInstance().GrabTransformStore().Add();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+AbstractComponent::~AbstractComponent()
+{
+	Engine::GrabInstance().GrabTransformStore().Remove( m_iTransform );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void AbstractComponent::RegisterUpdate( ComponentScheduler& rScheduler )
+{
+	rScheduler.Add( *this );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void AbstractComponent::UnregisterUpdate( ComponentScheduler& rScheduler )
+{
+	rScheduler.Remove( *this );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void AbstractComponent::SetPos( vec3 const& a_vValue )
+{
+	Engine::GrabInstance().GrabTransformStore().SetLocalPosition( m_iTransform, a_vValue );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void AbstractComponent::SetScale( float const a_fValue )
+{
+	Engine::GrabInstance().GrabTransformStore().SetLocalScale( m_iTransform, a_fValue );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void AbstractComponent::SetRotation( vec3 const& a_vValue )
+{
+	Engine::GrabInstance().GrabTransformStore().SetLocalRotation( m_iTransform, a_vValue );
+}
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
 const vec3 AbstractComponent::GetPos() const
 {
-	if ( m_pParentNode )
-	{
-		vec3 f3ParentRotation = m_pParentNode->GetRotation();
-		vec3 f3Pos = m_f3Position * m_pParentNode->GetScale();
-		vec4 f4NewPos = rotateY( f3ParentRotation.y * DEG_TO_RAD ) * vec4(f3Pos,1.0f);
-		return f4NewPos.xyz() + m_pParentNode->GetPos();
-	}
-	else
-	{
-		return m_f3Position;
-	}
+	return Engine::GrabInstance().GrabTransformStore().GetWorldPosition( m_iTransform );
 }
+
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
 float AbstractComponent::GetScale() const
 {
-	if ( m_pParentNode )
-	{
-		return m_fScale * m_pParentNode->GetScale();
-	}
-	else
-	{
-		return m_fScale;
-	}
+	return Engine::GrabInstance().GrabTransformStore().GetWorldScale( m_iTransform );
 }
+
 //--------------------------------------------------------------------------------------------------------------------
 //
-//--------------------------------------------------------------------------------------------------------------------	
+//--------------------------------------------------------------------------------------------------------------------
 const vec3 AbstractComponent::GetRotation() const
 {
-	if ( m_pParentNode )
-	{
-		return m_f3Rotation + m_pParentNode->GetRotation();
-	}
-	else
-	{
-		return m_f3Rotation;
-	}
+	return Engine::GrabInstance().GrabTransformStore().GetWorldRotation( m_iTransform );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+vec3 const& AbstractComponent::GetLocalPos() const
+{
+	return Engine::GrabInstance().GrabTransformStore().GetLocalPosition( m_iTransform );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+float AbstractComponent::GetLocalScale() const
+{
+	return Engine::GrabInstance().GrabTransformStore().GetLocalScale( m_iTransform );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+vec3 const& AbstractComponent::GetLocalRotation() const
+{
+	return Engine::GrabInstance().GrabTransformStore().GetLocalRotation( m_iTransform );
 }
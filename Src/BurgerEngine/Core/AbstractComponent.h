@@ -12,8 +12,10 @@
 #define __ABSTRACTCOMPONENT_H__
 
 //Forward declaration
-class TiXmlElement;
+class SceneNode;
 class CompositeComponent;
+class BoundingBoxBatch;
+class ComponentScheduler;
 
 #include "BurgerEngine/Base/CommonBase.h"
 #include "BurgerEngine/External/Math/Vector.h"
@@ -32,43 +34,79 @@ enum ComponentType
 	UNKNOWN
 };
 
+/// \brief When the Update of a component runs in the frame, the phases run one after the other.
+///			The phases before the render sync run at every simulation step, the render sync once per rendered frame
+enum UpdatePhase
+{
+	E_UPDATE_PRE_PHYSICS,
+	E_UPDATE_GAMEPLAY,
+	E_UPDATE_ANIMATION,
+	/// After the TransformStore computed the world matrices, what moves there shows the next frame
+	E_UPDATE_POST_TRANSFORM,
+	/// Once the renderer has the transforms of the frame, always on the main thread
+	E_UPDATE_RENDER_SYNC,
+	E_UPDATE_PHASE_COUNT,
+	/// Nothing to update
+	E_UPDATE_NONE = E_UPDATE_PHASE_COUNT
+};
 
 class AbstractComponent
 {
 public:
-	/// \brief constructor
-	AbstractComponent( CompositeComponent* a_pParent = NULL )
-		: m_pParentNode(a_pParent)
-		, m_fScale( 1.0f )
-	{}
+	/// \brief constructor, adds the transform of the component to the TransformStore
+	AbstractComponent( CompositeComponent* a_pParent = NULL, ComponentType a_eType = UNKNOWN );
 
 	/// \brief Copy constructor
-	AbstractComponent(AbstractComponent const& a_rToCopy){}
+	AbstractComponent(AbstractComponent const& a_rToCopy);
 
 	/// \brief Destructor
-	virtual ~AbstractComponent(){}
+	virtual ~AbstractComponent();
 
 	/// \brief Clone method is used by the factory
 	AbstractComponent& Clone(AbstractComponent const& a_rToCopy);
 
-	/// \brief Load the component using a XML Node
-	/// \todo Shoudl not be an xml node (maybe a InitParam or something)
-	virtual void Initialize(TiXmlElement const& a_rParameters) = 0;
+	/// \brief Load the component using its parameters node, from the XML or a compiled scene
+	virtual void Initialize(SceneNode const& a_rParameters) = 0;
 
 	///\brief Update
 	virtual void Update( float fFrameTime, float fElapsedTime ) = 0;
 
-	/// \brief Set and Get position
-	virtual void SetPos( vec3 const& a_vValue ){ m_f3Position = a_vValue; }
+	/// \brief Phase the Update runs in
+	virtual UpdatePhase GetUpdatePhase() const { return E_UPDATE_GAMEPLAY; }
+
+	/// \brief The Update may run on any thread, at the same time as the others of its phase
+	/// The components touching shared state (managers, input, other objects) return false, they run on the main thread
+	virtual bool IsUpdateParallel() const { return true; }
+
+	/// \brief Add the component, or its children, to the phases of the scheduler
+	virtual void RegisterUpdate( ComponentScheduler& rScheduler );
+
+	/// \brief Remove the component, or its children, from the scheduler before deleting it
+	virtual void UnregisterUpdate( ComponentScheduler& rScheduler );
+
+	/// \brief Called once the TransformStore computed the world matrices of the frame,
+	/// for the components copying their transform to the renderer
+	/// \param rBoundingBoxBatch Where the moved objects queue their world boxes, computed after every component
+	virtual void UpdateTransform( BoundingBoxBatch& rBoundingBoxBatch ){}
+
+	/// \brief Set the position relative to the parent, Get the world position
+	/// The world values are the ones of the last TransformStore update
+	virtual void SetPos( vec3 const& a_vValue );
 	vec3 const GetPos() const;
+	vec3 const& GetLocalPos() const;
 
-	/// \brief Update all render componenent with a new scale
-	virtual void SetScale( float const a_fValue ){ m_fScale = a_fValue; }
+	/// \brief Set the scale relative to the parent, Get the world scale
+	virtual void SetScale( float const a_fValue );
 	float GetScale() const;
+	float GetLocalScale() const;
 
-	/// \brief Update all render componenent with a new rotation
-	virtual void SetRotation( vec3 const& a_vValue ){ m_f3Rotation = a_vValue; }
+	/// \brief Set the rotation relative to the parent, in degrees, Get the world rotation
+	virtual void SetRotation( vec3 const& a_vValue );
 	vec3 const GetRotation() const;
+	vec3 const& GetLocalRotation() const;
+
+	/// \brief Handle of the transform of the component in the TransformStore
+	unsigned int GetTransform() const { return m_iTransform; }
 
 	/// \brief Get the parent of the node
 	CompositeComponent const* GetParent() const {return m_pParentNode;}
@@ -77,23 +115,13 @@ public:
 	/// \brief Get the Component Type
 	ComponentType GetType() const {return m_eType;}
 
-	void SetUpdateNeeded( bool bValue ){ m_bUpdateNeeded = bValue; };
-
-protected :
-	bool m_bUpdateNeeded;
-
 private:
 	/// The component type
 	ComponentType m_eType;
 
-	/// Each components has its own position
-	/// \todo maybe it's up to the component itself to has or not a position
-	/// the problem is that if only the composite hold it's runtime position
-	/// how the render can be inform of the composite position
-	/// Position - might be better is matrix
-	vec3	m_f3Position;
-	float	m_fScale;
-	vec3	m_f3Rotation;
+	/// Each components has its own transform, relative to the parent one, kept in the TransformStore
+	/// so the world matrices of the whole scene are computed in one pass
+	unsigned int	m_iTransform;
 
 	/// The parent Node, which has to be a composite composent
 	/// Will be useful to retrieve info of the parent, (position)
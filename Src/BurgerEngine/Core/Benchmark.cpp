@@ -0,0 +1,200 @@
+#include "BurgerEngine/Core/Benchmark.h"
+#include "BurgerEngine/Core/Engine.h"
+#include "BurgerEngine/Base/CommonBase.h"
+
+#include "BurgerEngine/External/TinyXml/TinyXml.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+Benchmark::Benchmark( TiXmlElement const& rSettings )
+	: m_iStepCount( 5 )
+	, m_fGrowth( 2.0f )
+	, m_iWarmUpFrameCount( 30 )
+	, m_iFrameCount( 200 )
+	, m_sScenePrefix( "../Data/Scenes/stress" )
+	, m_sReportName( "../benchmark.txt" )
+	, m_iStep( 0 )
+	, m_iFrame( 0 )
+{
+	int iStepCount = m_iStepCount, iWarmUpFrameCount = m_iWarmUpFrameCount, iFrameCount = m_iFrameCount;
+	rSettings.QueryIntAttribute( "steps", &iStepCount );
+	rSettings.QueryFloatAttribute( "growth", &m_fGrowth );
+	rSettings.QueryIntAttribute( "warmup", &iWarmUpFrameCount );
+	rSettings.QueryIntAttribute( "frames", &iFrameCount );
+
+	//The counts of the first step
+	int iMeshCount = m_oBaseScene.m_iMeshCount, iMoverCount = m_oBaseScene.m_iMoverCount, iParticleCount = m_oBaseScene.m_iParticleCount;
+	int iOmniCount = m_oBaseScene.m_iOmniCount, iSpotCount = m_oBaseScene.m_iSpotCount, iSpotShadowCount = m_oBaseScene.m_iSpotShadowCount;
+	rSettings.QueryIntAttribute( "meshes", &iMeshCount );
+	rSettings.QueryIntAttribute( "movers", &iMoverCount );
+	rSettings.QueryIntAttribute( "particles", &iParticleCount );
+	rSettings.QueryIntAttribute( "omnis", &iOmniCount );
+	rSettings.QueryIntAttribute( "spots", &iSpotCount );
+	rSettings.QueryIntAttribute( "spotshadows", &iSpotShadowCount );
+	rSettings.QueryFloatAttribute( "spacing", &m_oBaseScene.m_fSpacing );
+	m_oBaseScene.m_iMeshCount = iMeshCount > 0 ? iMeshCount : 0;
+	m_oBaseScene.m_iMoverCount = iMoverCount > 0 ? iMoverCount : 0;
+	m_oBaseScene.m_iParticleCount = iParticleCount > 0 ? iParticleCount : 0;
+	m_oBaseScene.m_iOmniCount = iOmniCount > 0 ? iOmniCount : 0;
+	m_oBaseScene.m_iSpotCount = iSpotCount > 0 ? iSpotCount : 0;
+	m_oBaseScene.m_iSpotShadowCount = iSpotShadowCount > 0 ? iSpotShadowCount : 0;
+
+	if( rSettings.Attribute( "mesh" ) )
+	{
+		m_oBaseScene.m_sMeshObject = rSettings.Attribute( "mesh" );
+	}
+	if( rSettings.Attribute( "particle" ) )
+	{
+		m_oBaseScene.m_sParticleObject = rSettings.Attribute( "particle" );
+	}
+	if( rSettings.Attribute( "scene" ) )
+	{
+		m_sScenePrefix = rSettings.Attribute( "scene" );
+	}
+	if( rSettings.Attribute( "report" ) )
+	{
+		m_sReportName = rSettings.Attribute( "report" );
+	}
+
+	//The profiler is reset on the last warm up frame, there has to be one
+	m_iStepCount = iStepCount > 1 ? iStepCount : 1;
+	m_iWarmUpFrameCount = iWarmUpFrameCount > 1 ? iWarmUpFrameCount : 1;
+	m_iFrameCount = iFrameCount > 1 ? iFrameCount : 1;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+std::string const& Benchmark::Start()
+{
+	m_iStep = 0;
+	m_iFrame = 0;
+	m_vResults.clear();
+	_WriteScene( m_iStep );
+	return m_sSceneName;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool Benchmark::Update()
+{
+	Profiler& rProfiler = Profiler::GrabInstance();
+
+	++m_iFrame;
+	if( m_iFrame == m_iWarmUpFrameCount )
+	{
+		rProfiler.Reset();
+		m_oTimer.Start();
+		return true;
+	}
+	if( m_iFrame < m_iWarmUpFrameCount + m_iFrameCount )
+	{
+		return true;
+	}
+
+	sResult oResult;
+	oResult.m_oScene = _GetScene( m_iStep );
+	oResult.m_fFrameTime = m_oTimer.Stop() / m_iFrameCount;
+	for( unsigned int i = 0; i < E_PROFILE_COUNT; ++i )
+	{
+		oResult.m_pSectionTimes[i] = rProfiler.GetTime( static_cast< ProfileSection >( i ) ) / m_iFrameCount;
+	}
+	m_vResults.push_back( oResult );
+
+	if( ++m_iStep == m_iStepCount )
+	{
+		_WriteReport();
+		return false;
+	}
+
+	_WriteScene( m_iStep );
+	Engine::GrabInstance().LoadScene( m_sSceneName.c_str() );
+	m_iFrame = 0;
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+sStressScene Benchmark::_GetScene( unsigned int iStep ) const
+{
+	float fScale = powf( m_fGrowth, static_cast< float >( iStep ) );
+
+	sStressScene oScene = m_oBaseScene;
+	oScene.m_iMeshCount = static_cast< unsigned int >( m_oBaseScene.m_iMeshCount * fScale );
+	oScene.m_iMoverCount = static_cast< unsigned int >( m_oBaseScene.m_iMoverCount * fScale );
+	oScene.m_iParticleCount = static_cast< unsigned int >( m_oBaseScene.m_iParticleCount * fScale );
+	oScene.m_iOmniCount = static_cast< unsigned int >( m_oBaseScene.m_iOmniCount * fScale );
+	oScene.m_iSpotCount = static_cast< unsigned int >( m_oBaseScene.m_iSpotCount * fScale );
+	oScene.m_iSpotShadowCount = static_cast< unsigned int >( m_oBaseScene.m_iSpotShadowCount * fScale );
+	return oScene;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void Benchmark::_WriteScene( unsigned int iStep )
+{
+	std::stringstream oName;
+	oName << m_sScenePrefix << "_" << iStep << ".xml";
+	m_sSceneName = oName.str();
+
+	StressSceneGenerator::Write( _GetScene( iStep ), m_sSceneName );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void Benchmark::_WriteReport() const
+{
+	std::stringstream oReport;
+	oReport << "Times in ms per frame, then in us per object of the kind the section works on" << std::endl;
+	oReport << std::setw(8) << "meshes" << std::setw(8) << "movers" << std::setw(8) << "fx" << std::setw(8) << "omnis"
+		<< std::setw(8) << "spots" << std::setw(8) << "shadows" << " |" << std::setw(9) << "frame";
+	for( unsigned int i = 0; i < E_PROFILE_COUNT; ++i )
+	{
+		oReport << std::setw(11) << Profiler::GetName( static_cast< ProfileSection >( i ) );
+	}
+	oReport << " |" << std::setw(11) << "upd/object" << std::setw(11) << "cull/item" << std::setw(11) << "light/light" << std::setw(11) << "sub/mesh" << std::endl;
+
+	FOR_EACH_IT_CONST( std::vector< sResult >, m_vResults, itResult )
+	{
+		sStressScene const& rScene = itResult->m_oScene;
+		unsigned int iMeshCount = rScene.m_iMeshCount + rScene.m_iMoverCount;
+		unsigned int iLightCount = rScene.m_iOmniCount + rScene.m_iSpotCount + rScene.m_iSpotShadowCount;
+		unsigned int iObjectCount = iMeshCount + iLightCount + rScene.m_iParticleCount;
+
+		oReport << std::setw(8) << rScene.m_iMeshCount << std::setw(8) << rScene.m_iMoverCount << std::setw(8) << rScene.m_iParticleCount
+			<< std::setw(8) << rScene.m_iOmniCount << std::setw(8) << rScene.m_iSpotCount << std::setw(8) << rScene.m_iSpotShadowCount
+			<< " |" << std::fixed << std::setprecision(3) << std::setw(9) << itResult->m_fFrameTime;
+		for( unsigned int i = 0; i < E_PROFILE_COUNT; ++i )
+		{
+			oReport << std::setw(11) << itResult->m_pSectionTimes[i];
+		}
+
+		//An empty kind gives 0 rather than a division by 0
+		float const* pTimes = itResult->m_pSectionTimes;
+		oReport << " |"
+			<< std::setw(11) << ( iObjectCount ? pTimes[ E_PROFILE_UPDATE ] * 1000.0f / iObjectCount : 0.0f )
+			<< std::setw(11) << ( iMeshCount + iLightCount ? pTimes[ E_PROFILE_CULLING ] * 1000.0f / ( iMeshCount + iLightCount ) : 0.0f )
+			<< std::setw(11) << ( iLightCount ? pTimes[ E_PROFILE_LIGHTS ] * 1000.0f / iLightCount : 0.0f )
+			<< std::setw(11) << ( iMeshCount ? pTimes[ E_PROFILE_SUBMISSION ] * 1000.0f / iMeshCount : 0.0f ) << std::endl;
+	}
+
+	std::cout << oReport.str();
+
+	std::ofstream oFile( m_sReportName.c_str() );
+	if( !oFile )
+	{
+		ADD_ERROR_MESSAGE( "Writing benchmark report : " << m_sReportName );
+		return;
+	}
+	oFile << oReport.str();
+}
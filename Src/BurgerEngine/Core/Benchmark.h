@@ -0,0 +1,75 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include "BurgerEngine/Core/StressSceneGenerator.h"
+#include "BurgerEngine/Core/Profiler.h"
+
+#include <string>
+#include <vector>
+
+class TiXmlElement;
+
+/// \class	Benchmark
+/// \brief	Runs stress scenes of growing size, one after the other, and reports the time per frame of each
+///			profiled section, then per object, so the section that stops scaling shows.
+///			Every step doubles (by default) the counts of the previous one. A step loads its scene, waits for
+///			its resources, lets a few frames go by, then measures its frames. The engine stops after the last
+class Benchmark
+{
+public:
+
+	/// \brief Read the <benchmark> settings
+	Benchmark( TiXmlElement const& rSettings );
+
+	/// \brief Write the scene of the first step and give its name
+	std::string const& Start();
+
+	/// \brief Called once per frame, false once the last step is measured and the report written
+	bool Update();
+
+private:
+
+	/// What a step measured, in milliseconds per frame
+	struct sResult
+	{
+		sStressScene	m_oScene;
+		float			m_pSectionTimes[ E_PROFILE_COUNT ];
+		float			m_fFrameTime;
+	};
+
+	/// \brief Counts of a step
+	sStressScene _GetScene( unsigned int iStep ) const;
+
+	/// \brief Write the scene of a step, in m_sSceneName
+	void _WriteScene( unsigned int iStep );
+
+	/// \brief Write the results, and print them
+	void _WriteReport() const;
+
+	sStressScene			m_oBaseScene;
+	unsigned int			m_iStepCount;
+	float					m_fGrowth;
+	unsigned int			m_iWarmUpFrameCount;
+	unsigned int			m_iFrameCount;
+	std::string				m_sScenePrefix;
+	std::string				m_sReportName;
+
+	unsigned int			m_iStep;
+	unsigned int			m_iFrame;
+	std::string				m_sSceneName;
+	Timer					m_oTimer;
+	std::vector< sResult >	m_vResults;
+};
+
+#endif //__BENCHMARK_H__
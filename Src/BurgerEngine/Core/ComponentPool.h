@@ -0,0 +1,146 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __COMPONENTPOOL_H__
+#define __COMPONENTPOOL_H__
+
+#include <vector>
+#include <new>
+
+#include "BurgerEngine/Base/CommonBase.h"
+
+/// \class	ComponentPool
+/// \brief	Storage of every component of a type, in chunks of contiguous slots that never move, so the
+///			components of a type sit next to each other and keep their address.
+///			A slot index is a handle, valid until the component is deleted.
+///			The components get there through their operator new and delete, see DECLARE_COMPONENT_POOL.
+///			Main thread only, components are not created by the parallel updates
+template< typename T >
+class ComponentPool
+{
+public:
+
+	static const unsigned int s_iChunkSize = 64;
+	static const unsigned int s_iInvalidHandle = 0xFFFFFFFF;
+
+	/// \brief Take a free slot
+	static void* Allocate( size_t iSize )
+	{
+		//A derived class inherits the operators, it does not fit in the slots
+		if( iSize != sizeof( T ) )
+		{
+			return ::operator new( iSize );
+		}
+
+		if( s_viFreeHandles.empty() )
+		{
+			_AddChunk();
+		}
+		unsigned int iHandle = s_viFreeHandles.back();
+		s_viFreeHandles.pop_back();
+		s_vbUsed[ iHandle ] = true;
+		++s_iCount;
+		return _GetSlot( iHandle );
+	}
+
+	/// \brief Release a slot, the chunks go once the last component is deleted
+	static void Free( void* pComponent, size_t iSize )
+	{
+		if( pComponent == NULL )
+		{
+			return;
+		}
+		if( iSize != sizeof( T ) )
+		{
+			::operator delete( pComponent );
+			return;
+		}
+
+		unsigned int iHandle = GetHandle( static_cast< T const* >( pComponent ) );
+		assert( iHandle != s_iInvalidHandle && s_vbUsed[ iHandle ] );
+		s_vbUsed[ iHandle ] = false;
+		s_viFreeHandles.push_back( iHandle );
+
+		if( --s_iCount == 0 )
+		{
+			FOR_EACH_IT( std::vector< unsigned char* >, s_vChunks, itChunk )
+			{
+				::operator delete( *itChunk );
+			}
+			s_vChunks.clear();
+			s_vbUsed.clear();
+			s_viFreeHandles.clear();
+		}
+	}
+
+	/// \brief Component of a slot, NULL if the slot is free
+	static T* Get( unsigned int iHandle )
+	{
+		return iHandle < s_vbUsed.size() && s_vbUsed[ iHandle ] ? static_cast< T* >( _GetSlot( iHandle ) ) : NULL;
+	}
+
+	/// \brief Slot of a component allocated by the pool, s_iInvalidHandle otherwise
+	static unsigned int GetHandle( T const* pComponent )
+	{
+		unsigned char const* pAddress = reinterpret_cast< unsigned char const* >( pComponent );
+		for( unsigned int i = 0; i < s_vChunks.size(); ++i )
+		{
+			if( pAddress >= s_vChunks[i] && pAddress < s_vChunks[i] + s_iChunkSize * sizeof( T ) )
+			{
+				return i * s_iChunkSize + ( pAddress - s_vChunks[i] ) / sizeof( T );
+			}
+		}
+		return s_iInvalidHandle;
+	}
+
+	/// \brief Slots to go through with Get to visit every component of the type
+	static unsigned int GetSlotCount() { return s_vbUsed.size(); }
+
+	/// \brief Components alive
+	static unsigned int GetCount() { return s_iCount; }
+
+private:
+
+	static void* _GetSlot( unsigned int iHandle )
+	{
+		return s_vChunks[ iHandle / s_iChunkSize ] + ( iHandle % s_iChunkSize ) * sizeof( T );
+	}
+
+	static void _AddChunk()
+	{
+		unsigned int iFirst = s_vbUsed.size();
+		s_vChunks.push_back( static_cast< unsigned char* >( ::operator new( s_iChunkSize * sizeof( T ) ) ) );
+		s_vbUsed.resize( iFirst + s_iChunkSize, false );
+
+		//Backwards, the lowest slots are taken first
+		for( unsigned int i = s_iChunkSize; i > 0; --i )
+		{
+			s_viFreeHandles.push_back( iFirst + i - 1 );
+		}
+	}
+
+	static std::vector< unsigned char* >	s_vChunks;
+	static std::vector< bool >				s_vbUsed;
+	static std::vector< unsigned int >		s_viFreeHandles;
+	static unsigned int						s_iCount;
+};
+
+template< typename T > std::vector< unsigned char* > ComponentPool< T >::s_vChunks;
+template< typename T > std::vector< bool > ComponentPool< T >::s_vbUsed;
+template< typename T > std::vector< unsigned int > ComponentPool< T >::s_viFreeHandles;
+template< typename T > unsigned int ComponentPool< T >::s_iCount = 0;
+
+/// \brief In the declaration of a component class, allocates its instances in its ComponentPool
+#define DECLARE_COMPONENT_POOL( Type ) \
+	static void* operator new( size_t iSize ){ return ComponentPool< Type >::Allocate( iSize ); } \
+	static void operator delete( void* pComponent, size_t iSize ){ ComponentPool< Type >::Free( pComponent, iSize ); }
+
+#endif //__COMPONENTPOOL_H__
@@ -0,0 +1,120 @@
+#include "BurgerEngine/Core/ComponentScheduler.h"
+#include "BurgerEngine/Core/JobPool.h"
+
+#include <algorithm>
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+ComponentScheduler::ComponentScheduler()
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+ComponentScheduler::~ComponentScheduler()
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ComponentScheduler::Add( AbstractComponent& rComponent )
+{
+	UpdatePhase ePhase = rComponent.GetUpdatePhase();
+	if( ePhase == E_UPDATE_NONE )
+	{
+		return;
+	}
+
+	sPhase& rPhase = m_pPhases[ ePhase ];
+	if( ePhase != E_UPDATE_RENDER_SYNC && rComponent.IsUpdateParallel() )
+	{
+		rPhase.m_vParallelComponents.push_back( &rComponent );
+	}
+	else
+	{
+		rPhase.m_vSerialComponents.push_back( &rComponent );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ComponentScheduler::Remove( AbstractComponent& rComponent )
+{
+	UpdatePhase ePhase = rComponent.GetUpdatePhase();
+	if( ePhase == E_UPDATE_NONE )
+	{
+		return;
+	}
+
+	//The order within a phase does not matter, the last one takes the place
+	sPhase& rPhase = m_pPhases[ ePhase ];
+	std::vector< AbstractComponent* >* pLists[2] = { &rPhase.m_vSerialComponents, &rPhase.m_vParallelComponents };
+	for( unsigned int i = 0; i < 2; ++i )
+	{
+		std::vector< AbstractComponent* >::iterator itComponent = std::find( pLists[i]->begin(), pLists[i]->end(), &rComponent );
+		if( itComponent != pLists[i]->end() )
+		{
+			*itComponent = pLists[i]->back();
+			pLists[i]->pop_back();
+			return;
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ComponentScheduler::Clear()
+{
+	for( unsigned int i = 0; i < E_UPDATE_PHASE_COUNT; ++i )
+	{
+		m_pPhases[i].m_vSerialComponents.clear();
+		m_pPhases[i].m_vParallelComponents.clear();
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ComponentScheduler::Update( UpdatePhase ePhase, float fFrameTime, float fElapsedTime )
+{
+	sPhase& rPhase = m_pPhases[ ePhase ];
+
+	FOR_EACH_IT( std::vector< AbstractComponent* >, rPhase.m_vSerialComponents, itComponent )
+	{
+		(*itComponent)->Update( fFrameTime, fElapsedTime );
+	}
+
+	if( !rPhase.m_vParallelComponents.empty() )
+	{
+		sUpdateContext oContext;
+		oContext.m_ppComponents = &rPhase.m_vParallelComponents[0];
+		oContext.m_fFrameTime = fFrameTime;
+		oContext.m_fElapsedTime = fElapsedTime;
+		JobPool::GrabInstance().Run( &_UpdateRange, &oContext, rPhase.m_vParallelComponents.size(), s_iGrainSize );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+unsigned int ComponentScheduler::GetComponentCount( UpdatePhase ePhase ) const
+{
+	return m_pPhases[ ePhase ].m_vSerialComponents.size() + m_pPhases[ ePhase ].m_vParallelComponents.size();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ComponentScheduler::_UpdateRange( void* pContext, unsigned int iBegin, unsigned int iEnd )
+{
+	sUpdateContext const& rContext = *static_cast< sUpdateContext const* >( pContext );
+	for( unsigned int i = iBegin; i < iEnd; ++i )
+	{
+		rContext.m_ppComponents[i]->Update( rContext.m_fFrameTime, rContext.m_fElapsedTime );
+	}
+}
@@ -0,0 +1,70 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __COMPONENTSCHEDULER_H__
+#define __COMPONENTSCHEDULER_H__
+
+#include <vector>
+
+#include "BurgerEngine/Core/AbstractComponent.h"
+
+/// \class	ComponentScheduler
+/// \brief	Components to update, sorted by phase. Within a phase, the components touching shared state run first
+///			on the calling thread, then the others are split across the JobPool.
+///			A phase is done before the next one starts, which is the only ordering between components
+class ComponentScheduler
+{
+public:
+
+	/// Components per range given to a pool thread
+	static const unsigned int s_iGrainSize = 64;
+
+	ComponentScheduler();
+	~ComponentScheduler();
+
+	/// \brief Add a component to the phase it updates in, if any
+	void Add( AbstractComponent& rComponent );
+
+	/// \brief Forget a component, before it is deleted
+	void Remove( AbstractComponent& rComponent );
+
+	/// \brief Forget every component
+	void Clear();
+
+	/// \brief Update the components of a phase, returns once they are all done
+	void Update( UpdatePhase ePhase, float fFrameTime, float fElapsedTime );
+
+	unsigned int GetComponentCount( UpdatePhase ePhase ) const;
+
+private:
+
+	struct sPhase
+	{
+		/// Main thread only
+		std::vector< AbstractComponent* >	m_vSerialComponents;
+		/// Any thread
+		std::vector< AbstractComponent* >	m_vParallelComponents;
+	};
+
+	/// What the pool threads need to update a range
+	struct sUpdateContext
+	{
+		AbstractComponent* const*	m_ppComponents;
+		float						m_fFrameTime;
+		float						m_fElapsedTime;
+	};
+
+	static void _UpdateRange( void* pContext, unsigned int iBegin, unsigned int iEnd );
+
+	sPhase	m_pPhases[ E_UPDATE_PHASE_COUNT ];
+};
+
+#endif //__COMPONENTSCHEDULER_H__
@@ -2,7 +2,7 @@
 #include "BurgerEngine/Core/RenderComponent.h"
 #include "BurgerEngine/Core/LightComponent.h"
 #include "BurgerEngine/Core/ObjectFactory.h"
-#include "BurgerEngine/External/TinyXml/TinyXml.h"
+#include "BurgerEngine/Core/SceneDocument.h"
 
 #include "BurgerEngine/Core/Engine.h"
 
@@ -10,17 +10,19 @@
 //
 //--------------------------------------------------------------------------------------------------------------------
 CompositeComponent::CompositeComponent(CompositeComponent* a_pParent)
-	: AbstractComponent(a_pParent)
+	: AbstractComponent(a_pParent, COMPOSITE)
 {
 	AbstractComponent::SetPos(vec3(0,0,0));
+	_ClearComponentTable();
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
 CompositeComponent::CompositeComponent(AbstractComponent const& a_rToCopy):
-	AbstractComponent()
+	AbstractComponent(NULL, COMPOSITE)
 {
+	_ClearComponentTable();
 }
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -34,18 +36,19 @@ CompositeComponent::~CompositeComponent()
 		(*itComponent) = NULL;
 	}
 	m_vComponents.clear();
+	_ClearComponentTable();
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void CompositeComponent::Initialize(TiXmlElement const& a_rParameters)
+void CompositeComponent::Initialize(SceneNode const& a_rParameters)
 {
 	//these values might be overwritten if the component :
 	// - is the first child of a sceneobject in a scene
 	// - is loaded as a ressource component by another component and this ressource component has a position tag
 	float x, y, z, rX, rY, rZ, scale;
-	TiXmlElement const* pPositionXml = a_rParameters.FirstChildElement( "position" );
+	SceneNode const* pPositionXml = a_rParameters.FirstChildElement( "position" );
 	if(pPositionXml)
 	{
 		pPositionXml->QueryFloatAttribute("x",&x);
@@ -63,12 +66,12 @@ void CompositeComponent::Initialize(TiXmlElement const& a_rParameters)
 	}
 	
 	//As long as we find components we add it to the composite components
-	TiXmlElement const* pComponentXml = a_rParameters.FirstChildElement( "component" );
+	SceneNode const* pComponentXml = a_rParameters.FirstChildElement( "component" );
 	while (pComponentXml)
 	{
 		AbstractComponent* pComponentObject = Engine::GrabInstance().GetObjectFactory().CreateAndInitComponent(*pComponentXml, this);
 
-		m_vComponents.push_back(pComponentObject);
+		_AddComponent(pComponentObject);
 
 		//Get the next components
 		pComponentXml = pComponentXml->NextSiblingElement( "component" );
@@ -79,7 +82,7 @@ void CompositeComponent::Initialize(TiXmlElement const& a_rParameters)
 	{
 		AbstractComponent* pComponentObject = Engine::GrabInstance().GetObjectFactory().LoadObject( pComponentXml, this );
 
-		m_vComponents.push_back(pComponentObject);
+		_AddComponent(pComponentObject);
 
 		//Get the next components
 		pComponentXml = pComponentXml->NextSiblingElement( "ressourcecomponent" );
@@ -95,39 +98,66 @@ void CompositeComponent::Update( float fFrameTime, float fElapsedTime )
 	FOR_EACH_IT(std::vector<AbstractComponent*>, m_vComponents, itComponent)
 	{
 		//Should check if need to be updated??? (think about render and phys)
-		(*itComponent)->SetUpdateNeeded(m_bUpdateNeeded);
 		(*itComponent)->Update( fFrameTime, fElapsedTime );
 	}
-	m_bUpdateNeeded = false;
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void CompositeComponent::SetPos( vec3 const& a_vValue )
+void CompositeComponent::UpdateTransform( BoundingBoxBatch& rBoundingBoxBatch )
 {
-	//Set the component position
-	AbstractComponent::SetPos( a_vValue );
-	m_bUpdateNeeded = true;
+	FOR_EACH_IT(std::vector<AbstractComponent*>, m_vComponents, itComponent)
+	{
+		(*itComponent)->UpdateTransform( rBoundingBoxBatch );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void CompositeComponent::RegisterUpdate( ComponentScheduler& rScheduler )
+{
+	FOR_EACH_IT(std::vector<AbstractComponent*>, m_vComponents, itComponent)
+	{
+		(*itComponent)->RegisterUpdate( rScheduler );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void CompositeComponent::UnregisterUpdate( ComponentScheduler& rScheduler )
+{
+	FOR_EACH_IT(std::vector<AbstractComponent*>, m_vComponents, itComponent)
+	{
+		(*itComponent)->UnregisterUpdate( rScheduler );
+	}
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void CompositeComponent::SetScale( float const a_fValue )
+void CompositeComponent::_AddComponent( AbstractComponent* pComponent )
 {
-	//Set the component scale
-	AbstractComponent::SetScale( a_fValue );
-	m_bUpdateNeeded = true;
+	m_vComponents.push_back(pComponent);
+
+	//The first child of each type answers the lookups
+	if( pComponent && pComponent->GetType() < UNKNOWN && m_pComponentTable[ pComponent->GetType() ] == NULL )
+	{
+		m_pComponentTable[ pComponent->GetType() ] = pComponent;
+	}
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void CompositeComponent::SetRotation( vec3 const& a_vValue )
+void CompositeComponent::_ClearComponentTable()
 {
-	AbstractComponent::SetRotation( a_vValue );
-	m_bUpdateNeeded = true;
+	for( unsigned int i = 0; i < UNKNOWN; ++i )
+	{
+		m_pComponentTable[i] = NULL;
+	}
 }
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -180,6 +210,11 @@ void CompositeComponent::SetRotation( vec3 const& a_vValue )
 //--------------------------------------------------------------------------------------------------------------------
 AbstractComponent const* CompositeComponent::TryGetComponentByType( ComponentType a_eType ) const
 {
+	if( a_eType < UNKNOWN )
+	{
+		return m_pComponentTable[ a_eType ];
+	}
+
 	FOR_EACH_IT_CONST(std::vector<AbstractComponent*>, m_vComponents, itComponent)
 	{
 		AbstractComponent const* pComponent = (*itComponent);
@@ -198,6 +233,11 @@ AbstractComponent const* CompositeComponent::TryGetComponentByType( ComponentTyp
 //--------------------------------------------------------------------------------------------------------------------
 AbstractComponent* CompositeComponent::TryGrabComponentByType( ComponentType a_eType )
 {
+	if( a_eType < UNKNOWN )
+	{
+		return m_pComponentTable[ a_eType ];
+	}
+
 	FOR_EACH_IT(std::vector<AbstractComponent*>, m_vComponents, itComponent)
 	{
 		AbstractComponent* pComponent = (*itComponent);
@@ -14,10 +14,13 @@
 #include <vector>
 
 #include "BurgerEngine/Core/AbstractComponent.h"
+#include "BurgerEngine/Core/ComponentPool.h"
 
 class CompositeComponent : public AbstractComponent
 {
 public:
+	DECLARE_COMPONENT_POOL( CompositeComponent )
+
 	/// \brief constructor
 	CompositeComponent(CompositeComponent* a_pParent);
 
@@ -29,7 +32,7 @@ public:
 
 	/// \brief Load the component using a XML Node
 	/// override
-	void Initialize(TiXmlElement const& a_rParameters);
+	void Initialize(SceneNode const& a_rParameters);
 
 	/// \brief Get a reference to the component
 	//template<typename t_CptType>
@@ -41,6 +44,7 @@ public:
 	//AbstractComponent& GrabComponentByType(ComponentType a_eType);
 
 	/// \brief Try to get a component, if not working then return a pointer to null
+	/// Constant time for the engine types, the first child of the type is returned
 	AbstractComponent const* TryGetComponentByType(ComponentType a_eType) const;
 
 	/// \brief Try to grab a component, if not working then return a pointer to null
@@ -50,27 +54,31 @@ public:
 	/// \todo to template
 	std::vector<AbstractComponent*> TryGrabComponentVectorByType( ComponentType a_eType );
 
+	void Update( float fFrameTime, float fElapsedTime );
 
-	/// \brief [OVERIDE] Set the position, and right now alert the render component
-	/// \todo we need to find a way to alert every component needed, but it might be
-	/// heavy with listener
-	void SetPos( vec3 const& a_vValue );
+	/// \brief [OVERIDE] Forward to the children, the moved ones copy their transform
+	void UpdateTransform( BoundingBoxBatch& rBoundingBoxBatch );
 
-	/// \brief Update all render componenent with a new scale
-	/// \todo again this is kinda specific so it's pretty ugly, should be change
-	void SetScale( float const a_fValue );
+	/// \brief [OVERIDE] Register the children, the composite itself has nothing to update
+	void RegisterUpdate( ComponentScheduler& rScheduler );
 
-	/// \brief Update all render componenent with a new rotation
-	/// \todo again this is kinda specific so it's pretty ugly, should be change
-	void SetRotation( vec3 const& a_vValue );
+	/// \brief [OVERIDE] Unregister the children
+	void UnregisterUpdate( ComponentScheduler& rScheduler );
 
-	void Update( float fFrameTime, float fElapsedTime );
+private:
+	/// \brief Add a child and index it by type
+	void _AddComponent( AbstractComponent* pComponent );
+
+	void _ClearComponentTable();
 
 private:
 	
 	/// \brief Collection Of AbstractComponenet
 
 	std::vector<AbstractComponent*> m_vComponents;
+
+	/// First child of each type, so the lookups do not go through the children
+	AbstractComponent* m_pComponentTable[ UNKNOWN ];
 };
 
 #endif //__COMPOSITECOMPONENT_H_
\ No newline at end of file
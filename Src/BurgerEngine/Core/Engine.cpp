@@ -5,11 +5,20 @@
 #include "BurgerEngine/Core/SceneGraph.h"
 #include "BurgerEngine/Core/TimeContext.h"
 #include "BurgerEngine/Core/ObjectFactory.h"
+#include "BurgerEngine/Core/TransformStore.h"
+#include "BurgerEngine/Core/JobPool.h"
+#include "BurgerEngine/Core/SceneCompiler.h"
+#include "BurgerEngine/Core/Benchmark.h"
+#include "BurgerEngine/Core/Profiler.h"
 
 #include "BurgerEngine/Graphics/MeshManager.h"
 #include "BurgerEngine/Graphics/MaterialManager.h"
 #include "BurgerEngine/Graphics/TextureManager.h"
 #include "BurgerEngine/Graphics/ShaderManager.h"
+#include "BurgerEngine/Graphics/ResourceLoader.h"
+#include "BurgerEngine/Graphics/MipmapGenerator.h"
+#include "BurgerEngine/Graphics/EffectTechnique.h"
+#include "BurgerEngine/Graphics/TextureArray.h"
 
 #include "BurgerEngine/Input/EventManager.h"
 
@@ -20,6 +29,8 @@
 #include "BurgerEngine/fx/ParticleContext.h"
 
 #include "BurgerEngine/External/TinyXml/TinyXml.h"
+
+#include <math.h>
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
@@ -30,7 +41,15 @@ Engine::Engine():
 	m_pStageManager(NULL),
 	m_pRenderContext(NULL),
 	m_pParticleContext(NULL),
-	m_pTimerContext(NULL)
+	m_pTimerContext(NULL),
+	m_pSceneGraph(NULL),
+	m_pTransformStore(NULL),
+	m_pBenchmark(NULL),
+	m_fSimulationStep(0.0f),
+	m_iMaxSimulationSteps(4),
+	m_bInterpolate(true),
+	m_fSimulationAccumulator(0.0f),
+	m_fSimulationTime(0.0f)
 {}
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -41,6 +60,23 @@ void Engine::Init( ObjectFactory* pFactory )
 	const char * pSceneName = NULL;
 	bool bFullScreen;
 	int isWiimoteUsed;
+	int iLoaderThreadCount = 2;
+	float fLoaderUploadBudget = 4.0f;
+	int iMipmapThreadCount = 4;
+	int iTextureStreaming = 0;
+	int iTextureStreamingBudget = 256;
+	int iTextureStreamingUploadBudget = 2048;
+	int iShaderCache = 1;
+	std::string sShaderCacheDirectory = "../Cache/Shaders";
+	std::string sDisabledShaderFeatures;
+	int iMaterialUniformBuffer = 0;
+	int iMaterialTextureArrays = 0;
+	int iUpdateThreadCount = 0;
+	int iSceneCache = 1;
+	std::string sSceneCacheDirectory = "../Cache/Scenes";
+	float fSimulationRate = 0.0f;
+	int iMaxSimulationSteps = 4;
+	int iInterpolate = 1;
 
 	TiXmlDocument * pDocument = new TiXmlDocument( "../Settings/Settings.xml" );
 	if( !pDocument->LoadFile() )
@@ -79,12 +115,88 @@ void Engine::Init( ObjectFactory* pFactory )
 			pWiimote->QueryIntAttribute("enable",&isWiimoteUsed);
 
 		}
+		TiXmlElement * pLoader = pRoot->FirstChildElement( "loader" );
+		if( pLoader )
+		{
+			pLoader->QueryIntAttribute("threads",&iLoaderThreadCount);
+			pLoader->QueryFloatAttribute("uploadbudget",&fLoaderUploadBudget);
+			pLoader->QueryIntAttribute("mipmapthreads",&iMipmapThreadCount);
+		}
+		TiXmlElement * pTextureStreaming = pRoot->FirstChildElement( "texturestreaming" );
+		if( pTextureStreaming )
+		{
+			pTextureStreaming->QueryIntAttribute("enable",&iTextureStreaming);
+			pTextureStreaming->QueryIntAttribute("budget",&iTextureStreamingBudget);
+			pTextureStreaming->QueryIntAttribute("uploadbudget",&iTextureStreamingUploadBudget);
+		}
+		TiXmlElement * pShaderCache = pRoot->FirstChildElement( "shadercache" );
+		if( pShaderCache )
+		{
+			pShaderCache->QueryIntAttribute("enable",&iShaderCache);
+			if( pShaderCache->Attribute("path") )
+			{
+				sShaderCacheDirectory = pShaderCache->Attribute("path");
+			}
+		}
+		TiXmlElement * pSceneCache = pRoot->FirstChildElement( "scenecache" );
+		if( pSceneCache )
+		{
+			pSceneCache->QueryIntAttribute("enable",&iSceneCache);
+			if( pSceneCache->Attribute("path") )
+			{
+				sSceneCacheDirectory = pSceneCache->Attribute("path");
+			}
+		}
+		TiXmlElement * pMaterials = pRoot->FirstChildElement( "materials" );
+		if( pMaterials )
+		{
+			pMaterials->QueryIntAttribute("uniformbuffer",&iMaterialUniformBuffer);
+			pMaterials->QueryIntAttribute("texturearrays",&iMaterialTextureArrays);
+		}
+		TiXmlElement * pUpdate = pRoot->FirstChildElement( "update" );
+		if( pUpdate )
+		{
+			pUpdate->QueryIntAttribute("threads",&iUpdateThreadCount);
+		}
+		TiXmlElement * pSimulation = pRoot->FirstChildElement( "simulation" );
+		if( pSimulation )
+		{
+			pSimulation->QueryFloatAttribute("rate",&fSimulationRate);
+			pSimulation->QueryIntAttribute("maxsteps",&iMaxSimulationSteps);
+			pSimulation->QueryIntAttribute("interpolate",&iInterpolate);
+		}
+		TiXmlElement * pShaderProfile = pRoot->FirstChildElement( "shaderprofile" );
+		if( pShaderProfile )
+		{
+			//Attribute, the std::string query stops at the first space
+			if( pShaderProfile->Attribute("disable") )
+			{
+				sDisabledShaderFeatures = pShaderProfile->Attribute("disable");
+			}
+		}
+		TiXmlElement * pBenchmark = pRoot->FirstChildElement( "benchmark" );
+		int iBenchmark = 0;
+		if( pBenchmark && pBenchmark->QueryIntAttribute("enable",&iBenchmark) == TIXML_SUCCESS && iBenchmark != 0 )
+		{
+			m_pBenchmark = new Benchmark( *pBenchmark );
+			pSceneName = m_pBenchmark->Start().c_str();
+			Profiler::GrabInstance().SetEnabled( true );
+		}
 	}
 	
 	assert(pSceneName);
 
 	m_pFactory = pFactory;
 
+	m_pTransformStore = new TransformStore();
+
+	m_fSimulationStep = fSimulationRate > 0.0f ? 1.0f / fSimulationRate : 0.0f;
+	m_iMaxSimulationSteps = iMaxSimulationSteps > 0 ? iMaxSimulationSteps : 1;
+	m_bInterpolate = iInterpolate != 0;
+
+	//The component updates of a phase are split between these threads and the main one
+	JobPool::GrabInstance().Initialize( iUpdateThreadCount > 0 ? iUpdateThreadCount : 0 );
+
 	m_pTimerContext = new TimerContext();
 
 	m_pEventManager = new EventManager();
@@ -99,12 +211,38 @@ void Engine::Init( ObjectFactory* pFactory )
 	m_pRenderingContext = new OpenGLContext();
 	m_pRenderingContext->Initialize( m_iWindowWidth, m_iWindowHeight );
 
+	//The renderer loads its shaders while initializing, the shader manager has to be ready before
+	ShaderManager::GrabInstance().Initialize( iShaderCache != 0 ? sShaderCacheDirectory : std::string() );
+	ShaderManager::GrabInstance().DisableFeatures( sDisabledShaderFeatures );
+	EffectTechnique::SetUniformBufferEnabled( iMaterialUniformBuffer != 0 );
+
+	//Without the arrays the material shaders are compiled with their plain samplers, and the textures left alone
+	if( iMaterialTextureArrays == 0 || !TextureArray::IsSupported() )
+	{
+		ShaderManager::GrabInstance().DisableFeatures( TextureArray::s_sShaderFeature );
+	}
+	TextureManager::GrabInstance().SetArrayPackingEnabled( !ShaderManager::GrabInstance().IsFeatureDisabled( TextureArray::s_sShaderFeature ) );
+
 	m_pRenderContext = new RenderingContext();
 	m_pRenderContext->Initialize();
 
+	//Meshes and textures are loaded in background from now on
+	ResourceLoader::GrabInstance().Initialize( iLoaderThreadCount, fLoaderUploadBudget );
+	MipmapGenerator::SetThreadCount( iMipmapThreadCount > 0 ? iMipmapThreadCount : 1 );
+	if( iTextureStreaming != 0 )
+	{
+		//Budgets are given in MB and KB
+		TextureManager::GrabInstance().InitializeStreaming( iTextureStreamingBudget * 1024 * 1024, iTextureStreamingUploadBudget * 1024 );
+	}
+
 	m_pParticleContext = new ParticleContext();
 
+	SceneCompiler::SetCacheDirectory( iSceneCache != 0 ? sSceneCacheDirectory : std::string() );
 	m_pSceneGraph = new SceneGraph( pSceneName );
+	if( m_pBenchmark )
+	{
+		ResourceLoader::GrabInstance().Flush();
+	}
 	
 	m_pWindow->GrabDriverWindow().ShowMouseCursor( false );
 	
@@ -116,6 +254,10 @@ void Engine::Init( ObjectFactory* pFactory )
 //--------------------------------------------------------------------------------------------------------------------
 void Engine::Terminate()
 {
+	//The components unregister from the contexts when deleted
+	delete m_pSceneGraph;
+	m_pSceneGraph = NULL;
+
 	delete m_pParticleContext;
 	m_pParticleContext = NULL;
 
@@ -132,6 +274,10 @@ void Engine::Terminate()
 	delete m_pFactory;
 	m_pFactory = NULL;
 
+	//Stop the loader threads before the resources they fill are destroyed
+	ResourceLoader::KillInstance();
+	JobPool::KillInstance();
+
 	MaterialManager::KillInstance();
 	MeshManager::KillInstance();
 	ShaderManager::KillInstance();
@@ -146,12 +292,16 @@ void Engine::Terminate()
 	delete m_pWindow;
 	m_pWindow = NULL;
 
-	delete m_pSceneGraph;
-	m_pSceneGraph = NULL;
+	//The components release their transforms when deleted
+	delete m_pTransformStore;
+	m_pTransformStore = NULL;
 
 	delete m_pTimerContext;
 	m_pTimerContext = NULL;
 
+	delete m_pBenchmark;
+	m_pBenchmark = NULL;
+	Profiler::KillInstance();
 }
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -161,7 +311,7 @@ void Engine::Run()
 {
 	m_bTerminate = false;
 	
-	m_pTimerContext->Initialize();
+	_ResetSimulation();
 
 	//Let's Roll
 	while (m_bTerminate == false)
@@ -169,9 +319,6 @@ void Engine::Run()
 		//Update Scene
 		m_pTimerContext->Update();
 
-		// Update Particle
-		m_pParticleContext->Update();
-
 		//TODO: The main loop might just process event the fact of updating a Scene could be an event.
 
 		//Process Event
@@ -179,23 +326,111 @@ void Engine::Run()
 		
 		float fDeltaTime= m_pTimerContext->GetScaledTime();
 
-		m_pSceneGraph->Update( fDeltaTime, m_pTimerContext->GetElapsedTime() );
-		
-		m_pStageManager->Update();
+		//The simulation catches up with the frame, the renderers get the transforms in between the last two steps
+		Profiler::GrabInstance().Begin( E_PROFILE_UPDATE );
+		float fAlpha = _UpdateSimulation( fDeltaTime );
+		m_pSceneGraph->UpdateRender( fAlpha, fDeltaTime, m_pTimerContext->GetElapsedTime() );
+		Profiler::GrabInstance().End( E_PROFILE_UPDATE );
 
+		//The camera follows the input of every frame
 		m_pCurrentCamera->Update(fDeltaTime);
 
-		//Render the scene
+		OpenGLContext::BeginFrame();
+
+		//Upload the resources loaded in background
+		ResourceLoader::GrabInstance().Update();
+		TextureManager::GrabInstance().UpdateStreaming();
+
+		//Render the scene, the particles are sent again every frame
+		m_pParticleContext->Draw();
 		m_pRenderContext->Update( fDeltaTime );
 
 		//Swap buffer
 		m_pWindow->Display();
 
+		//The benchmark moves to its next scene, and stops the engine after the last one
+		if( m_pBenchmark && !m_pBenchmark->Update() )
+		{
+			m_bTerminate = true;
+		}
+
 		//m_pRenderingContext->CheckError();
 	}
 }
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+float Engine::_UpdateSimulation( float fDeltaTime )
+{
+	//Without a fixed step, the frame is simulated as it comes
+	if( m_fSimulationStep <= 0.0f )
+	{
+		_StepSimulation( fDeltaTime );
+		return 1.0f;
+	}
+
+	m_fSimulationAccumulator += fDeltaTime;
+	unsigned int iStepCount = 0;
+	while( m_fSimulationAccumulator >= m_fSimulationStep && iStepCount < m_iMaxSimulationSteps )
+	{
+		_StepSimulation( m_fSimulationStep );
+		m_fSimulationAccumulator -= m_fSimulationStep;
+		++iStepCount;
+	}
+
+	//After a slow frame the simulation falls behind rather than taking more steps every frame to catch up
+	if( m_fSimulationAccumulator >= m_fSimulationStep )
+	{
+		m_fSimulationAccumulator = fmodf( m_fSimulationAccumulator, m_fSimulationStep );
+	}
+
+	return m_bInterpolate ? m_fSimulationAccumulator / m_fSimulationStep : 1.0f;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void Engine::_StepSimulation( float fStepTime )
+{
+	m_fSimulationTime += fStepTime;
+
+	m_pParticleContext->Update( fStepTime );
+	m_pSceneGraph->Update( fStepTime, m_fSimulationTime );
+	m_pStageManager->Update();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void Engine::_ResetSimulation()
+{
+	m_pTimerContext->Initialize();
+	m_fSimulationAccumulator = 0.0f;
+	m_fSimulationTime = 0.0f;
+}
  
 
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void Engine::LoadScene( const char * pSceneName )
+{
+	//The camera comes with the scene
+	delete m_pSceneGraph;
+	m_pSceneGraph = NULL;
+	delete m_pCurrentCamera;
+	m_pCurrentCamera = NULL;
+
+	m_pSceneGraph = new SceneGraph( pSceneName );
+
+	//No frame is drawn while the scene is half loaded
+	ResourceLoader::GrabInstance().Flush();
+
+	//Otherwise the next frame would catch up with the whole load on the new scene
+	_ResetSimulation();
+}
+
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
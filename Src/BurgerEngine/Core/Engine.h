@@ -24,6 +24,8 @@ class RenderingContext;
 class ParticleContext;
 class TimerContext;
 class ObjectFactory;
+class TransformStore;
+class Benchmark;
 
 ///	\name	Engine.h
 ///	\brief	It's the main core of the program
@@ -46,6 +48,9 @@ public:
 	/// \brief	Start the Engine loop
 	void Run();
 
+	/// \brief	Replace the scene graph and its camera, the resources of the new scene are loaded before returning
+	void LoadScene( const char * pSceneName );
+
 	/// \brief	Called to finish eveything
 	void Terminate();
 
@@ -76,6 +81,10 @@ public:
 	ObjectFactory const& GetObjectFactory() const {return *m_pFactory;}
 	ObjectFactory & GetObjectFactory(){return *m_pFactory;}
 
+	/// \brief Get/Grab the transforms of the components
+	TransformStore const& GetTransformStore() const {return *m_pTransformStore;}
+	TransformStore& GrabTransformStore() {return *m_pTransformStore;}
+
 
 	const unsigned int GetWindowWidth() const { return m_iWindowWidth; }
 	const unsigned int GetWindowHeight() const { return m_iWindowHeight; }
@@ -93,6 +102,16 @@ protected:
 
 private:
 
+	/// \brief Run the simulation steps the frame time covers
+	/// \return Part of a step left over, where the rendered transforms are between the last two steps
+	float _UpdateSimulation( float fDeltaTime );
+
+	/// \brief Advance the particles, the scene and the stage by a step
+	void _StepSimulation( float fStepTime );
+
+	/// \brief Restart the frame timer and the simulation clock, the time spent loading is not simulated
+	void _ResetSimulation();
+
 	EventManager*	m_pEventManager;
 	StageManager*	m_pStageManager;
 
@@ -109,6 +128,9 @@ private:
 
 	SceneGraph*		m_pSceneGraph;
 
+	/// Transforms of every component, created before and destroyed after them
+	TransformStore*	m_pTransformStore;
+
 	unsigned int	m_iWindowWidth;
 	unsigned int	m_iWindowHeight;
 
@@ -120,6 +142,20 @@ private:
 
 	/// The Factory which can create object depending on the string griven
 	ObjectFactory* m_pFactory;
+
+	/// Runs the stress scenes instead of the scene of the settings, NULL if disabled
+	Benchmark*		m_pBenchmark;
+
+	/// Duration of a simulation step in seconds, 0 for one step of the frame time
+	float			m_fSimulationStep;
+	/// Steps that may run in a frame to catch up, the time left behind is dropped
+	unsigned int	m_iMaxSimulationSteps;
+	/// Render the transforms between the last two steps, the last ones otherwise
+	bool			m_bInterpolate;
+	/// Frame time not simulated yet, less than a step
+	float			m_fSimulationAccumulator;
+	/// Time simulated since the start, what the components get as elapsed time
+	float			m_fSimulationTime;
 };
 
 #endif //__ENGINE_H__
@@ -0,0 +1,220 @@
+#include "BurgerEngine/Core/JobPool.h"
+
+#include <limits.h>
+
+/// \class	JobThread
+/// \brief	Pool thread, runs the ranges of the current loop until the pool stops
+class JobThread: public sf::Thread
+{
+public:
+	JobThread( JobPool& rPool, unsigned int iQueue ): m_rPool( rPool ), m_iQueue( iQueue ){}
+
+private:
+	virtual void Run()
+	{
+		for( ;; )
+		{
+			WaitForSingleObject( m_rPool.m_hWakeSemaphore, INFINITE );
+			if( !m_rPool.m_bRunning )
+			{
+				break;
+			}
+			m_rPool._RunRanges( m_iQueue );
+		}
+	}
+
+	JobPool&		m_rPool;
+	unsigned int	m_iQueue;
+};
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+JobPool::JobPool()
+	: m_pFunction( NULL )
+	, m_pContext( NULL )
+	, m_iRemainingRanges( 0 )
+	, m_hWakeSemaphore( NULL )
+	, m_bWorking( false )
+	, m_bRunning( false )
+{
+	//The calling thread queue
+	m_vQueues.push_back( new sQueue() );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+JobPool::~JobPool()
+{
+	Terminate();
+	delete m_vQueues[0];
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void JobPool::Initialize( unsigned int iThreadCount )
+{
+	Terminate();
+
+	if( iThreadCount == 0 )
+	{
+		return;
+	}
+
+	m_hWakeSemaphore = CreateSemaphore( NULL, 0, LONG_MAX, NULL );
+	m_bRunning = true;
+	for( unsigned int i = 0; i < iThreadCount; ++i )
+	{
+		m_vQueues.push_back( new sQueue() );
+
+		JobThread* pThread = new JobThread( *this, i + 1 );
+		pThread->Launch();
+		m_vThreads.push_back( pThread );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void JobPool::Terminate()
+{
+	assert( !m_bWorking );
+
+	m_bRunning = false;
+	if( !m_vThreads.empty() )
+	{
+		ReleaseSemaphore( m_hWakeSemaphore, (LONG)m_vThreads.size(), NULL );
+	}
+	FOR_EACH_IT( std::vector< JobThread* >, m_vThreads, itThread )
+	{
+		(*itThread)->Wait();
+		delete (*itThread);
+	}
+	m_vThreads.clear();
+
+	if( m_hWakeSemaphore )
+	{
+		CloseHandle( m_hWakeSemaphore );
+		m_hWakeSemaphore = NULL;
+	}
+
+	//Keep the calling thread queue
+	for( unsigned int i = 1; i < m_vQueues.size(); ++i )
+	{
+		delete m_vQueues[i];
+	}
+	m_vQueues.resize( 1 );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void JobPool::Run( JobFunction pFunction, void* pContext, unsigned int iCount, unsigned int iGrainSize )
+{
+	assert( pFunction && !m_bWorking );
+	if( iCount == 0 )
+	{
+		return;
+	}
+
+	iGrainSize = iGrainSize > 0 ? iGrainSize : 1;
+
+	//Not worth waking the threads
+	if( m_vThreads.empty() || iCount <= iGrainSize )
+	{
+		pFunction( pContext, 0, iCount );
+		return;
+	}
+
+	m_pFunction = pFunction;
+	m_pContext = pContext;
+
+	//Deal the ranges one queue after the other, the locks publish the loop to the threads
+	unsigned int iRangeCount = ( iCount + iGrainSize - 1 ) / iGrainSize;
+	{
+		sf::Lock oLock( m_oRemainingMutex );
+		m_iRemainingRanges = iRangeCount;
+	}
+	for( unsigned int i = 0; i < iRangeCount; ++i )
+	{
+		sRange oRange;
+		oRange.m_iBegin = i * iGrainSize;
+		oRange.m_iEnd = oRange.m_iBegin + iGrainSize < iCount ? oRange.m_iBegin + iGrainSize : iCount;
+
+		sQueue& rQueue = *m_vQueues[ i % m_vQueues.size() ];
+		sf::Lock oLock( rQueue.m_oMutex );
+		rQueue.m_vRanges.push_back( oRange );
+	}
+	m_bWorking = true;
+	ReleaseSemaphore( m_hWakeSemaphore, (LONG)m_vThreads.size(), NULL );
+
+	_RunRanges( 0 );
+
+	//Every queue is empty, wait for the ranges still running on the threads, a range at most
+	for( ;; )
+	{
+		{
+			sf::Lock oLock( m_oRemainingMutex );
+			if( m_iRemainingRanges == 0 )
+			{
+				break;
+			}
+		}
+		sf::Sleep( 0.0f );
+	}
+
+	m_bWorking = false;
+	m_pFunction = NULL;
+	m_pContext = NULL;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool JobPool::_PopRange( unsigned int iQueue, sRange& rRange )
+{
+	//Own queue, the last range dealt is the most likely to be still in cache
+	{
+		sQueue& rQueue = *m_vQueues[ iQueue ];
+		sf::Lock oLock( rQueue.m_oMutex );
+		if( !rQueue.m_vRanges.empty() )
+		{
+			rRange = rQueue.m_vRanges.back();
+			rQueue.m_vRanges.pop_back();
+			return true;
+		}
+	}
+
+	//Steal from the others, starting with the next one so the thieves spread
+	unsigned int iQueueCount = m_vQueues.size();
+	for( unsigned int i = 1; i < iQueueCount; ++i )
+	{
+		sQueue& rQueue = *m_vQueues[ ( iQueue + i ) % iQueueCount ];
+		sf::Lock oLock( rQueue.m_oMutex );
+		if( !rQueue.m_vRanges.empty() )
+		{
+			rRange = rQueue.m_vRanges.front();
+			rQueue.m_vRanges.pop_front();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void JobPool::_RunRanges( unsigned int iQueue )
+{
+	sRange oRange;
+	while( _PopRange( iQueue, oRange ) )
+	{
+		m_pFunction( m_pContext, oRange.m_iBegin, oRange.m_iEnd );
+
+		sf::Lock oLock( m_oRemainingMutex );
+		--m_iRemainingRanges;
+	}
+}
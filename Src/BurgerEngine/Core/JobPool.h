@@ -0,0 +1,102 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __JOBPOOL_H__
+#define __JOBPOOL_H__
+
+#include <vector>
+#include <deque>
+
+#include "BurgerEngine/Base/Singleton.h"
+
+#include <SFML/System.hpp>
+#include <Windows.h>
+
+class JobThread;
+
+/// \class	JobPool
+/// \brief	Threads splitting a loop between them, the calling thread works too.
+///			The loop is cut in ranges dealt to a queue per thread. A thread takes the ranges of its own queue
+///			from the back, and once it is empty steals from the front of the others, so the threads running
+///			the cheap ranges help the ones running the costly ranges. Run returns once every range is done.
+///			The threads sleep on a semaphore (SFML has none, it is the Win32 one) released once per thread by every
+///			loop, so they cost nothing while no loop runs
+class JobPool: public Singleton<JobPool>
+{
+	friend class Singleton<JobPool>;
+	friend class JobThread;
+
+public:
+
+	/// \brief Run the range [iBegin, iEnd) of a loop
+	typedef void (*JobFunction)( void* pContext, unsigned int iBegin, unsigned int iEnd );
+
+	/// \brief Start the threads
+	/// \param iThreadCount Threads besides the calling one, 0 runs every loop on the calling thread
+	void Initialize( unsigned int iThreadCount );
+
+	/// \brief Stop the threads
+	void Terminate();
+
+	/// \brief Run a loop across the threads, returns once it is done. Not reentrant, a range cannot call Run
+	/// \param iGrainSize Iterations per range, the smallest share a thread takes
+	void Run( JobFunction pFunction, void* pContext, unsigned int iCount, unsigned int iGrainSize );
+
+	unsigned int GetThreadCount() const { return m_vThreads.size(); }
+
+private:
+
+	JobPool();
+	virtual ~JobPool();
+
+	struct sRange
+	{
+		unsigned int	m_iBegin;
+		unsigned int	m_iEnd;
+	};
+
+	struct sQueue
+	{
+		std::deque< sRange >	m_vRanges;
+		sf::Mutex				m_oMutex;
+	};
+
+	/// \brief Pop a range from the back of a queue, or steal one from the front of another
+	bool _PopRange( unsigned int iQueue, sRange& rRange );
+
+	/// \brief Run ranges until every queue is empty
+	void _RunRanges( unsigned int iQueue );
+
+private:
+
+	std::vector< JobThread* >	m_vThreads;
+
+	/// Queue 0 is the calling thread one, then one per thread
+	std::vector< sQueue* >		m_vQueues;
+
+	/// Loop being run
+	JobFunction					m_pFunction;
+	void*						m_pContext;
+
+	/// Ranges not finished yet
+	unsigned int				m_iRemainingRanges;
+	sf::Mutex					m_oRemainingMutex;
+
+	/// Released once per thread when a loop starts, and when the pool stops.
+	/// A thread waking late for a loop finds the queues empty and goes back to sleep
+	HANDLE						m_hWakeSemaphore;
+
+	/// A loop is running
+	volatile bool				m_bWorking;
+	volatile bool				m_bRunning;
+};
+
+#endif //__JOBPOOL_H__
@@ -2,8 +2,9 @@
 #include "BurgerEngine/Core/ObjectFactory.h"
 #include "BurgerEngine/Core/Engine.h"
 #include "BurgerEngine/Core/CompositeComponent.h"
+#include "BurgerEngine/Core/TransformStore.h"
 
-#include "BurgerEngine/External/TinyXml/TinyXml.h"
+#include "BurgerEngine/Core/SceneDocument.h"
 
 #include "BurgerEngine/Graphics/DirectionalLight.h"
 #include "BurgerEngine/Graphics/SpotShadow.h"
@@ -18,7 +19,7 @@
 //
 //--------------------------------------------------------------------------------------------------------------------
 LightComponent::LightComponent(CompositeComponent* a_pParent):
-AbstractComponent(a_pParent),
+AbstractComponent(a_pParent, LIGHT),
 	m_pLight(NULL)
 {
 	m_mStringToLightTypeMap["omni"] = SceneLight::E_OMNI_LIGHT;
@@ -31,7 +32,7 @@ AbstractComponent(a_pParent),
 //
 //--------------------------------------------------------------------------------------------------------------------
 LightComponent::LightComponent(AbstractComponent const& a_rToCopy):
-AbstractComponent()
+AbstractComponent(NULL, LIGHT)
 {
 
 }
@@ -41,6 +42,11 @@ AbstractComponent()
 //--------------------------------------------------------------------------------------------------------------------
 LightComponent::~LightComponent()
 {
+	//Streamed out components go while the scene is rendered
+	if( m_pLight )
+	{
+		Engine::GrabInstance().GrabRenderContext().RemoveLight(*m_pLight, m_pLight->GetType());
+	}
 	//Maybe will be deleted by someone else
 	delete m_pLight;
 }
@@ -48,15 +54,15 @@ LightComponent::~LightComponent()
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void LightComponent::Initialize(TiXmlElement const& a_rParameters)
+void LightComponent::Initialize(SceneNode const& a_rParameters)
 {
-	TiXmlElement const* pXmlElement;
+	SceneNode const* pXmlElement;
 
 	//Retrieve position
 	//First we should check is there is not an desc offset
 	//to the parent node
 	float x, y, z, rX, rY, rZ;
-	TiXmlElement const* pPositionXml = a_rParameters.FirstChildElement( "position" );
+	SceneNode const* pPositionXml = a_rParameters.FirstChildElement( "position" );
 	if(pPositionXml)
 	{
 		//gets position & bounded volume information 
@@ -86,11 +92,11 @@ void LightComponent::Initialize(TiXmlElement const& a_rParameters)
 	}
 
 	pXmlElement = a_rParameters.FirstChildElement("light");
-	SceneLight::LightType eType;
+	SceneLight::LightType eType = static_cast< SceneLight::LightType >( 0 );
 	if (pXmlElement)
 	{
 		std::string sLightType;
-		pXmlElement->QueryValueAttribute<std::string>("type",&sLightType);
+		pXmlElement->QueryValueAttribute("type",&sLightType);
 		eType = m_mStringToLightTypeMap[ sLightType ];
 	}
 	
@@ -155,6 +161,13 @@ void LightComponent::Initialize(TiXmlElement const& a_rParameters)
 		m_pLight->SetPos( vec3( x, y, z ) );
 	}
 
+	//An unknown type leaves the component without a light, it is skipped by the updates
+	if( !m_pLight )
+	{
+		std::cerr << "[ERROR] LightComponent : unknown light type" << std::endl;
+		return;
+	}
+
 	SetPos(vec3( x, y, z ));
 	//Add the light to the render context
 	Engine::GrabInstance().GrabRenderContext().AddLight(*m_pLight, eType);
@@ -166,10 +179,23 @@ void LightComponent::Initialize(TiXmlElement const& a_rParameters)
 //--------------------------------------------------------------------------------------------------------------------
 void LightComponent::Update( float fFrameTime, float fElapsedTime )
 {
-	if( m_bUpdateNeeded )
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void LightComponent::UpdateTransform( BoundingBoxBatch& rBoundingBoxBatch )
+{
+	//No light when its description could not be read
+	if( !m_pLight )
+	{
+		return;
+	}
+	TransformStore const& rTransformStore = Engine::GrabInstance().GetTransformStore();
+	if( rTransformStore.HasRenderMoved( GetTransform() ) )
 	{
-		m_pLight->SetPos( GetPos() );
-		m_pLight->SetRotation( GetRotation() );
+		m_pLight->SetPos( rTransformStore.GetRenderPosition( GetTransform() ) );
+		m_pLight->SetRotation( rTransformStore.GetRenderRotation( GetTransform() ) );
 		if( (m_pLight->GetType() & SceneLight::E_SPOT_LIGHT) == SceneLight::E_SPOT_LIGHT )
 		{
 			static_cast< SpotLight* >(m_pLight)->ComputeBoundingBox();
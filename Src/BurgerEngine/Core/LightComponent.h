@@ -12,6 +12,7 @@
 #define __LIGHTCOMPONENT_H__
 
 #include "BurgerEngine/Core/AbstractComponent.h"
+#include "BurgerEngine/Core/ComponentPool.h"
 #include "BurgerEngine/Graphics/SceneLight.h"
 #include <map>
 #include <string>
@@ -21,6 +22,8 @@
 class LightComponent : public AbstractComponent
 {
 public:
+	DECLARE_COMPONENT_POOL( LightComponent )
+
 	/// \brief constructor
 	LightComponent(CompositeComponent* a_pParent = NULL);
 
@@ -32,7 +35,7 @@ public:
 
 	/// \brief Load the component using a XML Node
 	/// override
-	void Initialize(TiXmlElement const& a_rParameters);
+	void Initialize(SceneNode const& a_rParameters);
 
 	/// \brief Grab the light
 	/// \todo Could also go from the RenderContext
@@ -40,6 +43,12 @@ public:
 
 	void Update( float fFrameTime, float fElapsedTime );
 
+	/// \brief [OVERIDE] Nothing to update, the light follows the transform in UpdateTransform
+	UpdatePhase GetUpdatePhase() const { return E_UPDATE_NONE; }
+
+	/// \brief [OVERIDE] Copy the world transform to the light when it moved
+	void UpdateTransform( BoundingBoxBatch& rBoundingBoxBatch );
+
 private:
 	/// Own a Scene light object
 	SceneLight* m_pLight;
@@ -0,0 +1,150 @@
+#include "BurgerEngine/Core/MovementHackerBatch.h"
+
+#include <emmintrin.h>
+#include <cassert>
+
+static const float s_fPi = 3.14159265f;
+static const float s_fHalfPi = 1.57079633f;
+static const float s_fInvTwoPi = 0.159154943f;
+
+//2 pi in two parts, the reduction of big angles keeps the bits the first product loses
+static const float s_fTwoPiHigh = 6.28125f;
+static const float s_fTwoPiLow = 1.93530717e-3f;
+
+//Taylor series up to x^11, under 1e-7 away from sin on [-pi/2, pi/2]
+static const float s_fSin3 = -1.66666667e-1f;
+static const float s_fSin5 = 8.33333333e-3f;
+static const float s_fSin7 = -1.98412698e-4f;
+static const float s_fSin9 = 2.75573192e-6f;
+static const float s_fSin11 = -2.50521084e-8f;
+
+/// \brief Four sines: the angles are brought in [-pi, pi], then in [-pi/2, pi/2] as sin( pi - x ) = sin( x )
+static inline __m128 _FastSin4( __m128 vAngle )
+{
+	const __m128 vSignMask = _mm_castsi128_ps( _mm_set1_epi32( 0x80000000 ) );
+
+	__m128 vTurns = _mm_cvtepi32_ps( _mm_cvtps_epi32( _mm_mul_ps( vAngle, _mm_set1_ps( s_fInvTwoPi ) ) ) );
+	__m128 vX = _mm_sub_ps( vAngle, _mm_mul_ps( vTurns, _mm_set1_ps( s_fTwoPiHigh ) ) );
+	vX = _mm_sub_ps( vX, _mm_mul_ps( vTurns, _mm_set1_ps( s_fTwoPiLow ) ) );
+
+	__m128 vSign = _mm_and_ps( vX, vSignMask );
+	__m128 vAbs = _mm_andnot_ps( vSignMask, vX );
+	vX = _mm_or_ps( _mm_min_ps( vAbs, _mm_sub_ps( _mm_set1_ps( s_fPi ), vAbs ) ), vSign );
+
+	__m128 vX2 = _mm_mul_ps( vX, vX );
+	__m128 vPolynomial = _mm_add_ps( _mm_mul_ps( vX2, _mm_set1_ps( s_fSin11 ) ), _mm_set1_ps( s_fSin9 ) );
+	vPolynomial = _mm_add_ps( _mm_mul_ps( vX2, vPolynomial ), _mm_set1_ps( s_fSin7 ) );
+	vPolynomial = _mm_add_ps( _mm_mul_ps( vX2, vPolynomial ), _mm_set1_ps( s_fSin5 ) );
+	vPolynomial = _mm_add_ps( _mm_mul_ps( vX2, vPolynomial ), _mm_set1_ps( s_fSin3 ) );
+	vPolynomial = _mm_add_ps( _mm_mul_ps( vX2, vPolynomial ), _mm_set1_ps( 1.0f ) );
+	return _mm_mul_ps( vX, vPolynomial );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+float MovementHackerBatch::FastSin( float fAngle )
+{
+	float pResult[4];
+	_mm_storeu_ps( pResult, _FastSin4( _mm_set1_ps( fAngle ) ) );
+	return pResult[0];
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void MovementHackerBatch::Reset( unsigned int iSlot )
+{
+	unsigned int iEnd = ( iSlot + 1 ) * E_TRACK_COUNT;
+	if( m_vfValues[0].size() < iEnd )
+	{
+		for( unsigned int i = 0; i < E_VALUE_COUNT; ++i )
+		{
+			m_vfValues[i].resize( iEnd, 0.0f );
+		}
+	}
+
+	for( unsigned int i = 0; i < E_TRACK_COUNT; ++i )
+	{
+		SetTrack( iSlot, static_cast< Track >( i ), 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f );
+		SetBase( iSlot, static_cast< Track >( i ), 0.0f );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void MovementHackerBatch::SetTrack( unsigned int iSlot, Track eTrack, float fSinPhase, float fSinSpeed, float fSinAmplitude, float fCosPhase, float fCosSpeed, float fCosAmplitude, float fIncrement, float fLastValueMultiplier )
+{
+	unsigned int iTrack = iSlot * E_TRACK_COUNT + eTrack;
+	m_vfValues[ E_SIN_PHASE ][ iTrack ] = fSinPhase;
+	m_vfValues[ E_SIN_SPEED ][ iTrack ] = fSinSpeed;
+	m_vfValues[ E_SIN_AMPLITUDE ][ iTrack ] = fSinAmplitude;
+	m_vfValues[ E_COS_PHASE ][ iTrack ] = fCosPhase + s_fHalfPi;
+	m_vfValues[ E_COS_SPEED ][ iTrack ] = fCosSpeed;
+	m_vfValues[ E_COS_AMPLITUDE ][ iTrack ] = fCosAmplitude;
+	m_vfValues[ E_INCREMENT ][ iTrack ] = fIncrement;
+	m_vfValues[ E_MULTIPLIER ][ iTrack ] = fLastValueMultiplier;
+	_UpdateOffset( iTrack );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void MovementHackerBatch::SetBase( unsigned int iSlot, Track eTrack, float fBase )
+{
+	unsigned int iTrack = iSlot * E_TRACK_COUNT + eTrack;
+	m_vfValues[ E_BASE ][ iTrack ] = fBase;
+	_UpdateOffset( iTrack );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void MovementHackerBatch::Evaluate( unsigned int iBeginSlot, unsigned int iEndSlot, float* pValues, float fFrameTime, float fElapsedTime ) const
+{
+	assert( iEndSlot * E_TRACK_COUNT <= m_vfValues[0].size() );
+	unsigned int iBegin = iBeginSlot * E_TRACK_COUNT;
+	unsigned int iCount = ( iEndSlot - iBeginSlot ) * E_TRACK_COUNT;
+	unsigned int iBatchEnd = iCount & ~3;
+
+	float const* pSinPhases = &m_vfValues[ E_SIN_PHASE ][ iBegin ];
+	float const* pSinSpeeds = &m_vfValues[ E_SIN_SPEED ][ iBegin ];
+	float const* pSinAmplitudes = &m_vfValues[ E_SIN_AMPLITUDE ][ iBegin ];
+	float const* pCosPhases = &m_vfValues[ E_COS_PHASE ][ iBegin ];
+	float const* pCosSpeeds = &m_vfValues[ E_COS_SPEED ][ iBegin ];
+	float const* pCosAmplitudes = &m_vfValues[ E_COS_AMPLITUDE ][ iBegin ];
+	float const* pIncrements = &m_vfValues[ E_INCREMENT ][ iBegin ];
+	float const* pMultipliers = &m_vfValues[ E_MULTIPLIER ][ iBegin ];
+	float const* pOffsets = &m_vfValues[ E_OFFSET ][ iBegin ];
+
+	const __m128 vFrameTime = _mm_set1_ps( fFrameTime );
+	const __m128 vElapsedTime = _mm_set1_ps( fElapsedTime );
+
+	for( unsigned int i = 0; i < iBatchEnd; i += 4 )
+	{
+		__m128 vSin = _FastSin4( _mm_add_ps( _mm_mul_ps( vElapsedTime, _mm_loadu_ps( pSinSpeeds + i ) ), _mm_loadu_ps( pSinPhases + i ) ) );
+		__m128 vCos = _FastSin4( _mm_add_ps( _mm_mul_ps( vElapsedTime, _mm_loadu_ps( pCosSpeeds + i ) ), _mm_loadu_ps( pCosPhases + i ) ) );
+
+		__m128 vValue = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( pMultipliers + i ), _mm_loadu_ps( pValues + i ) ), _mm_mul_ps( vFrameTime, _mm_loadu_ps( pIncrements + i ) ) );
+		vValue = _mm_add_ps( vValue, _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( pSinAmplitudes + i ), vSin ), _mm_mul_ps( _mm_loadu_ps( pCosAmplitudes + i ), vCos ) ) );
+		_mm_storeu_ps( pValues + i, _mm_add_ps( vValue, _mm_loadu_ps( pOffsets + i ) ) );
+	}
+
+	//Remaining tracks, a slot has six so there are two at most
+	for( unsigned int i = iBatchEnd; i < iCount; ++i )
+	{
+		float fSin = FastSin( fElapsedTime * pSinSpeeds[i] + pSinPhases[i] );
+		float fCos = FastSin( fElapsedTime * pCosSpeeds[i] + pCosPhases[i] );
+		pValues[i] = pMultipliers[i] * pValues[i] + fFrameTime * pIncrements[i] + pSinAmplitudes[i] * fSin + pCosAmplitudes[i] * fCos + pOffsets[i];
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void MovementHackerBatch::_UpdateOffset( unsigned int iTrack )
+{
+	bool bWave = m_vfValues[ E_SIN_SPEED ][ iTrack ] != 0.0f || m_vfValues[ E_COS_SPEED ][ iTrack ] != 0.0f;
+	m_vfValues[ E_OFFSET ][ iTrack ] = bWave ? m_vfValues[ E_BASE ][ iTrack ] : 0.0f;
+}
@@ -0,0 +1,81 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __MOVEMENTHACKERBATCH_H__
+#define __MOVEMENTHACKERBATCH_H__
+
+#include <vector>
+
+/// \class	MovementHackerBatch
+/// \brief	Tracks of the movement hackers, six per hacker slot (position then rotation, x y z), one array per value.
+///			A track moves a value to
+///				multiplier * value + frame time * increment + sin amplitude * sin( time * sin speed + sin phase )
+///				+ cos amplitude * cos( time * cos speed + cos phase ) + base, the base only if a speed is set.
+///			The tracks are evaluated four at a time with SSE and a polynomial sine, the cosine being a sine a
+///			quarter turn ahead, and the base term is folded in an offset when the track is set
+class MovementHackerBatch
+{
+public:
+
+	enum Track
+	{
+		E_TRACK_POS_X,
+		E_TRACK_POS_Y,
+		E_TRACK_POS_Z,
+		E_TRACK_ROTATION_X,
+		E_TRACK_ROTATION_Y,
+		E_TRACK_ROTATION_Z,
+		E_TRACK_COUNT
+	};
+
+	/// \brief Make room for the tracks of a slot and leave them still, the value is kept as is
+	void Reset( unsigned int iSlot );
+
+	/// \brief Slots with room in the batch, up to the last one reset
+	unsigned int GetSlotCount() const { return (unsigned int)m_vfValues[0].size() / E_TRACK_COUNT; }
+
+	void SetTrack( unsigned int iSlot, Track eTrack, float fSinPhase, float fSinSpeed, float fSinAmplitude, float fCosPhase, float fCosSpeed, float fCosAmplitude, float fIncrement, float fLastValueMultiplier );
+
+	/// \brief Value the waves oscillate around, the value of the target when the hacker was given it
+	void SetBase( unsigned int iSlot, Track eTrack, float fBase );
+
+	/// \brief Move the values of the tracks of the slots [iBeginSlot, iEndSlot), six values per slot in pValues
+	void Evaluate( unsigned int iBeginSlot, unsigned int iEndSlot, float* pValues, float fFrameTime, float fElapsedTime ) const;
+
+	/// \brief Polynomial sine, the one of the batch, for a single value
+	static float FastSin( float fAngle );
+
+private:
+
+	enum Value
+	{
+		E_SIN_PHASE,
+		E_SIN_SPEED,
+		E_SIN_AMPLITUDE,
+		/// The quarter turn is already added
+		E_COS_PHASE,
+		E_COS_SPEED,
+		E_COS_AMPLITUDE,
+		E_INCREMENT,
+		E_MULTIPLIER,
+		/// The base when the track has a wave, 0 otherwise
+		E_OFFSET,
+		E_BASE,
+		E_VALUE_COUNT
+	};
+
+	/// \brief Recompute the offset of a track
+	void _UpdateOffset( unsigned int iTrack );
+
+	std::vector< float >	m_vfValues[ E_VALUE_COUNT ];
+};
+
+#endif //__MOVEMENTHACKERBATCH_H__
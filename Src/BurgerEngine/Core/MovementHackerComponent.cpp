@@ -2,16 +2,28 @@
 #include "BurgerEngine/Core/ObjectFactory.h"
 #include "BurgerEngine/Core/Engine.h"
 #include "BurgerEngine/Core/CompositeComponent.h"
+#include "BurgerEngine/Core/JobPool.h"
 
-#include "BurgerEngine/External/TinyXml/TinyXml.h"
+#include "BurgerEngine/Core/SceneDocument.h"
+
+MovementHackerBatch MovementHackerComponent::s_oBatch;
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
 MovementHackerComponent::MovementHackerComponent(CompositeComponent* a_pParent)
-	: AbstractComponent(a_pParent)
+	: AbstractComponent(a_pParent, MOVEMENTHACKER)
+	, m_iSlot( ComponentPool< MovementHackerComponent >::GetHandle( this ) )
+	, m_bRegistered( false )
 	, m_pComponent( NULL )
+	, m_pOwnBatch( NULL )
 {
+	//The slot indexes the tracks, a derived class allocated out of the pool has no slot
+	if( m_iSlot == ComponentPool< MovementHackerComponent >::s_iInvalidHandle )
+	{
+		m_pOwnBatch = new MovementHackerBatch();
+	}
+	_GrabBatch().Reset( _GetBatchSlot() );
 }
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -19,153 +31,177 @@ MovementHackerComponent::MovementHackerComponent(CompositeComponent* a_pParent)
 //--------------------------------------------------------------------------------------------------------------------
 MovementHackerComponent::~MovementHackerComponent()
 {
+	if( m_pOwnBatch )
+	{
+		delete m_pOwnBatch;
+		return;
+	}
+	//The slot may be evaluated before it is taken again
+	s_oBatch.Reset( m_iSlot );
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void MovementHackerComponent::Initialize(TiXmlElement const& a_rParameters)
+void MovementHackerComponent::RegisterUpdate( ComponentScheduler& rScheduler )
 {
-	//Position paramaters
-	TiXmlElement const*  pPosX = a_rParameters.FirstChildElement( "posx" );
-	if( pPosX )
-	{
-		float fSinPhase, fSinSpeed, fSinAmplitude, fCosPhase, fCosSpeed, fCosAmplitude, fIncrement, fLastPosMultiplier;
-		LoadMovementHackerValues(pPosX, &fSinPhase, &fSinSpeed, &fSinAmplitude, &fCosPhase, &fCosSpeed, &fCosAmplitude, &fIncrement, &fLastPosMultiplier );
-		SetValues( f3XSinPhaseSpeedAmplitude, f3XCosPhaseSpeedAmplitude, f3XConstIncMultiplier, fSinPhase, fSinSpeed, fSinAmplitude, fCosPhase, fCosSpeed, fCosAmplitude, fIncrement, fLastPosMultiplier );
-	}
-	else
+	m_bRegistered = true;
+	if( m_pOwnBatch )
 	{
-		SetValues( f3XSinPhaseSpeedAmplitude, f3XCosPhaseSpeedAmplitude, f3XConstIncMultiplier );
-	}
-
-	TiXmlElement const* pPosY = a_rParameters.FirstChildElement( "posy" );
-	if( pPosY )
-	{
-		float fSinPhase, fSinSpeed, fSinAmplitude, fCosPhase, fCosSpeed, fCosAmplitude, fIncrement, fLastPosMultiplier;
-		LoadMovementHackerValues(pPosY, &fSinPhase, &fSinSpeed, &fSinAmplitude, &fCosPhase, &fCosSpeed, &fCosAmplitude, &fIncrement, &fLastPosMultiplier );
-		SetValues( f3YSinPhaseSpeedAmplitude, f3YCosPhaseSpeedAmplitude, f3YConstIncMultiplier, fSinPhase, fSinSpeed, fSinAmplitude, fCosPhase, fCosSpeed, fCosAmplitude, fIncrement, fLastPosMultiplier );
-	}
-	else
-	{
-		SetValues( f3YSinPhaseSpeedAmplitude, f3YCosPhaseSpeedAmplitude, f3YConstIncMultiplier );
+		AbstractComponent::RegisterUpdate( rScheduler );
 	}
+}
 
-	TiXmlElement const* pPosZ= a_rParameters.FirstChildElement( "posz" );
-	if( pPosZ )
-	{
-		float fSinPhase, fSinSpeed, fSinAmplitude, fCosPhase, fCosSpeed, fCosAmplitude, fIncrement, fLastPosMultiplier;
-		LoadMovementHackerValues(pPosZ, &fSinPhase, &fSinSpeed, &fSinAmplitude, &fCosPhase, &fCosSpeed, &fCosAmplitude, &fIncrement, &fLastPosMultiplier );
-		SetValues( f3ZSinPhaseSpeedAmplitude, f3ZCosPhaseSpeedAmplitude, f3ZConstIncMultiplier, fSinPhase, fSinSpeed, fSinAmplitude, fCosPhase, fCosSpeed, fCosAmplitude, fIncrement, fLastPosMultiplier );
-	}
-	else
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void MovementHackerComponent::UnregisterUpdate( ComponentScheduler& rScheduler )
+{
+	m_bRegistered = false;
+	if( m_pOwnBatch )
 	{
-		SetValues( f3ZSinPhaseSpeedAmplitude, f3ZCosPhaseSpeedAmplitude, f3ZConstIncMultiplier );
+		AbstractComponent::UnregisterUpdate( rScheduler );
 	}
+}
 
-	//Rotation paramaters
-	TiXmlElement const* pRotationX = a_rParameters.FirstChildElement( "rotationx" ) ;
-	if( pRotationX )
-	{
-		float fSinPhase, fSinSpeed, fSinAmplitude, fCosPhase, fCosSpeed, fCosAmplitude, fIncrement, fLastRotationMultiplier;
-		LoadMovementHackerValues(pRotationX, &fSinPhase, &fSinSpeed, &fSinAmplitude, &fCosPhase, &fCosSpeed, &fCosAmplitude, &fIncrement, &fLastRotationMultiplier );
-		SetValues( f3RotationXSinPhaseSpeedAmplitude, f3RotationXCosPhaseSpeedAmplitude, f3RotationXConstIncMultiplier, fSinPhase, fSinSpeed, fSinAmplitude, fCosPhase, fCosSpeed, fCosAmplitude, fIncrement, fLastRotationMultiplier );
-	}
-	else
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void MovementHackerComponent::Initialize(SceneNode const& a_rParameters)
+{
+	//Position then rotation paramaters, in the order of the tracks
+	static char const* s_pTrackNames[ MovementHackerBatch::E_TRACK_COUNT ] = { "posx", "posy", "posz", "rotationx", "rotationy", "rotationz" };
+	for( unsigned int i = 0; i < MovementHackerBatch::E_TRACK_COUNT; ++i )
 	{
-		SetValues( f3RotationXSinPhaseSpeedAmplitude, f3RotationXCosPhaseSpeedAmplitude, f3RotationXConstIncMultiplier );
+		_LoadTrack( a_rParameters.FirstChildElement( s_pTrackNames[i] ), static_cast< MovementHackerBatch::Track >( i ) );
 	}
+}
 
-	TiXmlElement const* pRotationY = a_rParameters.FirstChildElement( "rotationy" );
-	if( pRotationY )
-	{
-		float fSinPhase, fSinSpeed, fSinAmplitude, fCosPhase, fCosSpeed, fCosAmplitude, fIncrement, fLastRotationMultiplier;
-		LoadMovementHackerValues(pRotationY, &fSinPhase, &fSinSpeed, &fSinAmplitude, &fCosPhase, &fCosSpeed, &fCosAmplitude, &fIncrement, &fLastRotationMultiplier );
-		SetValues( f3RotationYSinPhaseSpeedAmplitude, f3RotationYCosPhaseSpeedAmplitude, f3RotationYConstIncMultiplier, fSinPhase, fSinSpeed, fSinAmplitude, fCosPhase, fCosSpeed, fCosAmplitude, fIncrement, fLastRotationMultiplier );
-	}
-	else
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void MovementHackerComponent::Update( float fFrameTime, float fElapsedTime )
+{
+	if( !m_pComponent )
 	{
-		SetValues( f3RotationYSinPhaseSpeedAmplitude, f3RotationYCosPhaseSpeedAmplitude, f3RotationYConstIncMultiplier );
+		return;
 	}
 
-	TiXmlElement const* pRotationZ = a_rParameters.FirstChildElement( "rotationz" );
-	if( pRotationZ )
-	{
-		float fSinPhase, fSinSpeed, fSinAmplitude, fCosPhase, fCosSpeed, fCosAmplitude, fIncrement, fLastRotationMultiplier;
-		LoadMovementHackerValues(pRotationZ, &fSinPhase, &fSinSpeed, &fSinAmplitude, &fCosPhase, &fCosSpeed, &fCosAmplitude, &fIncrement, &fLastRotationMultiplier );
-		SetValues( f3RotationZSinPhaseSpeedAmplitude, f3RotationZCosPhaseSpeedAmplitude, f3RotationZConstIncMultiplier, fSinPhase, fSinSpeed, fSinAmplitude, fCosPhase, fCosSpeed, fCosAmplitude, fIncrement, fLastRotationMultiplier );
-	}
-	else
-	{
-		SetValues( f3RotationZSinPhaseSpeedAmplitude, f3RotationZCosPhaseSpeedAmplitude, f3RotationZConstIncMultiplier );
-	}
+	float pValues[ MovementHackerBatch::E_TRACK_COUNT ];
+	_GetValues( pValues );
+	unsigned int iSlot = _GetBatchSlot();
+	_GrabBatch().Evaluate( iSlot, iSlot + 1, pValues, fFrameTime, fElapsedTime );
+	_SetValues( pValues );
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void MovementHackerComponent::UpdateValue( float * fValue, float fFrameTime, float fElapsedTime, vec3 f3SinPhaseSpeedAmplitude, vec3 f3CosPhaseSpeedAmplitude, vec3 f3ConstIncMultiplier )
+void MovementHackerComponent::UpdateBatch( float fFrameTime, float fElapsedTime )
 {
-	float fSinValue = sinf( fElapsedTime * f3SinPhaseSpeedAmplitude.y + f3SinPhaseSpeedAmplitude.x ) * f3SinPhaseSpeedAmplitude.z;
-	float fCosValue = cosf( fElapsedTime * f3CosPhaseSpeedAmplitude.y + f3CosPhaseSpeedAmplitude.x ) * f3CosPhaseSpeedAmplitude.z;
-	*fValue = ( f3ConstIncMultiplier.z * *fValue ) + ( fFrameTime * f3ConstIncMultiplier.y ) + fSinValue + fCosValue;
-	if( f3SinPhaseSpeedAmplitude.y || f3CosPhaseSpeedAmplitude.y )
+	//The pool counts every slot of its chunks, the batch only has room up to the last hacker reset
+	unsigned int iSlotCount = min( ComponentPool< MovementHackerComponent >::GetSlotCount(), s_oBatch.GetSlotCount() );
+	if( iSlotCount == 0 )
 	{
-		*fValue += f3ConstIncMultiplier.x;
+		return;
 	}
+
+	sUpdateContext oContext;
+	oContext.m_fFrameTime = fFrameTime;
+	oContext.m_fElapsedTime = fElapsedTime;
+	JobPool::GrabInstance().Run( &_UpdateRange, &oContext, iSlotCount, s_iGrainSize );
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void MovementHackerComponent::Update( float fFrameTime, float fElapsedTime )
+void MovementHackerComponent::_UpdateRange( void* pContext, unsigned int iBegin, unsigned int iEnd )
 {
-	vec3 f3Pos = m_pComponent->GetPos();
-	UpdateValue( &f3Pos.x, fFrameTime, fElapsedTime, f3XSinPhaseSpeedAmplitude, f3XCosPhaseSpeedAmplitude, f3XConstIncMultiplier);
-	UpdateValue( &f3Pos.y, fFrameTime, fElapsedTime, f3YSinPhaseSpeedAmplitude, f3YCosPhaseSpeedAmplitude, f3YConstIncMultiplier);
-	UpdateValue( &f3Pos.z, fFrameTime, fElapsedTime, f3ZSinPhaseSpeedAmplitude, f3ZCosPhaseSpeedAmplitude, f3ZConstIncMultiplier);
-	m_pComponent->SetPos( f3Pos );
-
-	vec3 f3Rotation = m_pComponent->GetRotation();
-	UpdateValue( &f3Rotation.x, fFrameTime, fElapsedTime, f3RotationXSinPhaseSpeedAmplitude, f3RotationXCosPhaseSpeedAmplitude, f3RotationXConstIncMultiplier);
-	UpdateValue( &f3Rotation.y, fFrameTime, fElapsedTime, f3RotationYSinPhaseSpeedAmplitude, f3RotationYCosPhaseSpeedAmplitude, f3RotationYConstIncMultiplier);
-	UpdateValue( &f3Rotation.z, fFrameTime, fElapsedTime, f3RotationZSinPhaseSpeedAmplitude, f3RotationZCosPhaseSpeedAmplitude, f3RotationZConstIncMultiplier);
-	m_pComponent->SetRotation( f3Rotation );
+	sUpdateContext const& rContext = *static_cast< sUpdateContext const* >( pContext );
+
+	//Gathered, evaluated and written back a grain at a time, the values stay on the stack
+	float pValues[ s_iGrainSize * MovementHackerBatch::E_TRACK_COUNT ];
+	for( unsigned int iFirst = iBegin; iFirst < iEnd; iFirst += s_iGrainSize )
+	{
+		unsigned int iLast = iFirst + s_iGrainSize < iEnd ? iFirst + s_iGrainSize : iEnd;
+
+		//The free slots and the idle hackers are evaluated on zeros, and left out of the write back
+		for( unsigned int i = iFirst; i < iLast; ++i )
+		{
+			MovementHackerComponent const* pHacker = ComponentPool< MovementHackerComponent >::Get( i );
+			float* pSlotValues = &pValues[ ( i - iFirst ) * MovementHackerBatch::E_TRACK_COUNT ];
+			if( pHacker && pHacker->m_bRegistered && pHacker->m_pComponent )
+			{
+				pHacker->_GetValues( pSlotValues );
+			}
+			else
+			{
+				for( unsigned int j = 0; j < MovementHackerBatch::E_TRACK_COUNT; ++j )
+				{
+					pSlotValues[j] = 0.0f;
+				}
+			}
+		}
+
+		s_oBatch.Evaluate( iFirst, iLast, pValues, rContext.m_fFrameTime, rContext.m_fElapsedTime );
+
+		for( unsigned int i = iFirst; i < iLast; ++i )
+		{
+			MovementHackerComponent* pHacker = ComponentPool< MovementHackerComponent >::Get( i );
+			if( pHacker && pHacker->m_bRegistered && pHacker->m_pComponent )
+			{
+				pHacker->_SetValues( &pValues[ ( i - iFirst ) * MovementHackerBatch::E_TRACK_COUNT ] );
+			}
+		}
+	}
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void MovementHackerComponent::SetValues( vec3& f3SinPhaseSpeedAmplitude, vec3& f3CosPhaseSpeedAmplitude, vec3& f3ConstIncMultiplier,float fSinPhase, float fSinSpeed, float fSinAmplitude, float fCosPhase, float fCosSpeed, float fCosAmplitude, float fIncrement, float fLastPosMultiplier )
+void MovementHackerComponent::_LoadTrack( SceneNode const* pXMLNode, MovementHackerBatch::Track eTrack )
 {
-	f3SinPhaseSpeedAmplitude.x = fSinPhase;
-	f3SinPhaseSpeedAmplitude.y = fSinSpeed;
-	f3SinPhaseSpeedAmplitude.z = fSinAmplitude;
+	float fSinPhase = 0.0f, fSinSpeed = 0.0f, fSinAmplitude = 0.0f;
+	float fCosPhase = 0.0f, fCosSpeed = 0.0f, fCosAmplitude = 0.0f;
+	float fIncrement = 0.0f, fLastPosMultiplier = 1.0f;
+	if( pXMLNode )
+	{
+		pXMLNode->QueryFloatAttribute( "sinPhase", &fSinPhase );
+		pXMLNode->QueryFloatAttribute( "sinSpeed", &fSinSpeed );
+		pXMLNode->QueryFloatAttribute( "sinAmplitude", &fSinAmplitude );
 
-	f3CosPhaseSpeedAmplitude.x = fCosPhase;
-	f3CosPhaseSpeedAmplitude.y = fCosSpeed;
-	f3CosPhaseSpeedAmplitude.z = fCosAmplitude;
+		pXMLNode->QueryFloatAttribute( "cosPhase", &fCosPhase );
+		pXMLNode->QueryFloatAttribute( "cosSpeed", &fCosSpeed );
+		pXMLNode->QueryFloatAttribute( "cosAmplitude", &fCosAmplitude );
 
-	//f3ConstIncMultiplier.x is initialized when m_pComponent is set
-	f3ConstIncMultiplier.y = fIncrement;
-	f3ConstIncMultiplier.z = fLastPosMultiplier;
+		pXMLNode->QueryFloatAttribute( "increment", &fIncrement );
+		pXMLNode->QueryFloatAttribute( "lastPosMultiplier", &fLastPosMultiplier );
+	}
+	_GrabBatch().SetTrack( _GetBatchSlot(), eTrack, fSinPhase, fSinSpeed, fSinAmplitude, fCosPhase, fCosSpeed, fCosAmplitude, fIncrement, fLastPosMultiplier );
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void MovementHackerComponent::LoadMovementHackerValues(TiXmlElement const* pXMLNode, float * pSinPhase, float * pSinSpeed, float * pSinAmplitude, float * pCosPhase, float * pCosSpeed, float * pCosAmplitude, float * pIncrement, float * pLastPosMultiplier )
+void MovementHackerComponent::_GetValues( float* pValues ) const
 {
-	pXMLNode->QueryFloatAttribute( "sinPhase", pSinPhase );
-	pXMLNode->QueryFloatAttribute( "sinSpeed",  pSinSpeed );
-	pXMLNode->QueryFloatAttribute( "sinAmplitude", pSinAmplitude );
-
-	pXMLNode->QueryFloatAttribute( "cosPhase", pCosPhase );
-	pXMLNode->QueryFloatAttribute( "cosSpeed", pCosSpeed );
-	pXMLNode->QueryFloatAttribute( "cosAmplitude", pCosAmplitude );
+	vec3 const& f3Pos = m_pComponent->GetLocalPos();
+	vec3 const& f3Rotation = m_pComponent->GetLocalRotation();
+	pValues[ MovementHackerBatch::E_TRACK_POS_X ] = f3Pos.x;
+	pValues[ MovementHackerBatch::E_TRACK_POS_Y ] = f3Pos.y;
+	pValues[ MovementHackerBatch::E_TRACK_POS_Z ] = f3Pos.z;
+	pValues[ MovementHackerBatch::E_TRACK_ROTATION_X ] = f3Rotation.x;
+	pValues[ MovementHackerBatch::E_TRACK_ROTATION_Y ] = f3Rotation.y;
+	pValues[ MovementHackerBatch::E_TRACK_ROTATION_Z ] = f3Rotation.z;
+}
 
-	pXMLNode->QueryFloatAttribute( "increment", pIncrement );
-	pXMLNode->QueryFloatAttribute( "lastPosMultiplier", pLastPosMultiplier );
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void MovementHackerComponent::_SetValues( float const* pValues )
+{
+	m_pComponent->SetPos( vec3( pValues[ MovementHackerBatch::E_TRACK_POS_X ], pValues[ MovementHackerBatch::E_TRACK_POS_Y ], pValues[ MovementHackerBatch::E_TRACK_POS_Z ] ) );
+	m_pComponent->SetRotation( vec3( pValues[ MovementHackerBatch::E_TRACK_ROTATION_X ], pValues[ MovementHackerBatch::E_TRACK_ROTATION_Y ], pValues[ MovementHackerBatch::E_TRACK_ROTATION_Z ] ) );
 }
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -175,13 +211,11 @@ void MovementHackerComponent::SetComponent( AbstractComponent* pComponent )
 {
 	m_pComponent = pComponent;
 
-	vec3 f3Pos = pComponent->GetPos();
-	f3XConstIncMultiplier.x = f3Pos.x;
-	f3YConstIncMultiplier.x = f3Pos.y;
-	f3ZConstIncMultiplier.x = f3Pos.z;
-
-	vec3 f3Rotation = pComponent->GetRotation();
-	f3RotationXConstIncMultiplier.x = f3Rotation.x;
-	f3RotationYConstIncMultiplier.x = f3Rotation.y;
-	f3RotationZConstIncMultiplier.x = f3Rotation.z;
+	//The waves oscillate around where the target was placed
+	float pValues[ MovementHackerBatch::E_TRACK_COUNT ];
+	_GetValues( pValues );
+	for( unsigned int i = 0; i < MovementHackerBatch::E_TRACK_COUNT; ++i )
+	{
+		_GrabBatch().SetBase( _GetBatchSlot(), static_cast< MovementHackerBatch::Track >( i ), pValues[i] );
+	}
 }
\ No newline at end of file
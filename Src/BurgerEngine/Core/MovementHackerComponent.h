@@ -12,10 +12,23 @@
 #define __MOVEMENTHACKERCOMPONENT_H__
 
 #include "BurgerEngine/Core/AbstractComponent.h"
+#include "BurgerEngine/Core/ComponentPool.h"
+#include "BurgerEngine/Core/MovementHackerBatch.h"
 
+/// \class	MovementHackerComponent
+/// \brief	Moves its target along sine and cosine tracks, for the position and the rotation.
+///			The tracks of every hacker are kept in a MovementHackerBatch at the pool slot of the hacker, and all
+///			the registered hackers are updated together by UpdateBatch, after the animation phase.
+///			A derived class is not allocated by the pool: it keeps its tracks in a batch of its own and
+///			is updated by the scheduler, one at a time
 class MovementHackerComponent : public AbstractComponent
 {
 public:
+	DECLARE_COMPONENT_POOL( MovementHackerComponent )
+
+	/// Hackers per range given to a pool thread
+	static const unsigned int s_iGrainSize = 64;
+
 	/// \brief constructor
 	MovementHackerComponent(CompositeComponent* a_pParent = NULL);
 
@@ -24,42 +37,51 @@ public:
 
 	/// \brief Load the component using a XML Node
 	/// override
-	void Initialize(TiXmlElement const& a_rParameters);
+	void Initialize(SceneNode const& a_rParameters);
 	void SetComponent( AbstractComponent* pComponent );
+
+	/// \brief Move the target of this hacker only, UpdateBatch moves them all
 	void Update( float fFrameTime, float fElapsedTime );
 
-protected:
-	void UpdateValue( float * fValue, float fFrameTime, float fElapsedTime, vec3 f3SinPhaseSpeedAmplitude, vec3 f3CosPhaseSpeedAmplitude, vec3 f3ConstIncMultiplier );
+	/// \brief [OVERIDE] Only writes the transform of its component, so it runs in parallel
+	UpdatePhase GetUpdatePhase() const { return E_UPDATE_ANIMATION; }
 
-private:
-		void SetValues( vec3& f3SinPhaseSpeedAmplitude, vec3& f3CosPhaseSpeedAmplitude, vec3& f3ConstIncMultiplier, float fSinPhase = 0.0f, float fSinSpeed = 0.0f, float fSinAmplitude = 0.0f, float fCosPhase = 0.0f, float fCosSpeed = 0.0f, float fCosAmplitude = 0.0f, float fIncrement = 0.0f, float fLastPosMultiplier = 1.0f );
-		void LoadMovementHackerValues( TiXmlElement const* pXMLNode, float * pSinPhase, float * pSinSpeed, float * pSinAmplitude, float * pCosPhase, float * pCosSpeed, float * pCosAmplitude, float * pIncrement, float * pLastPosMultiplier );
+	/// \brief [OVERIDE] Not in the scheduler, registered hackers are moved by UpdateBatch, but the ones out of the pool
+	void RegisterUpdate( ComponentScheduler& rScheduler );
+	void UnregisterUpdate( ComponentScheduler& rScheduler );
+
+	/// \brief Move the targets of every registered hacker, across the JobPool
+	static void UpdateBatch( float fFrameTime, float fElapsedTime );
 
-		vec3 f3XSinPhaseSpeedAmplitude;
-		vec3 f3XCosPhaseSpeedAmplitude;
-		vec3 f3XConstIncMultiplier;
+private:
+	/// \brief Read a track, the missing values leave it still
+	void _LoadTrack( SceneNode const* pXMLNode, MovementHackerBatch::Track eTrack );
 
-		vec3 f3YSinPhaseSpeedAmplitude;
-		vec3 f3YCosPhaseSpeedAmplitude;
-		vec3 f3YConstIncMultiplier;
+	/// \brief Copy the position and rotation of the target, or write them back, six values
+	void _GetValues( float* pValues ) const;
+	void _SetValues( float const* pValues );
 
-		vec3 f3ZSinPhaseSpeedAmplitude;
-		vec3 f3ZCosPhaseSpeedAmplitude;
-		vec3 f3ZConstIncMultiplier;
+	/// \brief Batch and slot of the tracks, the shared batch for the hackers of the pool
+	MovementHackerBatch& _GrabBatch(){ return m_pOwnBatch ? *m_pOwnBatch : s_oBatch; }
+	unsigned int _GetBatchSlot() const { return m_pOwnBatch ? 0 : m_iSlot; }
 
-		vec3 f3RotationXSinPhaseSpeedAmplitude;
-		vec3 f3RotationXCosPhaseSpeedAmplitude;
-		vec3 f3RotationXConstIncMultiplier;
+	/// What the pool threads need to update a range of slots
+	struct sUpdateContext
+	{
+		float	m_fFrameTime;
+		float	m_fElapsedTime;
+	};
 
-		vec3 f3RotationYSinPhaseSpeedAmplitude;
-		vec3 f3RotationYCosPhaseSpeedAmplitude;
-		vec3 f3RotationYConstIncMultiplier;
+	static void _UpdateRange( void* pContext, unsigned int iBegin, unsigned int iEnd );
 
-		vec3 f3RotationZSinPhaseSpeedAmplitude;
-		vec3 f3RotationZCosPhaseSpeedAmplitude;
-		vec3 f3RotationZConstIncMultiplier;
+	/// Tracks of every hacker, at its slot in the pool
+	static MovementHackerBatch s_oBatch;
 
-		AbstractComponent* m_pComponent;
+	unsigned int		m_iSlot;
+	bool				m_bRegistered;
+	AbstractComponent*	m_pComponent;
+	/// Tracks of a hacker allocated out of the pool, NULL for the others
+	MovementHackerBatch*	m_pOwnBatch;
 };
 
 #endif //__MOVEMENTHACKERCOMPONENT_H__
\ No newline at end of file
@@ -4,8 +4,28 @@
 #include "BurgerEngine/Core/RenderComponent.h"
 #include "BurgerEngine/Core/LightComponent.h"
 #include "BurgerEngine/Core/ParticleComponent.h"
+#include "BurgerEngine/Core/SceneDocument.h"
+
+#include <algorithm>
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+ObjectFactory::ObjectFactory()
+{
+	RegisterComponent( "render", &_CreateComponent< RenderComponent > );
+	RegisterComponent( "composite", &_CreateComponent< CompositeComponent > );
+	RegisterComponent( "light", &_CreateComponent< LightComponent > );
+	RegisterComponent( "particle", &_CreateComponent< ParticleComponent > );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+ObjectFactory::~ObjectFactory()
+{
+	ObjectFactory::Terminate();
+}
 
-#include "BurgerEngine/External/TinyXml/TinyXml.h"
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
@@ -19,48 +39,34 @@ void ObjectFactory::Init()
 //--------------------------------------------------------------------------------------------------------------------
 void ObjectFactory::Terminate()
 {
-	for (std::map<std::string , CompositeComponent*>::iterator iter = m_mObjects.begin() ; iter != m_mObjects.end() ; ++iter)
+	for (std::vector<SceneDocument*>::iterator iter = m_vDocuments.begin() ; iter != m_vDocuments.end() ; ++iter)
 	{
-		delete (*iter).second;
+		delete (*iter);
 	}
-	m_mObjects.clear();
+	m_vDocuments.clear();
+	m_mPrototypes.clear();
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-AbstractComponent* ObjectFactory::LoadObject( const TiXmlElement * const pXmlElement, CompositeComponent* a_pParent )
+AbstractComponent* ObjectFactory::LoadObject( const SceneNode * const pXmlElement, CompositeComponent* a_pParent )
 {
-	std::string sFullPath;
 	std::string sFileName;
-	const TiXmlElement * pFileNameXml= pXmlElement->FirstChildElement( "file" );
+	const SceneNode * pFileNameXml= pXmlElement->FirstChildElement( "file" );
 	if( pFileNameXml )
 	{
 		sFileName = pFileNameXml->GetText();
 	}
-	
-	sFullPath.append( "../Data/Objects/" );
-	sFullPath.append( sFileName );
-	sFullPath.append(".bcp.xml");
-
-	//Load the file
-	TiXmlDocument * pDocument = new TiXmlDocument( sFullPath );
-
-	if(!pDocument->LoadFile())
-	{
-		ADD_ERROR_MESSAGE( std::string("Loading : ") << pDocument->ErrorDesc() << std::string(" ") << sFileName );
-		return NULL;
-	}
 
-	TiXmlElement * pComponentXML = pDocument->FirstChildElement( "component" );
-	AbstractComponent* pComponent = CreateAndInitComponent( *pComponentXML, a_pParent );
+	AbstractComponent* pComponent = CreateComponentInstance( sFileName, a_pParent );
 	
 	//a ressource component can override the component postion/rotation/scale
 	if( pComponent )
 	{
 		float x, y, z, rX, rY, rZ, scale;
 
-		TiXmlElement const* pPositionXml = pXmlElement->FirstChildElement( "position" );
+		SceneNode const* pPositionXml = pXmlElement->FirstChildElement( "position" );
 		if( pPositionXml )
 		{
 			//gets position & bounded volume information 
@@ -85,15 +91,20 @@ AbstractComponent* ObjectFactory::LoadObject( const TiXmlElement * const pXmlEle
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-AbstractComponent* ObjectFactory::CreateAndInitComponent(TiXmlElement const& a_rComponentXml,  CompositeComponent* a_pParent )
+AbstractComponent* ObjectFactory::CreateAndInitComponent(SceneNode const& a_rComponentXml,  CompositeComponent* a_pParent )
 {
 	AbstractComponent* pComponent = NULL;
 
 	//Retrieve ID
 	std::string sId;
-	a_rComponentXml.QueryValueAttribute<std::string>("id",&sId);
+	a_rComponentXml.QueryValueAttribute("id",&sId);
 
 	pComponent = CreateComponentFromID(sId, a_pParent);
+	if( !pComponent )
+	{
+		ADD_ERROR_MESSAGE( std::string("Unknown component : ") << sId );
+		return NULL;
+	}
 
 	//Get Parameters
 	//std::map<std::string, void*> mParameters;
@@ -102,7 +113,7 @@ AbstractComponent* ObjectFactory::CreateAndInitComponent(TiXmlElement const& a_r
 	// It would create a map of <string, void>
 	// I want to do this in order to avoid moving around the TIXmlElement
 	//Init with the parameter node
-	TiXmlElement const* pParameter = a_rComponentXml.FirstChildElement("parameters");
+	SceneNode const* pParameter = a_rComponentXml.FirstChildElement("parameters");
 	pComponent->Initialize(*pParameter);
 
 	return pComponent;
@@ -111,50 +122,149 @@ AbstractComponent* ObjectFactory::CreateAndInitComponent(TiXmlElement const& a_r
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-AbstractComponent* ObjectFactory::CreateComponentFromID( std::string& a_sID, CompositeComponent* a_pParent )
+AbstractComponent* ObjectFactory::CreateComponentFromID( std::string const& a_sID, CompositeComponent* a_pParent )
+{
+	std::map<unsigned int, ComponentCreator>::const_iterator iter = m_mCreators.find( HashID( a_sID ) );
+	if( iter == m_mCreators.end() )
+	{
+		return NULL;
+	}
+	return iter->second( a_pParent );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+AbstractComponent* ObjectFactory::CreateComponentInstance( std::string const& a_rsFileName, CompositeComponent* a_pParent )
+{
+	SceneNode const* pComponentXml = _GetPrototype( a_rsFileName );
+	if( !pComponentXml )
+	{
+		return NULL;
+	}
+	return CreateAndInitComponent( *pComponentXml, a_pParent );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ObjectFactory::AddPrototypes( SceneDocument* a_pDocument )
 {
-	//Transform to switch case with an int?
-	if (a_sID == "render")
+	m_vDocuments.push_back( a_pDocument );
+
+	//The newest document wins, its objects were compiled from the current files
+	for( SceneNode const* pObjectXml = a_pDocument->FirstChildElement( "object" ); pObjectXml; pObjectXml = pObjectXml->NextSiblingElement( "object" ) )
 	{
-		//Create the component
-		return new RenderComponent(a_pParent);
+		char const* sFileName = pObjectXml->Attribute( "file" );
+		SceneNode const* pComponentXml = pObjectXml->FirstChildElement( "component" );
+		if( sFileName && pComponentXml )
+		{
+			sPrototype& rPrototype = m_mPrototypes[ sFileName ];
+			rPrototype.m_pComponentXml = pComponentXml;
+			rPrototype.m_pDocument = a_pDocument;
+		}
 	}
-	else if(a_sID == "composite")
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ObjectFactory::RemovePrototypes( SceneDocument* a_pDocument )
+{
+	//The objects it held are read again from their file if another scene asks for them
+	std::map<std::string, sPrototype>::iterator iter = m_mPrototypes.begin();
+	while( iter != m_mPrototypes.end() )
 	{
-		return new CompositeComponent(a_pParent);
+		if( iter->second.m_pDocument == a_pDocument )
+		{
+			m_mPrototypes.erase( iter++ );
+		}
+		else
+		{
+			++iter;
+		}
 	}
-	else if(a_sID == "light")
+
+	std::vector<SceneDocument*>::iterator itDocument = std::find( m_vDocuments.begin(), m_vDocuments.end(), a_pDocument );
+	if( itDocument != m_vDocuments.end() )
 	{
-		return new LightComponent(a_pParent);
+		m_vDocuments.erase( itDocument );
 	}
-	else if(a_sID == "particle")
+	delete a_pDocument;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ObjectFactory::RegisterComponent( std::string const& a_sID, ComponentCreator a_pCreator )
+{
+	unsigned int iTypeID = HashID( a_sID );
+
+	//Two ids with the same hash would silently create the wrong type
+	assert( m_mCreators.find( iTypeID ) == m_mCreators.end() );
+	m_mCreators[ iTypeID ] = a_pCreator;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+unsigned int ObjectFactory::HashID( std::string const& a_sID )
+{
+	//FNV-1a
+	unsigned int iHash = 2166136261u;
+	for( unsigned int i = 0; i < a_sID.size(); ++i )
 	{
-		return new ParticleComponent(a_pParent);
+		iHash ^= static_cast< unsigned char >( a_sID[i] );
+		iHash *= 16777619u;
 	}
+	return iHash;
+}
 
-	return NULL;
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+std::string ObjectFactory::GetObjectPath( std::string const& a_rsFileName )
+{
+	std::string sFullPath;
+	sFullPath.append( "../Data/Objects/" );
+	sFullPath.append( a_rsFileName );
+	sFullPath.append(".bcp.xml");
+	return sFullPath;
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-CompositeComponent* ObjectFactory::CreateComponentInstance(std::string const& a_rsID)
+SceneNode const* ObjectFactory::_GetPrototype( std::string const& a_rsFileName )
 {
-	//We look for the instance to create
-	std::map<std::string , CompositeComponent*>::iterator iter = m_mObjects.find(a_rsID);
-	
-	//The instance is not created, we load it so far never store
-	if (iter != m_mObjects.end())
+	std::map<std::string , sPrototype>::iterator iter = m_mPrototypes.find( a_rsFileName );
+	if( iter != m_mPrototypes.end() )
+	{
+		return iter->second.m_pComponentXml;
+	}
+
+	//Not part of a compiled scene, the file is read on its own
+	SceneDocument * pDocument = new SceneDocument();
+	SceneNode const* pComponentXml = NULL;
+	if( pDocument->LoadXml( GetObjectPath( a_rsFileName ) ) )
+	{
+		pComponentXml = pDocument->FirstChildElement( "component" );
+	}
+
+	if( pComponentXml )
 	{
-		CompositeComponent* pObject = new CompositeComponent(*iter->second);
-		return pObject;
+		m_vDocuments.push_back( pDocument );
 	}
 	else
 	{
-		assert(false);
+		delete pDocument;
+		pDocument = NULL;
 	}
-	return NULL;
 
+	sPrototype& rPrototype = m_mPrototypes[ a_rsFileName ];
+	rPrototype.m_pComponentXml = pComponentXml;
+	rPrototype.m_pDocument = pDocument;
+	return pComponentXml;
 }
 
 
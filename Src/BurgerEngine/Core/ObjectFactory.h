@@ -15,19 +15,29 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include "BurgerEngine/External/Math/Vector.h"
 #include "BurgerEngine/Base/CommonBase.h"
 
 //forward declaration
 class CompositeComponent;
 class AbstractComponent;
-class TiXmlElement;
+class SceneNode;
+class SceneDocument;
 
 /// \brief
 /// \class ObjectFactory
+/// Each object file is parsed once, the instances are then created from its parsed document
 class ObjectFactory
 {
 public:
+	/// \brief Create a component of a type
+	typedef AbstractComponent* (*ComponentCreator)( CompositeComponent* a_pParent );
+
+	/// \brief Register the engine components
+	ObjectFactory();
+	virtual ~ObjectFactory();
+
 	/// \brief Init
 	void Init();
 
@@ -35,20 +45,61 @@ public:
 	virtual void Terminate();
 
 	/// \brief Load a Object from a xml file
-	AbstractComponent* LoadObject( const TiXmlElement * const pXmlElement, CompositeComponent* a_pParent = NULL );
+	AbstractComponent* LoadObject( const SceneNode * const pXmlElement, CompositeComponent* a_pParent = NULL );
 
 	/// \brief Static loading method just load a single component
-	AbstractComponent* CreateAndInitComponent(TiXmlElement const& a_rParameters, CompositeComponent* a_pParent);
+	AbstractComponent* CreateAndInitComponent(SceneNode const& a_rParameters, CompositeComponent* a_pParent);
 
-	virtual AbstractComponent* CreateComponentFromID( std::string& a_sID, CompositeComponent* a_pParent );
+	/// \brief Create a component of a registered type, NULL if the type is unknown
+	AbstractComponent* CreateComponentFromID( std::string const& a_sID, CompositeComponent* a_pParent );
 	
-	/// \brief Try to create an object using the ID
-	/// \param a_rsID the unique ID... should become an int as it would become much faster
-	CompositeComponent* CreateComponentInstance(std::string const& a_rsID);
+	/// \brief Create an instance of an object file, the file is only read the first time
+	/// \param a_rsFileName name of the file in Data/Objects, without the .bcp.xml extension
+	AbstractComponent* CreateComponentInstance( std::string const& a_rsFileName, CompositeComponent* a_pParent = NULL );
+
+	/// \brief Keep a document and use its "object" roots as the prototypes of their files, in place of the
+	/// prototypes already there so a recompiled object is picked up.
+	/// The factory takes the document, which stays alive until RemovePrototypes
+	void AddPrototypes( SceneDocument* a_pDocument );
+
+	/// \brief Forget the prototypes of a document given to AddPrototypes and delete it, once its scene is gone
+	void RemovePrototypes( SceneDocument* a_pDocument );
+
+	/// \brief Make a component type available to the objects files
+	/// \param a_sID value of the id attribute of the component node
+	void RegisterComponent( std::string const& a_sID, ComponentCreator a_pCreator );
+
+	/// \brief Type ID of a component id
+	static unsigned int HashID( std::string const& a_sID );
+
+	/// \brief Path of an object file from its name
+	static std::string GetObjectPath( std::string const& a_rsFileName );
+
+protected:
+	/// \brief Creator of the components built from their parent only
+	template< typename T >
+	static AbstractComponent* _CreateComponent( CompositeComponent* a_pParent ) { return new T( a_pParent ); }
+
+private:
+	/// \brief Parsed component node of an object file, NULL if it could not be loaded
+	SceneNode const* _GetPrototype( std::string const& a_rsFileName );
 
 private:
-	/// The map which contain all the object to spawn
-	std::map<std::string, CompositeComponent*> m_mObjects;
+	/// Root component of an object file, and the document it is in
+	struct sPrototype
+	{
+		SceneNode const*	m_pComponentXml;
+		SceneDocument*		m_pDocument;
+	};
+
+	/// The creators, by type ID
+	std::map<unsigned int, ComponentCreator> m_mCreators;
+
+	/// The prototypes, by file name. NULL when loading failed, it is not tried again
+	std::map<std::string, sPrototype> m_mPrototypes;
+
+	/// The documents the prototypes are in
+	std::vector<SceneDocument*> m_vDocuments;
 
 	/// The Path to the loading of object
 	//std::string m_sPath;
@@ -11,13 +11,13 @@
 #include "BurgerEngine/Graphics/MaterialManager.h"
 
 
-#include "BurgerEngine/External/TinyXml/TinyXml.h"
+#include "BurgerEngine/Core/SceneDocument.h"
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
 ParticleComponent::ParticleComponent(CompositeComponent* a_pParent):
-	AbstractComponent(a_pParent),
+	AbstractComponent(a_pParent, PARTICLE),
 	m_pSystem(NULL)
 {
 }
@@ -26,7 +26,7 @@ ParticleComponent::ParticleComponent(CompositeComponent* a_pParent):
 //
 //--------------------------------------------------------------------------------------------------------------------
 ParticleComponent::ParticleComponent(AbstractComponent const& a_rToCopy):
-	AbstractComponent(),
+	AbstractComponent(NULL, PARTICLE),
 	m_pSystem(NULL)
 {
 
@@ -37,19 +37,24 @@ ParticleComponent::ParticleComponent(AbstractComponent const& a_rToCopy):
 //--------------------------------------------------------------------------------------------------------------------
 ParticleComponent::~ParticleComponent()
 {
-	m_pSystem->Terminate();
-	delete m_pSystem;
+	if( m_pSystem )
+	{
+		//Streamed out components go while the scene is updated
+		Engine::GrabInstance().GrabParticleContext().UnregisterFXInstance(*m_pSystem);
+		m_pSystem->Terminate();
+		delete m_pSystem;
+	}
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void ParticleComponent::Initialize(TiXmlElement const& a_rParameters)
+void ParticleComponent::Initialize(SceneNode const& a_rParameters)
 {
 	//Create the whole system
 	m_pSystem = new ParticleSystem();
 
-	TiXmlElement const* pGroupsXml = a_rParameters.FirstChildElement( "group" );
+	SceneNode const* pGroupsXml = a_rParameters.FirstChildElement( "group" );
 
 	while (pGroupsXml)
 	{
@@ -66,7 +71,7 @@ void ParticleComponent::Initialize(TiXmlElement const& a_rParameters)
 		pGroupsXml->QueryFloatAttribute("y",&y);
 		pGroupsXml->QueryFloatAttribute("z",&z);
 
-		TiXmlElement const* pEmitterXml = pGroupsXml->FirstChildElement( "emitter" );
+		SceneNode const* pEmitterXml = pGroupsXml->FirstChildElement( "emitter" );
 		if (pEmitterXml)
 		{
 			// TODO : take position
@@ -77,23 +82,23 @@ void ParticleComponent::Initialize(TiXmlElement const& a_rParameters)
 			pEmitterXml->QueryFloatAttribute("life",&rEmitter.m_fLife);
 		}
 		
-		TiXmlElement const* pEffectorXml = pGroupsXml->FirstChildElement( "effector" );
+		SceneNode const* pEffectorXml = pGroupsXml->FirstChildElement( "effector" );
 		//now were adding the effector for each row 
 		while (pEffectorXml)
 		{
 			std::string sId;
-			pEffectorXml->QueryValueAttribute<std::string>("id",&sId);
+			pEffectorXml->QueryValueAttribute("id",&sId);
 			ParticleEffector* pEffector;
 			if (sId == "velocity")
 			{
 				ParticleVelocityEffector* pTypedEffector = new ParticleVelocityEffector();
 				vec3 vMax, vMin;
-				TiXmlElement const* pMinXml = pEffectorXml->FirstChildElement( "min" );
+				SceneNode const* pMinXml = pEffectorXml->FirstChildElement( "min" );
 				pMinXml->QueryFloatAttribute("x", &vMin.x);
 				pMinXml->QueryFloatAttribute("y", &vMin.y);
 				pMinXml->QueryFloatAttribute("z", &vMin.z);
 
-				TiXmlElement const* pMaxXml = pEffectorXml->FirstChildElement( "max" );
+				SceneNode const* pMaxXml = pEffectorXml->FirstChildElement( "max" );
 				pMaxXml->QueryFloatAttribute("x", &vMax.x);
 				pMaxXml->QueryFloatAttribute("y", &vMax.y);
 				pMaxXml->QueryFloatAttribute("z", &vMax.z);
@@ -105,7 +110,7 @@ void ParticleComponent::Initialize(TiXmlElement const& a_rParameters)
 			{
 				ParticleLifeEffector* pTypedEffector = new ParticleLifeEffector();
 				float fMin, fMax;
-				TiXmlElement const* pValueXml = pEffectorXml->FirstChildElement( "value" );
+				SceneNode const* pValueXml = pEffectorXml->FirstChildElement( "value" );
 				pValueXml->QueryFloatAttribute("min", &fMin);
 				pValueXml->QueryFloatAttribute("max", &fMax);
 
@@ -116,12 +121,12 @@ void ParticleComponent::Initialize(TiXmlElement const& a_rParameters)
 			{
 				ParticleAccelerationEffector* pTypedEffector = new ParticleAccelerationEffector();
 				vec3 vMax, vMin;
-				TiXmlElement const* pMinXml = pEffectorXml->FirstChildElement( "min" );
+				SceneNode const* pMinXml = pEffectorXml->FirstChildElement( "min" );
 				pMinXml->QueryFloatAttribute("x", &vMin.x);
 				pMinXml->QueryFloatAttribute("y", &vMin.y);
 				pMinXml->QueryFloatAttribute("z", &vMin.z);
 
-				TiXmlElement const* pMaxXml = pEffectorXml->FirstChildElement( "max" );
+				SceneNode const* pMaxXml = pEffectorXml->FirstChildElement( "max" );
 				pMaxXml->QueryFloatAttribute("x", &vMax.x);
 				pMaxXml->QueryFloatAttribute("y", &vMax.y);
 				pMaxXml->QueryFloatAttribute("z", &vMax.z);
@@ -134,7 +139,7 @@ void ParticleComponent::Initialize(TiXmlElement const& a_rParameters)
 			pEffectorXml = pEffectorXml->NextSiblingElement( "effector" );
 		}
 		//The material 
-		TiXmlElement const* pMaterialXml = pGroupsXml->FirstChildElement( "material" );
+		SceneNode const* pMaterialXml = pGroupsXml->FirstChildElement( "material" );
 		Material * pMaterial = MaterialManager::GrabInstance().addMaterial( pMaterialXml->GetText() );
 		pGroup->SetMaterial(pMaterial);
 
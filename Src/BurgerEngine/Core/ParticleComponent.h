@@ -12,12 +12,15 @@
 #define __PARTICLECOMPONENT_H__
 
 #include "BurgerEngine/Core/AbstractComponent.h"
+#include "BurgerEngine/Core/ComponentPool.h"
 
 class ParticleSystem;
 
 class ParticleComponent : public AbstractComponent
 {
 public:
+	DECLARE_COMPONENT_POOL( ParticleComponent )
+
 	/// \brief constructor
 	ParticleComponent(CompositeComponent* a_pParent = NULL);
 
@@ -29,10 +32,13 @@ public:
 
 	/// \brief Load the component using a XML Node
 	/// override
-	void Initialize(TiXmlElement const& a_rParameters);
+	void Initialize(SceneNode const& a_rParameters);
 
 	void Update( float fFrameTime, float fElapsedTime );
 
+	/// \brief [OVERIDE] Nothing to update, the particles are run by the ParticleContext
+	UpdatePhase GetUpdatePhase() const { return E_UPDATE_NONE; }
+
 private:
 
 	/// The contained system
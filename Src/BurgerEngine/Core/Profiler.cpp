@@ -0,0 +1,21 @@
+#include "BurgerEngine/Core/Profiler.h"
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void Profiler::Reset()
+{
+	for( unsigned int i = 0; i < E_PROFILE_COUNT; ++i )
+	{
+		m_pTimes[i] = 0.0f;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+char const* Profiler::GetName( ProfileSection eSection )
+{
+	static char const* s_pNames[ E_PROFILE_COUNT ] = { "update", "culling", "lights", "submission" };
+	return s_pNames[ eSection ];
+}
@@ -0,0 +1,63 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include "BurgerEngine/Base/Singleton.h"
+#include "BurgerEngine/Core/Timer.h"
+
+/// \brief The parts of a frame measured on the CPU
+enum ProfileSection
+{
+	E_PROFILE_UPDATE,
+	E_PROFILE_CULLING,
+	E_PROFILE_LIGHTS,
+	E_PROFILE_SUBMISSION,
+	E_PROFILE_COUNT
+};
+
+/// \class	Profiler
+/// \brief	Time spent by the main thread in each section, summed over the frames until Reset.
+///			A section can be entered many times per frame, its times add up.
+///			Disabled by default, Begin and End then cost no timer query outside of a benchmark
+class Profiler: public Singleton<Profiler>
+{
+	friend class Singleton<Profiler>;
+
+public:
+
+	void Begin( ProfileSection eSection ){ if( m_bEnabled ){ m_pTimers[ eSection ].Start(); } }
+	void End( ProfileSection eSection ){ if( m_bEnabled ){ m_pTimes[ eSection ] += m_pTimers[ eSection ].Stop(); } }
+
+	/// \brief Set by the engine when a benchmark runs
+	void SetEnabled( bool bEnabled ){ m_bEnabled = bEnabled; }
+	bool IsEnabled() const { return m_bEnabled; }
+
+	/// \brief Milliseconds spent in the section since the last Reset
+	float GetTime( ProfileSection eSection ) const { return m_pTimes[ eSection ]; }
+
+	void Reset();
+
+	/// \brief Name of a section, for the reports
+	static char const* GetName( ProfileSection eSection );
+
+private:
+
+	Profiler(): m_bEnabled( false ){ Reset(); }
+	virtual ~Profiler(){}
+
+	Timer	m_pTimers[ E_PROFILE_COUNT ];
+	float	m_pTimes[ E_PROFILE_COUNT ];
+	bool	m_bEnabled;
+};
+
+#endif //__PROFILER_H__
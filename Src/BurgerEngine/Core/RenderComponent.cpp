@@ -2,8 +2,9 @@
 #include "BurgerEngine/Core/ObjectFactory.h"
 #include "BurgerEngine/Core/Engine.h"
 #include "BurgerEngine/Core/CompositeComponent.h"
+#include "BurgerEngine/Core/TransformStore.h"
 
-#include "BurgerEngine/External/TinyXml/TinyXml.h"
+#include "BurgerEngine/Core/SceneDocument.h"
 
 #include "BurgerEngine/Graphics/SceneMesh.h"
 #include "BurgerEngine/Graphics/MeshManager.h"
@@ -14,7 +15,7 @@
 //
 //--------------------------------------------------------------------------------------------------------------------
 RenderComponent::RenderComponent(CompositeComponent* a_pParent):
-	AbstractComponent(a_pParent),
+	AbstractComponent(a_pParent, RENDER),
 	m_pMesh(NULL)
 {
 }
@@ -23,7 +24,7 @@ RenderComponent::RenderComponent(CompositeComponent* a_pParent):
 //
 //--------------------------------------------------------------------------------------------------------------------
 RenderComponent::RenderComponent(AbstractComponent const& a_rToCopy):
-	AbstractComponent()
+	AbstractComponent(NULL, RENDER)
 {
 
 }
@@ -33,6 +34,19 @@ RenderComponent::RenderComponent(AbstractComponent const& a_rToCopy):
 //--------------------------------------------------------------------------------------------------------------------
 RenderComponent::~RenderComponent()
 {
+	//Streamed out components go while the scene is rendered
+	if( m_pMesh )
+	{
+		Engine::GrabInstance().GrabRenderContext().RemoveMesh(*m_pMesh);
+
+		//The resources are shared with the other instances, they are freed with the last one
+		std::vector<Material*> const& vMaterials = m_pMesh->GetMaterials();
+		for( unsigned int i = 0; i < vMaterials.size(); ++i )
+		{
+			MaterialManager::GrabInstance().releaseMaterial( vMaterials[i] );
+		}
+		MeshManager::GrabInstance().releaseMesh( m_pMesh->GetMesh() );
+	}
 	//Maybe will be deleted by someone else
 	delete m_pMesh;
 }
@@ -40,14 +54,14 @@ RenderComponent::~RenderComponent()
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void RenderComponent::Initialize(TiXmlElement const& a_rParameters)
+void RenderComponent::Initialize(SceneNode const& a_rParameters)
 {
 	//Retrieve position
 	//First we should check is there is not an desc offset
 	//to the parent node
 	float x, y, z, rX, rY, rZ, scale;
 
-	TiXmlElement const* pPositionXml = a_rParameters.FirstChildElement( "position" );
+	SceneNode const* pPositionXml = a_rParameters.FirstChildElement( "position" );
 	if(pPositionXml)
 	{
 		//gets position & bounded volume information 
@@ -63,11 +77,11 @@ void RenderComponent::Initialize(TiXmlElement const& a_rParameters)
 	}
 	
 	//Find a way to retrieve position from the composite
-	TiXmlElement const* pMeshXml = a_rParameters.FirstChildElement( "mesh" );
+	SceneNode const* pMeshXml = a_rParameters.FirstChildElement( "mesh" );
 	if(pMeshXml)
 	{
 		//checks for the filename
-		TiXmlElement const* pFilename = pMeshXml->FirstChildElement( "file" );
+		SceneNode const* pFilename = pMeshXml->FirstChildElement( "file" );
 		if(pFilename)
 		{
 			std::string sMeshFileName( pFilename->GetText() );
@@ -76,6 +90,7 @@ void RenderComponent::Initialize(TiXmlElement const& a_rParameters)
 			if( pMesh )
 			{
 				m_pMesh = new SceneMesh( pMesh );
+				m_pMesh->SetTransform( GetTransform() );
 				
 				SetPos( vec3(x,y,z) );
 				SetRotation( vec3( rX, rY, rZ ) );
@@ -84,11 +99,11 @@ void RenderComponent::Initialize(TiXmlElement const& a_rParameters)
 				//checks for materials used on different parts of the mesh
 				unsigned int iPartCount = 0;
 
-				TiXmlElement const* pPart = pMeshXml->FirstChildElement( "part" );
+				SceneNode const* pPart = pMeshXml->FirstChildElement( "part" );
 				while( pPart )
 				{
 					++iPartCount;
-					TiXmlElement const* pXmlMaterial = pPart->FirstChildElement( "material" );
+					SceneNode const* pXmlMaterial = pPart->FirstChildElement( "material" );
 					if( pXmlMaterial )
 					{
 						Material * pMaterial = MaterialManager::GrabInstance().addMaterial( pXmlMaterial->GetText() );
@@ -118,11 +133,24 @@ void RenderComponent::Initialize(TiXmlElement const& a_rParameters)
 //--------------------------------------------------------------------------------------------------------------------
 void RenderComponent::Update( float fFrameTime, float fElapsedTime )
 {
-	if( m_bUpdateNeeded )
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void RenderComponent::UpdateTransform( BoundingBoxBatch& rBoundingBoxBatch )
+{
+	//the bounding box is also refreshed once the mesh gets loaded
+	//the mesh reads its render matrix from the TransformStore, only the values it sorts and culls with are copied
+	if( !m_pMesh )
+	{
+		return;
+	}
+	TransformStore const& rTransformStore = Engine::GrabInstance().GetTransformStore();
+	if( rTransformStore.HasRenderMoved( GetTransform() ) || m_pMesh->IsWaitingForMesh() )
 	{
-		m_pMesh->SetPos( GetPos() );
-		m_pMesh->SetRotation( GetRotation() );
-		m_pMesh->SetScale( GetScale() );
-		m_pMesh->ComputeBoundingBox();
+		m_pMesh->SetPos( rTransformStore.GetRenderPosition( GetTransform() ) );
+		m_pMesh->SetScale( rTransformStore.GetRenderScale( GetTransform() ) );
+		m_pMesh->ComputeBoundingBox( rBoundingBoxBatch );
 	}
 }
\ No newline at end of file
@@ -12,12 +12,15 @@
 #define __RENDERCOMPONENT_H__
 
 #include "BurgerEngine/Core/AbstractComponent.h"
+#include "BurgerEngine/Core/ComponentPool.h"
 
 class SceneMesh;
 
 class RenderComponent : public AbstractComponent
 {
 public:
+	DECLARE_COMPONENT_POOL( RenderComponent )
+
 	/// \brief constructor
 	RenderComponent(CompositeComponent* a_pParent = NULL);
 
@@ -29,7 +32,7 @@ public:
 
 	/// \brief Load the component using a XML Node
 	/// override
-	void Initialize(TiXmlElement const& a_rParameters);
+	void Initialize(SceneNode const& a_rParameters);
 
 	/// \brief Grab the mesh
 	/// \todo Could also go from the RenderContext
@@ -37,6 +40,12 @@ public:
 
 	void Update( float fFrameTime, float fElapsedTime );
 
+	/// \brief [OVERIDE] Nothing to update, the mesh follows the transform in UpdateTransform
+	UpdatePhase GetUpdatePhase() const { return E_UPDATE_NONE; }
+
+	/// \brief [OVERIDE] Copy the world transform to the mesh when it moved
+	void UpdateTransform( BoundingBoxBatch& rBoundingBoxBatch );
+
 private:
 	/// Own a Scene mesh object
 	SceneMesh* m_pMesh;
@@ -0,0 +1,298 @@
+#include "BurgerEngine/Core/SceneCompiler.h"
+#include "BurgerEngine/Core/SceneDocument.h"
+#include "BurgerEngine/Core/ObjectFactory.h"
+#include "BurgerEngine/Base/CommonBase.h"
+#include "BurgerEngine/Graphics/StaticMesh.h"
+
+#include "BurgerEngine/External/TinyXml/TinyXml.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <sstream>
+#include <iomanip>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef WIN32
+	#include <direct.h>
+#endif
+
+std::string SceneCompiler::s_sCacheDirectory;
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneCompiler::SetCacheDirectory( std::string const& sDirectory )
+{
+	s_sCacheDirectory = sDirectory;
+	if( s_sCacheDirectory.empty() )
+	{
+		return;
+	}
+
+	//Every parent is created first, the ones already there just fail
+	for( unsigned int i = 1; i <= s_sCacheDirectory.size(); ++i )
+	{
+		if( i == s_sCacheDirectory.size() || s_sCacheDirectory[i] == '/' || s_sCacheDirectory[i] == '\\' )
+		{
+			std::string sParent = s_sCacheDirectory.substr( 0, i );
+#ifdef WIN32
+			_mkdir( sParent.c_str() );
+#else
+			mkdir( sParent.c_str(), 0755 );
+#endif
+		}
+	}
+
+	if( s_sCacheDirectory[ s_sCacheDirectory.size() - 1 ] != '/' )
+	{
+		s_sCacheDirectory += '/';
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool SceneCompiler::Load( std::string const& sSceneName, SceneDocument& rDocument )
+{
+	std::string sCompiledName;
+	if( !s_sCacheDirectory.empty() )
+	{
+		sCompiledName = _GetCompiledName( sSceneName );
+		if( rDocument.LoadFile( sCompiledName ) && _IsUpToDate( rDocument, sSceneName ) )
+		{
+			return true;
+		}
+	}
+
+	if( !Compile( sSceneName, rDocument ) )
+	{
+		return false;
+	}
+
+	if( !sCompiledName.empty() )
+	{
+		rDocument.SaveFile( sCompiledName );
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool SceneCompiler::Compile( std::string const& sSceneName, SceneDocument& rDocument )
+{
+	sCompilation oCompilation;
+	oCompilation.m_pMeshes = new TiXmlElement( "meshes" );
+	oCompilation.m_pSources = new TiXmlElement( "sources" );
+
+	bool bCompiled = false;
+	TiXmlDocument* pScene = _Parse( sSceneName, oCompilation );
+	TiXmlElement const* pRoot = pScene ? pScene->FirstChildElement( "scene" ) : NULL;
+	if( pRoot )
+	{
+		_AddObjects( *pRoot, oCompilation );
+		_AddMeshes( *pRoot, oCompilation );
+		FOR_EACH_IT( std::vector< TiXmlElement* >, oCompilation.m_vObjects, itObject )
+		{
+			_AddMeshes( **itObject, oCompilation );
+		}
+
+		std::vector< TiXmlElement const* > vRoots;
+		vRoots.push_back( pRoot );
+		vRoots.insert( vRoots.end(), oCompilation.m_vObjects.begin(), oCompilation.m_vObjects.end() );
+		vRoots.push_back( oCompilation.m_pMeshes );
+		vRoots.push_back( oCompilation.m_pSources );
+		rDocument.Build( vRoots );
+		bCompiled = true;
+	}
+
+	FOR_EACH_IT( std::vector< TiXmlDocument* >, oCompilation.m_vFiles, itFile )
+	{
+		delete (*itFile);
+	}
+	FOR_EACH_IT( std::vector< TiXmlElement* >, oCompilation.m_vObjects, itObject )
+	{
+		delete (*itObject);
+	}
+	delete oCompilation.m_pMeshes;
+	delete oCompilation.m_pSources;
+
+	return bCompiled;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+TiXmlDocument* SceneCompiler::_Parse( std::string const& sFileName, sCompilation& rCompilation )
+{
+	_AddSource( sFileName, rCompilation );
+
+	TiXmlDocument* pDocument = new TiXmlDocument( sFileName );
+	if( !pDocument->LoadFile() )
+	{
+		ADD_ERROR_MESSAGE( std::string("Loading : ") << pDocument->ErrorDesc() << std::string(" ") << sFileName );
+		delete pDocument;
+		return NULL;
+	}
+	rCompilation.m_vFiles.push_back( pDocument );
+
+	return pDocument;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneCompiler::_AddSource( std::string const& sFileName, sCompilation& rCompilation )
+{
+	//Recorded even when missing, the scene is then compiled again until the file is there
+	int iTime = 0;
+	_GetTime( sFileName, iTime );
+	TiXmlElement oSource( "source" );
+	oSource.SetAttribute( "file", sFileName.c_str() );
+	oSource.SetAttribute( "time", iTime );
+	rCompilation.m_pSources->InsertEndChild( oSource );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneCompiler::_AddObjects( TiXmlElement const& rElement, sCompilation& rCompilation )
+{
+	for( TiXmlElement const* pChild = rElement.FirstChildElement(); pChild; pChild = pChild->NextSiblingElement() )
+	{
+		TiXmlElement const* pFileXml;
+		if( strcmp( pChild->Value(), "ressourcecomponent" ) != 0 || !( pFileXml = pChild->FirstChildElement( "file" ) ) || !pFileXml->GetText() )
+		{
+			_AddObjects( *pChild, rCompilation );
+			continue;
+		}
+
+		//An object placed many times is stored once
+		std::string sObjectName( pFileXml->GetText() );
+		if( std::find( rCompilation.m_vObjectNames.begin(), rCompilation.m_vObjectNames.end(), sObjectName ) != rCompilation.m_vObjectNames.end() )
+		{
+			continue;
+		}
+		rCompilation.m_vObjectNames.push_back( sObjectName );
+
+		TiXmlDocument* pObject = _Parse( ObjectFactory::GetObjectPath( sObjectName ), rCompilation );
+		TiXmlElement const* pComponentXml = pObject ? pObject->FirstChildElement( "component" ) : NULL;
+		if( pComponentXml )
+		{
+			TiXmlElement* pObjectXml = new TiXmlElement( "object" );
+			pObjectXml->SetAttribute( "file", sObjectName.c_str() );
+			pObjectXml->InsertEndChild( *pComponentXml );
+			rCompilation.m_vObjects.push_back( pObjectXml );
+
+			_AddObjects( *pComponentXml, rCompilation );
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneCompiler::_AddMeshes( TiXmlElement const& rElement, sCompilation& rCompilation )
+{
+	for( TiXmlElement const* pChild = rElement.FirstChildElement(); pChild; pChild = pChild->NextSiblingElement() )
+	{
+		TiXmlElement const* pFileXml;
+		if( strcmp( pChild->Value(), "mesh" ) != 0 || !( pFileXml = pChild->FirstChildElement( "file" ) ) || !pFileXml->GetText() )
+		{
+			_AddMeshes( *pChild, rCompilation );
+			continue;
+		}
+
+		std::string sMeshName( pFileXml->GetText() );
+		if( std::find( rCompilation.m_vMeshNames.begin(), rCompilation.m_vMeshNames.end(), sMeshName ) != rCompilation.m_vMeshNames.end() )
+		{
+			continue;
+		}
+		rCompilation.m_vMeshNames.push_back( sMeshName );
+
+		//The bounds change with the file, a missing file is looked for again on the next load
+		_AddSource( sMeshName, rCompilation );
+		float pBoundingBox[6];
+		if( !StaticMesh::ReadBoundingBox( sMeshName, pBoundingBox ) )
+		{
+			continue;
+		}
+
+		static char const* s_pBoundNames[6] = { "xmin", "xmax", "ymin", "ymax", "zmin", "zmax" };
+		TiXmlElement oMesh( "mesh" );
+		oMesh.SetAttribute( "file", sMeshName.c_str() );
+		for( unsigned int i = 0; i < 6; ++i )
+		{
+			oMesh.SetDoubleAttribute( s_pBoundNames[i], pBoundingBox[i] );
+		}
+		rCompilation.m_pMeshes->InsertEndChild( oMesh );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+std::string SceneCompiler::_GetCompiledName( std::string const& sSceneName )
+{
+	//The separators and the case of the path do not make another file on Windows
+	std::string sPath( sSceneName );
+	for( unsigned int i = 0; i < sPath.size(); ++i )
+	{
+		sPath[i] = sPath[i] == '\\' ? '/' : static_cast< char >( tolower( sPath[i] ) );
+	}
+
+	std::string::size_type iSlash = sSceneName.find_last_of( "/\\" );
+	std::ostringstream oName;
+	oName << s_sCacheDirectory << sSceneName.substr( iSlash == std::string::npos ? 0 : iSlash + 1 )
+		<< '.' << std::hex << std::setw( 8 ) << std::setfill( '0' ) << ObjectFactory::HashID( sPath ) << ".bscn";
+	return oName.str();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool SceneCompiler::_IsUpToDate( SceneDocument const& rDocument, std::string const& sSceneName )
+{
+	SceneNode const* pSources = rDocument.FirstChildElement( "sources" );
+	if( !pSources || !rDocument.FirstChildElement( "scene" ) )
+	{
+		return false;
+	}
+
+	//The scene is the first source, a document of another scene with the same hash is compiled again
+	SceneNode const* pScene = pSources->FirstChildElement( "source" );
+	char const* sSceneFile = pScene ? pScene->Attribute( "file" ) : NULL;
+	if( !sSceneFile || sSceneName != sSceneFile )
+	{
+		return false;
+	}
+
+	//Only the times are checked, the sources are not opened
+	for( SceneNode const* pSource = pSources->FirstChildElement( "source" ); pSource; pSource = pSource->NextSiblingElement( "source" ) )
+	{
+		int iCompiledTime = 0;
+		int iTime = 0;
+		char const* sFileName = pSource->Attribute( "file" );
+		if( !sFileName || !pSource->QueryIntAttribute( "time", &iCompiledTime ) || !_GetTime( sFileName, iTime ) || iTime != iCompiledTime )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool SceneCompiler::_GetTime( std::string const& sFileName, int& iTime )
+{
+	struct stat oStatus;
+	if( stat( sFileName.c_str(), &oStatus ) != 0 )
+	{
+		return false;
+	}
+	iTime = static_cast< int >( oStatus.st_mtime );
+	return true;
+}
@@ -0,0 +1,82 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __SCENECOMPILER_H__
+#define __SCENECOMPILER_H__
+
+#include <string>
+#include <vector>
+
+class SceneDocument;
+class TiXmlElement;
+class TiXmlDocument;
+
+/// \class	SceneCompiler
+/// \brief	Resolves a scene XML and every object file it references, directly or through other objects, in a
+///			single SceneDocument. Its roots are the "scene", an "object" per object file with its "file" name and
+///			its root component, the "meshes" with the bounds of each mesh file the scene uses, then the "sources"
+///			with the modification time of each file read.
+///			The compiled document is saved in the cache directory and read back in one go while none of
+///			the sources changed.
+///			The materials, effects and textures are still read by their managers when the objects are created
+///	\todo	Compile the materials (.bma), effects (.bfx) and textures (.btx) the objects reference
+class SceneCompiler
+{
+public:
+
+	/// \brief Where the compiled scenes are saved, empty to compile the scene on every load
+	static void SetCacheDirectory( std::string const& sDirectory );
+
+	/// \brief Read the compiled scene if it is up to date, compile it otherwise
+	static bool Load( std::string const& sSceneName, SceneDocument& rDocument );
+
+	/// \brief Resolve the scene XML and its objects
+	static bool Compile( std::string const& sSceneName, SceneDocument& rDocument );
+
+private:
+
+	/// What the compilation keeps alive until the document is built
+	struct sCompilation
+	{
+		std::vector< TiXmlDocument* >	m_vFiles;
+		std::vector< TiXmlElement* >	m_vObjects;
+		std::vector< std::string >		m_vObjectNames;
+		std::vector< std::string >		m_vMeshNames;
+		TiXmlElement*					m_pMeshes;
+		TiXmlElement*					m_pSources;
+	};
+
+	/// \brief Parse a source file and record its modification time, NULL if it cannot be read
+	static TiXmlDocument* _Parse( std::string const& sFileName, sCompilation& rCompilation );
+
+	/// \brief Record the modification time of a file the document depends on
+	static void _AddSource( std::string const& sFileName, sCompilation& rCompilation );
+
+	/// \brief Add the objects referenced under an element, and the ones they reference
+	static void _AddObjects( TiXmlElement const& rElement, sCompilation& rCompilation );
+
+	/// \brief Add the bounds of the mesh files referenced under an element
+	static void _AddMeshes( TiXmlElement const& rElement, sCompilation& rCompilation );
+
+	/// \brief Name of the compiled scene in the cache, the file name and a hash of the whole path
+	///			so the scenes of the same name in different directories do not share it
+	static std::string _GetCompiledName( std::string const& sSceneName );
+
+	/// \brief The document was compiled from this scene and none of the sources changed since
+	static bool _IsUpToDate( SceneDocument const& rDocument, std::string const& sSceneName );
+
+	/// \brief Modification time of a file, false if it does not exist
+	static bool _GetTime( std::string const& sFileName, int& iTime );
+
+	static std::string s_sCacheDirectory;
+};
+
+#endif //__SCENECOMPILER_H__
@@ -0,0 +1,401 @@
+#include "BurgerEngine/Core/SceneDocument.h"
+#include "BurgerEngine/Base/CommonBase.h"
+
+#include "BurgerEngine/External/TinyXml/TinyXml.h"
+
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const char s_pDocumentMagic[4] = { 'B', 'S', 'C', 'N' };
+static const unsigned int s_iDocumentVersion = 1;
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static char const* GetString( void const* pRecord, int iOffset )
+{
+	return iOffset != 0 ? static_cast< char const* >( pRecord ) + iOffset : NULL;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+char const* SceneNode::Value() const
+{
+	return GetString( this, m_iName );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+char const* SceneNode::GetText() const
+{
+	return GetString( this, m_iText );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+char const* SceneNode::Attribute( char const* sName ) const
+{
+	if( m_iAttributeCount == 0 )
+	{
+		return NULL;
+	}
+
+	sAttribute const* pAttributes = reinterpret_cast< sAttribute const* >( reinterpret_cast< char const* >( this ) + m_iAttributes );
+	for( unsigned int i = 0; i < m_iAttributeCount; ++i )
+	{
+		if( strcmp( GetString( &pAttributes[i], pAttributes[i].m_iName ), sName ) == 0 )
+		{
+			return GetString( &pAttributes[i], pAttributes[i].m_iValue );
+		}
+	}
+	return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool SceneNode::QueryFloatAttribute( char const* sName, float* pValue ) const
+{
+	char const* sValue = Attribute( sName );
+	if( !sValue )
+	{
+		return false;
+	}
+
+	char* pEnd;
+	double dValue = strtod( sValue, &pEnd );
+	if( pEnd == sValue )
+	{
+		return false;
+	}
+	*pValue = static_cast< float >( dValue );
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool SceneNode::QueryIntAttribute( char const* sName, int* pValue ) const
+{
+	char const* sValue = Attribute( sName );
+	if( !sValue )
+	{
+		return false;
+	}
+
+	char* pEnd;
+	long iValue = strtol( sValue, &pEnd, 10 );
+	if( pEnd == sValue )
+	{
+		return false;
+	}
+	*pValue = static_cast< int >( iValue );
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool SceneNode::QueryValueAttribute( char const* sName, std::string* pValue ) const
+{
+	char const* sValue = Attribute( sName );
+	if( !sValue )
+	{
+		return false;
+	}
+	*pValue = sValue;
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+SceneNode const* SceneNode::FirstChildElement( char const* sName ) const
+{
+	if( m_iFirstChild == 0 )
+	{
+		return NULL;
+	}
+	return reinterpret_cast< SceneNode const* >( reinterpret_cast< char const* >( this ) + m_iFirstChild )->_FindSibling( sName );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+SceneNode const* SceneNode::NextSiblingElement( char const* sName ) const
+{
+	if( m_iNextSibling == 0 )
+	{
+		return NULL;
+	}
+	return reinterpret_cast< SceneNode const* >( reinterpret_cast< char const* >( this ) + m_iNextSibling )->_FindSibling( sName );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+SceneNode const* SceneNode::_FindSibling( char const* sName ) const
+{
+	SceneNode const* pNode = this;
+	for( ;; )
+	{
+		if( !sName || strcmp( pNode->Value(), sName ) == 0 )
+		{
+			return pNode;
+		}
+		if( pNode->m_iNextSibling == 0 )
+		{
+			return NULL;
+		}
+		pNode = reinterpret_cast< SceneNode const* >( reinterpret_cast< char const* >( pNode ) + pNode->m_iNextSibling );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+SceneDocument::SceneDocument()
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool SceneDocument::LoadFile( std::string const& sFileName )
+{
+	m_vBuffer.clear();
+
+	std::ifstream oFile( sFileName.c_str(), std::ios::binary );
+	if( !oFile )
+	{
+		return false;
+	}
+
+	oFile.seekg( 0, std::ios::end );
+	std::streamoff iSize = oFile.tellg();
+	oFile.seekg( 0, std::ios::beg );
+	if( iSize < static_cast< std::streamoff >( sizeof( sHeader ) ) )
+	{
+		return false;
+	}
+
+	//The whole document in one read, the records are used where they land
+	std::vector< char > vBuffer( static_cast< unsigned int >( iSize ) );
+	oFile.read( &vBuffer[0], iSize );
+	if( !oFile )
+	{
+		return false;
+	}
+
+	sHeader const& rHeader = *reinterpret_cast< sHeader const* >( &vBuffer[0] );
+	if( memcmp( rHeader.m_pMagic, s_pDocumentMagic, 4 ) != 0 || rHeader.m_iVersion != s_iDocumentVersion || rHeader.m_iSize != vBuffer.size() )
+	{
+		return false;
+	}
+
+	m_vBuffer.swap( vBuffer );
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool SceneDocument::SaveFile( std::string const& sFileName ) const
+{
+	if( m_vBuffer.empty() )
+	{
+		return false;
+	}
+
+	std::string sTemporaryName = sFileName + ".tmp";
+	{
+		std::ofstream oFile( sTemporaryName.c_str(), std::ios::binary | std::ios::trunc );
+		if( !oFile )
+		{
+			std::cerr << "WARNING : cannot write the compiled scene " << sTemporaryName << std::endl;
+			return false;
+		}
+		oFile.write( &m_vBuffer[0], m_vBuffer.size() );
+		if( !oFile )
+		{
+			return false;
+		}
+	}
+
+	remove( sFileName.c_str() );
+	return rename( sTemporaryName.c_str(), sFileName.c_str() ) == 0;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool SceneDocument::LoadXml( std::string const& sFileName )
+{
+	m_vBuffer.clear();
+
+	TiXmlDocument oDocument( sFileName );
+	if( !oDocument.LoadFile() )
+	{
+		ADD_ERROR_MESSAGE( std::string("Loading : ") << oDocument.ErrorDesc() << std::string(" ") << sFileName );
+		return false;
+	}
+
+	std::vector< TiXmlElement const* > vRoots;
+	if( oDocument.RootElement() )
+	{
+		vRoots.push_back( oDocument.RootElement() );
+	}
+	Build( vRoots );
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneDocument::Build( std::vector< TiXmlElement const* > const& vRoots )
+{
+	//Counted first, the records are written in place and never move
+	unsigned int iNodeCount = 0;
+	unsigned int iAttributeCount = 0;
+	for( unsigned int i = 0; i < vRoots.size(); ++i )
+	{
+		_Count( *vRoots[i], iNodeCount, iAttributeCount );
+	}
+
+	sBuilder oBuilder;
+	oBuilder.m_iNodeCount = 0;
+	oBuilder.m_iAttributeCount = 0;
+	oBuilder.m_iAttributeStart = sizeof( sHeader ) + iNodeCount * sizeof( SceneNode );
+	oBuilder.m_iStringStart = oBuilder.m_iAttributeStart + iAttributeCount * sizeof( SceneNode::sAttribute );
+	m_vBuffer.assign( oBuilder.m_iStringStart, 0 );
+
+	unsigned int iFirstRoot = 0;
+	unsigned int iPrevious = 0;
+	for( unsigned int i = 0; i < vRoots.size(); ++i )
+	{
+		unsigned int iRoot = _Flatten( *vRoots[i], oBuilder );
+		if( iPrevious == 0 )
+		{
+			iFirstRoot = iRoot;
+		}
+		else
+		{
+			_GrabNode( iPrevious ).m_iNextSibling = static_cast< int >( iRoot - iPrevious );
+		}
+		iPrevious = iRoot;
+	}
+
+	m_vBuffer.insert( m_vBuffer.end(), oBuilder.m_vStrings.begin(), oBuilder.m_vStrings.end() );
+
+	sHeader& rHeader = *reinterpret_cast< sHeader* >( &m_vBuffer[0] );
+	memcpy( rHeader.m_pMagic, s_pDocumentMagic, 4 );
+	rHeader.m_iVersion = s_iDocumentVersion;
+	rHeader.m_iSize = m_vBuffer.size();
+	rHeader.m_iFirstRoot = iFirstRoot;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+SceneNode const* SceneDocument::FirstChildElement( char const* sName ) const
+{
+	if( m_vBuffer.empty() )
+	{
+		return NULL;
+	}
+
+	sHeader const& rHeader = *reinterpret_cast< sHeader const* >( &m_vBuffer[0] );
+	if( rHeader.m_iFirstRoot == 0 )
+	{
+		return NULL;
+	}
+	return reinterpret_cast< SceneNode const* >( &m_vBuffer[ rHeader.m_iFirstRoot ] )->_FindSibling( sName );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneDocument::_Count( TiXmlElement const& rElement, unsigned int& iNodeCount, unsigned int& iAttributeCount )
+{
+	++iNodeCount;
+	for( TiXmlAttribute const* pAttribute = rElement.FirstAttribute(); pAttribute; pAttribute = pAttribute->Next() )
+	{
+		++iAttributeCount;
+	}
+	for( TiXmlElement const* pChild = rElement.FirstChildElement(); pChild; pChild = pChild->NextSiblingElement() )
+	{
+		_Count( *pChild, iNodeCount, iAttributeCount );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+unsigned int SceneDocument::_Flatten( TiXmlElement const& rElement, sBuilder& rBuilder )
+{
+	unsigned int iRecord = sizeof( sHeader ) + rBuilder.m_iNodeCount++ * sizeof( SceneNode );
+
+	SceneNode& rNode = _GrabNode( iRecord );
+	rNode.m_iName = _AddString( rElement.Value(), iRecord, rBuilder );
+	rNode.m_iText = rElement.GetText() ? _AddString( rElement.GetText(), iRecord, rBuilder ) : 0;
+	rNode.m_iAttributes = 0;
+	rNode.m_iAttributeCount = 0;
+	rNode.m_iFirstChild = 0;
+	rNode.m_iNextSibling = 0;
+
+	//The attributes of a node follow each other
+	for( TiXmlAttribute const* pAttribute = rElement.FirstAttribute(); pAttribute; pAttribute = pAttribute->Next() )
+	{
+		unsigned int iAttribute = rBuilder.m_iAttributeStart + rBuilder.m_iAttributeCount++ * sizeof( SceneNode::sAttribute );
+		if( rNode.m_iAttributeCount++ == 0 )
+		{
+			rNode.m_iAttributes = static_cast< int >( iAttribute - iRecord );
+		}
+
+		SceneNode::sAttribute& rAttribute = *reinterpret_cast< SceneNode::sAttribute* >( &m_vBuffer[ iAttribute ] );
+		rAttribute.m_iName = _AddString( pAttribute->Name(), iAttribute, rBuilder );
+		rAttribute.m_iValue = _AddString( pAttribute->Value(), iAttribute, rBuilder );
+	}
+
+	unsigned int iPrevious = 0;
+	for( TiXmlElement const* pChild = rElement.FirstChildElement(); pChild; pChild = pChild->NextSiblingElement() )
+	{
+		unsigned int iChild = _Flatten( *pChild, rBuilder );
+		if( iPrevious == 0 )
+		{
+			rNode.m_iFirstChild = static_cast< int >( iChild - iRecord );
+		}
+		else
+		{
+			_GrabNode( iPrevious ).m_iNextSibling = static_cast< int >( iChild - iPrevious );
+		}
+		iPrevious = iChild;
+	}
+
+	return iRecord;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+int SceneDocument::_AddString( char const* sString, unsigned int iRecord, sBuilder& rBuilder )
+{
+	unsigned int iString;
+	std::map< std::string, unsigned int >::iterator itString = rBuilder.m_mStrings.find( sString );
+	if( itString != rBuilder.m_mStrings.end() )
+	{
+		iString = itString->second;
+	}
+	else
+	{
+		iString = rBuilder.m_vStrings.size();
+		rBuilder.m_vStrings.insert( rBuilder.m_vStrings.end(), sString, sString + strlen( sString ) + 1 );
+		rBuilder.m_mStrings[ sString ] = iString;
+	}
+	return static_cast< int >( rBuilder.m_iStringStart + iString - iRecord );
+}
@@ -0,0 +1,137 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __SCENEDOCUMENT_H__
+#define __SCENEDOCUMENT_H__
+
+#include <string>
+#include <vector>
+#include <map>
+
+class TiXmlElement;
+
+/// \class	SceneNode
+/// \brief	Element of a SceneDocument, read only, with the part of the TinyXml element interface the loaders use.
+///			A node is a record of the document buffer, its name, text, attributes, first child and next sibling
+///			are found at offsets from the record itself, so a buffer read from a file is used as is
+class SceneNode
+{
+public:
+
+	/// \brief Name of the node
+	char const* Value() const;
+
+	/// \brief Text of the node, NULL if it has none
+	char const* GetText() const;
+
+	/// \brief Value of an attribute, NULL if the node does not have it
+	char const* Attribute( char const* sName ) const;
+
+	/// \brief Convert an attribute, the value is left untouched if the attribute is missing or malformed
+	/// \return false in that case
+	bool QueryFloatAttribute( char const* sName, float* pValue ) const;
+	bool QueryIntAttribute( char const* sName, int* pValue ) const;
+	bool QueryValueAttribute( char const* sName, std::string* pValue ) const;
+
+	/// \brief First child with that name, the first one of any name if NULL
+	SceneNode const* FirstChildElement( char const* sName = NULL ) const;
+
+	/// \brief Next sibling with that name, the next one of any name if NULL
+	SceneNode const* NextSiblingElement( char const* sName = NULL ) const;
+
+private:
+
+	friend class SceneDocument;
+
+	struct sAttribute
+	{
+		int	m_iName;
+		int	m_iValue;
+	};
+
+	/// \brief First of the node and its next siblings with that name
+	SceneNode const* _FindSibling( char const* sName ) const;
+
+	/// Offsets in bytes from the record, 0 when there is none
+	int				m_iName;
+	int				m_iText;
+	int				m_iAttributes;
+	unsigned int	m_iAttributeCount;
+	int				m_iFirstChild;
+	int				m_iNextSibling;
+};
+
+/// \class	SceneDocument
+/// \brief	Tree of SceneNode in a single buffer: a header, the node records, the attributes, then the strings.
+///			Either read from a compiled file in one go, or built from XML elements, the nodes are never
+///			allocated one by one. The roots are the top level nodes, siblings of each other
+class SceneDocument
+{
+public:
+
+	SceneDocument();
+
+	/// \brief Read a compiled document, false if the file is missing or was written by another version
+	bool LoadFile( std::string const& sFileName );
+
+	/// \brief Write the document, aside then renamed so a crash never leaves a truncated file behind
+	bool SaveFile( std::string const& sFileName ) const;
+
+	/// \brief Parse an XML file, its root element becomes the root of the document
+	bool LoadXml( std::string const& sFileName );
+
+	/// \brief Flatten XML elements and their children, each element becomes a root of the document
+	void Build( std::vector< TiXmlElement const* > const& vRoots );
+
+	/// \brief First root with that name, the first one of any name if NULL
+	SceneNode const* FirstChildElement( char const* sName = NULL ) const;
+
+	/// \brief Bytes taken by the document
+	unsigned int GetSize() const { return m_vBuffer.size(); }
+
+private:
+
+	struct sHeader
+	{
+		char			m_pMagic[4];
+		unsigned int	m_iVersion;
+		unsigned int	m_iSize;
+		/// Offset of the first root, 0 if the document is empty
+		unsigned int	m_iFirstRoot;
+	};
+
+	/// What the flattening needs to know while walking the elements
+	struct sBuilder
+	{
+		unsigned int		m_iNodeCount;
+		unsigned int		m_iAttributeCount;
+		unsigned int		m_iAttributeStart;
+		unsigned int		m_iStringStart;
+		std::vector< char >	m_vStrings;
+		/// Offset of each string in the table, the names come back on every node
+		std::map< std::string, unsigned int >	m_mStrings;
+	};
+
+	/// \brief Count the nodes and attributes under an element, itself included
+	static void _Count( TiXmlElement const& rElement, unsigned int& iNodeCount, unsigned int& iAttributeCount );
+
+	/// \brief Write the record of an element and its children, returns its offset
+	unsigned int _Flatten( TiXmlElement const& rElement, sBuilder& rBuilder );
+
+	/// \brief Offset from a record to a string, added to the string table
+	static int _AddString( char const* sString, unsigned int iRecord, sBuilder& rBuilder );
+
+	SceneNode& _GrabNode( unsigned int iRecord ) { return *reinterpret_cast< SceneNode* >( &m_vBuffer[ iRecord ] ); }
+
+	std::vector< char >	m_vBuffer;
+};
+
+#endif //__SCENEDOCUMENT_H__
@@ -6,10 +6,14 @@
 #include "BurgerEngine/Core/MovementHackerComponent.h"
 #include "BurgerEngine/Core/RenderComponent.h"
 #include "BurgerEngine/Core/ObjectFactory.h"
+#include "BurgerEngine/Core/TransformStore.h"
+#include "BurgerEngine/Core/ComponentScheduler.h"
+#include "BurgerEngine/Core/SceneStreamer.h"
 
 #include "BurgerEngine/Input/EventManager.h"
 
 #include "BurgerEngine/Graphics/SceneMesh.h"
+#include "BurgerEngine/Graphics/BoundingBoxBatch.h"
 #include "BurgerEngine/Graphics/SkyBox.h"
 
 #include "BurgerEngine/Graphics/DirectionalLight.h"
@@ -22,7 +26,8 @@
 #include "BurgerEngine/Graphics/RenderingContext.h"
 #include "BurgerEngine/Graphics/DeferredRenderer.h"
 
-#include "BurgerEngine/External/TinyXml/TinyXml.h"
+#include "BurgerEngine/Core/SceneDocument.h"
+#include "BurgerEngine/Core/SceneCompiler.h"
 
 #include "BurgerEngine/Base/CommonBase.h"
 
@@ -30,8 +35,22 @@
 //
 //--------------------------------------------------------------------------------------------------------------------
 SceneGraph::SceneGraph( const char * pSceneName )
+	: m_pStreamer( NULL )
+	, m_pBoundingBoxBatch( new BoundingBoxBatch() )
+	, m_pScheduler( new ComponentScheduler() )
+	, m_pDocument( NULL )
 {
-	LoadSceneXML( pSceneName );
+	LoadScene( pSceneName );
+
+	FOR_EACH_IT(ComponentCollection, m_vComponentCollection, oComponentIt)
+	{
+		(*oComponentIt)->RegisterUpdate( *m_pScheduler );
+	}
+
+	//The frames drawn before the first step use the placement of the scene, not identity matrices
+	TransformStore& rTransformStore = Engine::GrabInstance().GrabTransformStore();
+	rTransformStore.Update();
+	rTransformStore.Interpolate( 1.0f );
 }
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -40,12 +59,27 @@ SceneGraph::SceneGraph( const char * pSceneName )
 SceneGraph::~SceneGraph()
 {
 	Clear();
+	delete m_pBoundingBoxBatch;
+	m_pBoundingBoxBatch = NULL;
+	delete m_pScheduler;
+	m_pScheduler = NULL;
+
+	//The components and the streamer are gone, nothing points in the document anymore
+	if( m_pDocument )
+	{
+		Engine::GrabInstance().GetObjectFactory().RemovePrototypes( m_pDocument );
+		m_pDocument = NULL;
+	}
 }
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
 void SceneGraph::Clear()
 {
+	delete m_pStreamer;
+	m_pStreamer = NULL;
+
+	m_pScheduler->Clear();
 	FOR_EACH_IT(ComponentCollection, m_vComponentCollection, oComponentIt)
 	{
 		delete (*oComponentIt);
@@ -59,27 +93,85 @@ void SceneGraph::Clear()
 //--------------------------------------------------------------------------------------------------------------------
 void SceneGraph::Update( float fFrameTime, float fElapsedTime )
 {
+	TransformStore& rTransformStore = Engine::GrabInstance().GrabTransformStore();
+	rTransformStore.BeginStep();
+
+	if( m_pStreamer )
+	{
+		m_pStreamer->Update( Engine::GrabInstance().GetCurrentCamera().GetPos() );
+	}
+
+	m_pScheduler->Update( E_UPDATE_PRE_PHYSICS, fFrameTime, fElapsedTime );
+	m_pScheduler->Update( E_UPDATE_GAMEPLAY, fFrameTime, fElapsedTime );
+	m_pScheduler->Update( E_UPDATE_ANIMATION, fFrameTime, fElapsedTime );
+	MovementHackerComponent::UpdateBatch( fFrameTime, fElapsedTime );
+
+	//One pass over the transforms moved by the updates
+	rTransformStore.Update();
+
+	m_pScheduler->Update( E_UPDATE_POST_TRANSFORM, fFrameTime, fElapsedTime );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneGraph::UpdateRender( float fAlpha, float fFrameTime, float fElapsedTime )
+{
+	Engine::GrabInstance().GrabTransformStore().Interpolate( fAlpha );
+
+	//The renderers pick up the new render values and the boxes of the moved meshes are computed together
+	m_pBoundingBoxBatch->Clear();
 	FOR_EACH_IT(ComponentCollection, m_vComponentCollection, oComponentIt)
 	{
-		//Should check if need to be updated??? (think about render and phys)
-		(*oComponentIt)->Update( fFrameTime, fElapsedTime );
+		(*oComponentIt)->UpdateTransform( *m_pBoundingBoxBatch );
+	}
+	if( m_pStreamer )
+	{
+		m_pStreamer->UpdateTransform( *m_pBoundingBoxBatch );
 	}
+	m_pBoundingBoxBatch->Compute();
+
+	m_pScheduler->Update( E_UPDATE_RENDER_SYNC, fFrameTime, fElapsedTime );
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void SceneGraph::LoadSceneXML( const char * sName )
+void SceneGraph::LoadScene( const char * sName )
 {
-	TiXmlDocument * pDocument = new TiXmlDocument( sName );
+	//The scene and its objects, read in one go once compiled
+	SceneDocument * pDocument = new SceneDocument();
+	if( !SceneCompiler::Load( sName, *pDocument ) )
+	{
+		ADD_ERROR_MESSAGE(" Loading scene : " << sName);
+		delete pDocument;
+		return;
+	}
 
-	if(!pDocument->LoadFile())
+	//The objects placed by the scene are instanced from their node in the document, the factory keeps it
+	//until the graph is deleted
+	Engine::GrabInstance().GetObjectFactory().AddPrototypes( pDocument );
+	m_pDocument = pDocument;
+
+	//The meshes have their bounds before they are loaded, for the culling and the streaming of their objects
+	SceneNode const* pMeshes = pDocument->FirstChildElement( "meshes" );
+	for( SceneNode const* pMesh = pMeshes ? pMeshes->FirstChildElement( "mesh" ) : NULL; pMesh; pMesh = pMesh->NextSiblingElement( "mesh" ) )
 	{
-  		ADD_ERROR_MESSAGE(" Loading : " << pDocument->ErrorDesc());
+		static char const* s_pBoundNames[6] = { "xmin", "xmax", "ymin", "ymax", "zmin", "zmax" };
+		float pBoundingBox[6];
+		bool bValid = pMesh->Attribute( "file" ) != NULL;
+		for( unsigned int i = 0; i < 6 && bValid; ++i )
+		{
+			bValid = pMesh->QueryFloatAttribute( s_pBoundNames[i], &pBoundingBox[i] );
+		}
+		if( bValid )
+		{
+			MeshManager::GrabInstance().setPrecomputedBoundingBox( pMesh->Attribute( "file" ), pBoundingBox );
+		}
 	}
 
 	//Get the scene
-	TiXmlElement * pRoot = pDocument->FirstChildElement( "scene" );
+	SceneNode const* pRoot = pDocument->FirstChildElement( "scene" );
 
 	if( pRoot )
 	{
@@ -92,17 +184,17 @@ void SceneGraph::LoadSceneXML( const char * sName )
 		float fToneMappingKey = 0.5f, fGlowMultiplier = 1.0f, fBrightPassThreshold = 1.0f, fBrightPassOffset= 10.0f, fAdaptationBaseTime = 0.9f;
 		const char * pColorLUT = NULL;
 
-		TiXmlElement * pXmlObject = pRoot->FirstChildElement( "settings" );
+		SceneNode const* pXmlObject = pRoot->FirstChildElement( "settings" );
 
 		if( pXmlObject )
 		{
-			TiXmlElement * pCamera = pXmlObject->FirstChildElement( "camera" );
+			SceneNode const* pCamera = pXmlObject->FirstChildElement( "camera" );
 			if( pCamera )
 			{
 				std::string sType = pCamera->Attribute("type");
 
 				float x = 0.0f, y = 0.0f, z = 0.0f, rX = 0.0f, rY = 0.0f;
-				TiXmlElement * pPosition = pCamera->FirstChildElement( "position" );
+				SceneNode const* pPosition = pCamera->FirstChildElement( "position" );
 				if( pPosition )
 				{			
 					pPosition->QueryFloatAttribute("x",&x);
@@ -113,14 +205,14 @@ void SceneGraph::LoadSceneXML( const char * sName )
 					pPosition->QueryFloatAttribute("rY",&rY);
 				}
 
-				TiXmlElement * pSpeed = pCamera->FirstChildElement( "speed" );
+				SceneNode const* pSpeed = pCamera->FirstChildElement( "speed" );
 				if( pSpeed )
 				{			
 					pSpeed->QueryFloatAttribute("position",&fPositionSpeed);
 					pSpeed->QueryFloatAttribute("rotation",&fRotationSpeed);
 				}
 				
-				TiXmlElement * pParameters = pCamera->FirstChildElement( "parameters" );
+				SceneNode const* pParameters = pCamera->FirstChildElement( "parameters" );
 				if( pParameters )
 				{			
 					pParameters->QueryFloatAttribute("fov",&fFOV);
@@ -152,10 +244,10 @@ void SceneGraph::LoadSceneXML( const char * sName )
 				Engine::GrabInstance().SetCurrentCamera( new FirstPersonCamera( fFOV, vec3(0.0f,0.0f,0.0f), vec2(0.0f,0.0f), vec4( fDofNearBlur, fDofFocalPlane, fDofFarBlur, fDofMaxFarBlur), vec2( fPositionSpeed, fRotationSpeed ) ) );
 			}
 			
-			TiXmlElement * pPostProcess = pXmlObject->FirstChildElement( "postprocess" );
+			SceneNode const* pPostProcess = pXmlObject->FirstChildElement( "postprocess" );
 			if( pPostProcess )
 			{
-				TiXmlElement * pParameters = pPostProcess->FirstChildElement( "parameters" );
+				SceneNode const* pParameters = pPostProcess->FirstChildElement( "parameters" );
 				if( pParameters )
 				{			
 					pParameters->QueryFloatAttribute("toneMappingKey",&fToneMappingKey);
@@ -177,46 +269,36 @@ void SceneGraph::LoadSceneXML( const char * sName )
 			pColorLUT = "../Data/Textures/xml/neutral_lut.btx.xml";
 		}
 		Engine::GrabInstance().GrabRenderContext().GrabRenderer().SetPostProcessParameters( fToneMappingKey, fGlowMultiplier, fBrightPassThreshold, fBrightPassOffset, fAdaptationBaseTime, pColorLUT );
+
+		//With streaming settings, the objects are only created once the camera comes near their cell
+		SceneNode const* pStreaming = pXmlObject ? pXmlObject->FirstChildElement( "streaming" ) : NULL;
+		if( pStreaming )
+		{
+			m_pStreamer = new SceneStreamer( *pStreaming, *this, *m_pScheduler );
+		}
+
 		///------------------
 		/// We start to load our object as component
 		///------------------
 		pXmlObject = pRoot->FirstChildElement( "sceneobject" );
+
+		//The shaders of every material are compiled together, once all the objects are read
+		MaterialManager::GrabInstance().BeginBatch();
 		
 		while ( pXmlObject )
-		{			
-			float x, y, z, rX, rY, rZ, scale;
-			x = y = z= rX = rY = rZ = 0.0f;
-			scale = 1.0f;
-			//gets position & rotation
-			pXmlObject->QueryFloatAttribute("x",&x);
-			pXmlObject->QueryFloatAttribute("y",&y);
-			pXmlObject->QueryFloatAttribute("z",&z);
-
-			pXmlObject->QueryFloatAttribute("rX",&rX);
-			pXmlObject->QueryFloatAttribute("rY",&rY);
-			pXmlObject->QueryFloatAttribute("rZ",&rZ);
-
-			pXmlObject->QueryFloatAttribute("scale",&scale);
-
-			CompositeComponent* pComponent = NULL;
-			
-			//Check for the current object
-			TiXmlElement * pCurrentXmlObject;
-			if( pCurrentXmlObject = pXmlObject->FirstChildElement( "ressourcecomponent" ) )
-			{
-				// Load a component from a xml file
-				pComponent = static_cast< CompositeComponent* >( Engine::GrabInstance().GetObjectFactory().LoadObject( pCurrentXmlObject ) );
-			}
-			else if( pCurrentXmlObject = pXmlObject->FirstChildElement( "component" ) )
+		{
+			SceneNode const* pXmlSkyBox;
+			if( m_pStreamer && m_pStreamer->AddObject( *pXmlObject ) )
 			{
-				// Load a component written in the scene xml
-				pComponent = static_cast< CompositeComponent* >( Engine::GrabInstance().GetObjectFactory().CreateAndInitComponent( *pCurrentXmlObject, NULL ) );
+				//Left to its cell
 			}
-			else if( pCurrentXmlObject = pXmlObject->FirstChildElement( "skybox" ) )
+			else if( pXmlSkyBox = pXmlObject->FirstChildElement( "skybox" ) )
 			{
+				float scale = 1.0f;
+				pXmlObject->QueryFloatAttribute("scale",&scale);
 				SkyBox * pSkyBox = new SkyBox( scale );
 
-				TiXmlElement * pXmlMaterial = pCurrentXmlObject->FirstChildElement( "material" );
+				SceneNode const* pXmlMaterial = pXmlSkyBox->FirstChildElement( "material" );
 				if( pXmlMaterial )
 				{
 					Material * pMaterial = MaterialManager::GrabInstance().addMaterial( pXmlMaterial->GetText() );
@@ -225,39 +307,76 @@ void SceneGraph::LoadSceneXML( const char * sName )
 				}
 				Engine::GrabInstance().GrabRenderContext().SetSkyBox( pSkyBox );
 			}
-
-			if ( pComponent )
+			else
 			{
-				pComponent->SetScale(scale);
-				pComponent->SetRotation(vec3(rX,rY,rZ));
-				pComponent->SetPos(vec3(x,y,z));
-
-				//Now every load create an instance
-				m_vComponentCollection.push_back(pComponent);
+				_LoadSceneObject( *pXmlObject, m_vComponentCollection );
 			}
 
-			if(pCurrentXmlObject = pXmlObject->FirstChildElement( "movementhackercomponent" ) )
-			{
-				TiXmlElement * pParameters;
-				if(pParameters = pCurrentXmlObject->FirstChildElement( "parameters" ) )
-				{
-					MovementHackerComponent* pMovementHackerComponent = new MovementHackerComponent();
-					pMovementHackerComponent->Initialize( *pParameters );
-
-					//this is a little bit to "hacky", we assume that the target of the movement hacker is the last created component
-					//we might use some kind of ID the identify the component
-					pMovementHackerComponent->SetComponent( m_vComponentCollection.back() );
-					
-					m_vComponentCollection.push_back(pMovementHackerComponent);
-				}
-			}
+			//moves on to the next object
+			pXmlObject = pXmlObject->NextSiblingElement( "sceneobject" );
+		}
 
+		MaterialManager::GrabInstance().EndBatch();
+	}
+}
 
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneGraph::_LoadSceneObject( SceneNode const& rObject, ComponentCollection& rComponents )
+{
+	float x, y, z, rX, rY, rZ, scale;
+	x = y = z= rX = rY = rZ = 0.0f;
+	scale = 1.0f;
+	//gets position & rotation
+	rObject.QueryFloatAttribute("x",&x);
+	rObject.QueryFloatAttribute("y",&y);
+	rObject.QueryFloatAttribute("z",&z);
 
-			//moves on to the next object
-			pXmlObject = pXmlObject->NextSiblingElement( "sceneobject" );
+	rObject.QueryFloatAttribute("rX",&rX);
+	rObject.QueryFloatAttribute("rY",&rY);
+	rObject.QueryFloatAttribute("rZ",&rZ);
+
+	rObject.QueryFloatAttribute("scale",&scale);
+
+	CompositeComponent* pComponent = NULL;
+
+	//Check for the current object
+	SceneNode const* pCurrentXmlObject;
+	if( pCurrentXmlObject = rObject.FirstChildElement( "ressourcecomponent" ) )
+	{
+		// Load a component from a xml file
+		pComponent = static_cast< CompositeComponent* >( Engine::GrabInstance().GetObjectFactory().LoadObject( pCurrentXmlObject ) );
+	}
+	else if( pCurrentXmlObject = rObject.FirstChildElement( "component" ) )
+	{
+		// Load a component written in the scene xml
+		pComponent = static_cast< CompositeComponent* >( Engine::GrabInstance().GetObjectFactory().CreateAndInitComponent( *pCurrentXmlObject, NULL ) );
+	}
 
+	if ( pComponent )
+	{
+		pComponent->SetScale(scale);
+		pComponent->SetRotation(vec3(rX,rY,rZ));
+		pComponent->SetPos(vec3(x,y,z));
+
+		//Now every load create an instance
+		rComponents.push_back(pComponent);
+	}
+
+	if(pCurrentXmlObject = rObject.FirstChildElement( "movementhackercomponent" ) )
+	{
+		SceneNode const* pParameters;
+		if( ( pParameters = pCurrentXmlObject->FirstChildElement( "parameters" ) ) && !rComponents.empty() )
+		{
+			MovementHackerComponent* pMovementHackerComponent = new MovementHackerComponent();
+			pMovementHackerComponent->Initialize( *pParameters );
+
+			//this is a little bit to "hacky", we assume that the target of the movement hacker is the last created component
+			//we might use some kind of ID the identify the component
+			pMovementHackerComponent->SetComponent( rComponents.back() );
+			
+			rComponents.push_back(pMovementHackerComponent);
 		}
 	}
 }
-
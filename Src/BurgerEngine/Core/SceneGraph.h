@@ -23,6 +23,11 @@
 
 /// forward declaration
 class AbstractComponent;
+class BoundingBoxBatch;
+class ComponentScheduler;
+class SceneNode;
+class SceneDocument;
+class SceneStreamer;
 
 /// Typedef
 typedef std::vector< AbstractComponent* > ComponentCollection;
@@ -39,20 +44,43 @@ public:
 
 	bool Initialize();
 
-	/// \brief Update all the components object in the graph
+	/// \brief Simulation step: update all the components object in the graph, phase after phase, then their transforms
 	void Update( float fFrameTime, float fElapsedTime );
 
+	/// \brief Once per rendered frame: give the renderers the transforms interpolated between the last two steps,
+	///			then run the render sync phase
+	/// \param fAlpha Part of the step elapsed since the last one, see TransformStore::Interpolate
+	void UpdateRender( float fAlpha, float fFrameTime, float fElapsedTime );
+
 private:
 /// \brief Clears object and light lists
 	void Clear();
 
-/// \brief Loads objects, light etc. from a XML file
-	void LoadSceneXML( const char * sName );
+/// \brief Loads objects, light etc. from a XML file, through its compiled version when up to date
+	void LoadScene( const char * sName );
+
+/// \brief Create the components of a scene object, the skybox is left to LoadScene
+	void _LoadSceneObject( SceneNode const& rObject, ComponentCollection& rComponents );
+
+	/// The streamer loads the objects of its cells the same way
+	friend class SceneStreamer;
 	
 private:
 
-	///List of all the components object
+	///List of all the components object, the resident ones when the scene is streamed
 	ComponentCollection m_vComponentCollection;
+
+	///Loads the cells near the camera, NULL when the scene has no streaming settings
+	SceneStreamer* m_pStreamer;
+
+	///World boxes of the meshes moved during the frame
+	BoundingBoxBatch* m_pBoundingBoxBatch;
+
+	///The components of the graph sorted by update phase
+	ComponentScheduler* m_pScheduler;
+
+	///The compiled scene, its objects are the prototypes of the factory while the graph lives
+	SceneDocument* m_pDocument;
 };
 
 
@@ -0,0 +1,213 @@
+#include "BurgerEngine/Core/SceneStreamer.h"
+#include "BurgerEngine/Core/SceneGraph.h"
+#include "BurgerEngine/Core/SceneDocument.h"
+#include "BurgerEngine/Core/AbstractComponent.h"
+#include "BurgerEngine/Core/ComponentScheduler.h"
+
+#include "BurgerEngine/Graphics/MaterialManager.h"
+
+#include "BurgerEngine/Base/CommonBase.h"
+
+#include <cmath>
+
+/// A cell is unloaded a bit further than it is loaded, so the camera on a border does not reload it every frame
+static const float s_fUnloadMargin = 1.2f;
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+SceneStreamer::SceneStreamer( SceneNode const& rSettings, SceneGraph& rSceneGraph, ComponentScheduler& rScheduler )
+	: m_rSceneGraph( rSceneGraph )
+	, m_rScheduler( rScheduler )
+	, m_fCellSize( 64.0f )
+	, m_fRadius( 150.0f )
+	, m_iBudget( 8 )
+{
+	int iBudget = m_iBudget;
+	rSettings.QueryFloatAttribute( "cellsize", &m_fCellSize );
+	rSettings.QueryFloatAttribute( "radius", &m_fRadius );
+	rSettings.QueryIntAttribute( "budget", &iBudget );
+
+	m_fCellSize = max( m_fCellSize, 1.0f );
+	m_iBudget = max( iBudget, 1 );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+SceneStreamer::~SceneStreamer()
+{
+	Clear();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool SceneStreamer::AddObject( SceneNode const& rObject )
+{
+	//The skybox and the objects asked to stay are loaded with the scene
+	int iResident = 0;
+	rObject.QueryIntAttribute( "resident", &iResident );
+	if( iResident != 0 || rObject.FirstChildElement( "skybox" ) )
+	{
+		return false;
+	}
+
+	float x = 0.0f, z = 0.0f;
+	rObject.QueryFloatAttribute( "x", &x );
+	rObject.QueryFloatAttribute( "z", &z );
+
+	unsigned int iCell;
+	char const* sCellName = rObject.Attribute( "cell" );
+	if( sCellName )
+	{
+		std::map< std::string, unsigned int >::iterator itCell = m_mNamedCells.find( sCellName );
+		if( itCell == m_mNamedCells.end() )
+		{
+			iCell = m_vCells.size();
+			m_vCells.push_back( sCell() );
+			m_vCells.back().m_f2Min = m_vCells.back().m_f2Max = vec2( x, z );
+			m_mNamedCells[ sCellName ] = iCell;
+		}
+		else
+		{
+			//An authored cell covers the positions of its objects
+			iCell = itCell->second;
+			sCell& rCell = m_vCells[ iCell ];
+			rCell.m_f2Min = vec2( min( rCell.m_f2Min.x, x ), min( rCell.m_f2Min.y, z ) );
+			rCell.m_f2Max = vec2( max( rCell.m_f2Max.x, x ), max( rCell.m_f2Max.y, z ) );
+		}
+	}
+	else
+	{
+		std::pair< int, int > oSquare( static_cast< int >( floorf( x / m_fCellSize ) ), static_cast< int >( floorf( z / m_fCellSize ) ) );
+		std::map< std::pair< int, int >, unsigned int >::iterator itCell = m_mGridCells.find( oSquare );
+		if( itCell == m_mGridCells.end() )
+		{
+			iCell = m_vCells.size();
+			m_vCells.push_back( sCell() );
+			m_vCells.back().m_f2Min = vec2( oSquare.first * m_fCellSize, oSquare.second * m_fCellSize );
+			m_vCells.back().m_f2Max = m_vCells.back().m_f2Min + vec2( m_fCellSize, m_fCellSize );
+			m_mGridCells[ oSquare ] = iCell;
+		}
+		else
+		{
+			iCell = itCell->second;
+		}
+	}
+
+	m_vCells[ iCell ].m_vObjects.push_back( &rObject );
+	m_vCells[ iCell ].m_iLoadedCount = 0;
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneStreamer::Update( vec3 const& f3CameraPos )
+{
+	//Out of the radius, the cells go right away, it only frees memory
+	unsigned int iNearest = m_vCells.size();
+	float fNearestDistance = 0.0f;
+	bool bNearestStarted = false;
+	for( unsigned int i = 0; i < m_vCells.size(); ++i )
+	{
+		sCell& rCell = m_vCells[i];
+		float fDistance = _GetDistance( rCell, f3CameraPos );
+		if( fDistance > m_fRadius * s_fUnloadMargin )
+		{
+			_Unload( rCell );
+			continue;
+		}
+		if( rCell.m_iLoadedCount == rCell.m_vObjects.size() )
+		{
+			continue;
+		}
+
+		//A started cell is completed before any other and as long as it is within the margin,
+		//a new cell is only started within the radius
+		bool bStarted = rCell.m_iLoadedCount > 0;
+		if( !bStarted && fDistance > m_fRadius )
+		{
+			continue;
+		}
+		if( iNearest == m_vCells.size() || ( bStarted && !bNearestStarted )
+			|| ( bStarted == bNearestStarted && fDistance < fNearestDistance ) )
+		{
+			iNearest = i;
+			fNearestDistance = fDistance;
+			bNearestStarted = bStarted;
+		}
+	}
+
+	//Only one cell is loaded at a time, a few objects per frame so the frame time stays even
+	if( iNearest == m_vCells.size() )
+	{
+		return;
+	}
+
+	sCell& rCell = m_vCells[ iNearest ];
+	unsigned int iFirstComponent = rCell.m_vComponents.size();
+	unsigned int iEnd = min( rCell.m_iLoadedCount + m_iBudget, rCell.m_vObjects.size() );
+
+	MaterialManager::GrabInstance().BeginBatch();
+	for( ; rCell.m_iLoadedCount < iEnd; ++rCell.m_iLoadedCount )
+	{
+		m_rSceneGraph._LoadSceneObject( *rCell.m_vObjects[ rCell.m_iLoadedCount ], rCell.m_vComponents );
+	}
+	MaterialManager::GrabInstance().EndBatch();
+
+	for( unsigned int i = iFirstComponent; i < rCell.m_vComponents.size(); ++i )
+	{
+		rCell.m_vComponents[i]->RegisterUpdate( m_rScheduler );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneStreamer::UpdateTransform( BoundingBoxBatch& rBoundingBoxBatch )
+{
+	FOR_EACH_IT( std::vector< sCell >, m_vCells, itCell )
+	{
+		FOR_EACH_IT( ComponentCollection, itCell->m_vComponents, itComponent )
+		{
+			(*itComponent)->UpdateTransform( rBoundingBoxBatch );
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneStreamer::Clear()
+{
+	FOR_EACH_IT( std::vector< sCell >, m_vCells, itCell )
+	{
+		_Unload( *itCell );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+float SceneStreamer::_GetDistance( sCell const& rCell, vec3 const& f3Pos )
+{
+	float fX = max( max( rCell.m_f2Min.x - f3Pos.x, f3Pos.x - rCell.m_f2Max.x ), 0.0f );
+	float fZ = max( max( rCell.m_f2Min.y - f3Pos.z, f3Pos.z - rCell.m_f2Max.y ), 0.0f );
+	return sqrtf( fX * fX + fZ * fZ );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneStreamer::_Unload( sCell& rCell )
+{
+	FOR_EACH_IT( ComponentCollection, rCell.m_vComponents, itComponent )
+	{
+		(*itComponent)->UnregisterUpdate( m_rScheduler );
+		delete (*itComponent);
+	}
+	rCell.m_vComponents.clear();
+	rCell.m_iLoadedCount = 0;
+}
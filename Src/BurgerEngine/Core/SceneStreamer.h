@@ -0,0 +1,96 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __SCENESTREAMER_H__
+#define __SCENESTREAMER_H__
+
+#include "BurgerEngine/External/Math/Vector.h"
+
+#include <vector>
+#include <map>
+#include <string>
+
+class SceneGraph;
+class SceneNode;
+class AbstractComponent;
+class BoundingBoxBatch;
+class ComponentScheduler;
+
+/// \class	SceneStreamer
+/// \brief	Splits the scene objects in cells and only keeps the ones near the camera instanced.
+///			A scene object goes in the cell named by its "cell" attribute, or in the square of the grid under
+///			its position, unless it is marked "resident". The cells within the radius are loaded a few objects
+///			per frame, the nearest first, and the ones out of the radius, with a margin, are deleted: their
+///			components leave the scheduler and the rendering and particle contexts with them.
+///			A cell started is completed while it is within the margin, so no cell is left half loaded.
+///			The meshes, materials and textures are shared by reference count in their managers, they are
+///			freed with the last instance of a cell that uses them.
+///			The objects are parsed and created on the main thread, within the per-frame budget: only the files
+///			of the meshes and textures are loaded in the background by the ResourceLoader
+class SceneStreamer
+{
+public:
+
+	/// \brief Read the <streaming> settings of the scene
+	SceneStreamer( SceneNode const& rSettings, SceneGraph& rSceneGraph, ComponentScheduler& rScheduler );
+	~SceneStreamer();
+
+	/// \brief Put a scene object in its cell, false if it has to be loaded with the scene
+	bool AddObject( SceneNode const& rObject );
+
+	/// \brief Load the cells that came in the radius and unload the ones that went out
+	void Update( vec3 const& f3CameraPos );
+
+	/// \brief Forward to the components of the loaded cells
+	void UpdateTransform( BoundingBoxBatch& rBoundingBoxBatch );
+
+	/// \brief Unload every cell
+	void Clear();
+
+private:
+
+	typedef std::vector< AbstractComponent* > ComponentCollection;
+
+	struct sCell
+	{
+		/// The scene objects, in the scene order
+		std::vector< SceneNode const* >	m_vObjects;
+		/// Components created for the objects loaded so far
+		ComponentCollection				m_vComponents;
+		/// Bounds on the ground plane, the grid square or the positions of an authored cell
+		vec2							m_f2Min;
+		vec2							m_f2Max;
+		/// Objects loaded, the cell is complete when all are
+		unsigned int					m_iLoadedCount;
+	};
+
+	/// \brief Distance on the ground plane from a position to a cell
+	static float _GetDistance( sCell const& rCell, vec3 const& f3Pos );
+
+	/// \brief Delete the components of a cell
+	void _Unload( sCell& rCell );
+
+	SceneGraph&				m_rSceneGraph;
+	ComponentScheduler&		m_rScheduler;
+
+	std::vector< sCell >	m_vCells;
+
+	/// Cell of each authored name and of each grid square
+	std::map< std::string, unsigned int >				m_mNamedCells;
+	std::map< std::pair< int, int >, unsigned int >		m_mGridCells;
+
+	float			m_fCellSize;
+	float			m_fRadius;
+	/// Scene objects created per frame at most
+	unsigned int	m_iBudget;
+};
+
+#endif //__SCENESTREAMER_H__
@@ -0,0 +1,169 @@
+#include "BurgerEngine/Core/StressSceneGenerator.h"
+
+#include "BurgerEngine/Base/CommonBase.h"
+
+#include "BurgerEngine/External/TinyXml/TinyXml.h"
+
+#include <cmath>
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+sStressScene::sStressScene()
+	: m_iMeshCount( 256 )
+	, m_iMoverCount( 64 )
+	, m_iParticleCount( 4 )
+	, m_iOmniCount( 64 )
+	, m_iSpotCount( 16 )
+	, m_iSpotShadowCount( 2 )
+	, m_fSpacing( 10.0f )
+	, m_sMeshObject( "ESM/Teapot" )
+	, m_sParticleObject( "TestComponent/Particle" )
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool StressSceneGenerator::Write( sStressScene const& rScene, std::string const& sFileName )
+{
+	unsigned int iGroundCount = rScene.m_iMeshCount + rScene.m_iMoverCount + rScene.m_iParticleCount;
+	unsigned int iLightCount = rScene.m_iOmniCount + rScene.m_iSpotCount + rScene.m_iSpotShadowCount;
+	float fExtent = sqrtf( static_cast< float >( iGroundCount > iLightCount ? iGroundCount : iLightCount ) ) * rScene.m_fSpacing;
+
+	TiXmlDocument oDocument;
+	TiXmlElement* pScene = static_cast< TiXmlElement* >( oDocument.LinkEndChild( new TiXmlElement( "scene" ) ) );
+
+	//The camera sees the whole grid, the culling still has the far objects to skip
+	TiXmlElement* pCamera = static_cast< TiXmlElement* >( pScene->LinkEndChild( new TiXmlElement( "settings" ) )->LinkEndChild( new TiXmlElement( "camera" ) ) );
+	pCamera->SetAttribute( "type", "sphere" );
+	TiXmlElement* pPosition = static_cast< TiXmlElement* >( pCamera->LinkEndChild( new TiXmlElement( "position" ) ) );
+	pPosition->SetDoubleAttribute( "rX", -35.0 );
+	pPosition->SetDoubleAttribute( "radius", fExtent * 0.75f + rScene.m_fSpacing );
+
+	//Ground objects, the movers then the particles take the places after the meshes
+	unsigned int iIndex = 0;
+	for( unsigned int i = 0; i < iGroundCount; ++i, ++iIndex )
+	{
+		float x, z;
+		_GetGridPosition( iIndex, iGroundCount, rScene.m_fSpacing, x, z );
+
+		if( i < rScene.m_iMeshCount )
+		{
+			_AddObject( *pScene, rScene.m_sMeshObject, x, 0.0f, z );
+		}
+		else if( i < rScene.m_iMeshCount + rScene.m_iMoverCount )
+		{
+			TiXmlElement* pObject = _AddObject( *pScene, rScene.m_sMeshObject, x, 0.0f, z );
+			TiXmlElement* pParameters = static_cast< TiXmlElement* >( pObject->LinkEndChild( new TiXmlElement( "movementhackercomponent" ) )->LinkEndChild( new TiXmlElement( "parameters" ) ) );
+
+			//Every mover its own phase, so they do not all move as one
+			_AddTrack( *pParameters, "posy", 1.0f + ( i % 7 ) * 0.25f, rScene.m_fSpacing * 0.25f, static_cast< float >( i ), 0.0f, 0.0f );
+			_AddTrack( *pParameters, "rotationy", 0.0f, 0.0f, 0.0f, 20.0f + ( i % 5 ) * 10.0f, 1.0f );
+		}
+		else
+		{
+			_AddObject( *pScene, rScene.m_sParticleObject, x, 0.0f, z );
+		}
+	}
+
+	//Lights above the objects, each reaching a few of them
+	float fRadius = rScene.m_fSpacing * 3.0f;
+	for( unsigned int i = 0; i < iLightCount; ++i )
+	{
+		float x, z;
+		_GetGridPosition( i, iLightCount, rScene.m_fSpacing, x, z );
+
+		char const* sType = i < rScene.m_iOmniCount ? "omni" : ( i < rScene.m_iOmniCount + rScene.m_iSpotCount ? "spot" : "spotshadow" );
+		_AddLight( *pScene, sType, i, fRadius, x, rScene.m_fSpacing, z );
+	}
+
+	if( !oDocument.SaveFile( sFileName ) )
+	{
+		ADD_ERROR_MESSAGE( "Writing stress scene : " << sFileName );
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void StressSceneGenerator::_GetGridPosition( unsigned int iIndex, unsigned int iCount, float fSpacing, float& x, float& z )
+{
+	unsigned int iSide = static_cast< unsigned int >( ceilf( sqrtf( static_cast< float >( iCount ) ) ) );
+	float fOffset = ( iSide - 1 ) * fSpacing * 0.5f;
+	x = ( iIndex % iSide ) * fSpacing - fOffset;
+	z = ( iIndex / iSide ) * fSpacing - fOffset;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+TiXmlElement* StressSceneGenerator::_AddObject( TiXmlElement& rScene, std::string const& sObject, float x, float y, float z )
+{
+	TiXmlElement* pObject = static_cast< TiXmlElement* >( rScene.LinkEndChild( new TiXmlElement( "sceneobject" ) ) );
+	pObject->SetDoubleAttribute( "x", x );
+	pObject->SetDoubleAttribute( "y", y );
+	pObject->SetDoubleAttribute( "z", z );
+
+	TiXmlElement* pFile = static_cast< TiXmlElement* >( pObject->LinkEndChild( new TiXmlElement( "ressourcecomponent" ) )->LinkEndChild( new TiXmlElement( "file" ) ) );
+	pFile->LinkEndChild( new TiXmlText( sObject.c_str() ) );
+	return pObject;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void StressSceneGenerator::_AddTrack( TiXmlElement& rParameters, char const* sName, float fSinSpeed, float fSinAmplitude, float fSinPhase, float fIncrement, float fLastValueMultiplier )
+{
+	//The movement hacker reads every value of a track
+	TiXmlElement* pTrack = static_cast< TiXmlElement* >( rParameters.LinkEndChild( new TiXmlElement( sName ) ) );
+	pTrack->SetDoubleAttribute( "sinSpeed", fSinSpeed );
+	pTrack->SetDoubleAttribute( "sinAmplitude", fSinAmplitude );
+	pTrack->SetDoubleAttribute( "sinPhase", fSinPhase );
+	pTrack->SetDoubleAttribute( "cosSpeed", 0.0 );
+	pTrack->SetDoubleAttribute( "cosAmplitude", 0.0 );
+	pTrack->SetDoubleAttribute( "cosPhase", 0.0 );
+	pTrack->SetDoubleAttribute( "increment", fIncrement );
+	pTrack->SetDoubleAttribute( "lastPosMultiplier", fLastValueMultiplier );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void StressSceneGenerator::_AddLight( TiXmlElement& rScene, char const* sType, unsigned int iIndex, float fRadius, float x, float y, float z )
+{
+	TiXmlElement* pObject = static_cast< TiXmlElement* >( rScene.LinkEndChild( new TiXmlElement( "sceneobject" ) ) );
+	pObject->SetDoubleAttribute( "x", x );
+	pObject->SetDoubleAttribute( "y", y );
+	pObject->SetDoubleAttribute( "z", z );
+
+	TiXmlElement* pComposite = static_cast< TiXmlElement* >( pObject->LinkEndChild( new TiXmlElement( "component" ) ) );
+	pComposite->SetAttribute( "id", "composite" );
+	TiXmlElement* pLightComponent = static_cast< TiXmlElement* >( pComposite->LinkEndChild( new TiXmlElement( "parameters" ) )->LinkEndChild( new TiXmlElement( "component" ) ) );
+	pLightComponent->SetAttribute( "id", "light" );
+	TiXmlElement* pParameters = static_cast< TiXmlElement* >( pLightComponent->LinkEndChild( new TiXmlElement( "parameters" ) ) );
+
+	//The spots look down on the objects, the light reads every value of its position
+	TiXmlElement* pPosition = static_cast< TiXmlElement* >( pParameters->LinkEndChild( new TiXmlElement( "position" ) ) );
+	pPosition->SetDoubleAttribute( "x", 0.0 );
+	pPosition->SetDoubleAttribute( "y", 0.0 );
+	pPosition->SetDoubleAttribute( "z", 0.0 );
+	pPosition->SetDoubleAttribute( "rX", -90.0 );
+	pPosition->SetDoubleAttribute( "rY", 0.0 );
+	pPosition->SetDoubleAttribute( "rZ", 0.0 );
+	static_cast< TiXmlElement* >( pParameters->LinkEndChild( new TiXmlElement( "light" ) ) )->SetAttribute( "type", sType );
+	static_cast< TiXmlElement* >( pParameters->LinkEndChild( new TiXmlElement( "Multiplier" ) ) )->SetDoubleAttribute( "value", 1.0 );
+	static_cast< TiXmlElement* >( pParameters->LinkEndChild( new TiXmlElement( "Radius" ) ) )->SetDoubleAttribute( "value", fRadius );
+	static_cast< TiXmlElement* >( pParameters->LinkEndChild( new TiXmlElement( "InnerAngle" ) ) )->SetDoubleAttribute( "value", 10.0 );
+	static_cast< TiXmlElement* >( pParameters->LinkEndChild( new TiXmlElement( "OuterAngle" ) ) )->SetDoubleAttribute( "value", 45.0 );
+
+	//A few colors in turn, the lit areas can be told apart
+	static float const s_pColors[4][3] = { { 1.0f, 0.9f, 0.8f }, { 1.0f, 0.3f, 0.2f }, { 0.2f, 0.5f, 1.0f }, { 0.3f, 1.0f, 0.4f } };
+	float const* pColor = s_pColors[ iIndex % 4 ];
+	TiXmlElement* pColorXml = static_cast< TiXmlElement* >( pParameters->LinkEndChild( new TiXmlElement( "Color" ) ) );
+	pColorXml->SetDoubleAttribute( "r", pColor[0] );
+	pColorXml->SetDoubleAttribute( "g", pColor[1] );
+	pColorXml->SetDoubleAttribute( "b", pColor[2] );
+}
@@ -0,0 +1,66 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __STRESSSCENEGENERATOR_H__
+#define __STRESSSCENEGENERATOR_H__
+
+#include <string>
+
+class TiXmlElement;
+
+/// \brief What a stress scene is made of
+struct sStressScene
+{
+	sStressScene();
+
+	unsigned int	m_iMeshCount;
+	unsigned int	m_iMoverCount;
+	unsigned int	m_iParticleCount;
+	unsigned int	m_iOmniCount;
+	unsigned int	m_iSpotCount;
+	unsigned int	m_iSpotShadowCount;
+
+	/// Distance between two objects of the grid
+	float			m_fSpacing;
+
+	/// Object files placed for the meshes, the movers and the particle systems
+	std::string		m_sMeshObject;
+	std::string		m_sParticleObject;
+};
+
+/// \class	StressSceneGenerator
+/// \brief	Writes a scene XML with the given number of each kind of object, to see how the engine scales.
+///			The meshes, the movers (meshes moved by a MovementHackerComponent) and the particle systems are laid
+///			on a square grid around the origin, the lights on a grid of their own above it, under a sphere
+///			camera looking at the whole scene from above. The same counts always give the same scene
+class StressSceneGenerator
+{
+public:
+
+	/// \brief Write the scene, false if the file cannot be written
+	static bool Write( sStressScene const& rScene, std::string const& sFileName );
+
+private:
+
+	/// \brief Position of an object on a grid of iCount objects
+	static void _GetGridPosition( unsigned int iIndex, unsigned int iCount, float fSpacing, float& x, float& z );
+
+	/// \brief Add a scene object placing an object file
+	static TiXmlElement* _AddObject( TiXmlElement& rScene, std::string const& sObject, float x, float y, float z );
+
+	/// \brief Add a track of a movement hacker, without cosine
+	static void _AddTrack( TiXmlElement& rParameters, char const* sName, float fSinSpeed, float fSinAmplitude, float fSinPhase, float fIncrement, float fLastValueMultiplier );
+
+	/// \brief Add a scene object holding a light of that type
+	static void _AddLight( TiXmlElement& rScene, char const* sType, unsigned int iIndex, float fRadius, float x, float y, float z );
+};
+
+#endif //__STRESSSCENEGENERATOR_H__
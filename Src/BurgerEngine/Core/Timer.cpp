@@ -19,6 +19,8 @@ Timer::Timer()
 void Timer::Initialize()
 {
 	m_oClock.Reset();
+	m_fScaledTime = 0.0f;
+	m_fLastFrameTime = 0.0f;
 }
 
 
@@ -0,0 +1,262 @@
+#include "BurgerEngine/Core/TransformStore.h"
+
+#include <assert.h>
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+TransformStore::TransformStore()
+	: m_bDirty( false )
+	, m_bRenderDirty( false )
+	, m_iMovedCount( 0 )
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+TransformStore::~TransformStore()
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+unsigned int TransformStore::Add( unsigned int iParent )
+{
+	//A released handle keeps the order only when it comes after the parent
+	unsigned int iHandle = s_iInvalidHandle;
+	for( unsigned int i = 0; i < m_viFreeHandles.size(); ++i )
+	{
+		if( iParent == s_iInvalidHandle || m_viFreeHandles[i] > iParent )
+		{
+			iHandle = m_viFreeHandles[i];
+			m_viFreeHandles[i] = m_viFreeHandles.back();
+			m_viFreeHandles.pop_back();
+			break;
+		}
+	}
+
+	if( iHandle == s_iInvalidHandle )
+	{
+		iHandle = m_viParent.size();
+		m_vf3Position.push_back( vec3( 0.0f, 0.0f, 0.0f ) );
+		m_vf3Rotation.push_back( vec3( 0.0f, 0.0f, 0.0f ) );
+		m_vfScale.push_back( 1.0f );
+		m_viParent.push_back( iParent );
+		m_vf3PreviousPosition.push_back( vec3( 0.0f, 0.0f, 0.0f ) );
+		m_vf3PreviousRotation.push_back( vec3( 0.0f, 0.0f, 0.0f ) );
+		m_vfPreviousScale.push_back( 1.0f );
+		m_vmWorld.push_back( identity4() );
+		m_vf3WorldRotation.push_back( vec3( 0.0f, 0.0f, 0.0f ) );
+		m_vfWorldScale.push_back( 1.0f );
+		m_vmRender.push_back( identity4() );
+		m_vf3RenderRotation.push_back( vec3( 0.0f, 0.0f, 0.0f ) );
+		m_vfRenderScale.push_back( 1.0f );
+		m_viFlags.push_back( 0 );
+	}
+	else
+	{
+		m_vf3Position[ iHandle ] = vec3( 0.0f, 0.0f, 0.0f );
+		m_vf3Rotation[ iHandle ] = vec3( 0.0f, 0.0f, 0.0f );
+		m_vfScale[ iHandle ] = 1.0f;
+		m_viParent[ iHandle ] = iParent;
+		m_viFlags[ iHandle ] = 0;
+	}
+
+	//Not interpolated from the origin, nor from the transform that had the handle before
+	m_viFlags[ iHandle ] |= E_FLAG_SNAP;
+	_SetDirty( iHandle );
+	return iHandle;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void TransformStore::Remove( unsigned int iHandle )
+{
+	assert( iHandle < m_viFlags.size() && !( m_viFlags[ iHandle ] & E_FLAG_FREE ) );
+	m_viFlags[ iHandle ] = E_FLAG_FREE;
+	m_viParent[ iHandle ] = s_iInvalidHandle;
+	m_viFreeHandles.push_back( iHandle );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+vec3 TransformStore::GetWorldPosition( unsigned int iHandle ) const
+{
+	float4x4 const& mWorld = m_vmWorld[ iHandle ];
+	return vec3( mWorld.rows[0].w, mWorld.rows[1].w, mWorld.rows[2].w );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+vec3 TransformStore::GetRenderPosition( unsigned int iHandle ) const
+{
+	float4x4 const& mRender = m_vmRender[ iHandle ];
+	return vec3( mRender.rows[0].w, mRender.rows[1].w, mRender.rows[2].w );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+float4x4 TransformStore::_ComputeLocalMatrix( vec3 const& f3Position, vec3 const& f3Rotation, float fScale )
+{
+	return translate( f3Position.x, f3Position.y, f3Position.z )
+		* rotateZ( f3Rotation.z * DEG_TO_RAD ) * rotateY( f3Rotation.y * DEG_TO_RAD ) * rotateX( f3Rotation.x * DEG_TO_RAD )
+		* scale( fScale, fScale, fScale );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void TransformStore::BeginStep()
+{
+	//The others were not changed by the last step, their values are still the ones kept
+	if( m_iMovedCount == 0 )
+	{
+		return;
+	}
+
+	unsigned int iCount = m_viFlags.size();
+	for( unsigned int i = 0; i < iCount; ++i )
+	{
+		if( ( m_viFlags[i] & ( E_FLAG_MOVED | E_FLAG_FREE ) ) == E_FLAG_MOVED )
+		{
+			m_vf3PreviousPosition[i] = m_vf3Position[i];
+			m_vf3PreviousRotation[i] = m_vf3Rotation[i];
+			m_vfPreviousScale[i] = m_vfScale[i];
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void TransformStore::Update()
+{
+	//Nothing changed, and no moved flag left from the last pass
+	if( !m_bDirty )
+	{
+		return;
+	}
+
+	m_iMovedCount = 0;
+	unsigned int iCount = m_viFlags.size();
+	for( unsigned int i = 0; i < iCount; ++i )
+	{
+		unsigned char& rFlags = m_viFlags[i];
+		if( rFlags & E_FLAG_FREE )
+		{
+			continue;
+		}
+
+		//The parent was handled before, its moved flag is already the one of this pass
+		unsigned int iParent = m_viParent[i];
+		bool bMoved = ( rFlags & E_FLAG_DIRTY ) || ( iParent != s_iInvalidHandle && ( m_viFlags[ iParent ] & E_FLAG_MOVED ) );
+		unsigned char iRenderFlags = rFlags & ( E_FLAG_RENDER_DIRTY | E_FLAG_RENDER_MOVED );
+		if( !bMoved )
+		{
+			//Moved by the step before, its render values stopped between two steps
+			rFlags = iRenderFlags | ( ( rFlags & E_FLAG_MOVED ) ? E_FLAG_RENDER_DIRTY : 0 );
+			continue;
+		}
+
+		vec3 const& f3Position = m_vf3Position[i];
+		vec3 const& f3Rotation = m_vf3Rotation[i];
+		float fScale = m_vfScale[i];
+		if( rFlags & E_FLAG_SNAP )
+		{
+			m_vf3PreviousPosition[i] = f3Position;
+			m_vf3PreviousRotation[i] = f3Rotation;
+			m_vfPreviousScale[i] = fScale;
+		}
+		rFlags = E_FLAG_MOVED | ( iRenderFlags & E_FLAG_RENDER_MOVED );
+		++m_iMovedCount;
+
+		float4x4 mLocal = _ComputeLocalMatrix( f3Position, f3Rotation, fScale );
+
+		if( iParent == s_iInvalidHandle )
+		{
+			m_vmWorld[i] = mLocal;
+			m_vf3WorldRotation[i] = f3Rotation;
+			m_vfWorldScale[i] = fScale;
+		}
+		else
+		{
+			m_vmWorld[i] = m_vmWorld[ iParent ] * mLocal;
+			m_vf3WorldRotation[i] = m_vf3WorldRotation[ iParent ] + f3Rotation;
+			m_vfWorldScale[i] = m_vfWorldScale[ iParent ] * fScale;
+		}
+	}
+
+	//The moved flags are cleared by the next pass
+	m_bDirty = m_iMovedCount != 0;
+	m_bRenderDirty = true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void TransformStore::Interpolate( float fAlpha )
+{
+	//Nothing moved since the last call, and no render moved flag left from it
+	if( !m_bRenderDirty )
+	{
+		return;
+	}
+
+	unsigned int iRenderMovedCount = 0;
+	unsigned int iCount = m_viFlags.size();
+	for( unsigned int i = 0; i < iCount; ++i )
+	{
+		unsigned char& rFlags = m_viFlags[i];
+		if( rFlags & E_FLAG_FREE )
+		{
+			continue;
+		}
+		rFlags &= ~E_FLAG_RENDER_MOVED;
+
+		//At the end of the step, or once it stopped, the render values are the world ones
+		if( ( rFlags & E_FLAG_RENDER_DIRTY ) || ( ( rFlags & E_FLAG_MOVED ) && fAlpha >= 1.0f ) )
+		{
+			m_vmRender[i] = m_vmWorld[i];
+			m_vf3RenderRotation[i] = m_vf3WorldRotation[i];
+			m_vfRenderScale[i] = m_vfWorldScale[i];
+			rFlags = ( rFlags & ~E_FLAG_RENDER_DIRTY ) | E_FLAG_RENDER_MOVED;
+			++iRenderMovedCount;
+			continue;
+		}
+		if( !( rFlags & E_FLAG_MOVED ) )
+		{
+			continue;
+		}
+		rFlags |= E_FLAG_RENDER_MOVED;
+		++iRenderMovedCount;
+
+		//The local values are interpolated, then put under the render matrix of the parent, handled before
+		vec3 f3Position = lerp( m_vf3PreviousPosition[i], m_vf3Position[i], fAlpha );
+		vec3 f3Rotation = lerp( m_vf3PreviousRotation[i], m_vf3Rotation[i], fAlpha );
+		float fScale = lerp( m_vfPreviousScale[i], m_vfScale[i], fAlpha );
+		float4x4 mLocal = _ComputeLocalMatrix( f3Position, f3Rotation, fScale );
+
+		unsigned int iParent = m_viParent[i];
+		if( iParent == s_iInvalidHandle )
+		{
+			m_vmRender[i] = mLocal;
+			m_vf3RenderRotation[i] = f3Rotation;
+			m_vfRenderScale[i] = fScale;
+		}
+		else
+		{
+			m_vmRender[i] = m_vmRender[ iParent ] * mLocal;
+			m_vf3RenderRotation[i] = m_vf3RenderRotation[ iParent ] + f3Rotation;
+			m_vfRenderScale[i] = m_vfRenderScale[ iParent ] * fScale;
+		}
+	}
+
+	//The render moved flags are cleared by the next call
+	m_bRenderDirty = iRenderMovedCount != 0;
+}
@@ -0,0 +1,150 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __TRANSFORMSTORE_H__
+#define __TRANSFORMSTORE_H__
+
+#include <vector>
+
+#include "BurgerEngine/External/Math/Vector.h"
+
+/// \class	TransformStore
+/// \brief	Position, rotation and scale of every component relative to its parent, in contiguous arrays,
+///			and the world matrices computed from them.
+///			A parent always has a smaller handle than its children, so a single pass in handle order computes
+///			the world matrices. Only the transforms changed since the last pass, and their children, are computed.
+///			The simulation runs at a fixed step, the local values at the start of the step are kept so the
+///			renderers read values interpolated between the last two steps, see Interpolate
+class TransformStore
+{
+public:
+
+	static const unsigned int s_iInvalidHandle = 0xFFFFFFFF;
+
+	TransformStore();
+	~TransformStore();
+
+	/// \brief Add an identity transform
+	/// \param iParent Handle of the parent, s_iInvalidHandle for a root
+	unsigned int Add( unsigned int iParent = s_iInvalidHandle );
+
+	/// \brief Release a transform, its children must be removed or given another parent
+	void Remove( unsigned int iHandle );
+
+	/// \name Local values, relative to the parent. The rotation is in degrees, applied around x, then y, then z
+	/// Components updated in parallel may set their own transforms at the same time, Add and Remove may not
+	/// \{
+	void SetLocalPosition( unsigned int iHandle, vec3 const& f3Position ){ m_vf3Position[ iHandle ] = f3Position; _SetDirty( iHandle ); }
+	void SetLocalRotation( unsigned int iHandle, vec3 const& f3Rotation ){ m_vf3Rotation[ iHandle ] = f3Rotation; _SetDirty( iHandle ); }
+	void SetLocalScale( unsigned int iHandle, float fScale ){ m_vfScale[ iHandle ] = fScale; _SetDirty( iHandle ); }
+
+	vec3 const& GetLocalPosition( unsigned int iHandle ) const { return m_vf3Position[ iHandle ]; }
+	vec3 const& GetLocalRotation( unsigned int iHandle ) const { return m_vf3Rotation[ iHandle ]; }
+	float GetLocalScale( unsigned int iHandle ) const { return m_vfScale[ iHandle ]; }
+	/// \}
+
+	/// \brief Keep the local values of the transforms moved by the last step, before a new step changes them
+	void BeginStep();
+
+	/// \brief Compute the world matrices of the transforms changed since the last call and of their children
+	void Update();
+
+	/// \brief Compute the render values of the transforms moved by the last step, between their values before
+	///			and after it
+	/// \param fAlpha Part of the step elapsed since it was simulated, 1 for the values of the last Update
+	void Interpolate( float fAlpha );
+
+	/// \name World values, as computed by the last Update
+	/// \{
+	float4x4 const& GetWorldMatrix( unsigned int iHandle ) const { return m_vmWorld[ iHandle ]; }
+	vec3 GetWorldPosition( unsigned int iHandle ) const;
+	float GetWorldScale( unsigned int iHandle ) const { return m_vfWorldScale[ iHandle ]; }
+
+	/// \brief Sum of the rotations of the transform and its parents, what the lights are oriented with
+	vec3 const& GetWorldRotation( unsigned int iHandle ) const { return m_vf3WorldRotation[ iHandle ]; }
+
+	/// \brief The world matrix changed during the last Update
+	bool HasMoved( unsigned int iHandle ) const { return ( m_viFlags[ iHandle ] & E_FLAG_MOVED ) != 0; }
+	/// \}
+
+	/// \name Render values, as computed by the last Interpolate, what the renderers draw and cull with
+	/// \{
+	float4x4 const& GetRenderMatrix( unsigned int iHandle ) const { return m_vmRender[ iHandle ]; }
+	vec3 GetRenderPosition( unsigned int iHandle ) const;
+	float GetRenderScale( unsigned int iHandle ) const { return m_vfRenderScale[ iHandle ]; }
+	vec3 const& GetRenderRotation( unsigned int iHandle ) const { return m_vf3RenderRotation[ iHandle ]; }
+
+	/// \brief The render matrix changed during the last Interpolate
+	bool HasRenderMoved( unsigned int iHandle ) const { return ( m_viFlags[ iHandle ] & E_FLAG_RENDER_MOVED ) != 0; }
+	/// \}
+
+	unsigned int GetCount() const { return m_viParent.size() - m_viFreeHandles.size(); }
+
+	/// \brief Transforms whose world matrix changed during the last Update
+	unsigned int GetMovedCount() const { return m_iMovedCount; }
+
+private:
+
+	enum Flag
+	{
+		/// Local values changed since the last Update
+		E_FLAG_DIRTY = 1 << 0,
+		/// World matrix changed by the last Update
+		E_FLAG_MOVED = 1 << 1,
+		E_FLAG_FREE = 1 << 2,
+		/// Added during the step, the values before it are the ones it was placed with
+		E_FLAG_SNAP = 1 << 3,
+		/// Moved by an earlier step but not by the last one, the render values catch up with the world ones
+		E_FLAG_RENDER_DIRTY = 1 << 4,
+		/// Render values changed by the last Interpolate
+		E_FLAG_RENDER_MOVED = 1 << 5
+	};
+
+	/// The parallel updates of a phase race on m_bDirty, tolerated since they all write true and the flag is
+	/// only read by Update, after JobPool::Run returned. A component only sets the flags of its own transform
+	void _SetDirty( unsigned int iHandle ){ m_viFlags[ iHandle ] |= E_FLAG_DIRTY; m_bDirty = true; }
+
+	/// \brief Matrix of local values, relative to the parent
+	static float4x4 _ComputeLocalMatrix( vec3 const& f3Position, vec3 const& f3Rotation, float fScale );
+
+	/// Local values
+	std::vector< vec3 >				m_vf3Position;
+	std::vector< vec3 >				m_vf3Rotation;
+	std::vector< float >			m_vfScale;
+	std::vector< unsigned int >		m_viParent;
+
+	/// Local values at the start of the last step
+	std::vector< vec3 >				m_vf3PreviousPosition;
+	std::vector< vec3 >				m_vf3PreviousRotation;
+	std::vector< float >			m_vfPreviousScale;
+
+	/// World values
+	std::vector< float4x4 >			m_vmWorld;
+	std::vector< vec3 >				m_vf3WorldRotation;
+	std::vector< float >			m_vfWorldScale;
+
+	/// Render values
+	std::vector< float4x4 >			m_vmRender;
+	std::vector< vec3 >				m_vf3RenderRotation;
+	std::vector< float >			m_vfRenderScale;
+
+	std::vector< unsigned char >	m_viFlags;
+	/// Released handles, reused for transforms whose parent comes before them
+	std::vector< unsigned int >		m_viFreeHandles;
+
+	/// A transform is dirty, or moved during the last Update so its flag has to be cleared
+	bool							m_bDirty;
+	/// Same for the render values and their flags
+	bool							m_bRenderDirty;
+	unsigned int					m_iMovedCount;
+};
+
+#endif //__TRANSFORMSTORE_H__
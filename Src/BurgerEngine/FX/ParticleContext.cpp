@@ -5,7 +5,7 @@
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void ParticleContext::Update()
+void ParticleContext::Update(float a_fFrameTime)
 {
 	FOR_EACH_IT(ParticleSystems, m_oSystems, it)
 	{
@@ -13,7 +13,22 @@ void ParticleContext::Update()
 		ParticleSystem& rSystem = (**it);
 		if (rSystem.IsRunning())
 		{
-			rSystem.Update();
+			rSystem.Update(a_fFrameTime);
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ParticleContext::Draw()
+{
+	FOR_EACH_IT(ParticleSystems, m_oSystems, it)
+	{
+		ParticleSystem& rSystem = (**it);
+		if (rSystem.IsRunning())
+		{
+			rSystem.Draw();
 		}
 	}
 }
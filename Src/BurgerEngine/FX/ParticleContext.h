@@ -22,8 +22,12 @@ class ParticleContext
 	typedef std::vector<ParticleSystem*> ParticleSystems;
 public:
 
-	/// \brief Update the context, so the particle
-	void Update();
+	/// \brief Update the context, so the particle, at every simulation step.
+	///			The particles are drawn where the last step left them, they are not interpolated between steps
+	void Update(float a_fFrameTime);
+
+	/// \brief Send the particles of the running systems to the renderer, once per rendered frame
+	void Draw();
 
 	/// \brief Set the system to be updated
 	void RegisterFXInstance(ParticleSystem& a_rSystem);
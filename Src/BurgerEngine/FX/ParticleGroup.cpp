@@ -2,9 +2,9 @@
 #include "BurgerEngine/fx/ParticleManager.h"
 #include "BurgerEngine/fx/ParticleEffector.h"
 #include "BurgerEngine/Core/Engine.h"
-#include "BurgerEngine/Core/TimeContext.h"
 #include "BurgerEngine/Graphics/RenderingContext.h"
 #include "BurgerEngine/Graphics/ParticleRenderer.h"
+#include "BurgerEngine/Graphics/MaterialManager.h"
 
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -23,6 +23,10 @@ void ParticleGroup::Terminate()
 {
 	delete m_pManager;
 	m_pManager = NULL;
+
+	//Taken by the ParticleComponent, freed with the last group using it
+	MaterialManager::GrabInstance().releaseMaterial( m_pMaterial );
+	m_pMaterial = NULL;
 }
 
 
@@ -52,10 +56,10 @@ void ParticleGroup::Stop()
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void ParticleGroup::Update()
+void ParticleGroup::Update(float a_fFrameTime)
 {
-	//Retrieve Time
-	float fTime = Engine::GetInstance().GetTimeContext().GetScaledTime();
+	//The simulation step
+	float fTime = a_fFrameTime;
 
 	// Has the emmitter completed one cycle
 	float fLife = m_oEmitter.GetCurrentLife();
@@ -108,11 +112,16 @@ void ParticleGroup::Update()
 
 	//Sort
 	_Sort();
+}
 
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ParticleGroup::Draw()
+{
 	//Send info to Gfx
 	ParticleRenderer& rRenderer = Engine::GrabInstance().GrabRenderContext().GrabParticleRenderer();
 	_DrawParticle(rRenderer);
-	
 }
 
 //--------------------------------------------------------------------------------------------------------------------
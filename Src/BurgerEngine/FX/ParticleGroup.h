@@ -46,7 +46,10 @@ public:
 	void Stop();
 
 	/// \brief Update all the layers
-	void Update();
+	void Update(float a_fFrameTime);
+
+	/// \brief Send the particles to the renderer, which forgets them after every frame
+	void Draw();
 
 	/// \brief GrabEmitter
 	ParticleEmitter& GrabEmitter(){return m_oEmitter;}
@@ -52,10 +52,21 @@ void ParticleSystem::Stop()
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void ParticleSystem::Update()
+void ParticleSystem::Update(float a_fFrameTime)
 {
 	FOR_EACH_IT(ParticleGroups, m_vGroups, it)
 	{
-		(*it)->Update();
+		(*it)->Update(a_fFrameTime);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ParticleSystem::Draw()
+{
+	FOR_EACH_IT(ParticleGroups, m_vGroups, it)
+	{
+		(*it)->Draw();
 	}
 }
\ No newline at end of file
@@ -41,7 +41,10 @@ public:
 	void Stop();
 
 	/// \brief Update all the layers
-	void Update();
+	void Update(float a_fFrameTime);
+
+	/// \brief Send the particles of all the layers to the renderer
+	void Draw();
 
 	/// \brief Is ruuning
 	bool IsRunning(){return m_bIsRunning;}
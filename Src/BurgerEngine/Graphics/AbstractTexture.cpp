@@ -1,16 +1,20 @@
 #include "AbstractTexture.h"
 #include "ImageTool.h"
+#include "BurgerEngine/Graphics/OpenGLContext.h"
 
 AbstractTexture::AbstractTexture()
+	: m_iId( 0 )
+	, m_bUseMipMaps( false )
 {
 }
 
 AbstractTexture::AbstractTexture( bool bUseMipMaps, bool bLinearFiltering, bool bClampS, bool bClampT )
-	: m_eFilteringMin( GL_NEAREST )
+	: m_iId( 0 )
+	, m_eFilteringMin( GL_NEAREST )
 	, m_eFilteringMag( GL_NEAREST )
 	, m_eWrapS( GL_REPEAT )
 	, m_eWrapT( GL_REPEAT )
-	, m_eGenerateMipMap( GL_FALSE )
+	, m_bUseMipMaps( false )
 {
 	if( bLinearFiltering )
 	{
@@ -20,7 +24,7 @@ AbstractTexture::AbstractTexture( bool bUseMipMaps, bool bLinearFiltering, bool
 	if( bUseMipMaps )
 	{
 		m_eFilteringMin = GL_LINEAR_MIPMAP_LINEAR;
-		m_eGenerateMipMap = GL_TRUE;
+		m_bUseMipMaps = true;
 	}
 	if( bClampS )
 	{
@@ -48,5 +52,5 @@ void AbstractTexture::generateID()
 }
 void AbstractTexture::destroyID()
 {
-	glDeleteTextures(1, &m_iId);
+	OpenGLContext::DeleteTexture( m_iId );
 }
@@ -16,6 +16,7 @@
 #include <iostream>
 
 #include "BurgerEngine/Graphics/CommonGraphics.h"
+#include "BurgerEngine/Graphics/MipmapGenerator.h"
 
 class AbstractTexture
 {
@@ -34,6 +35,19 @@ class AbstractTexture
 		virtual void Activate() = 0;
 
 		virtual GLubyte* LoadData();
+
+		/// \brief How the mip levels are built, set before loading the texture
+		void SetMipmapSettings( MipmapGenerator::sSettings const& oSettings ){ m_oMipmapSettings = oSettings; }
+
+		/// \brief Size on screen, in pixels, of an object using the texture, used by the streamed textures
+		virtual void RequestResolution( float /*fScreenSize*/ ){}
+
+		/// \brief Target the texture is bound to
+		virtual GLenum GetTarget() const { return GL_TEXTURE_2D; }
+
+		/// \brief Layer of the texture in its TextureArray, for the shaders sampling the array
+		virtual unsigned int GetLayer() const { return 0; }
+
 		void generateID();
 		void destroyID();
 	
@@ -49,7 +63,10 @@ class AbstractTexture
 		GLenum			m_eFilteringMag;
 		GLenum			m_eWrapS;
 		GLenum			m_eWrapT;
-		GLenum			m_eGenerateMipMap;
+
+		/// The mip chain is built on the CPU and every level is uploaded
+		bool						m_bUseMipMaps;
+		MipmapGenerator::sSettings	m_oMipmapSettings;
 };
 
 #endif //__ABSTRACTTEXTURE_H__
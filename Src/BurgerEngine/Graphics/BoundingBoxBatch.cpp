@@ -0,0 +1,137 @@
+#include "BurgerEngine/Graphics/BoundingBoxBatch.h"
+
+#include <emmintrin.h>
+#include <math.h>
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+BoundingBoxBatch::BoundingBoxBatch()
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+BoundingBoxBatch::~BoundingBoxBatch()
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void BoundingBoxBatch::Clear()
+{
+	for( unsigned int i = 0; i < E_VALUE_COUNT; ++i )
+	{
+		m_vfValues[i].clear();
+	}
+	m_vpOutputs.clear();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void BoundingBoxBatch::Add( const float* pLocalBoundingBox, const float4x4& mTransform, float* pBoundingBox )
+{
+	for( unsigned int i = 0; i < 3; ++i )
+	{
+		m_vfValues[ E_CENTER_X + i ].push_back( ( pLocalBoundingBox[ i * 2 ] + pLocalBoundingBox[ i * 2 + 1 ] ) * 0.5f );
+		m_vfValues[ E_HALF_SIZE_X + i ].push_back( ( pLocalBoundingBox[ i * 2 + 1 ] - pLocalBoundingBox[ i * 2 ] ) * 0.5f );
+
+		vec4 const& f4Row = mTransform.rows[i];
+		m_vfValues[ E_MATRIX + i * 4 ].push_back( f4Row.x );
+		m_vfValues[ E_MATRIX + i * 4 + 1 ].push_back( f4Row.y );
+		m_vfValues[ E_MATRIX + i * 4 + 2 ].push_back( f4Row.z );
+		m_vfValues[ E_MATRIX + i * 4 + 3 ].push_back( f4Row.w );
+	}
+	m_vpOutputs.push_back( pBoundingBox );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void BoundingBoxBatch::Compute()
+{
+	unsigned int iCount = m_vpOutputs.size();
+	unsigned int iBatchEnd = iCount & ~3;
+
+	//Clearing the sign bit gives the absolute value
+	const __m128 vAbsMask = _mm_castsi128_ps( _mm_set1_epi32( 0x7FFFFFFF ) );
+
+	for( unsigned int i = 0; i < iBatchEnd; i += 4 )
+	{
+		__m128 vCenterX = _mm_loadu_ps( &m_vfValues[ E_CENTER_X ][i] );
+		__m128 vCenterY = _mm_loadu_ps( &m_vfValues[ E_CENTER_Y ][i] );
+		__m128 vCenterZ = _mm_loadu_ps( &m_vfValues[ E_CENTER_Z ][i] );
+		__m128 vHalfSizeX = _mm_loadu_ps( &m_vfValues[ E_HALF_SIZE_X ][i] );
+		__m128 vHalfSizeY = _mm_loadu_ps( &m_vfValues[ E_HALF_SIZE_Y ][i] );
+		__m128 vHalfSizeZ = _mm_loadu_ps( &m_vfValues[ E_HALF_SIZE_Z ][i] );
+
+		//One output axis per row of the matrix, the four boxes in the lanes
+		float pMin[3][4];
+		float pMax[3][4];
+		for( unsigned int iRow = 0; iRow < 3; ++iRow )
+		{
+			__m128 vM0 = _mm_loadu_ps( &m_vfValues[ E_MATRIX + iRow * 4 ][i] );
+			__m128 vM1 = _mm_loadu_ps( &m_vfValues[ E_MATRIX + iRow * 4 + 1 ][i] );
+			__m128 vM2 = _mm_loadu_ps( &m_vfValues[ E_MATRIX + iRow * 4 + 2 ][i] );
+			__m128 vM3 = _mm_loadu_ps( &m_vfValues[ E_MATRIX + iRow * 4 + 3 ][i] );
+
+			__m128 vCenter = _mm_add_ps( _mm_add_ps( _mm_mul_ps( vM0, vCenterX ), _mm_mul_ps( vM1, vCenterY ) ),
+				_mm_add_ps( _mm_mul_ps( vM2, vCenterZ ), vM3 ) );
+			__m128 vHalfSize = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_and_ps( vM0, vAbsMask ), vHalfSizeX ), _mm_mul_ps( _mm_and_ps( vM1, vAbsMask ), vHalfSizeY ) ),
+				_mm_mul_ps( _mm_and_ps( vM2, vAbsMask ), vHalfSizeZ ) );
+
+			_mm_storeu_ps( pMin[ iRow ], _mm_sub_ps( vCenter, vHalfSize ) );
+			_mm_storeu_ps( pMax[ iRow ], _mm_add_ps( vCenter, vHalfSize ) );
+		}
+
+		for( unsigned int j = 0; j < 4; ++j )
+		{
+			float* pBoundingBox = m_vpOutputs[ i + j ];
+			pBoundingBox[0] = pMin[0][j];
+			pBoundingBox[1] = pMax[0][j];
+			pBoundingBox[2] = pMin[1][j];
+			pBoundingBox[3] = pMax[1][j];
+			pBoundingBox[4] = pMin[2][j];
+			pBoundingBox[5] = pMax[2][j];
+		}
+	}
+
+	//Remaining boxes
+	for( unsigned int i = iBatchEnd; i < iCount; ++i )
+	{
+		float* pBoundingBox = m_vpOutputs[i];
+		for( unsigned int iRow = 0; iRow < 3; ++iRow )
+		{
+			const float fM0 = m_vfValues[ E_MATRIX + iRow * 4 ][i];
+			const float fM1 = m_vfValues[ E_MATRIX + iRow * 4 + 1 ][i];
+			const float fM2 = m_vfValues[ E_MATRIX + iRow * 4 + 2 ][i];
+			const float fM3 = m_vfValues[ E_MATRIX + iRow * 4 + 3 ][i];
+
+			float fCenter = fM0 * m_vfValues[ E_CENTER_X ][i] + fM1 * m_vfValues[ E_CENTER_Y ][i] + fM2 * m_vfValues[ E_CENTER_Z ][i] + fM3;
+			float fHalfSize = fabsf( fM0 ) * m_vfValues[ E_HALF_SIZE_X ][i] + fabsf( fM1 ) * m_vfValues[ E_HALF_SIZE_Y ][i] + fabsf( fM2 ) * m_vfValues[ E_HALF_SIZE_Z ][i];
+			pBoundingBox[ iRow * 2 ] = fCenter - fHalfSize;
+			pBoundingBox[ iRow * 2 + 1 ] = fCenter + fHalfSize;
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void BoundingBoxBatch::TransformBox( const float* pLocalBoundingBox, const float4x4& mTransform, float* pBoundingBox )
+{
+	vec3 f3Center( ( pLocalBoundingBox[0] + pLocalBoundingBox[1] ) * 0.5f, ( pLocalBoundingBox[2] + pLocalBoundingBox[3] ) * 0.5f, ( pLocalBoundingBox[4] + pLocalBoundingBox[5] ) * 0.5f );
+	vec3 f3HalfSize( ( pLocalBoundingBox[1] - pLocalBoundingBox[0] ) * 0.5f, ( pLocalBoundingBox[3] - pLocalBoundingBox[2] ) * 0.5f, ( pLocalBoundingBox[5] - pLocalBoundingBox[4] ) * 0.5f );
+
+	for( unsigned int iRow = 0; iRow < 3; ++iRow )
+	{
+		vec4 const& f4Row = mTransform.rows[ iRow ];
+		float fCenter = f4Row.x * f3Center.x + f4Row.y * f3Center.y + f4Row.z * f3Center.z + f4Row.w;
+		float fHalfSize = fabsf( f4Row.x ) * f3HalfSize.x + fabsf( f4Row.y ) * f3HalfSize.y + fabsf( f4Row.z ) * f3HalfSize.z;
+		pBoundingBox[ iRow * 2 ] = fCenter - fHalfSize;
+		pBoundingBox[ iRow * 2 + 1 ] = fCenter + fHalfSize;
+	}
+}
@@ -0,0 +1,66 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __BOUNDINGBOXBATCH_H__
+#define __BOUNDINGBOXBATCH_H__
+
+#include <vector>
+
+#include "BurgerEngine/External/Math/Vector.h"
+
+/// \class	BoundingBoxBatch
+/// \brief	World space boxes of the objects moved during the frame, computed together.
+///			A box is kept as its center and half size, the world center is the transformed center and the world
+///			half size the local one transformed by the absolute values of the matrix, so there are no corners to
+///			transform. The boxes are stored one array per value, and computed four at a time with SSE.
+///			Boxes are (xmin, xmax, ymin, ymax, zmin, zmax)
+class BoundingBoxBatch
+{
+public:
+
+	BoundingBoxBatch();
+	~BoundingBoxBatch();
+
+	/// \brief Forget the boxes of the previous frame
+	void Clear();
+
+	/// \brief Queue a box
+	/// \param[out] pBoundingBox Where the world box is written by Compute, must stay valid until then
+	void Add( const float* pLocalBoundingBox, const float4x4& mTransform, float* pBoundingBox );
+
+	/// \brief Write the world box of every queued box
+	void Compute();
+
+	unsigned int GetCount() const { return (unsigned int)m_vpOutputs.size(); }
+
+	/// \brief Same computation for a single box
+	static void TransformBox( const float* pLocalBoundingBox, const float4x4& mTransform, float* pBoundingBox );
+
+private:
+
+	enum Value
+	{
+		E_CENTER_X,
+		E_CENTER_Y,
+		E_CENTER_Z,
+		E_HALF_SIZE_X,
+		E_HALF_SIZE_Y,
+		E_HALF_SIZE_Z,
+		/// Upper 3x4 of the matrix, row after row
+		E_MATRIX,
+		E_VALUE_COUNT = E_MATRIX + 12
+	};
+
+	std::vector< float >	m_vfValues[ E_VALUE_COUNT ];
+	std::vector< float* >	m_vpOutputs;
+};
+
+#endif //__BOUNDINGBOXBATCH_H__
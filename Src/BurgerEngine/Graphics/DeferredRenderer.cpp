@@ -13,8 +13,11 @@
 #include "BurgerEngine/Graphics/RenderingContext.h"
 #include "BurgerEngine/Graphics/ParticleRenderer.h"
 #include "BurgerEngine/Graphics/Material.h"
+#include "BurgerEngine/Graphics/MeshManager.h"
 
 #include "BurgerEngine/Core/Timer.h"
+#include "BurgerEngine/Core/Profiler.h"
+#include "BurgerEngine/Core/TimeContext.h"
 
 #include "BurgerEngine/External/Math/Vector.h"
 #include "BurgerEngine/External/Math/Miniball.h"
@@ -44,6 +47,9 @@ float pSphere[16];
 DeferredRenderer::DeferredRenderer()
 	: m_iDebugFlag(0)
 	, m_iSkipCulling(0)
+	, m_iShadowDrawCount(0)
+	, m_iShadowCallCount(0)
+	, m_iSkipSubMeshCulling(0)
 	, m_iDebugBoundingBox(0)
 	, m_iDebugRender(0)
 	, m_iDebugSpotLightFrustum(0)
@@ -94,12 +100,25 @@ DeferredRenderer::DeferredRenderer()
 	oDebugMenu.AddEntry( "Adaptation Base Time", m_fAdaptationBaseTime, 0.0f, 1.0f, 0.02f );
 	oDebugMenu.AddEntry( "DebugFlag", m_iDebugFlag, 0, 100, 1 );
 	oDebugMenu.AddEntry( "Skip Culling", m_iSkipCulling, 0, 1, 1 );
+	oDebugMenu.AddEntry( "Skip Sub-Mesh Culling", m_iSkipSubMeshCulling, 0, 1, 1 );
 	oDebugMenu.AddEntry( "Show Bounding Boxes", m_iDebugBoundingBox, 0, 1, 1 );
 	oDebugMenu.AddEntry( "Show Spot Lights Frustum", m_iDebugSpotLightFrustum, 0, 1, 1 );
 	oDebugMenu.AddEntry( "DebugRender", m_iDebugRender, 0, 10, 1 );
 
 }
 
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void DeferredRenderer::ForgetLight( SceneLight const& rLight )
+{
+	//The next directional light takes over the cascades
+	if( m_pDirectionalShadowLight == &rLight )
+	{
+		m_pDirectionalShadowLight = NULL;
+	}
+}
+
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
@@ -184,8 +203,8 @@ DeferredRenderer::~DeferredRenderer()
 	delete [] m_pFrustumBoundingSpheres;
 	m_pFrustumBoundingSpheres = NULL;
 
-	glDeleteBuffers( 1, &m_iFullScreenQuadBufferId );
-	glDeleteBuffers( 1, &m_iFullScreenQuadBufferIdCW );
+	OpenGLContext::DeleteBuffer( m_iFullScreenQuadBufferId );
+	OpenGLContext::DeleteBuffer( m_iFullScreenQuadBufferIdCW );
 }
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -262,13 +281,50 @@ void DeferredRenderer::CreateFBO()
 void DeferredRenderer::LoadEngineShaders()
 {
 	ShaderManager& rShaderManager = ShaderManager::GrabInstance();
+
+	//Permutations of the shared passes
+	const char* pBlurShaderName = "../Data/Shaders/Engine/xml/GaussianBlur.bfx.xml";
+	const char* pDownSampleShaderName = "../Data/Shaders/Engine/xml/DownSample4x4.bfx.xml";
+	unsigned int iBlur10Features = rShaderManager.GetFeatureMask( pBlurShaderName, "TAPS_10" );
+	unsigned int iDownSampleDOFFeatures = rShaderManager.GetFeatureMask( pDownSampleShaderName, "DOF" );
+
+	//Every compile is submitted first, the first AddShader below waits for all of them at once
+	static const char* s_pEngineShaders[] =
+	{
+		"../Data/Shaders/Engine/xml/DirectionalLight.bfx.xml",
+		"../Data/Shaders/Engine/xml/OmniLight.bfx.xml",
+		"../Data/Shaders/Engine/xml/SpotLight.bfx.xml",
+		"../Data/Shaders/Engine/xml/SpotShadow.bfx.xml",
+		"../Data/Shaders/Engine/xml/ExponentialShadowMap.bfx.xml",
+		"../Data/Shaders/Engine/xml/ShadowMap.bfx.xml",
+		"../Data/Shaders/Engine/xml/GaussianBlur.bfx.xml",
+		"../Data/Shaders/Engine/xml/LogGaussianBlur10.bfx.xml",
+		"../Data/Shaders/Engine/xml/DownSample4x4.bfx.xml",
+		"../Data/Shaders/Engine/xml/AvgLumInit.bfx.xml",
+		"../Data/Shaders/Engine/xml/AvgLumFinal.bfx.xml",
+		"../Data/Shaders/Engine/xml/ToneMapping.bfx.xml",
+		"../Data/Shaders/Engine/xml/PostProcess.bfx.xml",
+		"../Data/Shaders/Engine/xml/LightAdaptation.bfx.xml",
+		"../Data/Shaders/Engine/xml/BrightPass.bfx.xml",
+		"../Data/Shaders/Engine/xml/DOF.bfx.xml",
+		"../Data/Shaders/Engine/xml/BasicTexture.bfx.xml",
+		"../Data/Shaders/Engine/xml/SelfIllum.bfx.xml",
+		"../Data/Shaders/Engine/DebugRender/xml/DebugGloss.bfx.xml",
+		"../Data/Shaders/Engine/DebugRender/xml/DebugSpecular.bfx.xml",
+		"../Data/Shaders/Engine/DebugRender/xml/DebugDepth.bfx.xml",
+	};
+	for( unsigned int i = 0; i < sizeof( s_pEngineShaders ) / sizeof( s_pEngineShaders[0] ); ++i )
+	{
+		rShaderManager.RequestShader( s_pEngineShaders[i] );
+	}
+	rShaderManager.RequestShader( pBlurShaderName, iBlur10Features );
+	rShaderManager.RequestShader( pDownSampleShaderName, iDownSampleDOFFeatures );
 	
 	//Directional light shader
 	m_pDirectionalLightShader = rShaderManager.AddShader( "../Data/Shaders/Engine/xml/DirectionalLight.bfx.xml" );
 	m_pDirectionalLightShader->Activate();
 
 	m_pDirectionalLightShader->QueryStdUniforms();
-	m_iDirectionalLightShaderInvProjHandle = glGetUniformLocation( m_pDirectionalLightShader->getHandle(), "mInvProj" );
 
 	m_iDirectionalLightShaderShadowMatrixHandle = glGetUniformLocation( m_pDirectionalLightShader->getHandle(), "mShadowMatrices" );
 	m_iDirectionalLightShaderSphereHandle = glGetUniformLocation( m_pDirectionalLightShader->getHandle(), "vSphere" );
@@ -287,7 +343,6 @@ void DeferredRenderer::LoadEngineShaders()
 	m_pOmniLightShader->Activate();
 
 	m_pOmniLightShader->QueryStdUniforms();
-	m_iOmniLightShaderInvProjHandle = glGetUniformLocation( m_pOmniLightShader->getHandle(), "mInvProj" );
 	
 	m_iOmniLightShaderColorAndInverseRadiusHandle = glGetAttribLocation( m_pOmniLightShader->getHandle(),"vColorAndInverseRadius");
 	m_iOmniLightShaderViewSpacePosAndMultiplierHandle = glGetAttribLocation( m_pOmniLightShader->getHandle(),"vViewSpacePosAndMultiplier");
@@ -302,7 +357,6 @@ void DeferredRenderer::LoadEngineShaders()
 	m_pSpotLightShader->Activate();
 
 	m_pSpotLightShader->QueryStdUniforms();
-	m_iSpotLightShaderInvProjHandle = glGetUniformLocation( m_pSpotLightShader->getHandle(), "mInvProj" );
 	m_iSpotLightShaderColorAndInverseRadiusHandle = glGetAttribLocation( m_pSpotLightShader->getHandle(),"vColorAndInverseRadius");
 	m_iSpotLightShaderViewSpacePosAndMultiplierHandle = glGetAttribLocation( m_pSpotLightShader->getHandle(),"vViewSpacePosAndMultiplier");
 	m_iSpotLightShaderViewSpaceDirHandle = glGetAttribLocation( m_pSpotLightShader->getHandle(),"vViewSpaceDir");
@@ -318,7 +372,6 @@ void DeferredRenderer::LoadEngineShaders()
 	m_pSpotShadowShader->Activate();
 
 	m_pSpotShadowShader->QueryStdUniforms();
-	m_iSpotShadowShaderInvProjHandle = glGetUniformLocation( m_pSpotShadowShader->getHandle(), "mInvProj" );
 	m_iSpotShadowShaderShadowMatrixHandle = glGetUniformLocation( m_pSpotShadowShader->getHandle(), "mShadowMatrix" );
 
 	m_iSpotShadowShaderColorAndInverseRadiusHandle = glGetAttribLocation( m_pSpotShadowShader->getHandle(),"vColorAndInverseRadius");
@@ -344,14 +397,14 @@ void DeferredRenderer::LoadEngineShaders()
 	m_pShadowMapShader->Activate();
 
 	//Blur 6 shader
-	m_pBlur6Shader = rShaderManager.AddShader( "../Data/Shaders/Engine/xml/GaussianBlur6.bfx.xml" );
+	m_pBlur6Shader = rShaderManager.AddShader( pBlurShaderName );
 	m_pBlur6Shader->Activate();
 	m_pBlur6Shader->QueryStdUniforms();
 	m_iBlur6ShaderPixelSizeHandle = glGetUniformLocation( m_pBlur6Shader->getHandle(), "vPixelSize" );
 	m_pBlur6Shader->setUniformTexture("sTexture",0);
 	m_pBlur6Shader->Deactivate();
 
-	m_pDownSample4x4DOF = rShaderManager.AddShader( "../Data/Shaders/Engine/xml/DownSample4x4DOF.bfx.xml" );
+	m_pDownSample4x4DOF = rShaderManager.AddShader( pDownSampleShaderName, iDownSampleDOFFeatures );
 	m_pDownSample4x4DOF->Activate();
 	m_pDownSample4x4DOF->QueryStdUniforms();
 	m_iDownSample4x4DOFPixelSizeHandle = glGetUniformLocation( m_pDownSample4x4DOF->getHandle(), "vPixelSize" );
@@ -360,7 +413,7 @@ void DeferredRenderer::LoadEngineShaders()
 	m_pDownSample4x4DOF->Deactivate();
 
 	//Blur 10 shader
-	m_pBlur10Shader = rShaderManager.AddShader( "../Data/Shaders/Engine/xml/GaussianBlur10.bfx.xml" );
+	m_pBlur10Shader = rShaderManager.AddShader( pBlurShaderName, iBlur10Features );
 	m_pBlur10Shader->Activate();
 	m_pBlur10Shader->QueryStdUniforms();
 	m_iBlur10ShaderPixelSizeHandle = glGetUniformLocation( m_pBlur10Shader->getHandle(), "vPixelSize" );
@@ -376,7 +429,7 @@ void DeferredRenderer::LoadEngineShaders()
 	m_pLogBlur10Shader->Deactivate();
 
 	//Downsample shader
-	m_pDownSample4x4Shader = rShaderManager.AddShader( "../Data/Shaders/Engine/xml/DownSample4x4.bfx.xml" );
+	m_pDownSample4x4Shader = rShaderManager.AddShader( pDownSampleShaderName );
 	m_pDownSample4x4Shader->Activate();
 	m_pDownSample4x4Shader->QueryStdUniforms();
 	m_pDownSample4x4Shader->setUniformTexture("sTexture",0);
@@ -506,26 +559,26 @@ void DeferredRenderer::GenFullScreenQuad()
 	pVertex[2] = vec2( 0.0f, 0.0f );
 	pVertex[3] = vec2( 1.0f, 0.0f );
 
-	glBindBuffer( GL_ARRAY_BUFFER, m_iFullScreenQuadBufferId );
+	OpenGLContext::BindBuffer( GL_ARRAY_BUFFER, m_iFullScreenQuadBufferId );
 
 	glBufferData( GL_ARRAY_BUFFER, 2 * iSizeVertex, 0, GL_STATIC_DRAW );
 	glBufferSubData(GL_ARRAY_BUFFER, 0, iSizeVertex, pVertex );
 	glBufferSubData(GL_ARRAY_BUFFER, iSizeVertex, iSizeVertex, pVertex );
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0 );
+	OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, 0 );
 
 	pVertex[0] = vec2( 1.0f, 1.0f );
 	pVertex[3] = vec2( 0.0f, 1.0f );
 	pVertex[2] = vec2( 0.0f, 0.0f );
 	pVertex[1] = vec2( 1.0f, 0.0f );
 
-	glBindBuffer( GL_ARRAY_BUFFER, m_iFullScreenQuadBufferIdCW );
+	OpenGLContext::BindBuffer( GL_ARRAY_BUFFER, m_iFullScreenQuadBufferIdCW );
 
 	glBufferData( GL_ARRAY_BUFFER, 2 * iSizeVertex, 0, GL_STATIC_DRAW );
 	glBufferSubData(GL_ARRAY_BUFFER, 0, iSizeVertex, pVertex );
 	glBufferSubData(GL_ARRAY_BUFFER, iSizeVertex, iSizeVertex, pVertex );
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0 );
+	OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, 0 );
 
 	delete [] pVertex;
 }
@@ -537,7 +590,7 @@ void DeferredRenderer::DrawFullScreenQuad( int iWindowWidth, int iWindowHeight,
 {
 	glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT );
 	Engine& rEngine = Engine::GrabInstance();
-	glViewport(0,0,iWindowWidth,iWindowHeight);
+	OpenGLContext::Viewport(0,0,iWindowWidth,iWindowHeight);
 	RenderingContext& rRenderContext = rEngine.GrabRenderContext();
 
 	float4x4 oOrthoMatrix = orthoMatrix(0.0, static_cast<float>(iWindowWidth), 0, static_cast<float>(iWindowHeight),-0.2f,0.2f);
@@ -546,11 +599,11 @@ void DeferredRenderer::DrawFullScreenQuad( int iWindowWidth, int iWindowHeight,
 	
 	if( bCCW )
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_iFullScreenQuadBufferId);
+		OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, m_iFullScreenQuadBufferId);
 	}
 	else
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_iFullScreenQuadBufferIdCW);
+		OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, m_iFullScreenQuadBufferIdCW);
 	}
 
 	glEnableClientState( GL_VERTEX_ARRAY );	
@@ -566,7 +619,7 @@ void DeferredRenderer::DrawFullScreenQuad( int iWindowWidth, int iWindowHeight,
 	glDisableClientState(GL_VERTEX_ARRAY);
 	glDisableClientState( GL_TEXTURE_COORD_ARRAY );
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0 );
+	OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, 0 );
 	rRenderContext.PopMVP();
 }
 
@@ -617,7 +670,7 @@ void DeferredRenderer::RenderDirectionalLights( std::vector< SceneLight::SceneLi
 		pDirectionalVertex[i*4+3] = oBottomRight;
 	}
 
-	glBindBuffer(GL_ARRAY_BUFFER, iVertexBufferId);
+	OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, iVertexBufferId);
 	glBufferData(GL_ARRAY_BUFFER, iSizeDirectionalVertex, pDirectionalVertex, GL_STATIC_DRAW);
 
 	glEnableClientState(GL_VERTEX_ARRAY);
@@ -635,9 +688,9 @@ void DeferredRenderer::RenderDirectionalLights( std::vector< SceneLight::SceneLi
 	glDisableVertexAttribArray(m_iDirectionalLightShaderColor);
 	glDisableVertexAttribArray(m_iDirectionalLightShaderViewSpacePosAndMultiplierHandle);
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0 );
+	OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, 0 );
 
-	glDeleteBuffers(1, &iVertexBufferId);
+	OpenGLContext::DeleteBuffer( iVertexBufferId );
 
 	delete [] pDirectionalVertex;
 }
@@ -695,7 +748,7 @@ void DeferredRenderer::RenderOmniLights( std::vector< OmniLight::OmniLightQuad >
 		pOmniVertex[i*4+3] = oBottomRight;
 	}
 	
-	glBindBuffer(GL_ARRAY_BUFFER, iVertexBufferId);
+	OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, iVertexBufferId);
 	glBufferData(GL_ARRAY_BUFFER, iSizeOmniVertex, pOmniVertex, GL_STATIC_DRAW);
 
 	glEnableClientState(GL_VERTEX_ARRAY);
@@ -713,9 +766,9 @@ void DeferredRenderer::RenderOmniLights( std::vector< OmniLight::OmniLightQuad >
 	glDisableVertexAttribArray(m_iOmniLightShaderColorAndInverseRadiusHandle);
 	glDisableVertexAttribArray(m_iOmniLightShaderViewSpacePosAndMultiplierHandle);
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0 );
+	OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, 0 );
 
-	glDeleteBuffers(1, &iVertexBufferId);
+	OpenGLContext::DeleteBuffer( iVertexBufferId );
 
 	delete [] pOmniVertex;
 }
@@ -775,7 +828,7 @@ void DeferredRenderer::RenderSpotLights( std::vector< SpotLight::SpotLightQuad >
 		pOmniVertex[i*4+3] = oBottomRight;
 	}
 	
-	glBindBuffer(GL_ARRAY_BUFFER, iVertexBufferId);
+	OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, iVertexBufferId);
 	glBufferData(GL_ARRAY_BUFFER, iSizeSpotVertex, pOmniVertex, GL_STATIC_DRAW);
 
 	glEnableClientState(GL_VERTEX_ARRAY);
@@ -799,9 +852,9 @@ void DeferredRenderer::RenderSpotLights( std::vector< SpotLight::SpotLightQuad >
 	glDisableVertexAttribArray( iViewSpaceDirHandle );
 	glDisableVertexAttribArray( iCosInAndOutHandle );
 	
-	glBindBuffer(GL_ARRAY_BUFFER, 0 );
+	OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, 0 );
 
-	glDeleteBuffers(1, &iVertexBufferId);
+	OpenGLContext::DeleteBuffer( iVertexBufferId );
 
 	delete [] pOmniVertex;
 
@@ -813,11 +866,11 @@ void DeferredRenderer::RenderSpotLights( std::vector< SpotLight::SpotLightQuad >
 void DeferredRenderer::DrawScreenSpaceQuad( int iWindowWidth, int iWindowHeight, vec3 vData )
 {
 	glPointSize(3);
-	glDisable(GL_CULL_FACE);
+	OpenGLContext::Disable(GL_CULL_FACE);
 	glMatrixMode(GL_PROJECTION);
 	glLoadIdentity();
 	  
-	glViewport(0,0,iWindowWidth,iWindowHeight);
+	OpenGLContext::Viewport(0,0,iWindowWidth,iWindowHeight);
 	glOrtho(0,iWindowWidth,0,iWindowHeight,-0.2,0.2);
 	glMatrixMode(GL_MODELVIEW);
 	glLoadIdentity();
@@ -850,7 +903,7 @@ void DeferredRenderer::DrawScreenSpaceQuad( int iWindowWidth, int iWindowHeight,
 
 	glEnd();
 	
-	glEnable(GL_CULL_FACE);
+	OpenGLContext::Enable(GL_CULL_FACE);
 	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
 }
 
@@ -858,7 +911,7 @@ void DeferredRenderer::DrawFrustum( const vec3 * pPoints, const vec3& f3Pos )
 {
 	glLineWidth( 2.0f );
 	glColor3f(0.0f,1.0f,0.0f);
-	glDisable( GL_DEPTH_TEST );
+	OpenGLContext::Disable( GL_DEPTH_TEST );
 
 	glBegin( GL_LINES );
 	for(unsigned int i = 0; i < 4; ++i)
@@ -881,7 +934,7 @@ void DeferredRenderer::DrawFrustum( const vec3 * pPoints, const vec3& f3Pos )
 
 	glEnd();
 
-	glEnable( GL_DEPTH_TEST );
+	OpenGLContext::Enable( GL_DEPTH_TEST );
 }
 
 void DeferredRenderer::DrawCube( const vec3 * pPoints )
@@ -938,27 +991,29 @@ void DeferredRenderer::DisplayText( const std::string& sText, int iPosX, int iPo
 	glMatrixMode(GL_PROJECTION);
 	glLoadIdentity();
 	  
-	glViewport(0,0,iWindowWidth,iWindowHeight);
+	OpenGLContext::Viewport(0,0,iWindowWidth,iWindowHeight);
 	glOrtho(0,iWindowWidth,iWindowHeight,0,-0.2,0.2);
 	glMatrixMode(GL_MODELVIEW);
 	glLoadIdentity();
 
-	glDisable(GL_CULL_FACE);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glDisable(GL_DEPTH_TEST);
+	OpenGLContext::Disable(GL_CULL_FACE);
+	OpenGLContext::Enable(GL_BLEND);
+	OpenGLContext::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	OpenGLContext::Disable(GL_DEPTH_TEST);
 
-	glActiveTexture( GL_TEXTURE0 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 	glEnable(GL_TEXTURE_2D);
 	glColor3f(1.0f, 1.0f, 1.0f);
 
 	oFont->Begin();
 	oFont->TextOut( sText, iPosX, iPosY, 0);
+	//The font binds its texture by itself
+	OpenGLContext::InvalidateState();
 	glDisable(GL_TEXTURE_2D);
 	Texture2D::Deactivate();
-	glDisable(GL_BLEND);
-	glEnable(GL_CULL_FACE);
-	glEnable(GL_DEPTH_TEST);
+	OpenGLContext::Disable(GL_BLEND);
+	OpenGLContext::Enable(GL_CULL_FACE);
+	OpenGLContext::Enable(GL_DEPTH_TEST);
 }
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -1307,7 +1362,7 @@ void DeferredRenderer::RenderCascadedShadowMap( const std::vector< SceneMesh* >&
 	m_pDirectionalShadowLight->ActivateBuffer();
 	
 	glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
-	glCullFace( GL_FRONT );
+	OpenGLContext::CullFace( GL_FRONT );
 	m_pShadowMapShader->Activate();
 	rRenderContext.SetCurrentShader(m_pShadowMapShader);
 	for( unsigned int i = 0; i < DirectionalLight::iCascadeCount; ++i )
@@ -1339,13 +1394,15 @@ void DeferredRenderer::RenderCascadedShadowMap( const std::vector< SceneMesh* >&
 		vWorldOrigin2 *= DirectionalLight::iShadowMapSize * 0.5f;
 		m_pDirectionalShadowLight->SetMatrix( mLightViewProjection, i );
 		
-		glViewport(x,y,DirectionalLight::iShadowMapSize,DirectionalLight::iShadowMapSize);
+		OpenGLContext::Viewport(x,y,DirectionalLight::iShadowMapSize,DirectionalLight::iShadowMapSize);
 
 		rRenderContext.PushMVP(mLightViewProjection);
 		rRenderContext.PushModelView(mLightView);
 		Frustum oViewFrustum;
 		oViewFrustum.loadFrustum( transpose(mLightViewProjection) );
 
+		//The whole cascade in one submission
+		m_oShadowBatch.Clear();
 		std::vector< SceneMesh* >::const_iterator oShadowMeshIt = oSceneMeshes.begin();
 		while( oShadowMeshIt != oSceneMeshes.end() )
 		{
@@ -1355,18 +1412,21 @@ void DeferredRenderer::RenderCascadedShadowMap( const std::vector< SceneMesh* >&
 
 				if( m_iSkipCulling || oViewFrustum.cubeInFrustum( pBoundingBox[0], pBoundingBox[1],pBoundingBox[2],pBoundingBox[3],pBoundingBox[4],pBoundingBox[5] ) )
 				{
-					(*oShadowMeshIt)->Draw( EffectTechnique::E_RENDER_SHADOW_MAP );
+					(*oShadowMeshIt)->GatherDraws( m_oShadowBatch, IsSubMeshCullingEnabled() );
 				}
 			}
 			++oShadowMeshIt;
 		}
+		m_oShadowBatch.Submit( m_pShadowMapShader );
+		m_iShadowDrawCount += m_oShadowBatch.GetDrawCount();
+		m_iShadowCallCount += m_oShadowBatch.GetSubmittedCallCount();
 		x += DirectionalLight::iShadowMapSize;
 		
 		rRenderContext.PopMVP();
 	}
 	m_pShadowMapShader->Deactivate();
 	m_pDirectionalShadowLight->DeactivateBuffer();
-	glCullFace( GL_BACK );
+	OpenGLContext::CullFace( GL_BACK );
 }
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -1390,7 +1450,7 @@ void DeferredRenderer::RenderShadowMaps( const std::vector< SceneMesh* >& oScene
 
 		float fRadius = pSpot->GetRadius();
 
-		glViewport(0,0,SpotShadow::iShadowMapSize,SpotShadow::iShadowMapSize);
+		OpenGLContext::Viewport(0,0,SpotShadow::iShadowMapSize,SpotShadow::iShadowMapSize);
 		float4x4 mLightProjection = transpose(GlperspectiveMatrix( 2.0f * acosf( pSpot->GetCosOuterAngle()  ) * RAD_TO_DEG, 1.0f,0.5, fRadius ));
 		float4x4 mLightView = rotateXY( -vLightRotation.x*DEG_TO_RAD, -vLightRotation.y*DEG_TO_RAD ) * translate( -vLightPos.x, -vLightPos.y, -vLightPos.z );
 		
@@ -1412,6 +1472,7 @@ void DeferredRenderer::RenderShadowMaps( const std::vector< SceneMesh* >& oScene
 		glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 		glClearColor( 0.0f,0.0f,0.0f,0.0f );
 
+		m_oShadowBatch.Clear();
 		std::vector< SceneMesh* >::const_iterator oShadowMeshIt = oSceneMeshes.begin();
 		while( oShadowMeshIt != oSceneMeshes.end() )
 		{			
@@ -1421,11 +1482,14 @@ void DeferredRenderer::RenderShadowMaps( const std::vector< SceneMesh* >& oScene
 
 				if( m_iSkipCulling || oViewFrustum.cubeInFrustum( pBoundingBox[0], pBoundingBox[1],pBoundingBox[2],pBoundingBox[3],pBoundingBox[4],pBoundingBox[5] ) )
 				{
-					(*oShadowMeshIt)->Draw( EffectTechnique::E_RENDER_SHADOW_MAP );
+					(*oShadowMeshIt)->GatherDraws( m_oShadowBatch, IsSubMeshCullingEnabled() );
 				}
 			}
 			++oShadowMeshIt;
 		}
+		m_oShadowBatch.Submit( m_pExponentialShadowMapShader );
+		m_iShadowDrawCount += m_oShadowBatch.GetDrawCount();
+		m_iShadowCallCount += m_oShadowBatch.GetSubmittedCallCount();
 
 		rRenderContext.PopModelView();
 		rRenderContext.PopMVP();
@@ -1477,7 +1541,7 @@ void DeferredRenderer::ComputeAvgLum()
 	//Downsampling HDR Scene
 	m_pDownSampledSceneBuffer->Activate();
 
-	glActiveTexture( GL_TEXTURE0 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 	m_pHDRSceneBuffer->ActivateTexture();
 	
 	m_pDownSample4x4Shader->Activate();
@@ -1548,9 +1612,9 @@ void DeferredRenderer::ComputeAvgLum()
 	m_pLightAdaptationShader->setUniform2fv( m_iAdaptationShaderTimeHandle, 1, fTimes );
 
 	m_p1x1LumBuffer->ActivateTexture();
-	glActiveTexture( GL_TEXTURE1 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE1 );
 	m_pLastAdaptationBuffer->ActivateTexture();
-	glActiveTexture( GL_TEXTURE0 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 
 	DrawFullScreenQuad( 1, 1 );
 	m_pCurrentAdaptationBuffer->Deactivate();
@@ -1572,7 +1636,7 @@ void DeferredRenderer::ComputeAvgLum()
 	m_pBrightPassShader->setUniform3fv( m_iBrightPassShaderThresholdOffsetKeyHandle, 1, pBrightPassUniforms);
 
 	m_pHDRSceneBuffer->ActivateTexture();
-	glActiveTexture( GL_TEXTURE1 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE1 );
 	m_pLastAdaptationBuffer->ActivateTexture();
 	
 	DrawFullScreenQuad( iWindowWidth/GLOW_RATIO, iWindowHeight/GLOW_RATIO );
@@ -1581,7 +1645,7 @@ void DeferredRenderer::ComputeAvgLum()
 	//Blur
 	m_pBrightPass2Buffer->Activate();
 
-	glActiveTexture( GL_TEXTURE0 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 	m_pBrightPass1Buffer->ActivateTexture();
 
 	m_pBlur10Shader->Activate();
@@ -1719,6 +1783,28 @@ void DeferredRenderer::Render()
 	float4x4 mViewProjection = transpose(mProjection) * mView;
 	float4x4 mInvViewProjection = !mViewProjection;
 
+	//Values of the frame shared by all the shaders, the draws only set their own transform
+	TimerContext const& rTimeContext = rEngine.GetTimeContext();
+	rRenderContext.GrabFrameConstants().Update( mView, mProjection, rCamera.GetPos(), rCamera.GetDofParams(),
+		iWindowWidth, iWindowHeight, rTimeContext.GetElapsedTime(), rTimeContext.GetScaledTime() );
+
+	//World matrices of every mesh, the shadow passes also draw the ones out of the view
+	TransformBuffer& rTransformBuffer = rRenderContext.GrabTransformBuffer();
+	rTransformBuffer.Clear();
+	const std::vector< SceneMesh* >& rSceneMeshes = rRenderContext.GetSceneMeshes();
+	for( unsigned int i = 0; i < rSceneMeshes.size(); ++i )
+	{
+		rSceneMeshes[i]->UpdateTransform( rTransformBuffer );
+	}
+	const std::vector< SceneMesh* >& rTransparentSceneMeshes = rRenderContext.GetTransparentSceneMeshes();
+	for( unsigned int i = 0; i < rTransparentSceneMeshes.size(); ++i )
+	{
+		rTransparentSceneMeshes[i]->UpdateTransform( rTransformBuffer );
+	}
+	rTransformBuffer.Upload();
+	m_iShadowDrawCount = 0;
+	m_iShadowCallCount = 0;
+
 	Frustum oViewFrustum;
 	oViewFrustum.loadFrustum( transpose(mViewProjection) );
 
@@ -1731,8 +1817,13 @@ void DeferredRenderer::Render()
 	const SkyBox* pSkyBox = rRenderContext.GetSkyBox();
 	
 	//Frustum culling
+	Profiler& rProfiler = Profiler::GrabInstance();
+	rProfiler.Begin( E_PROFILE_CULLING );
 	GetVisibleObjects( rRenderContext, oViewFrustum, mView, oSceneMeshes, oTransparentSceneMeshes, oOmniLights, oSpotLights, oSpotShadows );
+	rProfiler.End( E_PROFILE_CULLING );
 
+	//The CPU side of the draws, the shadow maps and the geometry passes
+	rProfiler.Begin( E_PROFILE_SUBMISSION );
 	if(!rRenderContext.GetDirectionalLights().empty())
 	{
 		if( !m_pDirectionalShadowLight )
@@ -1748,7 +1839,7 @@ void DeferredRenderer::Render()
 
 	RenderShadowMaps( rRenderContext.GetSceneMeshes(),oSpotShadows,rHardwareRenderContext );
 
-	glViewport(0,0,iWindowWidth,iWindowHeight);
+	OpenGLContext::Viewport(0,0,iWindowWidth,iWindowHeight);
 	rRenderContext.PushMVP(mViewProjection);
 	rRenderContext.PushModelView(mView);
 	//GBuffer pass
@@ -1759,13 +1850,18 @@ void DeferredRenderer::Render()
 	std::vector< SceneMesh* >::const_iterator oMeshIt = oSceneMeshes.begin();
 	while( oMeshIt != oSceneMeshes.end() )
 	{
-		(*oMeshIt)->Draw( EffectTechnique::E_RENDER_GBUFFER );
+		(*oMeshIt)->Draw( EffectTechnique::E_RENDER_GBUFFER, IsSubMeshCullingEnabled(), &rCamera.GetPos() );
 		++oMeshIt;
 	}
+	EffectTechnique::DeactivateCurrent();
+	//The meshes of a page are drawn without binding it again, the arrays are released once per pass
+	MeshManager::GrabInstance().GrabGeometryPool().Unbind();
 	
 	m_pGBuffer->Deactivate();
+	rProfiler.End( E_PROFILE_SUBMISSION );
 	
 	//Lighting pass
+	rProfiler.Begin( E_PROFILE_LIGHTS );
 
 	//creates one quad per omni light
 	PrepareOmniLights( oOmniLights, rCamera, mView, mViewProjection );
@@ -1773,24 +1869,25 @@ void DeferredRenderer::Render()
 	PrepareDirectionalLights( rRenderContext.GetDirectionalLights(), rCamera, mView );
 	//creates one quad per spot light
 	PrepareSpotLights( oSpotLights, rCamera, mView, mViewProjection );
+	rProfiler.End( E_PROFILE_LIGHTS );
 
 	//enable blending in order to add all the light contributions
 	
-	glEnable(GL_BLEND);
-	glBlendFunc( GL_ONE, GL_ONE );
-	glDisable( GL_DEPTH_TEST );
+	OpenGLContext::Enable(GL_BLEND);
+	OpenGLContext::BlendFunc( GL_ONE, GL_ONE );
+	OpenGLContext::Disable( GL_DEPTH_TEST );
 
-	glActiveTexture( GL_TEXTURE0 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 	m_pGBuffer->ActivateTexture(0);
-	glActiveTexture( GL_TEXTURE1 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE1 );
 	m_pGBuffer->ActivateDepthTexture();
-	glActiveTexture( GL_TEXTURE0 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 
 	m_pLightBuffer->Activate();
 	
 	glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 
-	glViewport(0,0,iWindowWidth,iWindowHeight);
+	OpenGLContext::Viewport(0,0,iWindowWidth,iWindowHeight);
 	float4x4 oOrthoMatrix = orthoMatrix(0.0, static_cast<float>(iWindowWidth), 0, static_cast<float>(iWindowHeight),-0.2f,0.2f);
 	rRenderContext.PushMVP(oOrthoMatrix);
 
@@ -1798,9 +1895,8 @@ void DeferredRenderer::Render()
 	{
 		m_pDirectionalLightShader->Activate();
 		m_pDirectionalLightShader->CommitStdUniforms();
-		m_pDirectionalLightShader->setUniformMatrix4fv( m_iDirectionalLightShaderInvProjHandle, mInvProjection );
 		
-		glActiveTexture( GL_TEXTURE2 );
+		OpenGLContext::ActiveTexture( GL_TEXTURE2 );
 		m_pDirectionalShadowLight->ActivateDepthTexture();
 		float pMatrices[ 16 * DirectionalLight::iCascadeCount ];
 		for( unsigned int i = 0; i < DirectionalLight::iCascadeCount; ++i)
@@ -1824,7 +1920,6 @@ void DeferredRenderer::Render()
 	{
 		m_pOmniLightShader->Activate();
 		m_pOmniLightShader->CommitStdUniforms();
-		m_pOmniLightShader->setUniformMatrix4fv( m_iOmniLightShaderInvProjHandle, mInvProjection );
 
 		RenderOmniLights( m_vOmniLightQuads );
 		
@@ -1836,7 +1931,6 @@ void DeferredRenderer::Render()
 	{
 		m_pSpotLightShader->Activate();
 		m_pSpotLightShader->CommitStdUniforms();
-		m_pSpotLightShader->setUniformMatrix4fv( m_iSpotLightShaderInvProjHandle, mInvProjection );
 		RenderSpotLights( m_vSpotLightQuads, m_iSpotLightShaderColorAndInverseRadiusHandle, m_iSpotLightShaderViewSpacePosAndMultiplierHandle, m_iSpotLightShaderViewSpaceDirHandle, m_iSpotLightShaderCosInAndOutHandle );
 		m_pSpotLightShader->Deactivate();
 	}
@@ -1845,9 +1939,8 @@ void DeferredRenderer::Render()
 	{
 		m_pSpotShadowShader->Activate();
 		m_pSpotShadowShader->CommitStdUniforms();
-		m_pSpotShadowShader->setUniformMatrix4fv( m_iSpotShadowShaderInvProjHandle, mInvProjection );
 
-		glActiveTexture( GL_TEXTURE2 );
+		OpenGLContext::ActiveTexture( GL_TEXTURE2 );
 	
 		PrepareAndRenderSpotShadows( oSpotShadows, rCamera, mView, mViewProjection );
 		m_pSpotShadowShader->Deactivate();	
@@ -1859,22 +1952,22 @@ void DeferredRenderer::Render()
 
 	rRenderContext.PopMVP();
 
-	glActiveTexture( GL_TEXTURE0 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 	Texture2D::Deactivate();
-	glActiveTexture( GL_TEXTURE1 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE1 );
 	Texture2D::Deactivate();
-	glActiveTexture( GL_TEXTURE0 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 
-	glDisable(GL_BLEND);
-	glEnable( GL_DEPTH_TEST );
+	OpenGLContext::Disable(GL_BLEND);
+	OpenGLContext::Enable( GL_DEPTH_TEST );
 
 	//Material pass
 	//The material pass needs to fetch the light buffer
-	glActiveTexture( GL_TEXTURE6 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE6 );
 	m_pLightBuffer->ActivateTexture();
 	
 	//Restoring perspective view
-	glViewport(0,0,iWindowWidth,iWindowHeight);
+	OpenGLContext::Viewport(0,0,iWindowWidth,iWindowHeight);
 	
 	m_pHDRSceneBuffer->Activate();
 	
@@ -1884,12 +1977,15 @@ void DeferredRenderer::Render()
 	glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 	
 	//rendering opaque objects
+	rProfiler.Begin( E_PROFILE_SUBMISSION );
 	oMeshIt = oSceneMeshes.begin();	
 	while( oMeshIt != oSceneMeshes.end() )
 	{
-		(*oMeshIt)->Draw( EffectTechnique::E_RENDER_OPAQUE );
+		(*oMeshIt)->Draw( EffectTechnique::E_RENDER_OPAQUE, IsSubMeshCullingEnabled(), &rCamera.GetPos() );
 		++oMeshIt;
 	}
+	EffectTechnique::DeactivateCurrent();
+	MeshManager::GrabInstance().GrabGeometryPool().Unbind();
 	
 	if( pSkyBox )
 	{
@@ -1898,32 +1994,35 @@ void DeferredRenderer::Render()
 
 	//rendering transparent objects
 	
-	glEnableIndexedEXT( GL_BLEND, 0 );
-	glDepthMask( GL_FALSE );
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	OpenGLContext::EnableIndexed( GL_BLEND, 0 );
+	OpenGLContext::DepthMask( GL_FALSE );
+	OpenGLContext::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	
 	oMeshIt = oTransparentSceneMeshes.begin();
-	glCullFace( GL_FRONT );
+	OpenGLContext::CullFace( GL_FRONT );
 	while( oMeshIt != oTransparentSceneMeshes.end() )
 	{
-		(*oMeshIt)->Draw( EffectTechnique::E_RENDER_TRANSPARENCY );
+		(*oMeshIt)->Draw( EffectTechnique::E_RENDER_TRANSPARENCY, IsSubMeshCullingEnabled() );
 		++oMeshIt;
 	}
 
 	oMeshIt = oTransparentSceneMeshes.begin();
-	glCullFace( GL_BACK );
+	OpenGLContext::CullFace( GL_BACK );
 	while( oMeshIt != oTransparentSceneMeshes.end() )
 	{
-		(*oMeshIt)->Draw( EffectTechnique::E_RENDER_TRANSPARENCY );
+		(*oMeshIt)->Draw( EffectTechnique::E_RENDER_TRANSPARENCY, IsSubMeshCullingEnabled() );
 		++oMeshIt;
 	}
+	EffectTechnique::DeactivateCurrent();
+	MeshManager::GrabInstance().GrabGeometryPool().Unbind();
+	rProfiler.End( E_PROFILE_SUBMISSION );
 
 	
 	//------------------ Draw particle
 	ParticleRenderer& rParticleRenderer = rRenderContext.GrabParticleRenderer();
 	if (rParticleRenderer.GrabBatchs().empty() == false)
 	{
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+		OpenGLContext::BlendFunc(GL_SRC_ALPHA, GL_ONE);
 		///Hack for now, retrive shader directly
 		ShaderManager& rShaderManager = ShaderManager::GrabInstance();
 		Shader* pParticleShader = rShaderManager.GetShader("../Data/Shaders/Material/xml/BasicParticle.bfx.xml");
@@ -1968,14 +2067,14 @@ void DeferredRenderer::Render()
 	}
 	//------------------ End particle
 	
-	glDepthMask( GL_TRUE );
-	glDisableIndexedEXT( GL_BLEND, 0 );
+	OpenGLContext::DepthMask( GL_TRUE );
+	OpenGLContext::DisableIndexed( GL_BLEND, 0 );
 	
 	glDrawBuffers(1, buffers);
 
-	glActiveTexture( GL_TEXTURE6 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE6 );
 	Texture2D::Deactivate();
-	glActiveTexture( GL_TEXTURE0 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 	Texture2D::Deactivate();
 	m_pHDRSceneBuffer->Deactivate();
 	rRenderContext.PopMVP();
@@ -1988,7 +2087,7 @@ void DeferredRenderer::Render()
 	m_pToneMappingShader->setUniformf( m_iToneMappingShaderKeyHandle, m_fToneMappingKey );
 	
 	m_pHDRSceneBuffer->ActivateTexture();
-	glActiveTexture( GL_TEXTURE1 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE1 );
 	m_pLastAdaptationBuffer->ActivateTexture();
 
 	m_pLDRSceneBuffer->Activate();
@@ -1997,7 +2096,7 @@ void DeferredRenderer::Render()
 
 	m_pToneMappingShader->Deactivate();
 	Texture2D::Deactivate();
-	glActiveTexture( GL_TEXTURE0 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 	Texture2D::Deactivate();
 	
 	//Post process: bloom, color correction, fxaa
@@ -2008,13 +2107,13 @@ void DeferredRenderer::Render()
 	m_pPostProcessShader->setUniformi( glGetUniformLocation( m_pPostProcessShader->getHandle(), "iDebug" ), m_iDebugFlag );
 	m_pLDRSceneBuffer->ActivateTexture();
 
-	glActiveTexture( GL_TEXTURE1 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE1 );
 	m_pBrightPass1Buffer->ActivateTexture();
 
-	glActiveTexture( GL_TEXTURE2 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE2 );
 	m_pHDRSceneBuffer->ActivateTexture(1);
 
-	glActiveTexture( GL_TEXTURE3 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE3 );
 	m_pColorLUT->Activate();
 
 	m_pLDRSceneBuffer2->Activate();
@@ -2024,16 +2123,16 @@ void DeferredRenderer::Render()
 	m_pPostProcessShader->Deactivate();
 	
 	Texture3D::Deactivate();
-	glActiveTexture( GL_TEXTURE2 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE2 );
 	Texture2D::Deactivate();
-	glActiveTexture( GL_TEXTURE1 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE1 );
 	Texture2D::Deactivate();
-	glActiveTexture( GL_TEXTURE0 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 	Texture2D::Deactivate();
 
 	//Downsampling scene for DOF
 	m_pLDRSceneBuffer2->ActivateTexture();
-	glActiveTexture( GL_TEXTURE1 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE1 );
 	m_pHDRSceneBuffer->ActivateTexture(1);
 	
 	m_pDOFBlur1Buffer->Activate();
@@ -2044,7 +2143,7 @@ void DeferredRenderer::Render()
 	DrawFullScreenQuad( iWindowWidth/2, iWindowHeight/2);
 	
 	Texture2D::Deactivate();
-	glActiveTexture( GL_TEXTURE0 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 	m_pDownSample4x4DOF->Deactivate();
 	m_pDOFBlur1Buffer->Deactivate();
 
@@ -2072,16 +2171,16 @@ void DeferredRenderer::Render()
 	
 	m_pDOFShader->Activate();
 	rRenderContext.SetCurrentShader(m_pDOFShader);
-	glActiveTexture( GL_TEXTURE0 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 	m_pLDRSceneBuffer2->ActivateTexture();
-	glActiveTexture( GL_TEXTURE1 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE1 );
 	m_pDOFBlur1Buffer->ActivateTexture();
 
 	DrawFullScreenQuad( iWindowWidth, iWindowHeight );
 
 	Texture2D::Deactivate();
 
-	glActiveTexture( GL_TEXTURE0 );
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 	Texture2D::Deactivate();
 
 	m_pDOFShader->Deactivate();
@@ -2121,6 +2220,14 @@ void DeferredRenderer::Render()
 		std::stringstream o3DObjectStream;
 		o3DObjectStream << "Displaying " << oSceneMeshes.size() + oTransparentSceneMeshes.size() << " of " << m_iObjectCount << " 3D object(s).";
 		DisplayText( o3DObjectStream.str(), iWindowWidth - PROFILING_LEFT_OFFSET, 170, m_pFont );
+
+		std::stringstream oStateStream;
+		oStateStream << "GL state: " << OpenGLContext::GetIssuedStateCallCount() << " call(s), " << OpenGLContext::GetAvoidedStateCallCount() << " avoided.";
+		DisplayText( oStateStream.str(), iWindowWidth - PROFILING_LEFT_OFFSET, 190, m_pFont );
+
+		std::stringstream oShadowStream;
+		oShadowStream << "Shadow maps: " << m_iShadowDrawCount << " range(s) in " << m_iShadowCallCount << ( DrawBatch::IsIndirectSupported() ? " indirect" : "" ) << " draw call(s).";
+		DisplayText( oShadowStream.str(), iWindowWidth - PROFILING_LEFT_OFFSET, 210, m_pFont );
 		
 		DisplayDebugMenu();
 	}
@@ -2136,7 +2243,7 @@ void DeferredRenderer::DebugRender( const std::vector< SceneMesh* >& oSceneMeshe
 	OpenGLContext& rHardwareRenderContext = rEngine.GrabRenderingContext();
 	AbstractCamera & rCamera = rEngine.GetCurrentCamera();
 	
-	glViewport(0,0,iWindowWidth,iWindowHeight);
+	OpenGLContext::Viewport(0,0,iWindowWidth,iWindowHeight);
 
 	glClear( GL_DEPTH_BUFFER_BIT );
 
@@ -2256,7 +2363,7 @@ void DeferredRenderer::DebugRender( const std::vector< SceneMesh* >& oSceneMeshe
 
 	if( m_iDebugRender == 1 )
 	{
-		glActiveTexture( GL_TEXTURE0 );
+		OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 		m_pGBuffer->ActivateTexture();
 		m_pBasicTextureShader->Activate();
 		rRenderContext.SetCurrentShader(m_pBasicTextureShader);
@@ -2265,7 +2372,7 @@ void DeferredRenderer::DebugRender( const std::vector< SceneMesh* >& oSceneMeshe
 	}
 	else if( m_iDebugRender == 2 )
 	{
-		glActiveTexture( GL_TEXTURE0 );
+		OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 		m_pGBuffer->ActivateTexture();
 		m_pDebugGlossShader->Activate();
 		rRenderContext.SetCurrentShader(m_pDebugGlossShader);
@@ -2274,7 +2381,7 @@ void DeferredRenderer::DebugRender( const std::vector< SceneMesh* >& oSceneMeshe
 	}
 	else if( m_iDebugRender == 3 )
 	{
-		glActiveTexture( GL_TEXTURE0 );
+		OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 		m_pLightBuffer->ActivateTexture();
 		m_pBasicTextureShader->Activate();
 		rRenderContext.SetCurrentShader(m_pBasicTextureShader);
@@ -2283,7 +2390,7 @@ void DeferredRenderer::DebugRender( const std::vector< SceneMesh* >& oSceneMeshe
 	}
 	else if( m_iDebugRender == 4 )
 	{
-		glActiveTexture( GL_TEXTURE0 );
+		OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 		m_pLightBuffer->ActivateTexture();
 		m_pDebugSpecularShader->Activate();
 		rRenderContext.SetCurrentShader(m_pDebugSpecularShader);
@@ -2292,7 +2399,7 @@ void DeferredRenderer::DebugRender( const std::vector< SceneMesh* >& oSceneMeshe
 	}
 	else if( m_iDebugRender == 5 )
 	{
-		glActiveTexture( GL_TEXTURE0 );
+		OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 		m_pHDRSceneBuffer->ActivateTexture();
 		m_pBasicTextureShader->Activate();
 		rRenderContext.SetCurrentShader(m_pBasicTextureShader);
@@ -2301,7 +2408,7 @@ void DeferredRenderer::DebugRender( const std::vector< SceneMesh* >& oSceneMeshe
 	}
 	else if( m_iDebugRender == 6 )
 	{
-		glActiveTexture( GL_TEXTURE0 );
+		OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 		m_pBrightPass1Buffer->ActivateTexture();
 		m_pBasicTextureShader->Activate();
 		rRenderContext.SetCurrentShader(m_pBasicTextureShader);
@@ -2310,7 +2417,7 @@ void DeferredRenderer::DebugRender( const std::vector< SceneMesh* >& oSceneMeshe
 	}
 	else if( m_iDebugRender == 7 )
 	{
-		glActiveTexture( GL_TEXTURE0 );
+		OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 		m_pGBuffer->ActivateDepthTexture();
 		m_pDebugDepthShader->Activate();
 		rRenderContext.SetCurrentShader(m_pDebugDepthShader);
@@ -2319,7 +2426,7 @@ void DeferredRenderer::DebugRender( const std::vector< SceneMesh* >& oSceneMeshe
 	}
 	else if( m_iDebugRender == 8 && m_pDirectionalShadowLight )
 	{
-		glActiveTexture( GL_TEXTURE0 );
+		OpenGLContext::ActiveTexture( GL_TEXTURE0 );
 		m_pDirectionalShadowLight->ActivateDepthTexture();
 		m_pBasicTextureShader->Activate();
 		rRenderContext.SetCurrentShader(m_pBasicTextureShader);
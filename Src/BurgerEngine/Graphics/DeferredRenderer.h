@@ -20,6 +20,7 @@
 #include "BurgerEngine/Graphics/SpotShadow.h"
 #include "BurgerEngine/Graphics/SceneMesh.h"
 #include "BurgerEngine/Graphics/ParticleRenderer.h"
+#include "BurgerEngine/Graphics/DrawBatch.h"
 
 #include "BurgerEngine/External/Math/Vector.h"
 
@@ -53,6 +54,9 @@ public:
 
 	void SetPostProcessParameters( float fToneMappingKey, float fGlowMultiplier, float fBrightPassThreshold, float fBrightPassOffset, float fAdaptationBaseTime, const char* pColorLUT );
 
+	/// \brief Drop what the renderer keeps of a light removed from the scene
+	void ForgetLight( SceneLight const& rLight );
+
 	/// \brief strats rendering process
 	void Render();
 
@@ -106,6 +110,9 @@ private:
 
 	void DebugRender( const std::vector< SceneMesh* >& oSceneMeshes,  const std::vector< SceneMesh* >& oTransparentSceneMeshes, const std::vector< SpotShadow* >& oSpotShadows, const std::vector< SpotLight* >& oSpotLights );
 
+	/// \brief Parts and clusters culling is done inside the meshes, on top of the per object culling
+	bool IsSubMeshCullingEnabled() const { return !m_iSkipCulling && !m_iSkipSubMeshCulling; }
+
 	/// \brief Do frustum culling test on meshes and lights
 	void GetVisibleObjects( RenderingContext& rRenderContext, const Frustum& oViewFrustum, const float4x4& mView, std::vector< SceneMesh* >& oVisibleSceneMeshes, std::vector< SceneMesh* >& oVisibleTransparentSceneMeshes, std::vector< OmniLight* >& oVisibleOmniLights, std::vector< SpotLight* >& oVisibleSpotLights, std::vector< SpotShadow* >& oVisibleSpotShadows );
 
@@ -139,6 +146,7 @@ private:
 	int				m_iDebugRender;
 	bool			m_bShowDebugMenu;
 	int				m_iSkipCulling;
+	int				m_iSkipSubMeshCulling;
 	int				m_iDebugBoundingBox;
 	int				m_iDebugSpotLightFrustum;
 
@@ -148,6 +156,11 @@ private:
 	unsigned int	m_iSpotShadowCount;
 	unsigned int	m_iDirectionalCount;
 
+	/// Every range the shadow passes draw goes in it, materials do not matter there
+	DrawBatch		m_oShadowBatch;
+	unsigned int	m_iShadowDrawCount;
+	unsigned int	m_iShadowCallCount;
+
 	//Fonts used to display text on screen
 	PixelPerfectGLFont* m_pFont;
 	PixelPerfectGLFont* m_pFont2;
@@ -159,26 +172,22 @@ private:
 
 	//Shader pointers and handles for uniform variables
 	Shader*			m_pDirectionalLightShader;
-	unsigned int	m_iDirectionalLightShaderInvProjHandle;
 	unsigned int	m_iDirectionalLightShaderColor;
 	unsigned int	m_iDirectionalLightShaderViewSpacePosAndMultiplierHandle;
 	unsigned int	m_iDirectionalLightShaderShadowMatrixHandle;
 	unsigned int	m_iDirectionalLightShaderSphereHandle;
 
 	Shader*			m_pOmniLightShader;
-	unsigned int	m_iOmniLightShaderInvProjHandle;
 	unsigned int	m_iOmniLightShaderColorAndInverseRadiusHandle;
 	unsigned int	m_iOmniLightShaderViewSpacePosAndMultiplierHandle;
 
 	Shader*			m_pSpotLightShader;
-	unsigned int	m_iSpotLightShaderInvProjHandle;
 	unsigned int	m_iSpotLightShaderColorAndInverseRadiusHandle;
 	unsigned int	m_iSpotLightShaderViewSpacePosAndMultiplierHandle;
 	unsigned int	m_iSpotLightShaderViewSpaceDirHandle;
 	unsigned int	m_iSpotLightShaderCosInAndOutHandle;
 
 	Shader*			m_pSpotShadowShader;
-	unsigned int	m_iSpotShadowShaderInvProjHandle;
 	unsigned int	m_iSpotShadowShaderShadowMatrixHandle;
 	unsigned int	m_iSpotShadowShaderColorAndInverseRadiusHandle;
 	unsigned int	m_iSpotShadowShaderViewSpacePosAndMultiplierHandle;
@@ -0,0 +1,225 @@
+#include "BurgerEngine/Graphics/DrawBatch.h"
+#include "BurgerEngine/Graphics/GeometryPool.h"
+#include "BurgerEngine/Graphics/MeshManager.h"
+#include "BurgerEngine/Graphics/TransformBuffer.h"
+#include "BurgerEngine/Graphics/RenderingContext.h"
+#include "BurgerEngine/Graphics/OpenGLContext.h"
+#include "BurgerEngine/Graphics/ShaderTool.h"
+#include "BurgerEngine/Graphics/Shader.h"
+#include "BurgerEngine/Core/Engine.h"
+
+#include <algorithm>
+
+#ifndef GL_DRAW_INDIRECT_BUFFER
+	#define GL_DRAW_INDIRECT_BUFFER			0x8F3F
+#endif
+
+typedef void (APIENTRY * MultiDrawElementsIndirectFunction)( GLenum eMode, GLenum eType, GLvoid const* pIndirect, GLsizei iDrawCount, GLsizei iStride );
+
+static MultiDrawElementsIndirectFunction	s_pMultiDrawElementsIndirect = NULL;
+
+bool DrawBatch::s_bIndirectSupported = false;
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool DrawBatch::InitializeExtension()
+{
+	s_bIndirectSupported = false;
+
+	//The base instance of the commands is only read with ARB_base_instance, it carries the object index
+	if( !isExtensionSupported( "GL_ARB_multi_draw_indirect" ) || !isExtensionSupported( "GL_ARB_base_instance" ) || !GLEE_ARB_instanced_arrays )
+	{
+		return false;
+	}
+
+	s_pMultiDrawElementsIndirect = (MultiDrawElementsIndirectFunction)getExtensionFunction( "glMultiDrawElementsIndirect" );
+	s_bIndirectSupported = s_pMultiDrawElementsIndirect != NULL;
+	return s_bIndirectSupported;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+DrawBatch::DrawBatch()
+	: m_iCommandBuffer( 0 )
+	, m_iInstanceBuffer( 0 )
+	, m_iInstanceCount( 0 )
+	, m_iSubmittedCalls( 0 )
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+DrawBatch::~DrawBatch()
+{
+	OpenGLContext::DeleteBuffer( m_iCommandBuffer );
+	OpenGLContext::DeleteBuffer( m_iInstanceBuffer );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void DrawBatch::Clear()
+{
+	m_vDraws.clear();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void DrawBatch::Add( unsigned int iPage, unsigned int iFirstIndex, unsigned int iIndexCount, unsigned int iObjectIndex, const float4x4* pWorld )
+{
+	//Contiguous ranges of the same object are merged
+	if( !m_vDraws.empty() )
+	{
+		sDraw& rLast = m_vDraws.back();
+		if( rLast.m_iPage == iPage && rLast.m_iObjectIndex == iObjectIndex && rLast.m_iFirstIndex + rLast.m_iIndexCount == iFirstIndex )
+		{
+			rLast.m_iIndexCount += iIndexCount;
+			return;
+		}
+	}
+
+	sDraw oDraw;
+	oDraw.m_iPage = iPage;
+	oDraw.m_iFirstIndex = iFirstIndex;
+	oDraw.m_iIndexCount = iIndexCount;
+	oDraw.m_iObjectIndex = iObjectIndex;
+	oDraw.m_pWorld = pWorld;
+	m_vDraws.push_back( oDraw );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void DrawBatch::Submit( Shader* pShader )
+{
+	m_iSubmittedCalls = 0;
+	if( m_vDraws.empty() )
+	{
+		return;
+	}
+
+	//Stable, the ranges of an object stay next to each other
+	std::stable_sort( m_vDraws.begin(), m_vDraws.end() );
+
+	//The indirect draws need the object index of the shader, the others get their world matrix from a uniform
+	bool bIndirect = s_bIndirectSupported && TransformBuffer::IsSupported() && pShader->ReadsObjectIndex();
+	GeometryPool& rPool = MeshManager::GrabInstance().GrabGeometryPool();
+
+	if( bIndirect )
+	{
+		//The pass matrices, the objects come from the instance buffer
+		Engine::GrabInstance().GrabRenderContext().SetCurrentObject( 0, NULL );
+		pShader->CommitStdUniforms();
+
+		m_vCommands.resize( m_vDraws.size() );
+		unsigned int iObjectCount = 0;
+		for( unsigned int i = 0; i < m_vDraws.size(); ++i )
+		{
+			sIndirectCommand& rCommand = m_vCommands[i];
+			rCommand.m_iCount = m_vDraws[i].m_iIndexCount;
+			rCommand.m_iInstanceCount = 1;
+			rCommand.m_iFirstIndex = m_vDraws[i].m_iFirstIndex;
+			rCommand.m_iBaseVertex = 0;
+			rCommand.m_iBaseInstance = m_vDraws[i].m_iObjectIndex;
+			iObjectCount = max( iObjectCount, m_vDraws[i].m_iObjectIndex + 1 );
+		}
+
+		if( m_iCommandBuffer == 0 )
+		{
+			glGenBuffers( 1, &m_iCommandBuffer );
+		}
+		OpenGLContext::BindBuffer( GL_DRAW_INDIRECT_BUFFER, m_iCommandBuffer );
+		glBufferData( GL_DRAW_INDIRECT_BUFFER, m_vCommands.size() * sizeof( sIndirectCommand ), &m_vCommands[0], GL_STREAM_DRAW );
+
+		if( m_iInstanceBuffer == 0 )
+		{
+			glGenBuffers( 1, &m_iInstanceBuffer );
+		}
+		OpenGLContext::BindBuffer( GL_ARRAY_BUFFER, m_iInstanceBuffer );
+		if( iObjectCount > m_iInstanceCount )
+		{
+			m_iInstanceCount = max( iObjectCount, m_iInstanceCount + m_iInstanceCount / 2 );
+			std::vector< float > vfInstances( m_iInstanceCount );
+			for( unsigned int i = 0; i < m_iInstanceCount; ++i )
+			{
+				vfInstances[i] = (float)i;
+			}
+			glBufferData( GL_ARRAY_BUFFER, m_iInstanceCount * sizeof( float ), &vfInstances[0], GL_STATIC_DRAW );
+		}
+		glVertexAttribPointerARB( TransformBuffer::s_iObjectIndexAttribute, 1, GL_FLOAT, GL_FALSE, 0, BUFFER_OFFSET( 0 ) );
+		glVertexAttribDivisor( TransformBuffer::s_iObjectIndexAttribute, 1 );
+		glEnableVertexAttribArrayARB( TransformBuffer::s_iObjectIndexAttribute );
+	}
+
+	unsigned int iFirst = 0;
+	while( iFirst < m_vDraws.size() )
+	{
+		unsigned int iEnd = iFirst + 1;
+		while( iEnd < m_vDraws.size() && m_vDraws[iEnd].m_iPage == m_vDraws[iFirst].m_iPage )
+		{
+			++iEnd;
+		}
+
+		rPool.Bind( m_vDraws[iFirst].m_iPage );
+		if( bIndirect )
+		{
+			_SubmitIndirect( iFirst, iEnd );
+		}
+		else
+		{
+			_SubmitMultiDraw( pShader, iFirst, iEnd );
+		}
+		iFirst = iEnd;
+	}
+
+	if( bIndirect )
+	{
+		glDisableVertexAttribArrayARB( TransformBuffer::s_iObjectIndexAttribute );
+		glVertexAttribDivisor( TransformBuffer::s_iObjectIndexAttribute, 0 );
+		OpenGLContext::BindBuffer( GL_DRAW_INDIRECT_BUFFER, 0 );
+	}
+	rPool.Unbind();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void DrawBatch::_SubmitIndirect( unsigned int iFirst, unsigned int iEnd )
+{
+	s_pMultiDrawElementsIndirect( GL_TRIANGLES, GL_UNSIGNED_INT, BUFFER_OFFSET( iFirst * sizeof( sIndirectCommand ) ), (GLsizei)( iEnd - iFirst ), 0 );
+	++m_iSubmittedCalls;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void DrawBatch::_SubmitMultiDraw( Shader* pShader, unsigned int iFirst, unsigned int iEnd )
+{
+	RenderingContext& rRenderContext = Engine::GrabInstance().GrabRenderContext();
+
+	//One call per object, its index or matrix is a uniform
+	while( iFirst < iEnd )
+	{
+		m_viCounts.clear();
+		m_vpOffsets.clear();
+
+		unsigned int iObjectIndex = m_vDraws[iFirst].m_iObjectIndex;
+		rRenderContext.SetCurrentObject( iObjectIndex, m_vDraws[iFirst].m_pWorld );
+		pShader->CommitStdUniforms();
+
+		while( iFirst < iEnd && m_vDraws[iFirst].m_iObjectIndex == iObjectIndex )
+		{
+			m_viCounts.push_back( (GLsizei)m_vDraws[iFirst].m_iIndexCount );
+			m_vpOffsets.push_back( BUFFER_OFFSET( m_vDraws[iFirst].m_iFirstIndex * sizeof( GLuint ) ) );
+			++iFirst;
+		}
+
+		glMultiDrawElements( GL_TRIANGLES, &m_viCounts[0], GL_UNSIGNED_INT, &m_vpOffsets[0], (GLsizei)m_viCounts.size() );
+		++m_iSubmittedCalls;
+	}
+	rRenderContext.SetCurrentObject( 0, NULL );
+}
@@ -0,0 +1,96 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __DRAWBATCH_H__
+#define __DRAWBATCH_H__
+
+#include <vector>
+
+#include "BurgerEngine/Graphics/CommonGraphics.h"
+#include "BurgerEngine/External/Math/Vector.h"
+
+class Shader;
+
+/// \class	DrawBatch
+/// \brief	Index ranges of the GeometryPool gathered for a whole pass, and submitted with the shader already active.
+///			With ARB_multi_draw_indirect every page is drawn by one glMultiDrawElementsIndirect, the object of each
+///			draw comes in its base instance through the object index attribute. Otherwise the ranges of an object
+///			go in one glMultiDrawElements.
+///			The entry points are newer than GLee, they are loaded by InitializeExtension
+class DrawBatch
+{
+public:
+
+	/// \brief Load the entry points, GL thread only
+	static bool InitializeExtension();
+	static bool IsIndirectSupported() { return s_bIndirectSupported; }
+
+	DrawBatch();
+	~DrawBatch();
+
+	/// \brief Forget the draws of the previous pass
+	void Clear();
+
+	/// \brief Add a range of indices of a page
+	/// \param[in] iObjectIndex Index of the object in the TransformBuffer
+	/// \param[in] pWorld World matrix of the object, for the shaders without the TransformBuffer
+	void Add( unsigned int iPage, unsigned int iFirstIndex, unsigned int iIndexCount, unsigned int iObjectIndex, const float4x4* pWorld );
+
+	/// \brief Draw every range with the active shader, grouped by page
+	void Submit( Shader* pShader );
+
+	unsigned int GetDrawCount() const { return (unsigned int)m_vDraws.size(); }
+
+	/// \brief GL calls the last Submit issued to draw the ranges
+	unsigned int GetSubmittedCallCount() const { return m_iSubmittedCalls; }
+
+private:
+
+	/// Layout of ARB_draw_indirect
+	struct sIndirectCommand
+	{
+		GLuint	m_iCount;
+		GLuint	m_iInstanceCount;
+		GLuint	m_iFirstIndex;
+		GLint	m_iBaseVertex;
+		GLuint	m_iBaseInstance;
+	};
+
+	struct sDraw
+	{
+		unsigned int		m_iPage;
+		unsigned int		m_iFirstIndex;
+		unsigned int		m_iIndexCount;
+		unsigned int		m_iObjectIndex;
+		const float4x4*		m_pWorld;
+
+		bool operator<( sDraw const& rOther ) const { return m_iPage < rOther.m_iPage; }
+	};
+
+	void _SubmitIndirect( unsigned int iFirst, unsigned int iEnd );
+	void _SubmitMultiDraw( Shader* pShader, unsigned int iFirst, unsigned int iEnd );
+
+	static bool						s_bIndirectSupported;
+
+	std::vector< sDraw >			m_vDraws;
+	std::vector< sIndirectCommand >	m_vCommands;
+	std::vector< GLsizei >			m_viCounts;
+	std::vector< const GLvoid* >	m_vpOffsets;
+
+	GLuint							m_iCommandBuffer;
+	/// Holds i at i, read with the base instance of a command as its object index
+	GLuint							m_iInstanceBuffer;
+	unsigned int					m_iInstanceCount;
+
+	unsigned int					m_iSubmittedCalls;
+};
+
+#endif //__DRAWBATCH_H__
@@ -1,62 +1,286 @@
 #include "EffectTechnique.h"
 #include "BurgerEngine/Graphics/Shader.h"
 #include "BurgerEngine/Graphics/AbstractTexture.h"
+#include "BurgerEngine/Graphics/OpenGLContext.h"
 #include "BurgerEngine/Graphics/Texture2D.h"
+#include "BurgerEngine/Graphics/UniformBuffer.h"
+#include "BurgerEngine/Graphics/TextureManager.h"
+
+#include <cstring>
+
+const char* EffectTechnique::s_sMaterialBlockName = "MaterialConstants";
+bool EffectTechnique::s_bUniformBufferEnabled = false;
+EffectTechnique* EffectTechnique::s_pCurrentTechnique = NULL;
 
 EffectTechnique::EffectTechnique()
 	: m_pShader( NULL )
+	, m_pUniformBuffer( NULL )
 {
 }
 
 EffectTechnique::~EffectTechnique()
 {
+	if( s_pCurrentTechnique == this )
+	{
+		s_pCurrentTechnique = NULL;
+	}
+	delete m_pUniformBuffer;
+
+	//The textures were taken from the TextureManager when the material was loaded
+	for( unsigned int i = 0; i < m_vTextures.size(); ++i )
+	{
+		TextureManager::GrabInstance().ReleaseTexture( m_vTextures[i].m_pTexture );
+	}
 };
 
-void EffectTechnique::Activate()
+void EffectTechnique::DeactivateCurrent()
+{
+	if( s_pCurrentTechnique )
+	{
+		s_pCurrentTechnique->Deactivate();
+	}
+}
+
+void EffectTechnique::Activate( bool bKeepBound )
 {
+	if( s_pCurrentTechnique == this )
+	{
+		//Already bound, only the matrices change from one draw to the next
+		m_pShader->CommitStdUniforms();
+		if( !bKeepBound )
+		{
+			s_pCurrentTechnique = NULL;
+		}
+		return;
+	}
+
+	if( s_pCurrentTechnique )
+	{
+		//The program is replaced below, only the units this technique does not use are cleared
+		s_pCurrentTechnique->DeactivateTextures( this );
+	}
+	s_pCurrentTechnique = bKeepBound ? this : NULL;
+
 	m_pShader->Activate();
 	ActivateTextures();
 	m_pShader->CommitStdUniforms();
 	CommitUniforms();
 }
 
+void EffectTechnique::Deactivate()
+{
+	if( s_pCurrentTechnique == this )
+	{
+		s_pCurrentTechnique = NULL;
+	}
+	m_pShader->Deactivate();
+	DeactivateTextures();
+}
+
+void EffectTechnique::AddUniformTexture( int iUnit, AbstractTexture* pTexture )
+{
+	for( unsigned int i = 0; i < m_vTextures.size(); ++i )
+	{
+		if( m_vTextures[i].m_iUnit == iUnit )
+		{
+			TextureManager::GrabInstance().ReleaseTexture( m_vTextures[i].m_pTexture );
+			m_vTextures[i].m_pTexture = pTexture;
+			return;
+		}
+	}
+	sTextureBinding oBinding = { iUnit, pTexture, -1 };
+	m_vTextures.push_back( oBinding );
+}
+
+void EffectTechnique::AddUniformFloat( int iUniformLocation, float fValue )
+{
+	for( unsigned int i = 0; i < m_vUniformFloats.size(); ++i )
+	{
+		if( m_vUniformFloats[i].m_iLocation == iUniformLocation )
+		{
+			m_vUniformFloats[i].m_fValue = fValue;
+			return;
+		}
+	}
+	sUniformFloat oUniform = { iUniformLocation, fValue };
+	m_vUniformFloats.push_back( oUniform );
+}
+
+void EffectTechnique::AddUniformVec4( int iUniformLocation, vec4 vValue )
+{
+	for( unsigned int i = 0; i < m_vUniformVec4s.size(); ++i )
+	{
+		if( m_vUniformVec4s[i].m_iLocation == iUniformLocation )
+		{
+			m_vUniformVec4s[i].m_vValue = vValue;
+			return;
+		}
+	}
+	sUniformVec4 oUniform;
+	oUniform.m_iLocation = iUniformLocation;
+	oUniform.m_vValue = vValue;
+	m_vUniformVec4s.push_back( oUniform );
+}
+
 void EffectTechnique::CommitUniforms()
 {
-	std::map< int, float >::iterator FloatIt = m_oUniformFloatsMap.begin();
-	while( FloatIt != m_oUniformFloatsMap.end() )
+	if( m_pUniformBuffer )
+	{
+		m_pUniformBuffer->Bind( s_iMaterialBlockBinding );
+	}
+	for( unsigned int i = 0; i < m_vUniformFloats.size(); ++i )
+	{
+		m_pShader->setUniformf( m_vUniformFloats[i].m_iLocation, m_vUniformFloats[i].m_fValue );
+	}
+	for( unsigned int i = 0; i < m_vUniformVec4s.size(); ++i )
+	{
+		m_pShader->setUniform4fv( m_vUniformVec4s[i].m_iLocation, 1, m_vUniformVec4s[i].m_vValue );
+	}
+}
+
+bool EffectTechnique::ResolveUniforms()
+{
+	if( !m_pShader || !m_pShader->IsReady() )
+	{
+		return false;
+	}
+
+	m_pShader->Activate();
+	for( unsigned int i = 0; i < m_vPendingSamplers.size(); ++i )
+	{
+		m_pShader->setUniformTexture( m_vPendingSamplers[i].first, m_vPendingSamplers[i].second );
+	}
+	for( unsigned int i = 0; i < m_vPendingLayers.size(); ++i )
+	{
+		int iUniformLocation = glGetUniformLocation( m_pShader->getHandle(), m_vPendingLayers[i].first.c_str() );
+		for( unsigned int j = 0; j < m_vTextures.size(); ++j )
+		{
+			if( m_vTextures[j].m_iUnit == m_vPendingLayers[i].second )
+			{
+				m_vTextures[j].m_iLayerLocation = iUniformLocation;
+			}
+		}
+	}
+
+	//The constants declared in the material block leave the lists below
+	if( s_bUniformBufferEnabled && UniformBuffer::IsSupported() )
+	{
+		_BuildUniformBuffer();
+	}
+
+	for( unsigned int i = 0; i < m_vPendingFloats.size(); ++i )
+	{
+		int iUniformLocation = glGetUniformLocation( m_pShader->getHandle(), m_vPendingFloats[i].first.c_str() );
+		AddUniformFloat( iUniformLocation, m_vPendingFloats[i].second );
+	}
+	for( unsigned int i = 0; i < m_vPendingVec4s.size(); ++i )
+	{
+		int iUniformLocation = glGetUniformLocation( m_pShader->getHandle(), m_vPendingVec4s[i].first.c_str() );
+		AddUniformVec4( iUniformLocation, m_vPendingVec4s[i].second );
+	}
+	m_pShader->QueryStdUniforms();
+	m_pShader->Deactivate();
+
+	m_vPendingSamplers.clear();
+	m_vPendingLayers.clear();
+	m_vPendingFloats.clear();
+	m_vPendingVec4s.clear();
+	return true;
+}
+
+void EffectTechnique::_BuildUniformBuffer()
+{
+	GLhandleARB oProgram = m_pShader->getHandle();
+	int iBlockIndex = UniformBuffer::GetBlockIndex( oProgram, s_sMaterialBlockName );
+	if( iBlockIndex < 0 )
+	{
+		return;
+	}
+
+	//Offsets come from the program, whatever the layout of the block
+	std::vector< GLubyte > vData( UniformBuffer::GetBlockSize( oProgram, iBlockIndex ), 0 );
+	std::vector< std::pair< std::string, float > > vOtherFloats;
+	for( unsigned int i = 0; i < m_vPendingFloats.size(); ++i )
 	{
-		m_pShader->setUniformf( (*FloatIt).first, (*FloatIt).second );
-		++FloatIt;
+		int iOffset = UniformBuffer::GetUniformOffset( oProgram, m_vPendingFloats[i].first.c_str() );
+		if( iOffset >= 0 && iOffset + sizeof( float ) <= vData.size() )
+		{
+			memcpy( &vData[ iOffset ], &m_vPendingFloats[i].second, sizeof( float ) );
+		}
+		else
+		{
+			vOtherFloats.push_back( m_vPendingFloats[i] );
+		}
 	}
-	std::map< int, vec4 >::iterator Vec4It = m_oUniformVec4Map.begin();
-	while( Vec4It != m_oUniformVec4Map.end() )
+	std::vector< std::pair< std::string, vec4 > > vOtherVec4s;
+	for( unsigned int i = 0; i < m_vPendingVec4s.size(); ++i )
 	{
-		m_pShader->setUniform4fv( (*Vec4It).first, 1, (*Vec4It).second );
-		++Vec4It;
+		int iOffset = UniformBuffer::GetUniformOffset( oProgram, m_vPendingVec4s[i].first.c_str() );
+		if( iOffset >= 0 && iOffset + 4 * sizeof( float ) <= vData.size() )
+		{
+			memcpy( &vData[ iOffset ], (float*)m_vPendingVec4s[i].second, 4 * sizeof( float ) );
+		}
+		else
+		{
+			vOtherVec4s.push_back( m_vPendingVec4s[i] );
+		}
 	}
+	m_vPendingFloats.swap( vOtherFloats );
+	m_vPendingVec4s.swap( vOtherVec4s );
 
+	if( vData.empty() )
+	{
+		return;
+	}
+	if( !m_pUniformBuffer )
+	{
+		m_pUniformBuffer = new UniformBuffer();
+	}
+	m_pUniformBuffer->Create( vData.size(), &vData[0] );
+	UniformBuffer::SetBlockBinding( oProgram, iBlockIndex, s_iMaterialBlockBinding );
+}
+
+void EffectTechnique::RequestTextureResolution( float fScreenSize )
+{
+	for( unsigned int i = 0; i < m_vTextures.size(); ++i )
+	{
+		m_vTextures[i].m_pTexture->RequestResolution( fScreenSize );
+	}
 }
 
 void EffectTechnique::ActivateTextures()
 {
-	std::map< int, AbstractTexture* >::iterator it = m_oUniformTextures2DMap.begin();
-	while( it != m_oUniformTextures2DMap.end() )
+	for( unsigned int i = 0; i < m_vTextures.size(); ++i )
 	{
-		glActiveTexture( GL_TEXTURE0 + (*it).first );
-		(*it).second->Activate();
-		++it;
+		OpenGLContext::ActiveTexture( GL_TEXTURE0 + m_vTextures[i].m_iUnit );
+		m_vTextures[i].m_pTexture->Activate();
+		//Read each time, a packed texture moves from the placeholder to its own layer once uploaded
+		if( m_vTextures[i].m_iLayerLocation >= 0 )
+		{
+			m_pShader->setUniformf( m_vTextures[i].m_iLayerLocation, (float)m_vTextures[i].m_pTexture->GetLayer() );
+		}
 	}
 }
 
-void EffectTechnique::DeactivateTextures()
+void EffectTechnique::DeactivateTextures( EffectTechnique const* pNext )
 {
-	std::map< int, AbstractTexture* >::iterator it = m_oUniformTextures2DMap.begin();
-	while( it != m_oUniformTextures2DMap.end() )
+	for( unsigned int i = 0; i < m_vTextures.size(); ++i )
 	{
-		int iItFirst = (*it).first;
-		glActiveTexture( GL_TEXTURE0 + (*it).first );
-		Texture2D::Deactivate();
-		++it;
+		int iUnit = m_vTextures[i].m_iUnit;
+		//pNext binds its own texture on the unit anyway
+		bool bRebound = false;
+		if( pNext )
+		{
+			for( unsigned int j = 0; j < pNext->m_vTextures.size() && !bRebound; ++j )
+			{
+				bRebound = pNext->m_vTextures[j].m_iUnit == iUnit;
+			}
+		}
+		if( !bRebound )
+		{
+			OpenGLContext::ActiveTexture( GL_TEXTURE0 + iUnit );
+			OpenGLContext::BindTexture( m_vTextures[i].m_pTexture->GetTarget(), 0 );
+		}
 	}
-	glActiveTexture( GL_TEXTURE0 );
-}
\ No newline at end of file
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 );
+}
@@ -16,6 +16,7 @@
 #include <iostream>
 #include <string>
 #include <map>
+#include <vector>
 
 #include "BurgerEngine/Graphics/Shader.h"
 
@@ -26,6 +27,8 @@
 
 #include "BurgerEngine/External/Math/Vector.h"
 
+class UniformBuffer;
+
 class EffectTechnique
 {
 public:
@@ -35,31 +38,93 @@ public:
 		E_RENDER_GBUFFER,
 		E_RENDER_OPAQUE,
 		E_RENDER_TRANSPARENCY,
+		/// Number of techniques a material can have, the ones below are drawn without material
+		E_RENDER_TECHNIQUE_COUNT,
 		E_RENDER_SHADOW_MAP = 100
 	};
 
+	/// Uniform block holding the constants of a material, when the shader declares it
+	static const char* s_sMaterialBlockName;
+	static const unsigned int s_iMaterialBlockBinding = 1;
+
+	/// \brief Pack the constants of the materials in a uniform buffer when their shader declares the block
+	static void SetUniformBufferEnabled( bool bEnabled ){ s_bUniformBufferEnabled = bEnabled; }
+
+	/// \brief Unbind the technique left active by Activate( true ), at the end of a pass
+	static void DeactivateCurrent();
+
 	EffectTechnique();
 	~EffectTechnique();
 
-	void Activate();
-	inline void Deactivate(){ m_pShader->Deactivate(); DeactivateTextures(); }
+	/// \brief Bind the shader, the textures and the constants. With bKeepBound, the technique stays bound
+	///			after the draw instead of being deactivated, and activating it again only commits the standard
+	///			uniforms (matrices): draws sharing a material pay almost nothing. DeactivateCurrent ends it
+	void Activate( bool bKeepBound = false );
+	void Deactivate();
 
-	void AddUniformTexture( int iUnit, AbstractTexture* pTexture ){ m_oUniformTextures2DMap[ iUnit ] = pTexture; };
-	//void AddUniformTextureCubeMap( int iUnit, TextureCubeMap* pTextureCube ){ m_oUniformTextures2DMap[ iUnit ] = pTextureCube; };
-	void AddUniformFloat( int iUniformLocation, float fValue ){ m_oUniformFloatsMap[ iUniformLocation ] = fValue; };
-	void AddUniformVec4( int iUniformLocation, vec4 vValue ){ m_oUniformVec4Map[ iUniformLocation ] = vValue; };
+	void AddUniformTexture( int iUnit, AbstractTexture* pTexture );
+	void AddUniformFloat( int iUniformLocation, float fValue );
+	void AddUniformVec4( int iUniformLocation, vec4 vValue );
 	void SetShader( Shader* pShader ){ m_pShader = pShader; };
 
+	/// \brief Uniforms given by name, their locations are only known once the shader is linked
+	void AddSampler( const std::string& sName, int iUnit ){ m_vPendingSamplers.push_back( std::make_pair( sName, iUnit ) ); };
+	/// \brief Float uniform given the layer of the texture of a unit, for the shaders sampling a TextureArray
+	void AddLayerUniform( const std::string& sName, int iUnit ){ m_vPendingLayers.push_back( std::make_pair( sName, iUnit ) ); };
+	void AddUniformFloat( const std::string& sName, float fValue ){ m_vPendingFloats.push_back( std::make_pair( sName, fValue ) ); };
+	void AddUniformVec4( const std::string& sName, vec4 vValue ){ m_vPendingVec4s.push_back( std::make_pair( sName, vValue ) ); };
+
+	/// \brief Look the named uniforms up and bind the samplers, false if the shader could not be built
+	bool ResolveUniforms();
+
+	/// \brief Tell the textures how large they are drawn, for the streaming
+	void RequestTextureResolution( float fScreenSize );
+
 private:
 	void ActivateTextures();
-	void DeactivateTextures();
+	/// \brief Unbind the textures, except on the units pNext is about to bind
+	void DeactivateTextures( EffectTechnique const* pNext = NULL );
 	void CommitUniforms();
+
+	/// \brief Move the constants declared in the material block to a uniform buffer
+	void _BuildUniformBuffer();
+
+	struct sTextureBinding
+	{
+		int					m_iUnit;
+		AbstractTexture*	m_pTexture;
+		/// Uniform given the layer of the texture, -1 when the shader samples it alone
+		int					m_iLayerLocation;
+	};
+
+	struct sUniformFloat
+	{
+		int		m_iLocation;
+		float	m_fValue;
+	};
+
+	struct sUniformVec4
+	{
+		int		m_iLocation;
+		vec4	m_vValue;
+	};
 	
 private:
+	static bool				s_bUniformBufferEnabled;
+	/// Technique left bound by Activate( true )
+	static EffectTechnique*	s_pCurrentTechnique;
+
 	Shader * m_pShader;
-	std::map< int, AbstractTexture* > m_oUniformTextures2DMap;
-	std::map< int, float > m_oUniformFloatsMap;
-	std::map< int, vec4 > m_oUniformVec4Map;
+	std::vector< sTextureBinding > m_vTextures;
+	std::vector< sUniformFloat > m_vUniformFloats;
+	std::vector< sUniformVec4 > m_vUniformVec4s;
+	/// Material constants, NULL when they are uploaded one by one
+	UniformBuffer* m_pUniformBuffer;
+
+	std::vector< std::pair< std::string, int > > m_vPendingSamplers;
+	std::vector< std::pair< std::string, int > > m_vPendingLayers;
+	std::vector< std::pair< std::string, float > > m_vPendingFloats;
+	std::vector< std::pair< std::string, vec4 > > m_vPendingVec4s;
 };
 
 #endif //__EFFECT_TECHNIQUE_H__
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "FBO.h"
+#include "BurgerEngine/Graphics/OpenGLContext.h"
 
 #include <iostream>
 #include <assert.h>
@@ -21,7 +22,7 @@ void FBO::GenerateDepthOnly()
 	Destroy();
 
 	glGenTextures(1, &m_iTexDepthId);
-	glBindTexture(m_eTextureType, m_iTexDepthId);
+	OpenGLContext::BindTexture(m_eTextureType, m_iTexDepthId);
 
 	//we create a special texture for depth
 	glTexImage2D(m_eTextureType, 0, GL_DEPTH_COMPONENT, m_iWidth, m_iHeight, 0,GL_DEPTH_COMPONENT, GL_FLOAT, 0);
@@ -32,7 +33,7 @@ void FBO::GenerateDepthOnly()
 	//glTexParameteri(GL_TEXTURE_2D, GL_DEPTH_TEXTURE_MODE, GL_INTENSITY);
 	glTexParameteri(m_eTextureType, GL_TEXTURE_WRAP_S, GL_CLAMP);
 	glTexParameteri(m_eTextureType, GL_TEXTURE_WRAP_T, GL_CLAMP);
-	glBindTexture(m_eTextureType, 0);
+	OpenGLContext::BindTexture(m_eTextureType, 0);
 
 	//Generating ID
 	glGenFramebuffersEXT(1, &m_iId);
@@ -61,7 +62,7 @@ void FBO::GenerateColorOnly( GLint iInternalFormat, GLint iFormat )
 
 	//Generate the texture
 	glGenTextures(1, &m_iTexId[0]);
-	glBindTexture(m_eTextureType, m_iTexId[0]);
+	OpenGLContext::BindTexture(m_eTextureType, m_iTexId[0]);
 
 	glTexParameteri (m_eTextureType, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri (m_eTextureType, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -84,7 +85,7 @@ void FBO::GenerateColorOnly( GLint iInternalFormat, GLint iFormat )
 		glTexImage2D(m_eTextureType, 0, iInternalFormat, m_iWidth, m_iHeight, 0, iFormat, GL_UNSIGNED_BYTE, 0);
 	}
 
-	glBindTexture(m_eTextureType, 0);
+	OpenGLContext::BindTexture(m_eTextureType, 0);
 
 	//Generate renderbuffer
 	glGenRenderbuffersEXT(1, &m_iRenderId);
@@ -116,25 +117,25 @@ void FBO::Generate( GLint iInternalFormat, GLint iFormat )
 {
 	// create a texture object for the depthmap
 	glGenTextures(1, &m_iTexDepthId);
-	glBindTexture(m_eTextureType, m_iTexDepthId);
+	OpenGLContext::BindTexture(m_eTextureType, m_iTexDepthId);
 	glTexParameterf(m_eTextureType, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glTexParameterf(m_eTextureType, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameterf(m_eTextureType, GL_TEXTURE_WRAP_S, GL_CLAMP);
 	glTexParameterf(m_eTextureType, GL_TEXTURE_WRAP_T, GL_CLAMP);
 	glTexParameteri(m_eTextureType, GL_GENERATE_MIPMAP, GL_TRUE);
 	glTexImage2D(m_eTextureType, 0, GL_DEPTH_COMPONENT24, m_iWidth, m_iHeight, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, 0);
-	glBindTexture(m_eTextureType, 0);
+	OpenGLContext::BindTexture(m_eTextureType, 0);
 
 	// create a texture object
 	glGenTextures(1, &m_iTexId[0]);
-	glBindTexture(m_eTextureType, m_iTexId[0]);
+	OpenGLContext::BindTexture(m_eTextureType, m_iTexId[0]);
 	glTexParameterf(m_eTextureType, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameterf(m_eTextureType, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameterf(m_eTextureType, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameterf(m_eTextureType, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
 	glTexImage2D(m_eTextureType, 0, iInternalFormat, m_iWidth, m_iHeight, 0, iFormat, GL_UNSIGNED_BYTE, 0);
-	glBindTexture(m_eTextureType, 0);
+	OpenGLContext::BindTexture(m_eTextureType, 0);
 
 	glGenFramebuffersEXT(1, &m_iId);
 	Activate();
@@ -158,7 +159,7 @@ void FBO::GenerateFinalHDRBuffer( GLint iInternalFormat0, GLint iFormat0, GLint
 
 	//Generate the textures
 	glGenTextures(1, &m_iTexId[0]);
-	glBindTexture(m_eTextureType, m_iTexId[0]);
+	OpenGLContext::BindTexture(m_eTextureType, m_iTexId[0]);
 
 	glTexParameteri (m_eTextureType, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri (m_eTextureType, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -169,7 +170,7 @@ void FBO::GenerateFinalHDRBuffer( GLint iInternalFormat0, GLint iFormat0, GLint
 	glTexImage2D(m_eTextureType, 0, iInternalFormat0, m_iWidth, m_iHeight, 0, iFormat0, GL_UNSIGNED_BYTE, 0);
 
 	glGenTextures(1, &m_iTexId[1]);
-	glBindTexture(m_eTextureType, m_iTexId[1]);
+	OpenGLContext::BindTexture(m_eTextureType, m_iTexId[1]);
 
 	glTexParameteri (m_eTextureType, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri (m_eTextureType, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -179,7 +180,7 @@ void FBO::GenerateFinalHDRBuffer( GLint iInternalFormat0, GLint iFormat0, GLint
 
 	glTexImage2D(m_eTextureType, 0, iInternalFormat1, m_iWidth, m_iHeight, 0, iFormat1, GL_UNSIGNED_BYTE, 0);
 
-	glBindTexture(m_eTextureType, 0);
+	OpenGLContext::BindTexture(m_eTextureType, 0);
 
 	//Generate renderbuffer
 	glGenRenderbuffersEXT(1, &m_iRenderId);
@@ -213,7 +214,7 @@ void FBO::ActivateTexture()
 	if (m_iType == 0 || m_iType == 2)
 	{
 		glEnable(m_eTextureType);
-		glBindTexture(m_eTextureType,m_iTexId[0]);
+		OpenGLContext::BindTexture(m_eTextureType,m_iTexId[0]);
 	}
 }
 
@@ -223,13 +224,13 @@ void FBO::ActivateTexture( unsigned int i )
 	if (m_iType == 0 || m_iType == 2)
 	{
 		glEnable(m_eTextureType);
-		glBindTexture(m_eTextureType,m_iTexId[i]);
+		OpenGLContext::BindTexture(m_eTextureType,m_iTexId[i]);
 	}
 }
 
 void FBO::DeactivateTexture()
 {
-	glBindTexture(m_eTextureType,0);
+	OpenGLContext::BindTexture(m_eTextureType,0);
 	glDisable(m_eTextureType);
 }
 
@@ -238,7 +239,7 @@ void FBO::ActivateDepthTexture()
 	if (m_iType == 1 || m_iType == 2)
 	{
 		glEnable(m_eTextureType);
-		glBindTexture(m_eTextureType,m_iTexDepthId);
+		OpenGLContext::BindTexture(m_eTextureType,m_iTexDepthId);
 	}
 }
 void FBO::DeactivateDepthTexture()
@@ -271,7 +272,7 @@ void FBO::Destroy()
 	glDeleteFramebuffersEXT(1, &m_iId);
 
 	if (m_iType == 0 || m_iType == 2)
-		glDeleteTextures(1,&m_iTexId[0]);
+		OpenGLContext::DeleteTexture( m_iTexId[0] );
 
 	if(m_iType == 0)
 		glDeleteRenderbuffersEXT(1, &m_iRenderId);
@@ -0,0 +1,105 @@
+#include "BurgerEngine/Graphics/FrameConstants.h"
+
+#include <cstring>
+
+const char* const FrameConstants::s_sBlockName = "FrameConstants";
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+FrameConstants::FrameConstants()
+{
+	memset( &m_oData, 0, sizeof( m_oData ) );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+std::string FrameConstants::GetDeclaration()
+{
+	//Same order as sData, std140 gives the offsets of the structure without any hole
+	static const char* s_sMembers =
+		"	mat4 mView;\n"
+		"	mat4 mProjection;\n"
+		"	mat4 mInvView;\n"
+		"	mat4 mInvProj;\n"
+		"	mat4 mViewProjection;\n"
+		"	mat4 mInvViewProjection;\n"
+		"	vec4 vDofParams;\n"
+		"	vec4 vCameraPosition;\n"
+		"	vec2 vViewport;\n"
+		"	vec2 vInvViewport;\n"
+		"	float fTime;\n"
+		"	float fDeltaTime;\n";
+
+	if( UniformBuffer::IsSupported() )
+	{
+		return std::string( "#extension GL_ARB_uniform_buffer_object : enable\n" )
+			+ "layout(std140) uniform " + s_sBlockName + "\n{\n" + s_sMembers + "};\n";
+	}
+
+	//Every member becomes a uniform of its own
+	std::string sDeclaration;
+	for( const char* pLine = s_sMembers; *pLine; )
+	{
+		const char* pEnd = strchr( pLine, '\n' );
+		sDeclaration += "uniform " + std::string( pLine + 1, pEnd + 1 );
+		pLine = pEnd + 1;
+	}
+	return sDeclaration;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void FrameConstants::Update( const float4x4& mView, const float4x4& mProjection, const vec3& vCameraPosition, const vec4& vDofParams,
+	unsigned int iWidth, unsigned int iHeight, float fTime, float fDeltaTime )
+{
+	float4x4 mViewProjection = transpose( mProjection ) * mView;
+
+	//Row major matrices are transposed, the projection already has the layout of GL
+	memcpy( m_oData.m_pView, (const float*)transpose( mView ), sizeof( m_oData.m_pView ) );
+	memcpy( m_oData.m_pProjection, (const float*)mProjection, sizeof( m_oData.m_pProjection ) );
+	memcpy( m_oData.m_pInvView, (const float*)transpose( !mView ), sizeof( m_oData.m_pInvView ) );
+	memcpy( m_oData.m_pInvProjection, (const float*)( !mProjection ), sizeof( m_oData.m_pInvProjection ) );
+	memcpy( m_oData.m_pViewProjection, (const float*)transpose( mViewProjection ), sizeof( m_oData.m_pViewProjection ) );
+	memcpy( m_oData.m_pInvViewProjection, (const float*)transpose( !mViewProjection ), sizeof( m_oData.m_pInvViewProjection ) );
+
+	m_oData.m_pDofParams[0] = vDofParams.x;
+	m_oData.m_pDofParams[1] = vDofParams.y;
+	m_oData.m_pDofParams[2] = vDofParams.z;
+	m_oData.m_pDofParams[3] = vDofParams.w;
+
+	m_oData.m_pCameraPosition[0] = vCameraPosition.x;
+	m_oData.m_pCameraPosition[1] = vCameraPosition.y;
+	m_oData.m_pCameraPosition[2] = vCameraPosition.z;
+	m_oData.m_pCameraPosition[3] = 1.0f;
+
+	m_oData.m_pViewport[0] = (float)iWidth;
+	m_oData.m_pViewport[1] = (float)iHeight;
+	m_oData.m_pInvViewport[0] = 1.0f / (float)iWidth;
+	m_oData.m_pInvViewport[1] = 1.0f / (float)iHeight;
+
+	m_oData.m_fTime = fTime;
+	m_oData.m_fDeltaTime = fDeltaTime;
+
+	if( !UniformBuffer::IsSupported() )
+	{
+		return;
+	}
+
+	//Orphaned each frame, the driver does not wait for the draws of the previous one
+	m_oBuffer.Create( sizeof( m_oData ), &m_oData, GL_STREAM_DRAW );
+	Bind();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void FrameConstants::Bind() const
+{
+	if( m_oBuffer.IsCreated() )
+	{
+		m_oBuffer.Bind( s_iBindingPoint );
+	}
+}
@@ -0,0 +1,74 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __FRAMECONSTANTS_H__
+#define __FRAMECONSTANTS_H__
+
+#include <string>
+
+#include "BurgerEngine/Graphics/CommonGraphics.h"
+#include "BurgerEngine/Graphics/UniformBuffer.h"
+#include "BurgerEngine/External/Math/Vector.h"
+
+/// \class	FrameConstants
+/// \brief	Camera and frame values, computed and uploaded once per frame in a std140 uniform block.
+///			Shaders opt in with "#pragma frameconstants", the ShaderManager then declares the block in both sources.
+///			Without ARB_uniform_buffer_object the same names are declared as plain uniforms, and Shader::CommitStdUniforms
+///			sets them from GetData
+class FrameConstants
+{
+public:
+
+	/// Binding point of the block, the material block is at EffectTechnique::s_iMaterialBlockBinding
+	static const unsigned int s_iBindingPoint = 0;
+	static const char* const s_sBlockName;
+
+	/// \brief Layout of the block, matrices are column major as GL reads them
+	struct sData
+	{
+		float m_pView[16];
+		float m_pProjection[16];
+		float m_pInvView[16];
+		float m_pInvProjection[16];
+		float m_pViewProjection[16];
+		float m_pInvViewProjection[16];
+		float m_pDofParams[4];
+		float m_pCameraPosition[4];
+		float m_pViewport[2];
+		float m_pInvViewport[2];
+		float m_fTime;
+		float m_fDeltaTime;
+		float m_pPadding[2];
+	};
+
+	FrameConstants();
+
+	/// \brief GLSL declaration of the values, for the sources that ask for it
+	static std::string GetDeclaration();
+
+	/// \brief Compute the values of the frame and upload them, GL thread only
+	/// \param mView		view matrix of the camera, row major as the engine stores it
+	/// \param mProjection	projection matrix, column major as GlperspectiveMatrix builds it
+	void Update( const float4x4& mView, const float4x4& mProjection, const vec3& vCameraPosition, const vec4& vDofParams,
+		unsigned int iWidth, unsigned int iHeight, float fTime, float fDeltaTime );
+
+	/// \brief Bind the block to its binding point, done by Update
+	void Bind() const;
+
+	const sData& GetData() const { return m_oData; }
+
+private:
+
+	sData			m_oData;
+	UniformBuffer	m_oBuffer;
+};
+
+#endif //__FRAMECONSTANTS_H__
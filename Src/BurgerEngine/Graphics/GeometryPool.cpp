@@ -0,0 +1,224 @@
+#include "BurgerEngine/Graphics/GeometryPool.h"
+#include "BurgerEngine/Graphics/OpenGLContext.h"
+
+#include <iostream>
+#include <cassert>
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+GeometryPool::GeometryPool()
+	: m_iBoundPage( -1 )
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+GeometryPool::~GeometryPool()
+{
+	Clear();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool GeometryPool::Add( Vertex const* pVertices, unsigned int iVertexCount, unsigned int const* pIndices, unsigned int iIndexCount, sAllocation& rAllocation )
+{
+	if( iVertexCount == 0 || iIndexCount == 0 )
+	{
+		return false;
+	}
+
+	//First page with enough room, only the end of a page is free so there is no hole to look for.
+	//A released page has no room left, its slot is reused below
+	unsigned int iPage = 0;
+	while( iPage < m_vPages.size()
+		&& ( m_vPages[iPage].m_iVertexCount + iVertexCount > m_vPages[iPage].m_iVertexCapacity
+		|| m_vPages[iPage].m_iIndexCount + iIndexCount > m_vPages[iPage].m_iIndexCapacity ) )
+	{
+		++iPage;
+	}
+
+	//The arrays of a bound page would stay enabled on the buffers changed below
+	Unbind();
+
+	if( iPage == m_vPages.size() )
+	{
+		//Twice as large as the largest page still in use
+		unsigned int iVertexCapacity = s_iFirstPageVertexCount / 2;
+		unsigned int iIndexCapacity = s_iFirstPageIndexCount / 2;
+		iPage = (unsigned int)m_vPages.size();
+		for( unsigned int i = 0; i < m_vPages.size(); ++i )
+		{
+			if( m_vPages[i].m_iMeshCount == 0 )
+			{
+				iPage = min( iPage, i );
+			}
+			iVertexCapacity = max( iVertexCapacity, m_vPages[i].m_iVertexCapacity );
+			iIndexCapacity = max( iIndexCapacity, m_vPages[i].m_iIndexCapacity );
+		}
+		iVertexCapacity = min( 2 * iVertexCapacity, s_iPageVertexCount );
+		iIndexCapacity = min( 2 * iIndexCapacity, s_iPageIndexCount );
+
+		sPage oPage;
+		oPage.m_iVertexCapacity = max( iVertexCapacity, iVertexCount );
+		oPage.m_iIndexCapacity = max( iIndexCapacity, iIndexCount );
+		oPage.m_iVertexCount = 0;
+		oPage.m_iIndexCount = 0;
+		oPage.m_iMeshCount = 0;
+
+		glGenBuffers( 1, &oPage.m_iVertexBuffer );
+		glGenBuffers( 1, &oPage.m_iIndexBuffer );
+		if( oPage.m_iVertexBuffer == 0 || oPage.m_iIndexBuffer == 0 )
+		{
+			std::cerr << "WARNING : cannot create a page of the geometry pool" << std::endl;
+			return false;
+		}
+
+		OpenGLContext::BindBuffer( GL_ARRAY_BUFFER, oPage.m_iVertexBuffer );
+		glBufferData( GL_ARRAY_BUFFER, oPage.m_iVertexCapacity * sizeof( Vertex ), NULL, GL_STATIC_DRAW );
+		OpenGLContext::BindBuffer( GL_ELEMENT_ARRAY_BUFFER, oPage.m_iIndexBuffer );
+		glBufferData( GL_ELEMENT_ARRAY_BUFFER, oPage.m_iIndexCapacity * sizeof( GLuint ), NULL, GL_STATIC_DRAW );
+
+		if( iPage == m_vPages.size() )
+		{
+			m_vPages.push_back( oPage );
+		}
+		else
+		{
+			m_vPages[iPage] = oPage;
+		}
+	}
+
+	sPage& rPage = m_vPages[iPage];
+	rAllocation.m_iPage = iPage;
+	rAllocation.m_iFirstVertex = rPage.m_iVertexCount;
+	rAllocation.m_iFirstIndex = rPage.m_iIndexCount;
+	rAllocation.m_iVertexCount = iVertexCount;
+	rAllocation.m_iIndexCount = iIndexCount;
+
+	m_viIndices.resize( iIndexCount );
+	for( unsigned int i = 0; i < iIndexCount; ++i )
+	{
+		m_viIndices[i] = pIndices[i] + rAllocation.m_iFirstVertex;
+	}
+
+	OpenGLContext::BindBuffer( GL_ARRAY_BUFFER, rPage.m_iVertexBuffer );
+	glBufferSubData( GL_ARRAY_BUFFER, rAllocation.m_iFirstVertex * sizeof( Vertex ), iVertexCount * sizeof( Vertex ), pVertices );
+	OpenGLContext::BindBuffer( GL_ELEMENT_ARRAY_BUFFER, rPage.m_iIndexBuffer );
+	glBufferSubData( GL_ELEMENT_ARRAY_BUFFER, rAllocation.m_iFirstIndex * sizeof( GLuint ), iIndexCount * sizeof( GLuint ), &m_viIndices[0] );
+
+	rPage.m_iVertexCount += iVertexCount;
+	rPage.m_iIndexCount += iIndexCount;
+	++rPage.m_iMeshCount;
+
+	//The other draws still read their indices from client memory
+	OpenGLContext::BindBuffer( GL_ARRAY_BUFFER, 0 );
+	OpenGLContext::BindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void GeometryPool::Remove( sAllocation const& rAllocation )
+{
+	assert( rAllocation.m_iPage < m_vPages.size() && m_vPages[rAllocation.m_iPage].m_iMeshCount > 0 );
+	sPage& rPage = m_vPages[rAllocation.m_iPage];
+	--rPage.m_iMeshCount;
+
+	if( rPage.m_iMeshCount == 0 )
+	{
+		if( m_iBoundPage == (int)rAllocation.m_iPage )
+		{
+			Unbind();
+		}
+		OpenGLContext::DeleteBuffer( rPage.m_iVertexBuffer );
+		OpenGLContext::DeleteBuffer( rPage.m_iIndexBuffer );
+		rPage.m_iVertexBuffer = 0;
+		rPage.m_iIndexBuffer = 0;
+		rPage.m_iVertexCapacity = 0;
+		rPage.m_iIndexCapacity = 0;
+		rPage.m_iVertexCount = 0;
+		rPage.m_iIndexCount = 0;
+	}
+	else if( rAllocation.m_iFirstVertex + rAllocation.m_iVertexCount == rPage.m_iVertexCount
+		&& rAllocation.m_iFirstIndex + rAllocation.m_iIndexCount == rPage.m_iIndexCount )
+	{
+		//Last mesh of the page, its space is free again
+		rPage.m_iVertexCount = rAllocation.m_iFirstVertex;
+		rPage.m_iIndexCount = rAllocation.m_iFirstIndex;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void GeometryPool::Bind( unsigned int iPage )
+{
+	if( m_iBoundPage == (int)iPage )
+	{
+		return;
+	}
+
+	sPage const& rPage = m_vPages[iPage];
+	OpenGLContext::BindBuffer( GL_ARRAY_BUFFER, rPage.m_iVertexBuffer );
+	OpenGLContext::BindBuffer( GL_ELEMENT_ARRAY_BUFFER, rPage.m_iIndexBuffer );
+
+	if( m_iBoundPage < 0 )
+	{
+		glEnableClientState( GL_VERTEX_ARRAY );
+		glEnableClientState( GL_NORMAL_ARRAY );
+		glClientActiveTexture( GL_TEXTURE1 );
+		glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+		glClientActiveTexture( GL_TEXTURE0 );
+		glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+	}
+
+	//Every page has the same layout, only the buffer changes
+	glVertexPointer( 3, GL_FLOAT, sizeof( Vertex ), BUFFER_OFFSET( 0 ) );
+	glNormalPointer( GL_FLOAT, sizeof( Vertex ), BUFFER_OFFSET( sizeof( vec3 ) ) );
+	glTexCoordPointer( 2, GL_FLOAT, sizeof( Vertex ), BUFFER_OFFSET( 2 * sizeof( vec3 ) ) );
+	glClientActiveTexture( GL_TEXTURE1 );
+	glTexCoordPointer( 3, GL_FLOAT, sizeof( Vertex ), BUFFER_OFFSET( 2 * sizeof( vec3 ) + sizeof( vec2 ) ) );
+	glClientActiveTexture( GL_TEXTURE0 );
+
+	m_iBoundPage = (int)iPage;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void GeometryPool::Unbind()
+{
+	if( m_iBoundPage < 0 )
+	{
+		return;
+	}
+
+	glClientActiveTexture( GL_TEXTURE1 );
+	glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+	glClientActiveTexture( GL_TEXTURE0 );
+	glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+	glDisableClientState( GL_NORMAL_ARRAY );
+	glDisableClientState( GL_VERTEX_ARRAY );
+
+	OpenGLContext::BindBuffer( GL_ARRAY_BUFFER, 0 );
+	OpenGLContext::BindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+	m_iBoundPage = -1;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void GeometryPool::Clear()
+{
+	Unbind();
+	for( std::vector< sPage >::iterator it = m_vPages.begin(); it != m_vPages.end(); ++it )
+	{
+		OpenGLContext::DeleteBuffer( (*it).m_iVertexBuffer );
+		OpenGLContext::DeleteBuffer( (*it).m_iIndexBuffer );
+	}
+	m_vPages.clear();
+}
@@ -0,0 +1,91 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __GEOMETRYPOOL_H__
+#define __GEOMETRYPOOL_H__
+
+#include <vector>
+
+#include "BurgerEngine/Graphics/CommonGraphics.h"
+#include "BurgerEngine/Graphics/Vertex.h"
+
+/// \class	GeometryPool
+/// \brief	A few large vertex and index buffers the static meshes are sub-allocated from, so the draws of a pass
+///			share the same buffers and vertex arrays. The indices are rebased on the first vertex of their mesh
+///			when they are copied, so the draws need no base vertex.
+///			A page is released once its last mesh is removed, the space of a mesh in the middle of a page
+///			is only reclaimed with the page
+class GeometryPool
+{
+public:
+
+	/// Size of the first page, each new page is twice as large as the one before up to the largest size,
+	/// so a small scene keeps small buffers. A larger mesh gets a page of its own
+	static const unsigned int s_iFirstPageVertexCount = 1 << 16;
+	static const unsigned int s_iFirstPageIndexCount = 3 << 16;
+	static const unsigned int s_iPageVertexCount = 1 << 20;
+	static const unsigned int s_iPageIndexCount = 3 << 20;
+
+	/// Place of a mesh in the pool
+	struct sAllocation
+	{
+		unsigned int	m_iPage;
+		unsigned int	m_iFirstVertex;
+		/// First index of the mesh in the index buffer of its page
+		unsigned int	m_iFirstIndex;
+		unsigned int	m_iVertexCount;
+		unsigned int	m_iIndexCount;
+	};
+
+	GeometryPool();
+	~GeometryPool();
+
+	/// \brief Copy a mesh in the first page with enough room, GL thread only
+	/// \param[in] pIndices Indices in the mesh, from 0
+	bool Add( Vertex const* pVertices, unsigned int iVertexCount, unsigned int const* pIndices, unsigned int iIndexCount, sAllocation& rAllocation );
+
+	/// \brief Give back the place of a mesh, GL thread only
+	void Remove( sAllocation const& rAllocation );
+
+	/// \brief Bind the buffers of a page and point the vertex arrays at them
+	void Bind( unsigned int iPage );
+
+	/// \brief Disable the vertex arrays, the next Bind sets them up again
+	void Unbind();
+
+	/// \brief Release every page
+	void Clear();
+
+	unsigned int GetPageCount() const { return (unsigned int)m_vPages.size(); }
+
+private:
+
+	struct sPage
+	{
+		GLuint			m_iVertexBuffer;
+		GLuint			m_iIndexBuffer;
+		unsigned int	m_iVertexCapacity;
+		unsigned int	m_iIndexCapacity;
+		unsigned int	m_iVertexCount;
+		unsigned int	m_iIndexCount;
+		/// Meshes still in the page, the page is released when it drops to 0
+		unsigned int	m_iMeshCount;
+	};
+
+	/// The index of a page is kept by its meshes, a released page leaves an empty slot for the next one
+	std::vector< sPage >	m_vPages;
+	/// Page whose arrays are set up, -1 when none
+	int						m_iBoundPage;
+	/// Scratch copy of the rebased indices
+	std::vector< GLuint >	m_viIndices;
+};
+
+#endif //__GEOMETRYPOOL_H__
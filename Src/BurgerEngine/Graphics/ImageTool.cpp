@@ -4,10 +4,16 @@
 
 #include <iostream>
 
+#include <SFML/System.hpp>
+
 #undef _UNICODE
 
+/// DevIL works on a global bound image, so images loaded from several threads are decoded one at a time
+static sf::Mutex s_oDevILMutex;
+
 GLubyte* ImageTool::LoadImage(const std::string& sName, unsigned int& iWidthOut,unsigned int& iHeightOut, unsigned int& iChannelOut)
 {
+	sf::Lock oLock( s_oDevILMutex );
 	std::cout<<"LOADING : " <<sName<<std::endl;
 	/// we are using DevIL just as a img loader, just for the data, we'll handle the rest
 	ILuint ImageName;
@@ -47,6 +53,7 @@ GLubyte* ImageTool::LoadImage(const std::string& sName, unsigned int& iWidthOut,
 
 GLubyte* ImageTool::Load3DFrom2DImage( const std::string& sName, unsigned int iWidth,unsigned int iHeight, unsigned int iDepth, unsigned int& iChannelOut )
 {
+	sf::Lock oLock( s_oDevILMutex );
 	std::cout<<"LOADING : " <<sName<<std::endl;
 	/// we are using DevIL just as a img loader, just for the data, we'll handle the rest
 	ILuint ImageName;
@@ -16,6 +16,10 @@
 //--------------------------------------------------------------------------------------------------------------------
 Material::Material()
 {
+	for( unsigned int i = 0; i < EffectTechnique::E_RENDER_TECHNIQUE_COUNT; ++i )
+	{
+		m_pTechniques[ i ] = NULL;
+	}
 }
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -23,12 +27,18 @@ Material::Material()
 //--------------------------------------------------------------------------------------------------------------------
 Material::~Material()
 {
-	std::map< EffectTechnique::RenderingTechnique, EffectTechnique* >::iterator it = m_oTechniques.begin();
-	while( it != m_oTechniques.end() )
+	Clear();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void Material::Clear()
+{
+	for( unsigned int i = 0; i < EffectTechnique::E_RENDER_TECHNIQUE_COUNT; ++i )
 	{
-		delete (*it).second;
-		(*it).second = NULL;
-		++it;
+		delete m_pTechniques[ i ];
+		m_pTechniques[ i ] = NULL;
 	}
 }
 
@@ -40,15 +50,43 @@ Material::MaterialStatus Material::Initialize( const char * sName )
 	return _LoadMaterialXML( sName );
 }
 
+//--------------------------------------------------------------------------------------------------------------------
+// 
+//--------------------------------------------------------------------------------------------------------------------
+Material::MaterialStatus Material::ResolveUniforms()
+{
+	MaterialStatus eStatus = E_LOADED;
+	for( unsigned int i = 0; i < EffectTechnique::E_RENDER_TECHNIQUE_COUNT; ++i )
+	{
+		if( m_pTechniques[ i ] && !m_pTechniques[ i ]->ResolveUniforms() )
+		{
+			eStatus = E_SHADER_ERROR;
+		}
+	}
+	return eStatus;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void Material::RequestTextureResolution( EffectTechnique::RenderingTechnique eTechnique, float fScreenSize )
+{
+	EffectTechnique* pTechnique = _GetTechnique( eTechnique );
+	if( pTechnique )
+	{
+		pTechnique->RequestTextureResolution( fScreenSize );
+	}
+}
+
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-bool Material::Activate( EffectTechnique::RenderingTechnique eTechnique )
+bool Material::Activate( EffectTechnique::RenderingTechnique eTechnique, bool bKeepBound )
 {
-	std::map< EffectTechnique::RenderingTechnique, EffectTechnique* >::iterator oIt = m_oTechniques.find(eTechnique);
-	if (oIt != m_oTechniques.end())
+	EffectTechnique* pTechnique = _GetTechnique( eTechnique );
+	if( pTechnique )
 	{
-		oIt->second->Activate();
+		pTechnique->Activate( bKeepBound );
 		return true;
 	}
 	return false;
@@ -59,10 +97,10 @@ bool Material::Activate( EffectTechnique::RenderingTechnique eTechnique )
 //--------------------------------------------------------------------------------------------------------------------
 void Material::Deactivate( EffectTechnique::RenderingTechnique eTechnique )
 {
-	std::map< EffectTechnique::RenderingTechnique, EffectTechnique* >::iterator oIt = m_oTechniques.find(eTechnique);
-	if (oIt != m_oTechniques.end())
+	EffectTechnique* pTechnique = _GetTechnique( eTechnique );
+	if( pTechnique )
 	{
-		oIt->second->Deactivate();
+		pTechnique->Deactivate();
 	}
 }
 
@@ -100,15 +138,21 @@ Material::MaterialStatus Material::_LoadMaterialXML( const char * sName )
 			return E_LOADING_ERROR;
 		}
 
-		pShader = ShaderManager::GrabInstance().AddShader( pXmlName->GetText() );
+		//Only requested, the uniforms are looked up by ResolveUniforms once every shader is built
+		//The features attribute lists the switches of the permutation used by this material
+		ShaderManager& rShaderManager = ShaderManager::GrabInstance();
+		unsigned int iFeatures = 0;
+		if( pXmlName->Attribute( "features" ) )
+		{
+			iFeatures = rShaderManager.GetFeatureMask( pXmlName->GetText(), pXmlName->Attribute( "features" ) );
+		}
+		pShader = rShaderManager.RequestShader( pXmlName->GetText(), iFeatures );
 
 		if( !pShader )
 		{
 			return E_SHADER_ERROR;
 		}
 
-		pShader->Activate();
-
 		//gets the textures used by the material
 		TiXmlElement * pXmlTextures = pXmlTechnique->FirstChildElement( "textures" );
 		if( pXmlTextures )
@@ -121,12 +165,21 @@ Material::MaterialStatus Material::_LoadMaterialXML( const char * sName )
 				if( pXmlParam )
 				{
 					pXmlParam->QueryIntAttribute("unit",&iUnit);
-					pShader->setUniformTexture( pXmlParam->GetText(), iUnit );
+					pTechnique->AddSampler( pXmlParam->GetText(), iUnit );
+
+					//The layer attribute names the uniform the shader reads the layer from, the texture is then
+					//packed in a texture array, and the shader has to sample an array with the TEXTURE_ARRAY feature
+					const char* sLayerUniform = pXmlParam->Attribute( "layer" );
+					bool bPacked = sLayerUniform && TextureManager::GrabInstance().IsArrayPackingEnabled();
+					if( bPacked )
+					{
+						pTechnique->AddLayerUniform( sLayerUniform, iUnit );
+					}
 
 					TiXmlElement * pXmlFileName = pXmlTexture->FirstChildElement( "filename" );
 					if( pXmlFileName )
 					{
-						AbstractTexture* pTexture = TextureManager::GrabInstance().AddTexture( pXmlFileName->GetText() );
+						AbstractTexture* pTexture = TextureManager::GrabInstance().AddTexture( pXmlFileName->GetText(), bPacked );
 						if(pTexture)
 						{
 							pTechnique->AddUniformTexture( iUnit, pTexture );
@@ -147,8 +200,7 @@ Material::MaterialStatus Material::_LoadMaterialXML( const char * sName )
 				float fValue;
 				pXmlFloat->QueryFloatAttribute("value",&fValue);
 
-				int iUniformLocation = glGetUniformLocation( pShader->getHandle(), pXmlFloat->GetText() );
-				pTechnique->AddUniformFloat( iUniformLocation, fValue );
+				pTechnique->AddUniformFloat( pXmlFloat->GetText(), fValue );
 				pXmlFloat = pXmlFloat->NextSiblingElement( "float" );
 			}
 			TiXmlElement * pXmlVec4 = pXmlUniforms->FirstChildElement( "vec4" );
@@ -160,17 +212,17 @@ Material::MaterialStatus Material::_LoadMaterialXML( const char * sName )
 				pXmlVec4->QueryFloatAttribute("z",&z);
 				pXmlVec4->QueryFloatAttribute("w",&w);
 
-				int iUniformLocation = glGetUniformLocation( pShader->getHandle(), pXmlVec4->GetText() );
-				pTechnique->AddUniformVec4( iUniformLocation, vec4(x,y,z,x) );
+				pTechnique->AddUniformVec4( pXmlVec4->GetText(), vec4(x,y,z,w) );
 				pXmlVec4 = pXmlVec4->NextSiblingElement( "vec4" );
 			}
 		}
 
-		pShader->QueryStdUniforms();
-		pShader->Deactivate();
 		pTechnique->SetShader( pShader );
 
-		m_oTechniques[ MaterialManager::GrabInstance().GetTechniqueID( sTechniqueName ) ] = pTechnique;
+		EffectTechnique::RenderingTechnique eTechnique = MaterialManager::GrabInstance().GetTechniqueID( sTechniqueName );
+		assert( eTechnique < EffectTechnique::E_RENDER_TECHNIQUE_COUNT );
+		delete m_pTechniques[ eTechnique ];
+		m_pTechniques[ eTechnique ] = pTechnique;
 
 		pXmlTechnique = pXmlTechnique->NextSiblingElement( "technique" );
 	}
@@ -179,12 +231,12 @@ Material::MaterialStatus Material::_LoadMaterialXML( const char * sName )
 
 bool Material::IsOpaque()
 {
-	return m_oTechniques.find( EffectTechnique::E_RENDER_OPAQUE ) != m_oTechniques.end();
+	return m_pTechniques[ EffectTechnique::E_RENDER_OPAQUE ] != NULL;
 }
 
 bool Material::IsTransparent()
 {
-	return m_oTechniques.find( EffectTechnique::E_RENDER_TRANSPARENCY ) != m_oTechniques.end();
+	return m_pTechniques[ EffectTechnique::E_RENDER_TRANSPARENCY ] != NULL;
 }
 
 
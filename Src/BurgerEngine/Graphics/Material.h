@@ -12,8 +12,6 @@
 #ifndef __MATERIAL_H__
 #define __MATERIAL_H__
 
-#include <map>
-
 #include "BurgerEngine/Graphics/EffectTechnique.h"
 
 /// \name	Material.h
@@ -33,11 +31,22 @@ public:
 	Material();
 	~Material();
 
+	/// \brief Read the material and request its shaders, which are not built yet
 	MaterialStatus Initialize( const char * sName );
 
-	bool Activate( EffectTechnique::RenderingTechnique eTechnique );
+	/// \brief Second part of the loading, once the shaders are built (ShaderManager::BuildPendingShaders)
+	MaterialStatus ResolveUniforms();
+
+	/// \brief Drop the techniques, to load the material again
+	void Clear();
+
+	/// \brief See EffectTechnique::Activate for bKeepBound
+	bool Activate( EffectTechnique::RenderingTechnique eTechnique, bool bKeepBound = false );
 	void Deactivate( EffectTechnique::RenderingTechnique eTechnique );
 
+	/// \brief Tell the textures of a technique how large the material is drawn, for the streaming
+	void RequestTextureResolution( EffectTechnique::RenderingTechnique eTechnique, float fScreenSize );
+
 	bool IsOpaque();
 	bool IsTransparent();
 
@@ -45,8 +54,14 @@ private:
 
 	MaterialStatus _LoadMaterialXML( const char * sName );
 
+	/// \brief NULL when the material has no such technique
+	EffectTechnique* _GetTechnique( EffectTechnique::RenderingTechnique eTechnique ) const
+	{
+		return eTechnique < EffectTechnique::E_RENDER_TECHNIQUE_COUNT ? m_pTechniques[ eTechnique ] : NULL;
+	}
+
 private:		
-	std::map< EffectTechnique::RenderingTechnique, EffectTechnique* > m_oTechniques;
+	EffectTechnique* m_pTechniques[ EffectTechnique::E_RENDER_TECHNIQUE_COUNT ];
 };
 
 #endif //__MATERIAL_H__
\ No newline at end of file
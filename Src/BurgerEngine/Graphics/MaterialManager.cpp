@@ -1,9 +1,13 @@
 #include "MaterialManager.h"
 #include "BurgerEngine/Graphics/Material.h"
+#include "BurgerEngine/Graphics/ShaderManager.h"
 
 #include <iostream>
+#include <algorithm>
+#include <cassert>
 
 MaterialManager::MaterialManager()
+	: m_bBatching( false )
 {
 	FillRenderingTechniqueMap();
 }
@@ -17,30 +21,37 @@ void MaterialManager::FillRenderingTechniqueMap()
 
 void MaterialManager::clear()
 {
-	for (std::map<std::string,Material*>::iterator iter = m_oMaterials.begin(); iter != m_oMaterials.end() ; ++iter)
-		delete (*iter).second;
+	m_vPendingMaterials.clear();
+	for (std::map<std::string,sMaterial>::iterator iter = m_oMaterials.begin(); iter != m_oMaterials.end() ; ++iter)
+		delete (*iter).second.m_pMaterial;
 	m_oMaterials.clear();
 }
 
 Material*	MaterialManager::getMaterial(const std::string& name)
 {
-	std::map<std::string,Material*>::iterator iter = m_oMaterials.find(name);
+	std::map<std::string,sMaterial>::iterator iter = m_oMaterials.find(name);
 	if (iter == m_oMaterials.end())
 	{
 		std::cerr << "WARNING : cannot Find Material :  " << name << std::endl;
 		return NULL;
 	}
-	return (*iter).second;
+	return (*iter).second.m_pMaterial;
 }
 
 Material * MaterialManager::addMaterial( const char * sName )
 {
-	std::map<std::string,Material*>::iterator iter = m_oMaterials.find( sName );
+	std::map<std::string,sMaterial>::iterator iter = m_oMaterials.find( sName );
 	if (iter == m_oMaterials.end())
 	{
 		Material* pMaterial	 =	new Material();
 		Material::MaterialStatus eStatus;
-		if( (eStatus = pMaterial->Initialize( sName )) != Material::E_LOADED )
+		eStatus = pMaterial->Initialize( sName );
+		if( eStatus == Material::E_LOADED && !m_bBatching )
+		{
+			ShaderManager::GrabInstance().BuildPendingShaders();
+			eStatus = pMaterial->ResolveUniforms();
+		}
+		if( eStatus != Material::E_LOADED )
 		{
 			delete pMaterial;
 			pMaterial = NULL;
@@ -58,11 +69,63 @@ Material * MaterialManager::addMaterial( const char * sName )
 			return addMaterial( sMaterialPath.c_str() );
 		}
 		
-		m_oMaterials[ sName ] =	pMaterial;
+		if( m_bBatching )
+		{
+			m_vPendingMaterials.push_back( pMaterial );
+		}
+		sMaterial& rMaterial = m_oMaterials[ sName ];
+		rMaterial.m_pMaterial = pMaterial;
+		rMaterial.m_iRefCount = 1;
 		return pMaterial;
 	}
 	else
 	{
-		return m_oMaterials[ sName ];
+		++(*iter).second.m_iRefCount;
+		return (*iter).second.m_pMaterial;
 	}
-}
\ No newline at end of file
+}
+
+void MaterialManager::releaseMaterial( Material* pMaterial )
+{
+	std::map<std::string,sMaterial>::iterator iter = m_oMaterials.begin();
+	while( iter != m_oMaterials.end() && (*iter).second.m_pMaterial != pMaterial )
+	{
+		++iter;
+	}
+	if( iter == m_oMaterials.end() )
+	{
+		return;
+	}
+
+	assert( (*iter).second.m_iRefCount > 0 );
+	--(*iter).second.m_iRefCount;
+	if( (*iter).second.m_iRefCount == 0 )
+	{
+		//A material released before EndBatch must not be resolved
+		m_vPendingMaterials.erase( std::remove( m_vPendingMaterials.begin(), m_vPendingMaterials.end(), pMaterial ), m_vPendingMaterials.end() );
+		delete pMaterial;
+		m_oMaterials.erase( iter );
+	}
+}
+
+void MaterialManager::EndBatch()
+{
+	m_bBatching = false;
+	ShaderManager::GrabInstance().BuildPendingShaders();
+
+	for( unsigned int i = 0; i < m_vPendingMaterials.size(); ++i )
+	{
+		Material* pMaterial = m_vPendingMaterials[i];
+		if( pMaterial->ResolveUniforms() != Material::E_LOADED )
+		{
+			//Already handed out, the error material is loaded in place
+			pMaterial->Clear();
+			if( pMaterial->Initialize( "../Data/Materials/Engine/ShaderError.bma.xml" ) == Material::E_LOADED )
+			{
+				ShaderManager::GrabInstance().BuildPendingShaders();
+				pMaterial->ResolveUniforms();
+			}
+		}
+	}
+	m_vPendingMaterials.clear();
+}
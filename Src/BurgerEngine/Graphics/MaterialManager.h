@@ -14,6 +14,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 #include "BurgerEngine/Base/Singleton.h"
 
@@ -27,8 +28,17 @@ class MaterialManager:public Singleton<MaterialManager>
 
 	public:
 		Material*	getMaterial(const std::string& name);
+		/// \brief Load a material or share the one already loaded, each call must be matched by a releaseMaterial
 		Material*	addMaterial( const char * sName );
 
+		/// \brief Drop a reference taken by addMaterial, the material and its textures are freed with the last one
+		void		releaseMaterial( Material* pMaterial );
+
+		/// \brief Between these calls the materials are returned before their shaders are built,
+		///			so the shaders of a whole scene are compiled together. The materials are usable after EndBatch
+		void BeginBatch(){ m_bBatching = true; };
+		void EndBatch();
+
 		void clear();
 
 		EffectTechnique::RenderingTechnique GetTechniqueID( std::string sName ){ return oTechniqueNameToIdMap[sName]; };
@@ -36,11 +46,21 @@ class MaterialManager:public Singleton<MaterialManager>
 	protected:
 
 		void FillRenderingTechniqueMap();
+
+		/// Materials waiting for EndBatch
+		std::vector< Material* > m_vPendingMaterials;
+		bool m_bBatching;
 		
 		MaterialManager();
 		virtual ~MaterialManager(){clear();};
 
-		std::map<std::string,Material*> m_oMaterials;
+		struct sMaterial
+		{
+			Material*		m_pMaterial;
+			unsigned int	m_iRefCount;
+		};
+
+		std::map<std::string,sMaterial> m_oMaterials;
 		std::map< std::string, EffectTechnique::RenderingTechnique > oTechniqueNameToIdMap;
 };
 
@@ -1,5 +1,35 @@
 #include "BurgerEngine/Graphics/MeshManager.h"
 #include "BurgerEngine/Graphics/StaticMesh.h"
+#include "BurgerEngine/Graphics/ResourceLoader.h"
+
+#include <cassert>
+
+/// \brief Parse the mesh on a loader thread and build its buffer on the GL thread
+class MeshLoadingJob: public ResourceLoader::AbstractJob
+{
+public:
+	MeshLoadingJob( StaticMesh* pMesh, const std::string& sName ): m_pMesh( pMesh ), m_sName( sName ){}
+
+	/// The mesh may have been released while it was loading
+	~MeshLoadingJob()
+	{
+		MeshManager::GrabInstance()._OnLoadingDone( m_pMesh );
+	}
+
+	bool Load()
+	{
+		return m_pMesh->LoadMeshData( m_sName );
+	}
+
+	void Upload()
+	{
+		m_pMesh->UploadMesh();
+	}
+
+private:
+	StaticMesh*	m_pMesh;
+	std::string	m_sName;
+};
 
 
 MeshManager::MeshManager()
@@ -9,40 +39,115 @@ MeshManager::MeshManager()
 
 void MeshManager::clear()
 {
-	for (std::map<std::string , StaticMesh*>::iterator iter = m_mMeshs.begin() ; iter != m_mMeshs.end() ; ++iter)
+	for (std::map<std::string , sMesh>::iterator iter = m_mMeshs.begin() ; iter != m_mMeshs.end() ; ++iter)
 	{
-		delete (*iter).second;
+		delete (*iter).second.m_pMesh;
 	}
 	m_mMeshs.clear();
+	m_oGeometryPool.Clear();
 }
 
 
 StaticMesh* MeshManager::getMesh(const std::string &sName)
 {
-	std::map<std::string , StaticMesh*>::iterator iter = m_mMeshs.find(sName);
+	std::map<std::string , sMesh>::iterator iter = m_mMeshs.find(sName);
 	if (iter == m_mMeshs.end())
 	{	
 		std::cerr<<"ERROR : couldn't find "<<sName<<std::endl;
 		return NULL;
 	}
 	else
-		return (*iter).second;
+		return (*iter).second.m_pMesh;
 
 }
 
 StaticMesh* MeshManager::loadMesh(const std::string &sName)
 {
-	std::map<std::string , StaticMesh*>::iterator iter = m_mMeshs.find(sName);
+	std::map<std::string , sMesh>::iterator iter = m_mMeshs.find(sName);
 	if (iter == m_mMeshs.end()) // We load a new mesh
 	{	
 		StaticMesh* pMesh = new StaticMesh();
 		std::cout<<"[LOADING] : "<<sName<<std::endl;
-		pMesh->LoadMesh(sName);
-		m_mMeshs[sName] = pMesh;
+		//Registered before the job, without loader thread the job is done and deleted in AddJob
+		sMesh& rMesh = m_mMeshs[sName];
+		rMesh.m_pMesh = pMesh;
+		rMesh.m_iRefCount = 1;
+		rMesh.m_bLoading = true;
+		std::map<std::string , sBoundingBox>::const_iterator itBox = m_mPrecomputedBoundingBoxes.find(sName);
+		if (itBox != m_mPrecomputedBoundingBoxes.end())
+		{
+			pMesh->SetPrecomputedBoundingBox((*itBox).second.m_pValues);
+		}
+		//The mesh is not rendered until it is resident
+		ResourceLoader::GrabInstance().AddJob( new MeshLoadingJob( pMesh, sName ) );
 		return pMesh;
 	}
 	else
 	{
-		return m_mMeshs[sName];
+		++(*iter).second.m_iRefCount;
+		return (*iter).second.m_pMesh;
+	}
+}
+
+void MeshManager::setPrecomputedBoundingBox(const std::string& sName, const float* pBoundingBox)
+{
+	sBoundingBox& rBox = m_mPrecomputedBoundingBoxes[sName];
+	for (unsigned int i = 0; i < 6; ++i)
+	{
+		rBox.m_pValues[i] = pBoundingBox[i];
+	}
+
+	std::map<std::string , sMesh>::iterator iter = m_mMeshs.find(sName);
+	if (iter != m_mMeshs.end() && !(*iter).second.m_pMesh->IsResident())
+	{
+		(*iter).second.m_pMesh->SetPrecomputedBoundingBox(pBoundingBox);
+	}
+}
+
+std::map<std::string,MeshManager::sMesh>::iterator MeshManager::_FindMesh(StaticMesh* pMesh)
+{
+	std::map<std::string , sMesh>::iterator iter = m_mMeshs.begin();
+	while (iter != m_mMeshs.end() && (*iter).second.m_pMesh != pMesh)
+	{
+		++iter;
+	}
+	return iter;
+}
+
+void MeshManager::releaseMesh(StaticMesh* pMesh)
+{
+	std::map<std::string , sMesh>::iterator iter = _FindMesh(pMesh);
+	if (iter == m_mMeshs.end())
+	{
+		return;
+	}
+
+	assert((*iter).second.m_iRefCount > 0);
+	--(*iter).second.m_iRefCount;
+	if ((*iter).second.m_iRefCount == 0 && !(*iter).second.m_bLoading)
+	{
+		delete pMesh;
+		m_mMeshs.erase(iter);
+	}
+}
+
+void MeshManager::_OnLoadingDone(StaticMesh* pMesh)
+{
+	std::map<std::string , sMesh>::iterator iter = _FindMesh(pMesh);
+	if (iter == m_mMeshs.end())
+	{
+		return;
+	}
+
+	(*iter).second.m_bLoading = false;
+	//The scene meshes stop waiting for a mesh that could not be loaded
+	if (!pMesh->IsResident())
+	{
+		pMesh->SetLoadFailed();
+	}
+	if ((*iter).second.m_iRefCount == 0)
+	{
+		delete pMesh;
+		m_mMeshs.erase(iter);
 	}
 }
\ No newline at end of file
@@ -16,6 +16,7 @@
 #include <map>
 
 #include "BurgerEngine/Base/Singleton.h"
+#include "BurgerEngine/Graphics/GeometryPool.h"
 
 
 class StaticMesh;
@@ -24,15 +25,49 @@ class MeshManager:public Singleton<MeshManager>
 {
 	friend class Singleton<MeshManager>;
 
+	friend class MeshLoadingJob;
+
 	public:
 		//void loadMesh(const std::string& sName);
+		/// \brief Load a mesh or share the one already loaded, each call must be matched by a releaseMesh
 		StaticMesh* loadMesh(const std::string& sName);
 		StaticMesh* getMesh(const std::string& sName);
 
+		/// \brief Drop a reference taken by loadMesh, the mesh and its place in the pool are freed with the last one
+		void releaseMesh(StaticMesh* pMesh);
+
+		/// \brief Bounds computed by the scene compiler, given to the mesh until it is resident
+		void setPrecomputedBoundingBox(const std::string& sName, const float* pBoundingBox);
+
 		void clear();
+
+		/// \brief The buffers every static mesh is allocated from
+		GeometryPool& GrabGeometryPool(){ return m_oGeometryPool; }
 	
 	private:
-		std::map<std::string,StaticMesh*> m_mMeshs;
+		struct sMesh
+		{
+			StaticMesh*		m_pMesh;
+			unsigned int	m_iRefCount;
+			/// The loading job still holds the mesh, it is deleted once the job is done
+			bool			m_bLoading;
+		};
+
+		/// \brief Called when the loading job of a mesh is deleted, whether it succeeded or not
+		void _OnLoadingDone(StaticMesh* pMesh);
+
+		/// \brief Find the entry of a mesh
+		std::map<std::string,sMesh>::iterator _FindMesh(StaticMesh* pMesh);
+
+		struct sBoundingBox
+		{
+			float	m_pValues[6];
+		};
+
+		std::map<std::string,sMesh> m_mMeshs;
+		/// Kept for the meshes loaded later, a scene compiled again replaces them
+		std::map<std::string,sBoundingBox> m_mPrecomputedBoundingBoxes;
+		GeometryPool m_oGeometryPool;
 
 		MeshManager();
 		virtual ~MeshManager(){clear();};
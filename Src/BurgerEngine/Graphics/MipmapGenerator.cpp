@@ -0,0 +1,617 @@
+#include "BurgerEngine/Graphics/MipmapGenerator.h"
+
+#include <math.h>
+#include <xmmintrin.h>
+
+#include <SFML/System.hpp>
+
+unsigned int MipmapGenerator::s_iThreadCount = 1;
+
+/// Levels smaller than this are not worth a thread
+static const unsigned int s_iMinBandPixelCount = 128 * 128;
+
+/// Precision of the linear to sRGB table
+static const unsigned int s_iToSRGBSize = 16384;
+
+/// Conversion tables between sRGB bytes and linear floats, built before main
+struct sGammaTables
+{
+	sGammaTables()
+	{
+		for( unsigned int i = 0; i < 256; ++i )
+		{
+			float fColor = i / 255.0f;
+			m_pToLinear[i] = fColor <= 0.04045f ? fColor / 12.92f : powf( ( fColor + 0.055f ) / 1.055f, 2.4f );
+		}
+		for( unsigned int i = 0; i < s_iToSRGBSize; ++i )
+		{
+			float fLinear = i / (float)( s_iToSRGBSize - 1 );
+			float fColor = fLinear <= 0.0031308f ? fLinear * 12.92f : 1.055f * powf( fLinear, 1.0f / 2.4f ) - 0.055f;
+			m_pToSRGB[i] = (GLubyte)( fColor * 255.0f + 0.5f );
+		}
+	}
+
+	float	m_pToLinear[256];
+	GLubyte	m_pToSRGB[ s_iToSRGBSize ];
+};
+
+static const sGammaTables s_oGammaTables;
+
+/// Taps of the Kaiser filter, for a destination pixel x they cover the source pixels 2x-2 to 2x+3
+static const unsigned int s_iKaiserTapCount = 6;
+
+/// A downsampling pass, the images are RGBA floats
+struct sPass
+{
+	float const*	m_pSource;
+	float*			m_pDestination;
+	unsigned int	m_iSourceWidth;
+	unsigned int	m_iSourceHeight;
+	unsigned int	m_iWidth;
+	unsigned int	m_iHeight;
+	float const*	m_pWeights;
+};
+
+/// Part of a job run by a thread
+typedef void (*BandFunction)( void* pContext, unsigned int iBegin, unsigned int iEnd );
+
+struct sBand
+{
+	BandFunction	m_pFunction;
+	void*			m_pContext;
+	unsigned int	m_iBegin;
+	unsigned int	m_iEnd;
+};
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static void RunBand( void* pUserData )
+{
+	sBand* pBand = (sBand*)pUserData;
+	pBand->m_pFunction( pBand->m_pContext, pBand->m_iBegin, pBand->m_iEnd );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Split [0, iCount) in bands run in parallel, the first one runs on the calling thread
+//--------------------------------------------------------------------------------------------------------------------
+static void RunBands( BandFunction pFunction, void* pContext, unsigned int iCount, unsigned int iThreadCount )
+{
+	if( iThreadCount > iCount )
+	{
+		iThreadCount = iCount;
+	}
+	if( iThreadCount <= 1 )
+	{
+		pFunction( pContext, 0, iCount );
+		return;
+	}
+
+	std::vector< sBand > vBands( iThreadCount );
+	for( unsigned int i = 0; i < iThreadCount; ++i )
+	{
+		vBands[i].m_pFunction = pFunction;
+		vBands[i].m_pContext = pContext;
+		vBands[i].m_iBegin = iCount * i / iThreadCount;
+		vBands[i].m_iEnd = iCount * ( i + 1 ) / iThreadCount;
+	}
+
+	std::vector< sf::Thread* > vThreads;
+	for( unsigned int i = 1; i < iThreadCount; ++i )
+	{
+		sf::Thread* pThread = new sf::Thread( &RunBand, &vBands[i] );
+		pThread->Launch();
+		vThreads.push_back( pThread );
+	}
+
+	RunBand( &vBands[0] );
+
+	FOR_EACH_IT( std::vector< sf::Thread* >, vThreads, itThread )
+	{
+		(*itThread)->Wait();
+		delete (*itThread);
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static unsigned int GetPassThreadCount( unsigned int iPixelCount, unsigned int iThreadCount )
+{
+	return iPixelCount >= s_iMinBandPixelCount ? iThreadCount : 1;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static float BesselI0( float x )
+{
+	float fSum = 1.0f;
+	float fTerm = 1.0f;
+	for( unsigned int k = 1; k < 20; ++k )
+	{
+		float fFactor = x / ( 2.0f * k );
+		fTerm *= fFactor * fFactor;
+		fSum += fTerm;
+	}
+	return fSum;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Kaiser windowed sinc for a half size downsampling, normalized
+//--------------------------------------------------------------------------------------------------------------------
+static void ComputeKaiserWeights( float pWeights[ s_iKaiserTapCount ] )
+{
+	const float fPi = 3.14159265f;
+	const float fAlpha = 4.0f;
+	const float fHalfWidth = 3.0f;
+
+	float fSum = 0.0f;
+	for( unsigned int k = 0; k < s_iKaiserTapCount; ++k )
+	{
+		//Distance to the center of the destination pixel, in source pixels
+		float fOffset = k - 2.5f;
+		float fSincInput = fPi * fOffset * 0.5f;
+		float fSinc = sinf( fSincInput ) / fSincInput;
+		float fRatio = fOffset / fHalfWidth;
+		float fWindow = BesselI0( fAlpha * sqrtf( 1.0f - fRatio * fRatio ) ) / BesselI0( fAlpha );
+		pWeights[k] = fSinc * fWindow;
+		fSum += pWeights[k];
+	}
+	for( unsigned int k = 0; k < s_iKaiserTapCount; ++k )
+	{
+		pWeights[k] /= fSum;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static void ToFloat( GLubyte const* pData, unsigned int iPixelCount, unsigned int iChannel, bool bGammaCorrect, float* pOut )
+{
+	for( unsigned int i = 0; i < iPixelCount; ++i )
+	{
+		for( unsigned int c = 0; c < 4; ++c )
+		{
+			float fValue = c == 3 ? 1.0f : 0.0f;
+			if( c < iChannel )
+			{
+				GLubyte iValue = pData[ i * iChannel + c ];
+				fValue = bGammaCorrect && c < 3 ? s_oGammaTables.m_pToLinear[ iValue ] : iValue / 255.0f;
+			}
+			pOut[ i * 4 + c ] = fValue;
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static void FromFloat( float const* pImage, unsigned int iPixelCount, unsigned int iChannel, bool bGammaCorrect, GLubyte* pOut )
+{
+	for( unsigned int i = 0; i < iPixelCount; ++i )
+	{
+		for( unsigned int c = 0; c < iChannel; ++c )
+		{
+			float fValue = pImage[ i * 4 + c ];
+			fValue = fValue < 0.0f ? 0.0f : ( fValue > 1.0f ? 1.0f : fValue );
+			if( bGammaCorrect && c < 3 )
+			{
+				pOut[ i * iChannel + c ] = s_oGammaTables.m_pToSRGB[ (unsigned int)( fValue * ( s_iToSRGBSize - 1 ) + 0.5f ) ];
+			}
+			else
+			{
+				pOut[ i * iChannel + c ] = (GLubyte)( fValue * 255.0f + 0.5f );
+			}
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// 2x2 box, rows [iBegin, iEnd) of the destination
+//--------------------------------------------------------------------------------------------------------------------
+static void BoxPass( void* pContext, unsigned int iBegin, unsigned int iEnd )
+{
+	sPass const& oPass = *(sPass const*)pContext;
+	const __m128 vQuarter = _mm_set1_ps( 0.25f );
+
+	for( unsigned int y = iBegin; y < iEnd; ++y )
+	{
+		unsigned int y0 = 2 * y < oPass.m_iSourceHeight ? 2 * y : oPass.m_iSourceHeight - 1;
+		unsigned int y1 = y0 + 1 < oPass.m_iSourceHeight ? y0 + 1 : y0;
+		float const* pRow0 = oPass.m_pSource + y0 * oPass.m_iSourceWidth * 4;
+		float const* pRow1 = oPass.m_pSource + y1 * oPass.m_iSourceWidth * 4;
+		float* pOut = oPass.m_pDestination + y * oPass.m_iWidth * 4;
+
+		for( unsigned int x = 0; x < oPass.m_iWidth; ++x )
+		{
+			unsigned int x0 = 2 * x < oPass.m_iSourceWidth ? 2 * x : oPass.m_iSourceWidth - 1;
+			unsigned int x1 = x0 + 1 < oPass.m_iSourceWidth ? x0 + 1 : x0;
+			__m128 vSum = _mm_add_ps( _mm_loadu_ps( pRow0 + x0 * 4 ), _mm_loadu_ps( pRow0 + x1 * 4 ) );
+			vSum = _mm_add_ps( vSum, _mm_add_ps( _mm_loadu_ps( pRow1 + x0 * 4 ), _mm_loadu_ps( pRow1 + x1 * 4 ) ) );
+			_mm_storeu_ps( pOut + x * 4, _mm_mul_ps( vSum, vQuarter ) );
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Horizontal Kaiser, rows [iBegin, iEnd) of the source, into a half width image
+//--------------------------------------------------------------------------------------------------------------------
+static void KaiserHorizontalPass( void* pContext, unsigned int iBegin, unsigned int iEnd )
+{
+	sPass const& oPass = *(sPass const*)pContext;
+	int iLastColumn = oPass.m_iSourceWidth - 1;
+
+	for( unsigned int y = iBegin; y < iEnd; ++y )
+	{
+		float const* pRow = oPass.m_pSource + y * oPass.m_iSourceWidth * 4;
+		float* pOut = oPass.m_pDestination + y * oPass.m_iWidth * 4;
+
+		for( unsigned int x = 0; x < oPass.m_iWidth; ++x )
+		{
+			__m128 vSum = _mm_setzero_ps();
+			for( unsigned int k = 0; k < s_iKaiserTapCount; ++k )
+			{
+				int iColumn = (int)( 2 * x + k ) - 2;
+				iColumn = iColumn < 0 ? 0 : ( iColumn > iLastColumn ? iLastColumn : iColumn );
+				vSum = _mm_add_ps( vSum, _mm_mul_ps( _mm_loadu_ps( pRow + iColumn * 4 ), _mm_set1_ps( oPass.m_pWeights[k] ) ) );
+			}
+			_mm_storeu_ps( pOut + x * 4, vSum );
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Vertical Kaiser, rows [iBegin, iEnd) of the destination, clamped to [0,1] against the ringing
+//--------------------------------------------------------------------------------------------------------------------
+static void KaiserVerticalPass( void* pContext, unsigned int iBegin, unsigned int iEnd )
+{
+	sPass const& oPass = *(sPass const*)pContext;
+	int iLastRow = oPass.m_iSourceHeight - 1;
+	const __m128 vZero = _mm_setzero_ps();
+	const __m128 vOne = _mm_set1_ps( 1.0f );
+
+	for( unsigned int y = iBegin; y < iEnd; ++y )
+	{
+		float const* pRows[ s_iKaiserTapCount ];
+		for( unsigned int k = 0; k < s_iKaiserTapCount; ++k )
+		{
+			int iRow = (int)( 2 * y + k ) - 2;
+			iRow = iRow < 0 ? 0 : ( iRow > iLastRow ? iLastRow : iRow );
+			pRows[k] = oPass.m_pSource + iRow * oPass.m_iWidth * 4;
+		}
+		float* pOut = oPass.m_pDestination + y * oPass.m_iWidth * 4;
+
+		for( unsigned int x = 0; x < oPass.m_iWidth; ++x )
+		{
+			__m128 vSum = _mm_setzero_ps();
+			for( unsigned int k = 0; k < s_iKaiserTapCount; ++k )
+			{
+				vSum = _mm_add_ps( vSum, _mm_mul_ps( _mm_loadu_ps( pRows[k] + x * 4 ), _mm_set1_ps( oPass.m_pWeights[k] ) ) );
+			}
+			_mm_storeu_ps( pOut + x * 4, _mm_min_ps( _mm_max_ps( vSum, vZero ), vOne ) );
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static float ComputeAlphaCoverage( float const* pImage, unsigned int iPixelCount, float fReference )
+{
+	unsigned int iCovered = 0;
+	for( unsigned int i = 0; i < iPixelCount; ++i )
+	{
+		iCovered += pImage[ i * 4 + 3 ] > fReference ? 1 : 0;
+	}
+	return iCovered / (float)iPixelCount;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Find the alpha threshold giving the wanted coverage, then scale alpha so that this threshold lands on the reference
+//--------------------------------------------------------------------------------------------------------------------
+static void ScaleAlphaToCoverage( float* pImage, unsigned int iPixelCount, float fCoverage, float fReference )
+{
+	float fMin = 0.0f;
+	float fMax = 1.0f;
+	for( unsigned int i = 0; i < 10; ++i )
+	{
+		float fThreshold = ( fMin + fMax ) * 0.5f;
+		if( ComputeAlphaCoverage( pImage, iPixelCount, fThreshold ) > fCoverage )
+		{
+			fMin = fThreshold;
+		}
+		else
+		{
+			fMax = fThreshold;
+		}
+	}
+
+	//The last threshold still covering enough: the pixels above it land strictly above the reference.
+	//The middle of the range could put a whole band of equal alphas right on the reference, and lose it to the rounding.
+	//When none covers enough, the smallest one tried brings the most pixels up
+	float fThreshold = fMin > 0.0f ? fMin : fMax;
+	float fScale = fReference / fThreshold;
+	for( unsigned int i = 0; i < iPixelCount; ++i )
+	{
+		float fAlpha = pImage[ i * 4 + 3 ] * fScale;
+		pImage[ i * 4 + 3 ] = fAlpha > 1.0f ? 1.0f : fAlpha;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static void GenerateChain( GLubyte const* pData, unsigned int iWidth, unsigned int iHeight, unsigned int iChannel, MipmapGenerator::sSettings const& oSettings, unsigned int iThreadCount, MipmapGenerator::MipChain& vLevelsOut )
+{
+	unsigned int iLevelCount = MipmapGenerator::GetLevelCount( iWidth, iHeight );
+	vLevelsOut.clear();
+	vLevelsOut.resize( iLevelCount );
+	vLevelsOut[0].assign( pData, pData + iWidth * iHeight * iChannel );
+	if( iLevelCount == 1 )
+	{
+		return;
+	}
+
+	bool bAlphaCoverage = iChannel == 4 && oSettings.m_fAlphaCoverage >= 0.0f;
+
+	std::vector< float > vLevel( iWidth * iHeight * 4 );
+	std::vector< float > vNextLevel;
+	std::vector< float > vTemporary;
+	ToFloat( pData, iWidth * iHeight, iChannel, oSettings.m_bGammaCorrect, &vLevel[0] );
+
+	float fCoverage = bAlphaCoverage ? ComputeAlphaCoverage( &vLevel[0], iWidth * iHeight, oSettings.m_fAlphaCoverage ) : 0.0f;
+
+	float pWeights[ s_iKaiserTapCount ];
+	ComputeKaiserWeights( pWeights );
+
+	for( unsigned int iLevel = 1; iLevel < iLevelCount; ++iLevel )
+	{
+		unsigned int iLevelWidth = MipmapGenerator::GetLevelSize( iWidth, 1 );
+		unsigned int iLevelHeight = MipmapGenerator::GetLevelSize( iHeight, 1 );
+		vNextLevel.resize( iLevelWidth * iLevelHeight * 4 );
+
+		sPass oPass;
+		oPass.m_iSourceWidth = iWidth;
+		oPass.m_iSourceHeight = iHeight;
+		oPass.m_iWidth = iLevelWidth;
+		oPass.m_pWeights = pWeights;
+
+		if( oSettings.m_eFilter == MipmapGenerator::E_FILTER_KAISER )
+		{
+			vTemporary.resize( iLevelWidth * iHeight * 4 );
+			oPass.m_pSource = &vLevel[0];
+			oPass.m_pDestination = &vTemporary[0];
+			oPass.m_iHeight = iHeight;
+			RunBands( &KaiserHorizontalPass, &oPass, iHeight, GetPassThreadCount( iLevelWidth * iHeight, iThreadCount ) );
+
+			oPass.m_pSource = &vTemporary[0];
+			oPass.m_pDestination = &vNextLevel[0];
+			oPass.m_iHeight = iLevelHeight;
+			RunBands( &KaiserVerticalPass, &oPass, iLevelHeight, GetPassThreadCount( iLevelWidth * iLevelHeight, iThreadCount ) );
+		}
+		else
+		{
+			oPass.m_pSource = &vLevel[0];
+			oPass.m_pDestination = &vNextLevel[0];
+			oPass.m_iHeight = iLevelHeight;
+			RunBands( &BoxPass, &oPass, iLevelHeight, GetPassThreadCount( iLevelWidth * iLevelHeight, iThreadCount ) );
+		}
+
+		if( bAlphaCoverage )
+		{
+			ScaleAlphaToCoverage( &vNextLevel[0], iLevelWidth * iLevelHeight, fCoverage, oSettings.m_fAlphaCoverage );
+		}
+
+		vLevelsOut[ iLevel ].resize( iLevelWidth * iLevelHeight * iChannel );
+		FromFloat( &vNextLevel[0], iLevelWidth * iLevelHeight, iChannel, oSettings.m_bGammaCorrect, &vLevelsOut[ iLevel ][0] );
+
+		vLevel.swap( vNextLevel );
+		iWidth = iLevelWidth;
+		iHeight = iLevelHeight;
+	}
+}
+
+/// A volume downsampling pass, by slices
+struct sVolumePass
+{
+	float const*	m_pSource;
+	float*			m_pDestination;
+	unsigned int	m_iSourceWidth;
+	unsigned int	m_iSourceHeight;
+	unsigned int	m_iSourceDepth;
+	unsigned int	m_iWidth;
+	unsigned int	m_iHeight;
+};
+
+//--------------------------------------------------------------------------------------------------------------------
+// 2x2x2 box, slices [iBegin, iEnd) of the destination
+//--------------------------------------------------------------------------------------------------------------------
+static void VolumeBoxPass( void* pContext, unsigned int iBegin, unsigned int iEnd )
+{
+	sVolumePass const& oPass = *(sVolumePass const*)pContext;
+	const __m128 vEighth = _mm_set1_ps( 0.125f );
+	unsigned int iSourceSlice = oPass.m_iSourceWidth * oPass.m_iSourceHeight * 4;
+
+	for( unsigned int z = iBegin; z < iEnd; ++z )
+	{
+		unsigned int z0 = 2 * z < oPass.m_iSourceDepth ? 2 * z : oPass.m_iSourceDepth - 1;
+		unsigned int z1 = z0 + 1 < oPass.m_iSourceDepth ? z0 + 1 : z0;
+		for( unsigned int y = 0; y < oPass.m_iHeight; ++y )
+		{
+			unsigned int y0 = 2 * y < oPass.m_iSourceHeight ? 2 * y : oPass.m_iSourceHeight - 1;
+			unsigned int y1 = y0 + 1 < oPass.m_iSourceHeight ? y0 + 1 : y0;
+			float const* pRows[4] =
+			{
+				oPass.m_pSource + z0 * iSourceSlice + y0 * oPass.m_iSourceWidth * 4,
+				oPass.m_pSource + z0 * iSourceSlice + y1 * oPass.m_iSourceWidth * 4,
+				oPass.m_pSource + z1 * iSourceSlice + y0 * oPass.m_iSourceWidth * 4,
+				oPass.m_pSource + z1 * iSourceSlice + y1 * oPass.m_iSourceWidth * 4,
+			};
+			float* pOut = oPass.m_pDestination + ( z * oPass.m_iHeight + y ) * oPass.m_iWidth * 4;
+
+			for( unsigned int x = 0; x < oPass.m_iWidth; ++x )
+			{
+				unsigned int x0 = 2 * x < oPass.m_iSourceWidth ? 2 * x : oPass.m_iSourceWidth - 1;
+				unsigned int x1 = x0 + 1 < oPass.m_iSourceWidth ? x0 + 1 : x0;
+				__m128 vSum = _mm_setzero_ps();
+				for( unsigned int r = 0; r < 4; ++r )
+				{
+					vSum = _mm_add_ps( vSum, _mm_add_ps( _mm_loadu_ps( pRows[r] + x0 * 4 ), _mm_loadu_ps( pRows[r] + x1 * 4 ) ) );
+				}
+				_mm_storeu_ps( pOut + x * 4, _mm_mul_ps( vSum, vEighth ) );
+			}
+		}
+	}
+}
+
+/// One face of a cube map
+struct sCubeFace
+{
+	GLubyte const*						m_pData;
+	MipmapGenerator::MipChain*			m_pLevels;
+};
+
+/// The six faces and their common settings
+struct sCubeJob
+{
+	sCubeFace							m_pFaces[6];
+	unsigned int						m_iSize;
+	unsigned int						m_iChannel;
+	MipmapGenerator::sSettings const*	m_pSettings;
+};
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static void CubeFacePass( void* pContext, unsigned int iBegin, unsigned int iEnd )
+{
+	sCubeJob const& oJob = *(sCubeJob const*)pContext;
+	for( unsigned int i = iBegin; i < iEnd; ++i )
+	{
+		//Already one thread per face
+		GenerateChain( oJob.m_pFaces[i].m_pData, oJob.m_iSize, oJob.m_iSize, oJob.m_iChannel, *oJob.m_pSettings, 1, *oJob.m_pFaces[i].m_pLevels );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+MipmapGenerator::sSettings::sSettings()
+	: m_eFilter( E_FILTER_KAISER )
+	, m_bGammaCorrect( true )
+	, m_fAlphaCoverage( -1.0f )
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+unsigned int MipmapGenerator::sSettings::GetKey() const
+{
+	unsigned int iAlphaCoverage = m_fAlphaCoverage < 0.0f ? 0xff : (unsigned int)( m_fAlphaCoverage * 254.0f + 0.5f );
+	return (unsigned int)m_eFilter | ( m_bGammaCorrect ? 1 : 0 ) << 8 | iAlphaCoverage << 16;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void MipmapGenerator::SetThreadCount( unsigned int iThreadCount )
+{
+	s_iThreadCount = iThreadCount > 0 ? iThreadCount : 1;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+unsigned int MipmapGenerator::GetLevelSize( unsigned int iSize, unsigned int iLevel )
+{
+	unsigned int iLevelSize = iSize >> iLevel;
+	return iLevelSize > 0 ? iLevelSize : 1;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+unsigned int MipmapGenerator::GetLevelCount( unsigned int iWidth, unsigned int iHeight, unsigned int iDepth )
+{
+	unsigned int iSize = iWidth > iHeight ? iWidth : iHeight;
+	iSize = iSize > iDepth ? iSize : iDepth;
+	unsigned int iCount = 1;
+	while( iSize > 1 )
+	{
+		iSize >>= 1;
+		++iCount;
+	}
+	return iCount;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void MipmapGenerator::Generate( GLubyte const* pData, unsigned int iWidth, unsigned int iHeight, unsigned int iChannel, sSettings const& oSettings, MipChain& vLevelsOut )
+{
+	assert( pData && iChannel > 0 && iChannel <= 4 );
+	GenerateChain( pData, iWidth, iHeight, iChannel, oSettings, s_iThreadCount, vLevelsOut );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void MipmapGenerator::Generate3D( GLubyte const* pData, unsigned int iWidth, unsigned int iHeight, unsigned int iDepth, unsigned int iChannel, sSettings const& oSettings, MipChain& vLevelsOut )
+{
+	assert( pData && iChannel > 0 && iChannel <= 4 );
+
+	unsigned int iLevelCount = GetLevelCount( iWidth, iHeight, iDepth );
+	vLevelsOut.clear();
+	vLevelsOut.resize( iLevelCount );
+	vLevelsOut[0].assign( pData, pData + iWidth * iHeight * iDepth * iChannel );
+
+	std::vector< float > vLevel( iWidth * iHeight * iDepth * 4 );
+	std::vector< float > vNextLevel;
+	ToFloat( pData, iWidth * iHeight * iDepth, iChannel, oSettings.m_bGammaCorrect, &vLevel[0] );
+
+	for( unsigned int iLevel = 1; iLevel < iLevelCount; ++iLevel )
+	{
+		sVolumePass oPass;
+		oPass.m_iSourceWidth = iWidth;
+		oPass.m_iSourceHeight = iHeight;
+		oPass.m_iSourceDepth = iDepth;
+		oPass.m_iWidth = GetLevelSize( iWidth, 1 );
+		oPass.m_iHeight = GetLevelSize( iHeight, 1 );
+		unsigned int iLevelDepth = GetLevelSize( iDepth, 1 );
+		unsigned int iPixelCount = oPass.m_iWidth * oPass.m_iHeight * iLevelDepth;
+
+		vNextLevel.resize( iPixelCount * 4 );
+		oPass.m_pSource = &vLevel[0];
+		oPass.m_pDestination = &vNextLevel[0];
+		RunBands( &VolumeBoxPass, &oPass, iLevelDepth, GetPassThreadCount( iPixelCount, s_iThreadCount ) );
+
+		vLevelsOut[ iLevel ].resize( iPixelCount * iChannel );
+		FromFloat( &vNextLevel[0], iPixelCount, iChannel, oSettings.m_bGammaCorrect, &vLevelsOut[ iLevel ][0] );
+
+		vLevel.swap( vNextLevel );
+		iWidth = oPass.m_iWidth;
+		iHeight = oPass.m_iHeight;
+		iDepth = iLevelDepth;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void MipmapGenerator::GenerateCubeFaces( GLubyte const* const pFaces[6], unsigned int iSize, unsigned int iChannel, sSettings const& oSettings, MipChain pLevelsOut[6] )
+{
+	sCubeJob oJob;
+	for( unsigned int i = 0; i < 6; ++i )
+	{
+		assert( pFaces[i] );
+		oJob.m_pFaces[i].m_pData = pFaces[i];
+		oJob.m_pFaces[i].m_pLevels = &pLevelsOut[i];
+	}
+	oJob.m_iSize = iSize;
+	oJob.m_iChannel = iChannel;
+	oJob.m_pSettings = &oSettings;
+
+	RunBands( &CubeFacePass, &oJob, 6, s_iThreadCount );
+}
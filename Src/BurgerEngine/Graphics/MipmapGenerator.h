@@ -0,0 +1,76 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __MIPMAPGENERATOR_H__
+#define __MIPMAPGENERATOR_H__
+
+#include <vector>
+
+#include "BurgerEngine/Graphics/CommonGraphics.h"
+
+/// \class	MipmapGenerator
+/// \brief	Builds mip chains on the CPU, instead of leaving it to GL_GENERATE_MIPMAP.
+///			Filtering is done in float with SSE, in linear space for color images,
+///			and the big levels are split in bands run by several threads
+class MipmapGenerator
+{
+public:
+
+	enum MipmapFilter
+	{
+		E_FILTER_BOX = 0,
+		/// Kaiser windowed sinc, sharper than the box filter
+		E_FILTER_KAISER,
+	};
+
+	/// \brief How a texture builds its mip levels, read from the texture xml
+	struct sSettings
+	{
+		sSettings();
+
+		/// Single key of the settings, to check a cached mip chain was built with them
+		unsigned int GetKey() const;
+
+		MipmapFilter	m_eFilter;
+		/// Filter sRGB colors in linear space, off for data textures (normal maps...)
+		bool			m_bGammaCorrect;
+		/// Alpha test reference of cut-out textures, the levels keep the coverage of the first one.
+		/// Negative to disable
+		float			m_fAlphaCoverage;
+	};
+
+	/// Every level of an image, from the largest, with the channel count of the source
+	typedef std::vector< std::vector< GLubyte > > MipChain;
+
+	/// \brief Number of threads used for the big levels, 1 runs everything on the calling thread
+	static void SetThreadCount( unsigned int iThreadCount );
+
+	/// \brief Full mip chain of an 8 bits image (1 to 4 channels), down to 1x1
+	static void Generate( GLubyte const* pData, unsigned int iWidth, unsigned int iHeight, unsigned int iChannel, sSettings const& oSettings, MipChain& vLevelsOut );
+
+	/// \brief Full mip chain of a volume, always box filtered
+	static void Generate3D( GLubyte const* pData, unsigned int iWidth, unsigned int iHeight, unsigned int iDepth, unsigned int iChannel, sSettings const& oSettings, MipChain& vLevelsOut );
+
+	/// \brief Mip chains of the six faces of a cube map, one thread per face
+	static void GenerateCubeFaces( GLubyte const* const pFaces[6], unsigned int iSize, unsigned int iChannel, sSettings const& oSettings, MipChain pLevelsOut[6] );
+
+	/// \brief Size of a level, never below 1
+	static unsigned int GetLevelSize( unsigned int iSize, unsigned int iLevel );
+
+	/// \brief Number of levels of a full mip chain
+	static unsigned int GetLevelCount( unsigned int iWidth, unsigned int iHeight, unsigned int iDepth = 1 );
+
+private:
+
+	static unsigned int s_iThreadCount;
+};
+
+#endif //__MIPMAPGENERATOR_H__
@@ -1,8 +1,28 @@
 #include "OpenGLContext.h"
 #include "BurgerEngine/Core/Engine.h"
 #include "BurgerEngine/Input/EventManager.h"
+#include "BurgerEngine/Graphics/UniformBuffer.h"
+#include "BurgerEngine/Graphics/DrawBatch.h"
 
+#ifndef GL_UNIFORM_BUFFER
+	#define GL_UNIFORM_BUFFER				0x8A11
+#endif
 
+GLhandleARB		OpenGLContext::s_oProgram = 0;
+bool			OpenGLContext::s_bProgramKnown = false;
+unsigned int	OpenGLContext::s_iActiveUnit = OpenGLContext::E_UNKNOWN;
+unsigned int	OpenGLContext::s_pTextures[ E_MAX_TEXTURE_UNITS ][ E_TEXTURE_TARGET_COUNT ];
+unsigned int	OpenGLContext::s_pBuffers[ E_BUFFER_TARGET_COUNT ];
+unsigned int	OpenGLContext::s_pCapabilities[ E_CAPABILITY_COUNT ];
+unsigned int	OpenGLContext::s_pBlendFunc[2];
+unsigned int	OpenGLContext::s_iDepthMask = OpenGLContext::E_UNKNOWN;
+unsigned int	OpenGLContext::s_iCullFace = OpenGLContext::E_UNKNOWN;
+unsigned int	OpenGLContext::s_pViewport[4];
+
+unsigned int	OpenGLContext::s_iIssuedCalls = 0;
+unsigned int	OpenGLContext::s_iAvoidedCalls = 0;
+unsigned int	OpenGLContext::s_iLastIssuedCalls = 0;
+unsigned int	OpenGLContext::s_iLastAvoidedCalls = 0;
 
 //--------------------------------------------------------------------------------------------------------------------
 //
@@ -30,17 +50,22 @@ bool OpenGLContext::Initialize( const unsigned int a_iWindowWidth, const unsigne
 	glClearColor(0.f,0.f,0.f,0.f);
 	glClearDepth(1.f);
 
-	glEnable(GL_DEPTH_TEST);
-	glDepthMask(GL_TRUE);
-	glEnable(GL_CULL_FACE);
+	InvalidateState();
+	Enable(GL_DEPTH_TEST);
+	DepthMask(GL_TRUE);
+	Enable(GL_CULL_FACE);
 	
-	glDisable(GL_BLEND);
+	Disable(GL_BLEND);
     //glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	
 	glPolygonMode(GL_FRONT_AND_BACK,GL_FILL);
 	glPixelStorei(GL_UNPACK_ALIGNMENT,1);
 	glPixelStorei(GL_PACK_ALIGNMENT,1);
 
+	//Entry points newer than GLee
+	UniformBuffer::InitializeExtension();
+	DrawBatch::InitializeExtension();
+
 	//Reshape Once for start
 	//are these line usefull??
 	//ReshapeGl(a_iWindowWidth,a_iWindowHeight);
@@ -76,4 +101,352 @@ bool OpenGLContext::CheckError()
 	}
 
 	return false;
-}
\ No newline at end of file
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::BeginFrame()
+{
+	s_iLastIssuedCalls = s_iIssuedCalls;
+	s_iLastAvoidedCalls = s_iAvoidedCalls;
+	s_iIssuedCalls = 0;
+	s_iAvoidedCalls = 0;
+
+	InvalidateState();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::InvalidateState()
+{
+	s_bProgramKnown = false;
+	s_iActiveUnit = E_UNKNOWN;
+	for( unsigned int i = 0; i < E_MAX_TEXTURE_UNITS; ++i )
+	{
+		for( unsigned int j = 0; j < E_TEXTURE_TARGET_COUNT; ++j )
+		{
+			s_pTextures[i][j] = E_UNKNOWN;
+		}
+	}
+	for( unsigned int i = 0; i < E_BUFFER_TARGET_COUNT; ++i )
+	{
+		s_pBuffers[i] = E_UNKNOWN;
+	}
+	for( unsigned int i = 0; i < E_CAPABILITY_COUNT; ++i )
+	{
+		s_pCapabilities[i] = E_UNKNOWN;
+	}
+	s_pBlendFunc[0] = s_pBlendFunc[1] = E_UNKNOWN;
+	s_iDepthMask = E_UNKNOWN;
+	s_iCullFace = E_UNKNOWN;
+	for( unsigned int i = 0; i < 4; ++i )
+	{
+		s_pViewport[i] = E_UNKNOWN;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool OpenGLContext::_Change( unsigned int& iCached, unsigned int iValue )
+{
+	if( iCached == iValue )
+	{
+		++s_iAvoidedCalls;
+		return false;
+	}
+	iCached = iValue;
+	++s_iIssuedCalls;
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+int OpenGLContext::_GetTextureTarget( GLenum eTarget )
+{
+	switch( eTarget )
+	{
+	case GL_TEXTURE_2D:			return E_TEXTURE_TARGET_2D;
+	case GL_TEXTURE_3D:			return E_TEXTURE_TARGET_3D;
+	case GL_TEXTURE_CUBE_MAP:	return E_TEXTURE_TARGET_CUBE_MAP;
+	case GL_TEXTURE_2D_ARRAY_EXT:	return E_TEXTURE_TARGET_2D_ARRAY;
+	default:					return -1;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+int OpenGLContext::_GetBufferTarget( GLenum eTarget )
+{
+	switch( eTarget )
+	{
+	case GL_ARRAY_BUFFER:			return E_BUFFER_TARGET_ARRAY;
+	case GL_ELEMENT_ARRAY_BUFFER:	return E_BUFFER_TARGET_ELEMENT_ARRAY;
+	case GL_UNIFORM_BUFFER:			return E_BUFFER_TARGET_UNIFORM;
+	default:						return -1;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+int OpenGLContext::_GetCapability( GLenum eCapability )
+{
+	switch( eCapability )
+	{
+	case GL_BLEND:		return E_CAPABILITY_BLEND;
+	case GL_DEPTH_TEST:	return E_CAPABILITY_DEPTH_TEST;
+	case GL_CULL_FACE:	return E_CAPABILITY_CULL_FACE;
+	default:			return -1;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::UseProgram( GLhandleARB oProgram )
+{
+	//GLhandleARB is not an integer on every platform, it gets its own flag
+	if( s_bProgramKnown && s_oProgram == oProgram )
+	{
+		++s_iAvoidedCalls;
+		return;
+	}
+	s_oProgram = oProgram;
+	s_bProgramKnown = true;
+	++s_iIssuedCalls;
+	glUseProgramObjectARB( oProgram );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::ActiveTexture( GLenum eUnit )
+{
+	if( _Change( s_iActiveUnit, eUnit - GL_TEXTURE0 ) )
+	{
+		glActiveTexture( eUnit );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::BindTexture( GLenum eTarget, GLuint iTexture )
+{
+	int iTarget = _GetTextureTarget( eTarget );
+	if( iTarget < 0 || s_iActiveUnit >= E_MAX_TEXTURE_UNITS )
+	{
+		++s_iIssuedCalls;
+		glBindTexture( eTarget, iTexture );
+		return;
+	}
+	if( _Change( s_pTextures[ s_iActiveUnit ][ iTarget ], iTexture ) )
+	{
+		glBindTexture( eTarget, iTexture );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::DeleteTexture( GLuint iTexture )
+{
+	if( iTexture == 0 )
+	{
+		return;
+	}
+	//GL unbinds a deleted texture, and its name may come back from the next glGenTextures
+	for( unsigned int i = 0; i < E_MAX_TEXTURE_UNITS; ++i )
+	{
+		for( unsigned int j = 0; j < E_TEXTURE_TARGET_COUNT; ++j )
+		{
+			if( s_pTextures[i][j] == iTexture )
+			{
+				s_pTextures[i][j] = 0;
+			}
+		}
+	}
+	glDeleteTextures( 1, &iTexture );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::BindBuffer( GLenum eTarget, GLuint iBuffer )
+{
+	int iTarget = _GetBufferTarget( eTarget );
+	if( iTarget < 0 )
+	{
+		++s_iIssuedCalls;
+		glBindBuffer( eTarget, iBuffer );
+		return;
+	}
+	if( _Change( s_pBuffers[ iTarget ], iBuffer ) )
+	{
+		glBindBuffer( eTarget, iBuffer );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::BindBufferBase( GLenum eTarget, GLuint iIndex, GLuint iBuffer )
+{
+	int iTarget = _GetBufferTarget( eTarget );
+	if( iTarget >= 0 )
+	{
+		s_pBuffers[ iTarget ] = iBuffer;
+	}
+	++s_iIssuedCalls;
+	glBindBufferBase( eTarget, iIndex, iBuffer );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::DeleteBuffer( GLuint iBuffer )
+{
+	if( iBuffer == 0 )
+	{
+		return;
+	}
+	for( unsigned int i = 0; i < E_BUFFER_TARGET_COUNT; ++i )
+	{
+		if( s_pBuffers[i] == iBuffer )
+		{
+			s_pBuffers[i] = 0;
+		}
+	}
+	glDeleteBuffers( 1, &iBuffer );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::_SetCapability( GLenum eCapability, bool bEnabled )
+{
+	int iCapability = _GetCapability( eCapability );
+	if( iCapability >= 0 && !_Change( s_pCapabilities[ iCapability ], bEnabled ? 1 : 0 ) )
+	{
+		return;
+	}
+	if( iCapability < 0 )
+	{
+		++s_iIssuedCalls;
+	}
+
+	if( bEnabled )
+	{
+		glEnable( eCapability );
+	}
+	else
+	{
+		glDisable( eCapability );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::Enable( GLenum eCapability )
+{
+	_SetCapability( eCapability, true );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::Disable( GLenum eCapability )
+{
+	_SetCapability( eCapability, false );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::EnableIndexed( GLenum eCapability, GLuint iIndex )
+{
+	int iCapability = _GetCapability( eCapability );
+	if( iCapability >= 0 )
+	{
+		s_pCapabilities[ iCapability ] = E_UNKNOWN;
+	}
+	++s_iIssuedCalls;
+	glEnableIndexedEXT( eCapability, iIndex );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::DisableIndexed( GLenum eCapability, GLuint iIndex )
+{
+	int iCapability = _GetCapability( eCapability );
+	if( iCapability >= 0 )
+	{
+		s_pCapabilities[ iCapability ] = E_UNKNOWN;
+	}
+	++s_iIssuedCalls;
+	glDisableIndexedEXT( eCapability, iIndex );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::BlendFunc( GLenum eSource, GLenum eDestination )
+{
+	if( s_pBlendFunc[0] == eSource && s_pBlendFunc[1] == eDestination )
+	{
+		++s_iAvoidedCalls;
+		return;
+	}
+	s_pBlendFunc[0] = eSource;
+	s_pBlendFunc[1] = eDestination;
+	++s_iIssuedCalls;
+	glBlendFunc( eSource, eDestination );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::DepthMask( GLboolean bMask )
+{
+	if( _Change( s_iDepthMask, bMask ) )
+	{
+		glDepthMask( bMask );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::CullFace( GLenum eFace )
+{
+	if( _Change( s_iCullFace, eFace ) )
+	{
+		glCullFace( eFace );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void OpenGLContext::Viewport( GLint iX, GLint iY, GLsizei iWidth, GLsizei iHeight )
+{
+	if( s_pViewport[0] == (unsigned int)iX && s_pViewport[1] == (unsigned int)iY
+		&& s_pViewport[2] == (unsigned int)iWidth && s_pViewport[3] == (unsigned int)iHeight )
+	{
+		++s_iAvoidedCalls;
+		return;
+	}
+	s_pViewport[0] = iX;
+	s_pViewport[1] = iY;
+	s_pViewport[2] = iWidth;
+	s_pViewport[3] = iHeight;
+	++s_iIssuedCalls;
+	glViewport( iX, iY, iWidth, iHeight );
+}
@@ -17,6 +17,10 @@
 /// \name	OpenGLContext.h
 /// \brief	With this class you can Init the GL param. So far the context is shared between all window
 /// However in the futur it would be nice to choose whether we want a different context for each window or not
+///
+/// The context also keeps a copy of the GL state (program, textures per unit, buffers, blend/depth/cull, viewport).
+/// The engine changes that state through the static functions below, which drop the calls that would not change anything.
+/// Code that touches the state behind its back (external libraries) must call InvalidateState afterwards
 
 class OpenGLContext
 {
@@ -38,6 +42,48 @@ public:
 	/// \return true if error, false otherwise
 	bool CheckError();
 
+	/// \name State cache
+	/// \{
+
+	/// \brief Start the counters of a new frame and forget the state, the window may have touched it between two frames
+	static void BeginFrame();
+
+	/// \brief Every cached value becomes unknown, the next call of each kind reaches GL
+	static void InvalidateState();
+
+	static void UseProgram( GLhandleARB oProgram );
+	static GLhandleARB GetProgram(){ return s_oProgram; }
+
+	/// \brief eUnit is GL_TEXTUREi, as for glActiveTexture
+	static void ActiveTexture( GLenum eUnit );
+	/// \brief Bind on the active unit
+	static void BindTexture( GLenum eTarget, GLuint iTexture );
+	/// \brief Delete a texture and forget it on the units where it was bound
+	static void DeleteTexture( GLuint iTexture );
+
+	static void BindBuffer( GLenum eTarget, GLuint iBuffer );
+	/// \brief glBindBufferBase, which binds the generic target of eTarget as well
+	static void BindBufferBase( GLenum eTarget, GLuint iIndex, GLuint iBuffer );
+	static void DeleteBuffer( GLuint iBuffer );
+
+	/// \brief GL_BLEND, GL_DEPTH_TEST and GL_CULL_FACE are cached, the other capabilities are passed through
+	static void Enable( GLenum eCapability );
+	static void Disable( GLenum eCapability );
+	/// \brief Blending of one draw buffer, the cached blend state of all buffers becomes unknown
+	static void EnableIndexed( GLenum eCapability, GLuint iIndex );
+	static void DisableIndexed( GLenum eCapability, GLuint iIndex );
+
+	static void BlendFunc( GLenum eSource, GLenum eDestination );
+	static void DepthMask( GLboolean bMask );
+	static void CullFace( GLenum eFace );
+	static void Viewport( GLint iX, GLint iY, GLsizei iWidth, GLsizei iHeight );
+
+	/// \brief Calls of the last frame sent to GL, and dropped because the state was already set
+	static unsigned int GetIssuedStateCallCount(){ return s_iLastIssuedCalls; }
+	static unsigned int GetAvoidedStateCallCount(){ return s_iLastAvoidedCalls; }
+
+	/// \}
+
 	/// \group Grabber
 	/// \{
 
@@ -55,7 +101,62 @@ public:
 
 private:
 
-
+	enum
+	{
+		E_MAX_TEXTURE_UNITS = 16,
+		E_UNKNOWN = 0xFFFFFFFF
+	};
+
+	enum TextureTarget
+	{
+		E_TEXTURE_TARGET_2D,
+		E_TEXTURE_TARGET_3D,
+		E_TEXTURE_TARGET_CUBE_MAP,
+		E_TEXTURE_TARGET_2D_ARRAY,
+		E_TEXTURE_TARGET_COUNT
+	};
+
+	enum BufferTarget
+	{
+		E_BUFFER_TARGET_ARRAY,
+		E_BUFFER_TARGET_ELEMENT_ARRAY,
+		E_BUFFER_TARGET_UNIFORM,
+		E_BUFFER_TARGET_COUNT
+	};
+
+	enum Capability
+	{
+		E_CAPABILITY_BLEND,
+		E_CAPABILITY_DEPTH_TEST,
+		E_CAPABILITY_CULL_FACE,
+		E_CAPABILITY_COUNT
+	};
+
+	/// \brief Slot of a GL enum in the cache, -1 when it is not cached
+	static int _GetTextureTarget( GLenum eTarget );
+	static int _GetBufferTarget( GLenum eTarget );
+	static int _GetCapability( GLenum eCapability );
+
+	static void _SetCapability( GLenum eCapability, bool bEnabled );
+
+	/// \brief Count a call, true when it must reach GL
+	static bool _Change( unsigned int& iCached, unsigned int iValue );
+
+	static GLhandleARB	s_oProgram;
+	static bool			s_bProgramKnown;
+	static unsigned int	s_iActiveUnit;
+	static unsigned int	s_pTextures[ E_MAX_TEXTURE_UNITS ][ E_TEXTURE_TARGET_COUNT ];
+	static unsigned int	s_pBuffers[ E_BUFFER_TARGET_COUNT ];
+	static unsigned int	s_pCapabilities[ E_CAPABILITY_COUNT ];
+	static unsigned int	s_pBlendFunc[2];
+	static unsigned int	s_iDepthMask;
+	static unsigned int	s_iCullFace;
+	static unsigned int	s_pViewport[4];
+
+	static unsigned int	s_iIssuedCalls;
+	static unsigned int	s_iAvoidedCalls;
+	static unsigned int	s_iLastIssuedCalls;
+	static unsigned int	s_iLastAvoidedCalls;
 };
 
 #endif //__OPENGLCONTEXT_H__
@@ -10,13 +10,18 @@
 #include "BurgerEngine/Graphics/SceneMesh.h"
 #include "BurgerEngine/Graphics/SkyBox.h"
 
+#include <algorithm>
+
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
 RenderingContext::RenderingContext():
 	m_pDeferredRenderer(NULL),
 	m_pParticleRenderer(NULL),
-	m_pSkyBox(NULL)
+	m_pSkyBox(NULL),
+	m_iMatrixSerial(0),
+	m_iCurrentObject(0),
+	m_pCurrentWorld(NULL)
 {
 
 }
@@ -110,4 +115,42 @@ void RenderingContext::AddLight( SceneLight& a_rLight, SceneLight::LightType a_e
 		case SceneLight::E_SPOT_SHADOW: m_oSpotShadows.push_back(static_cast<SpotShadow*>(&a_rLight));break;
 		default:break;
 	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+template< typename T >
+static void RemoveFrom( std::vector< T* >& rList, T* pElement )
+{
+	typename std::vector< T* >::iterator it = std::find( rList.begin(), rList.end(), pElement );
+	if( it != rList.end() )
+	{
+		rList.erase( it );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void RenderingContext::RemoveMesh(SceneMesh& a_rSceneMesh)
+{
+	RemoveFrom( m_oSceneMeshes, &a_rSceneMesh );
+	RemoveFrom( m_oTransparentSceneMeshes, &a_rSceneMesh );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void RenderingContext::RemoveLight( SceneLight& a_rLight, SceneLight::LightType a_eType )
+{
+	switch (a_eType)
+	{
+		case SceneLight::E_DIRECTIONAL:RemoveFrom(m_oDirectionalLights, static_cast<DirectionalLight*>(&a_rLight));break;
+		case SceneLight::E_OMNI_LIGHT:RemoveFrom(m_oOmniLights, static_cast<OmniLight*>(&a_rLight));break;
+		case SceneLight::E_SPOT_LIGHT:RemoveFrom(m_oSpotLights, static_cast<SpotLight*>(&a_rLight));break;
+		case SceneLight::E_SPOT_SHADOW:RemoveFrom(m_oSpotShadows, static_cast<SpotShadow*>(&a_rLight));break;
+		default:break;
+	}
+	m_pDeferredRenderer->ForgetLight( a_rLight );
 }
\ No newline at end of file
@@ -18,6 +18,8 @@
 
 #include "BurgerEngine/Graphics/CommonGraphics.h"
 #include "BurgerEngine/Graphics/SceneLight.h"
+#include "BurgerEngine/Graphics/FrameConstants.h"
+#include "BurgerEngine/Graphics/TransformBuffer.h"
 #include "BurgerEngine/gui/DebugMenu.h"
 
 ///Forward declaration
@@ -53,6 +55,9 @@ public:
 	/// \brief Add a mesh to to be render
 	bool AddMesh(SceneMesh& a_rSceneMesh/*MeshType*/);
 
+	/// \brief Stop rendering a mesh, before it is deleted
+	void RemoveMesh(SceneMesh& a_rSceneMesh);
+
 	/// \brief Getters
 	const std::vector< SceneMesh* >& GetSceneMeshes() const { return m_oSceneMeshes; }
 
@@ -86,23 +91,41 @@ public:
 	/// \brief Add a light, depending on it's type
 	void AddLight(SceneLight& a_rLight, SceneLight::LightType a_eType);
 
+	/// \brief Stop lighting with a light, before it is deleted
+	void RemoveLight(SceneLight& a_rLight, SceneLight::LightType a_eType);
+
 	const float4x4& GetMVP() const {return m_oModelViewProjectionMatrices.top(); };
-	void PushMVP(const float4x4& mMVP ){ m_oModelViewProjectionMatrices.push(mMVP); };
-	void PopMVP(){ m_oModelViewProjectionMatrices.pop(); };
+	void PushMVP(const float4x4& mMVP ){ m_oModelViewProjectionMatrices.push(mMVP); ++m_iMatrixSerial; };
+	void PopMVP(){ m_oModelViewProjectionMatrices.pop(); ++m_iMatrixSerial; };
 
 	//const float4x4& GetView() const {return m_oViewMatrices.top(); };
 	//void PushView(const float4x4& mMVP ){ m_oViewMatrices.push(mMVP); };
 	//void PopView(){ m_oViewMatrices.pop(); };
 	
 	const float4x4& GetModelView() const {return m_oModelViewMatrices.top(); };
-	void PushModelView(const float4x4& mMVP ){ m_oModelViewMatrices.push(mMVP); m_mNormalMatrix = transpose(!mMVP); };
-	void PopModelView(){ m_oModelViewMatrices.pop(); };
+	void PushModelView(const float4x4& mMVP ){ m_oModelViewMatrices.push(mMVP); m_mNormalMatrix = transpose(!mMVP); ++m_iMatrixSerial; };
+	void PopModelView(){ m_oModelViewMatrices.pop(); ++m_iMatrixSerial; };
+
+	/// \brief Changes with the top of the matrix stacks, shaders upload the pass matrices again only when it moved
+	unsigned int GetMatrixSerial() const { return m_iMatrixSerial; }
+
+	/// \brief Object of the next draws, its world matrix is at iIndex in the TransformBuffer. 0 and NULL for no object
+	void SetCurrentObject( unsigned int iIndex, const float4x4* pWorld ){ m_iCurrentObject = iIndex; m_pCurrentWorld = pWorld; }
+	unsigned int GetCurrentObject() const { return m_iCurrentObject; }
+	const float4x4* GetCurrentWorld() const { return m_pCurrentWorld; }
 
 	void SetCurrentShader( Shader* pShader ){ m_pCurrentShader = pShader; }
 	Shader* GetCurrentShader() { return m_pCurrentShader; }
 
 	const float4x4& GetNormalMatrix() const { return m_mNormalMatrix; }
 
+	/// \brief Camera and frame values of the shaders, updated by the renderer at the beginning of the frame
+	const FrameConstants& GetFrameConstants() const { return m_oFrameConstants; }
+	FrameConstants& GrabFrameConstants() { return m_oFrameConstants; }
+
+	/// \brief World matrices of the meshes, filled by the renderer at the beginning of the frame
+	TransformBuffer& GrabTransformBuffer() { return m_oTransformBuffer; }
+
 private:
 	/// The actual renderer
 	/// List of renderer? This will come with pipeline
@@ -128,6 +151,13 @@ private:
 	//std::stack<float4x4> m_oViewMatrices;
 	std::stack<float4x4> m_oModelViewMatrices;
 	float4x4 m_mNormalMatrix;
+
+	FrameConstants m_oFrameConstants;
+	TransformBuffer m_oTransformBuffer;
+
+	unsigned int m_iMatrixSerial;
+	unsigned int m_iCurrentObject;
+	const float4x4* m_pCurrentWorld;
 };
 
 
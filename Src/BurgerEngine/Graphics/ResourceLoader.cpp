@@ -0,0 +1,206 @@
+#include "BurgerEngine/Graphics/ResourceLoader.h"
+
+#include "BurgerEngine/Core/Timer.h"
+
+/// \class	LoaderThread
+/// \brief	Loader thread, runs the jobs of the loader until it stops
+class LoaderThread: public sf::Thread
+{
+public:
+	LoaderThread( ResourceLoader& rLoader ): m_rLoader( rLoader ){}
+
+private:
+	virtual void Run()
+	{
+		while( m_rLoader.m_bRunning )
+		{
+			ResourceLoader::AbstractJob* pJob = m_rLoader.PopJob();
+			if( pJob )
+			{
+				m_rLoader.PushLoadedJob( pJob, pJob->Load() );
+			}
+			else
+			{
+				//SFML has no condition, so idle threads poll the queue
+				sf::Sleep( 0.005f );
+			}
+		}
+	}
+
+	ResourceLoader& m_rLoader;
+};
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+ResourceLoader::ResourceLoader()
+	: m_iJobCount( 0 )
+	, m_fUploadBudget( 4.0f )
+	, m_bRunning( false )
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ResourceLoader::Initialize( unsigned int iThreadCount, float fUploadBudget )
+{
+	Terminate();
+
+	m_fUploadBudget = fUploadBudget;
+	m_bRunning = true;
+	for( unsigned int i = 0; i < iThreadCount; ++i )
+	{
+		LoaderThread* pThread = new LoaderThread( *this );
+		pThread->Launch();
+		m_vThreads.push_back( pThread );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ResourceLoader::Terminate()
+{
+	m_bRunning = false;
+	FOR_EACH_IT( std::vector< LoaderThread* >, m_vThreads, itThread )
+	{
+		(*itThread)->Wait();
+		delete (*itThread);
+	}
+	m_vThreads.clear();
+
+	FOR_EACH_IT( std::deque< AbstractJob* >, m_vPendingJobs, itJob )
+	{
+		delete (*itJob);
+	}
+	m_vPendingJobs.clear();
+
+	FOR_EACH_IT( std::deque< LoadedJob >, m_vLoadedJobs, itJob )
+	{
+		delete (*itJob).first;
+	}
+	m_vLoadedJobs.clear();
+
+	m_iJobCount = 0;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ResourceLoader::AddJob( AbstractJob* pJob )
+{
+	assert( pJob );
+
+	//No thread, load right now
+	if( m_vThreads.empty() )
+	{
+		UploadJob( pJob, pJob->Load() );
+		return;
+	}
+
+	sf::Lock oLock( m_oMutex );
+	m_vPendingJobs.push_back( pJob );
+	++m_iJobCount;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+ResourceLoader::AbstractJob* ResourceLoader::PopJob()
+{
+	sf::Lock oLock( m_oMutex );
+	if( m_vPendingJobs.empty() )
+	{
+		return NULL;
+	}
+	AbstractJob* pJob = m_vPendingJobs.front();
+	m_vPendingJobs.pop_front();
+	return pJob;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ResourceLoader::PushLoadedJob( AbstractJob* pJob, bool bSuccess )
+{
+	sf::Lock oLock( m_oMutex );
+	m_vLoadedJobs.push_back( LoadedJob( pJob, bSuccess ) );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ResourceLoader::UploadJob( AbstractJob* pJob, bool bSuccess )
+{
+	if( bSuccess )
+	{
+		pJob->Upload();
+	}
+	delete pJob;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ResourceLoader::Update()
+{
+	Timer oTimer;
+	oTimer.Start();
+
+	//At least one job per frame, so a job longer than the budget still goes through
+	do
+	{
+		LoadedJob oJob;
+		{
+			sf::Lock oLock( m_oMutex );
+			if( m_vLoadedJobs.empty() )
+			{
+				return;
+			}
+			oJob = m_vLoadedJobs.front();
+			m_vLoadedJobs.pop_front();
+			--m_iJobCount;
+		}
+		UploadJob( oJob.first, oJob.second );
+	}
+	while( oTimer.Stop() < m_fUploadBudget );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ResourceLoader::Flush()
+{
+	while( GetPendingJobCount() > 0 )
+	{
+		LoadedJob oJob( NULL, false );
+		{
+			sf::Lock oLock( m_oMutex );
+			if( !m_vLoadedJobs.empty() )
+			{
+				oJob = m_vLoadedJobs.front();
+				m_vLoadedJobs.pop_front();
+				--m_iJobCount;
+			}
+		}
+
+		if( oJob.first )
+		{
+			UploadJob( oJob.first, oJob.second );
+		}
+		else
+		{
+			sf::Sleep( 0.001f );
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+unsigned int ResourceLoader::GetPendingJobCount()
+{
+	sf::Lock oLock( m_oMutex );
+	return m_iJobCount;
+}
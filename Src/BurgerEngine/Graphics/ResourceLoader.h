@@ -0,0 +1,105 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __RESOURCELOADER_H__
+#define __RESOURCELOADER_H__
+
+#include <vector>
+#include <deque>
+
+#include "BurgerEngine/Base/Singleton.h"
+
+#include <SFML/System.hpp>
+
+class LoaderThread;
+
+/// \class	ResourceLoader
+/// \brief	Loads resources in the background:
+///			the CPU side (file parsing, image decoding) runs on a pool of loader threads,
+///			the GL side is done on the main thread by Update, within a time budget per frame
+class ResourceLoader: public Singleton<ResourceLoader>
+{
+	friend class Singleton<ResourceLoader>;
+	friend class LoaderThread;
+
+public:
+
+	/// \brief A resource to load, the job is deleted by the loader once done
+	class AbstractJob
+	{
+	public:
+		virtual ~AbstractJob(){}
+
+		/// \brief Called on a loader thread, must not call OpenGL
+		/// \return false if the resource could not be loaded, Upload won't be called
+		virtual bool Load() = 0;
+
+		/// \brief Called on the main thread once Load succeeded
+		virtual void Upload() = 0;
+	};
+
+	/// \brief Start the loader threads
+	/// \param iThreadCount Number of loader threads, 0 makes every job load synchronously
+	/// \param fUploadBudget Time spent uploading per frame, in milliseconds
+	void Initialize( unsigned int iThreadCount, float fUploadBudget );
+
+	/// \brief Stop the threads and drop the pending jobs
+	void Terminate();
+
+	/// \brief Queue a job, the loader takes its ownership
+	void AddJob( AbstractJob* pJob );
+
+	/// \brief Upload the loaded jobs until the frame budget is spent, main thread only
+	void Update();
+
+	/// \brief Upload every job, waiting for the loader threads if needed (loading screen, stage switch)
+	void Flush();
+
+	/// \brief Number of jobs not uploaded yet
+	unsigned int GetPendingJobCount();
+
+private:
+
+	ResourceLoader();
+	virtual ~ResourceLoader(){ Terminate(); }
+
+	/// \brief Pop a job to load, NULL if none
+	AbstractJob* PopJob();
+
+	/// \brief Hand a loaded job to the main thread
+	void PushLoadedJob( AbstractJob* pJob, bool bSuccess );
+
+	/// \brief Upload and delete a loaded job
+	void UploadJob( AbstractJob* pJob, bool bSuccess );
+
+private:
+
+	/// Loaded job and its load result
+	typedef std::pair< AbstractJob*, bool > LoadedJob;
+
+	std::vector< LoaderThread* >	m_vThreads;
+
+	/// Jobs waiting for a thread
+	std::deque< AbstractJob* >		m_vPendingJobs;
+	/// Jobs waiting for their upload
+	std::deque< LoadedJob >			m_vLoadedJobs;
+
+	/// Protect both queues and the job counter
+	sf::Mutex						m_oMutex;
+
+	/// Jobs added and not uploaded yet
+	unsigned int					m_iJobCount;
+
+	float							m_fUploadBudget;
+	volatile bool					m_bRunning;
+};
+
+#endif //__RESOURCELOADER_H__
@@ -1,10 +1,15 @@
 #include "BurgerEngine/Core/Engine.h"
+#include "BurgerEngine/Core/TransformStore.h"
 #include "BurgerEngine/Graphics/RenderingContext.h"
 
 #include "BurgerEngine/Graphics/SceneMesh.h"
 
 #include "BurgerEngine/Graphics/StaticMesh.h"
 #include "BurgerEngine/Graphics/Material.h"
+#include "BurgerEngine/Graphics/TextureManager.h"
+#include "BurgerEngine/Graphics/BoundingBoxBatch.h"
+
+#include "BurgerEngine/External/Math/Frustum.h"
 
 //--------------------------------------------------------------------------------------------------------------------
 //
@@ -14,7 +19,11 @@ SceneMesh::SceneMesh( StaticMesh * pMesh )
 	, m_uPartCount( 0 )
 	, m_bCastShadow( true )
 	, m_fScale( 1.0f )
+	, m_iTransformIndex( 0 )
+	, m_iTransform( TransformStore::s_iInvalidHandle )
+	, m_bWaitingForMesh( false )
 {
+	m_mWorld = identity4();
 	m_pBoundingBox = new float[6];
 }
 
@@ -23,36 +32,134 @@ SceneMesh::~SceneMesh()
 	delete [] m_pBoundingBox;
 	m_pBoundingBox = NULL;
 }
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+float4x4 SceneMesh::_ComputeWorldMatrix() const
+{
+	if( m_iTransform != TransformStore::s_iInvalidHandle )
+	{
+		return Engine::GrabInstance().GetTransformStore().GetRenderMatrix( m_iTransform );
+	}
+	return translate(m_f3Position.x,m_f3Position.y,m_f3Position.z) * m_mRotationMatrix * scale(m_fScale,m_fScale,m_fScale);
+}
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneMesh::UpdateTransform( TransformBuffer& rTransformBuffer )
+{
+	m_mWorld = _ComputeWorldMatrix();
+	m_iTransformIndex = rTransformBuffer.Add( m_mWorld );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneMesh::GatherDraws( DrawBatch& rBatch, bool bSubMeshCulling )
+{
+	if( !m_pMesh || !m_pMesh->IsResident() )
+	{
+		return;
+	}
+
+	Frustum oLocalFrustum;
+	if( bSubMeshCulling )
+	{
+		//Planes in object space, as in Draw
+		oLocalFrustum.loadFrustum( transpose( Engine::GrabInstance().GrabRenderContext().GetMVP() * m_mWorld ) );
+	}
+	m_pMesh->GatherDraws( rBatch, m_iTransformIndex, &m_mWorld, bSubMeshCulling ? &oLocalFrustum : NULL, NULL );
+}
+
 //--------------------------------------------------------------------------------------------------------------------
 //
 //------------------------------------------------------------------------------------------------------------------
-void SceneMesh::Draw( EffectTechnique::RenderingTechnique eTechnique )
+void SceneMesh::Draw( EffectTechnique::RenderingTechnique eTechnique, bool bSubMeshCulling, vec3 const* pf3ViewPosition )
 {
-	if( m_pMesh )
+	if( m_pMesh && m_pMesh->IsResident() )
 	{
 		Engine& rEngine = Engine::GrabInstance();
 		RenderingContext& rRenderContext = rEngine.GrabRenderContext();
 		
-		float4x4 oPositonMatrix = translate(m_f3Position.x,m_f3Position.y,m_f3Position.z) * m_mRotationMatrix * scale(m_fScale,m_fScale,m_fScale);
+		const float4x4& oPositonMatrix = m_mWorld;
+
+		//Texture streaming, the size on screen of each part tells which texture levels it needs
+		float4x4 mViewProjection = rRenderContext.GetMVP();
+		bool bRequestTextures = eTechnique != EffectTechnique::E_RENDER_SHADOW_MAP && TextureManager::GrabInstance().IsStreaming();
+
+		//Pass frustum, in world space, to cull the parts
+		Frustum oFrustum;
+		if( bSubMeshCulling )
+		{
+			oFrustum.loadFrustum( transpose( rRenderContext.GetMVP() ) );
+		}
+
+		//The pass matrices stay on the stack, the shaders fetch the world matrix from the index
+		rRenderContext.SetCurrentObject( m_iTransformIndex, &m_mWorld );
+
+		Frustum oLocalFrustum;
+		vec3 f3LocalViewPosition;
+		vec3 const* pf3LocalViewPosition = NULL;
+		if( bSubMeshCulling )
+		{
+			//Planes extracted from the object MVP are in object space,
+			//so the cluster bounds are tested without being transformed
+			oLocalFrustum.loadFrustum( transpose( mViewProjection * oPositonMatrix ) );
+			if( pf3ViewPosition )
+			{
+				f3LocalViewPosition = ( !oPositonMatrix * vec4( *pf3ViewPosition, 1.0f ) ).xyz();
+				pf3LocalViewPosition = &f3LocalViewPosition;
+			}
+		}
 
-		rRenderContext.PushMVP( rRenderContext.GetMVP() * oPositonMatrix);
 		if( eTechnique == EffectTechnique::E_RENDER_SHADOW_MAP )
 		{
 			rRenderContext.GetCurrentShader()->CommitStdUniforms();
-			m_pMesh->Render();
+			if( bSubMeshCulling )
+			{
+				//groups are culled in object space along with their clusters
+				m_pMesh->Render( oLocalFrustum, pf3LocalViewPosition );
+			}
+			else
+			{
+				m_pMesh->Render();
+			}
 		}
 		else
 		{
 			for( unsigned int i = 0; i < m_uPartCount; ++i )
 			{
-				if( m_vMaterials[ i ]->Activate( eTechnique ) )
+				//Skip the material activation of parts out of the frustum
+				if( bSubMeshCulling && ( i + 1 ) * 6 <= m_vPartBoundingBoxes.size() )
 				{
-					m_pMesh->Render( i );
-					m_vMaterials[ i ]->Deactivate( eTechnique );
+					const float* pBoundingBox = &m_vPartBoundingBoxes[ i * 6 ];
+					if( !oFrustum.cubeInFrustum( pBoundingBox[0], pBoundingBox[1], pBoundingBox[2], pBoundingBox[3], pBoundingBox[4], pBoundingBox[5] ) )
+					{
+						continue;
+					}
+				}
+
+				if( bRequestTextures && ( i + 1 ) * 6 <= m_vPartBoundingBoxes.size() )
+				{
+					m_vMaterials[ i ]->RequestTextureResolution( eTechnique, ComputeScreenSize( &m_vPartBoundingBoxes[ i * 6 ], mViewProjection ) );
+				}
+
+				//Left bound for the next part, the renderer unbinds it at the end of the pass
+				if( m_vMaterials[ i ]->Activate( eTechnique, true ) )
+				{
+					if( bSubMeshCulling )
+					{
+						m_pMesh->Render( i, oLocalFrustum, pf3LocalViewPosition );
+					}
+					else
+					{
+						m_pMesh->Render( i );
+					}
 				}
 			}
 		}
-		rRenderContext.PopMVP();
+		rRenderContext.SetCurrentObject( 0, NULL );
 	}
 }
 
@@ -83,58 +190,104 @@ bool SceneMesh::IsTransparent()
 	return false;
 }
 
-void SceneMesh::ComputeBoundingBox()
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+float SceneMesh::ComputeScreenSize( const float* pBoundingBox, const float4x4& mViewProjection )
 {
-	//glDisable( GL_DEPTH_TEST );
-
-	const float * pBoundingBox = m_pMesh->GetBoundingBox();
+	Engine& rEngine = Engine::GrabInstance();
+	float fWidth = (float)rEngine.GetWindowWidth();
+	float fHeight = (float)rEngine.GetWindowHeight();
 
-	std::vector<vec3> vf3Point3;
-	for( unsigned int i = 0; i < 2; ++i )
+	vec2 f2Min( 1.0f, 1.0f );
+	vec2 f2Max( -1.0f, -1.0f );
+	for( unsigned int i = 0; i < 8; ++i )
 	{
-		for( unsigned int j = 2; j < 4; ++j )
+		vec4 f4Corner = mViewProjection * vec4( pBoundingBox[ i & 1 ], pBoundingBox[ 2 + ( ( i >> 1 ) & 1 ) ], pBoundingBox[ 4 + ( i >> 2 ) ], 1.0f );
+		if( f4Corner.w <= 0.0f )
 		{
-			for( unsigned int k = 4; k < 6; ++k )
-			{
-				vf3Point3.push_back( vec3( pBoundingBox[i], pBoundingBox[j], pBoundingBox[k] ) );
-			}
+			return fWidth > fHeight ? fWidth : fHeight;
 		}
+		float fX = f4Corner.x / f4Corner.w;
+		float fY = f4Corner.y / f4Corner.w;
+		f2Min.x = min( f2Min.x, fX );
+		f2Min.y = min( f2Min.y, fY );
+		f2Max.x = max( f2Max.x, fX );
+		f2Max.y = max( f2Max.y, fY );
 	}
 
-	vf3Point3[0] = (translate(m_f3Position.x,m_f3Position.y,m_f3Position.z) * m_mRotationMatrix * scale(m_fScale,m_fScale,m_fScale) * vec4( vf3Point3[0], 1.0f )).xyz();
-
-	m_pBoundingBox[0] = m_pBoundingBox[1] = vf3Point3[0].x;
-	m_pBoundingBox[2] = m_pBoundingBox[3] = vf3Point3[0].y;
-	m_pBoundingBox[4] = m_pBoundingBox[5] = vf3Point3[0].z;
-	
-	//glPointSize(3.0f);
-	//glBegin(GL_POINTS);
-	//glVertex3f( vf3Point3[0].x, vf3Point3[0].y, vf3Point3[0].z );
+	//Only the part on screen
+	float fSizeX = ( min( f2Max.x, 1.0f ) - max( f2Min.x, -1.0f ) ) * 0.5f * fWidth;
+	float fSizeY = ( min( f2Max.y, 1.0f ) - max( f2Min.y, -1.0f ) ) * 0.5f * fHeight;
+	return fSizeX > fSizeY ? fSizeX : fSizeY;
+}
 
-	std::vector<vec3>::iterator oIt = vf3Point3.begin();
-	std::vector<vec3>::iterator oEnd = vf3Point3.end();
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneMesh::ComputeBoundingBox()
+{
+	_ComputeBoundingBoxes( NULL );
+}
 
-	++oIt;
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneMesh::ComputeBoundingBox( BoundingBoxBatch& rBatch )
+{
+	_ComputeBoundingBoxes( &rBatch );
+}
 
-	while( oIt != oEnd )
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void SceneMesh::_ComputeBoundingBoxes( BoundingBoxBatch* pBatch )
+{
+	//Until the mesh is loaded, its bounds are the ones the scene compiler read from the file, or a point when it
+	//gave none. A mesh that failed is never drawn, its box is left as is
+	m_bWaitingForMesh = !m_pMesh->IsResident() && !m_pMesh->HasLoadFailed();
+	if( !m_pMesh->IsResident() )
 	{
-		vec3 f3Point = (translate(m_f3Position.x,m_f3Position.y,m_f3Position.z) * m_mRotationMatrix * scale(m_fScale,m_fScale,m_fScale) * vec4( (*oIt), 1.0f )).xyz();
-
-		m_pBoundingBox[0] = min( m_pBoundingBox[0], f3Point.x );
-		m_pBoundingBox[1] = max( m_pBoundingBox[1], f3Point.x );
-
-		m_pBoundingBox[2] = min( m_pBoundingBox[2], f3Point.y );
-		m_pBoundingBox[3] = max( m_pBoundingBox[3], f3Point.y );
+		m_vPartBoundingBoxes.clear();
+		const float* pPrecomputedBoundingBox = m_pMesh->GetPrecomputedBoundingBox();
+		if( !pPrecomputedBoundingBox )
+		{
+			m_pBoundingBox[0] = m_pBoundingBox[1] = m_f3Position.x;
+			m_pBoundingBox[2] = m_pBoundingBox[3] = m_f3Position.y;
+			m_pBoundingBox[4] = m_pBoundingBox[5] = m_f3Position.z;
+		}
+		else if( pBatch )
+		{
+			pBatch->Add( pPrecomputedBoundingBox, _ComputeWorldMatrix(), m_pBoundingBox );
+		}
+		else
+		{
+			BoundingBoxBatch::TransformBox( pPrecomputedBoundingBox, _ComputeWorldMatrix(), m_pBoundingBox );
+		}
+		return;
+	}
 
-		m_pBoundingBox[4] = min( m_pBoundingBox[4], f3Point.z );
-		m_pBoundingBox[5] = max( m_pBoundingBox[5], f3Point.z );
+	float4x4 mTransform = _ComputeWorldMatrix();
 
-		//glVertex3f( f3Point.x, f3Point.y, f3Point.z );
-		++oIt;
+	//one box per part, so they can be culled separately
+	//sized before queuing, the batch keeps pointers to the boxes
+	m_vPartBoundingBoxes.resize( m_pMesh->GetGroupCount() * 6 );
+	if( pBatch )
+	{
+		pBatch->Add( m_pMesh->GetBoundingBox(), mTransform, m_pBoundingBox );
+		for( unsigned int i = 0; i < m_pMesh->GetGroupCount(); ++i )
+		{
+			pBatch->Add( m_pMesh->GetGroupBoundingBox( i ), mTransform, &m_vPartBoundingBoxes[ i * 6 ] );
+		}
+	}
+	else
+	{
+		BoundingBoxBatch::TransformBox( m_pMesh->GetBoundingBox(), mTransform, m_pBoundingBox );
+		for( unsigned int i = 0; i < m_pMesh->GetGroupCount(); ++i )
+		{
+			BoundingBoxBatch::TransformBox( m_pMesh->GetGroupBoundingBox( i ), mTransform, &m_vPartBoundingBoxes[ i * 6 ] );
+		}
 	}
-
-	//glEnd();
-	//glEnable( GL_DEPTH_TEST );
 }
 
 
@@ -18,6 +18,9 @@
 
 class StaticMesh;
 class Material;
+class TransformBuffer;
+class DrawBatch;
+class BoundingBoxBatch;
 
 /// \name	SceneMesh.h
 /// \brief	The scene object which has a mesh
@@ -33,7 +36,14 @@ public:
 	~SceneMesh();
 
 public: 
-	void Draw( EffectTechnique::RenderingTechnique eTechnique );
+	/// \brief Draw the mesh with the current MVP
+	/// \param[in] bSubMeshCulling Only draw the parts, and their clusters, inside the current MVP frustum
+	/// \param[in] pf3ViewPosition World space viewer position used to skip back facing clusters, NULL to draw them
+	void Draw( EffectTechnique::RenderingTechnique eTechnique, bool bSubMeshCulling = false, vec3 const* pf3ViewPosition = NULL );
+
+	/// \brief Add the ranges of the mesh to a batch, for the passes where materials do not matter
+	/// \param[in] bSubMeshCulling Only add the clusters inside the current MVP frustum
+	void GatherDraws( DrawBatch& rBatch, bool bSubMeshCulling = false );
 	
 	void SetScale( float fValue ){ m_fScale = fValue; }
 	void SetPartCount( unsigned int iValue ){ m_uPartCount = iValue; }
@@ -48,14 +58,47 @@ public:
 	bool IsTransparent();
 
 	void AddMaterial( Material * pMaterial ){ m_vMaterials.push_back( pMaterial ); }
+	std::vector<Material*> const& GetMaterials() const { return m_vMaterials; }
+	StaticMesh* GetMesh() const { return m_pMesh; }
 	virtual void	ComputeBoundingBox();
 
+	/// \brief Queue the world boxes in a batch, they are written when the batch is computed
+	void	ComputeBoundingBox( BoundingBoxBatch& rBatch );
+
+	/// \brief The mesh is still loading, the bounding box must be computed again once it is resident.
+	///			False once the loading failed, the box is then left as is
+	bool	IsWaitingForMesh() const { return m_bWaitingForMesh; }
+
+	/// \brief Compute the world matrix of the frame and add it to the TransformBuffer, before any pass draws the mesh
+	void	UpdateTransform( TransformBuffer& rTransformBuffer );
+
+	/// \brief Read the world matrix from a transform of the TransformStore instead of the position, rotation and scale of the mesh
+	void	SetTransform( unsigned int iTransform ){ m_iTransform = iTransform; }
+
+private:
+	/// \brief World matrix from the TransformStore, or from the values of the mesh
+	float4x4 _ComputeWorldMatrix() const;
+
+	/// \brief Compute the world boxes now, or queue them when there is a batch
+	void _ComputeBoundingBoxes( BoundingBoxBatch* pBatch );
+
+	/// \brief Size on screen, in pixels, of a world space box, the whole screen if it crosses the near plane
+	static float ComputeScreenSize( const float* pBoundingBox, const float4x4& mViewProjection );
+
 private:	
 	std::vector<Material*>	m_vMaterials;
+	/// World space boxes of each part, 6 floats per part
+	std::vector<float>		m_vPartBoundingBoxes;
 	unsigned int			m_uPartCount;
 	StaticMesh*				m_pMesh;
 	float					m_fScale;
+	/// World matrix of the frame and its index in the TransformBuffer
+	float4x4				m_mWorld;
+	unsigned int			m_iTransformIndex;
+	/// Handle in the TransformStore, s_iInvalidHandle when the mesh is placed by its own values
+	unsigned int			m_iTransform;
 	bool					m_bCastShadow;
+	bool					m_bWaitingForMesh;
 };
 
 #endif //__SCENEMESH_H__
\ No newline at end of file
@@ -1,61 +1,159 @@
 #include "shader.h"
 #include "shaderTool.h"
+#include "ShaderCache.h"
+#include "BurgerEngine/Graphics/OpenGLContext.h"
+#include "BurgerEngine/Graphics/UniformBuffer.h"
+#include "BurgerEngine/Graphics/FrameConstants.h"
+#include "BurgerEngine/Graphics/TransformBuffer.h"
 
 #include "BurgerEngine/Core/Engine.h"
 #include "BurgerEngine/Graphics/RenderingContext.h"
-#include "BurgerEngine/Core/AbstractCamera.h"
-#include "BurgerEngine/Core/TimeContext.h"
 #include "BurgerEngine/External/Math/Vector.h"
 
 #include <iostream>
 
 Shader::Shader()
 {
+	m_oProgram = 0;
 	m_bIsReady = false;
+	m_eBuildStep = E_BUILD_NONE;
+	memset(m_pObjects, 0, sizeof(GLhandleARB)*2);
+	for(unsigned int i = 0; i < E_STD_COUNT; ++i)
+		m_piStdUniforms[i] = -1;
+	m_bFrameUniforms = false;
+	m_iCommittedMatrixSerial = 0xFFFFFFFF;
 }
 
-bool Shader::LoadAndCompile(const std::string& sVert, const std::string& sFrag)
+bool Shader::LoadAndCompile(const std::string& sVert, const std::string& sFrag, ShaderCache const* pCache, const std::string& sDefines)
 {
-	GLhandleARB so[2]; 
-	memset(so, 0, sizeof(GLhandleARB)*2);
-
-	///Loading the shader
-	so[0] = loadShader(sVert.c_str()); 
-	if(so[0]==0){
-		std::cerr << "loading shader "+sVert+" failed" << std::endl;
+	if(!Compile(sVert, sFrag, pCache, sDefines))
 		return false;
+	Link(pCache);
+	return Finish(pCache);
+}
+
+bool Shader::Compile(const std::string& sVert, const std::string& sFrag, ShaderCache const* pCache, const std::string& sDefines)
+{
+	m_sVertexName = sVert;
+	m_sFragmentName = sFrag;
+	m_sCacheKey.clear();
+
+	///Try the cached binary first, the sources are only read to build its key
+	if( pCache && pCache->IsEnabled() )
+	{
+		std::string sVertexSource, sFragmentSource;
+		if( readShaderSource( sVert.c_str(), sVertexSource ) && readShaderSource( sFrag.c_str(), sFragmentSource ) )
+		{
+			m_sCacheKey = pCache->ComputeKey( sDefines + sVertexSource, sDefines + sFragmentSource );
+
+			GLhandleARB oProgram = glCreateProgramObjectARB();
+			if( pCache->LoadProgram( oProgram, m_sCacheKey ) )
+			{
+				m_oProgram = oProgram;
+				m_bIsReady = true;
+				m_eBuildStep = E_BUILD_DONE;
+				return true;
+			}
+			glDeleteObjectARB( oProgram );
+		}
 	}
 
-	///Compiling the shader, done by the graphic card
-	if(!compileShader(so[0])){ 
-		std::cerr << "compiling shader "+sVert+" failed" << std::endl;
+	///Loading the shaders
+	m_pObjects[0] = loadShader(sVert.c_str(), sDefines); 
+	if(m_pObjects[0]==0){
+		std::cerr << "loading shader "+sVert+" failed" << std::endl;
+		_ReleaseObjects();
 		return false;
 	}
 
-	so[1] = loadShader(sFrag.c_str());
-	if(so[1]==0){
+	m_pObjects[1] = loadShader(sFrag.c_str(), sDefines);
+	if(m_pObjects[1]==0){
 		std::cerr << "loading shader "+sFrag+" failed " << std::endl;
-		return false;
-	}
-	if(!compileShader(so[1])){
-		std::cerr << "compiling shader "+sFrag+" failed " << std::endl;
+		_ReleaseObjects();
 		return false;
 	}
 
-	m_oProgram = linkShaders(so,2);
-	m_bIsReady = true;
+	///Compiling the shaders, done by the graphic card. The status is only checked by Finish,
+	///asking for it now would wait for the driver
+	glCompileShaderARB(m_pObjects[0]);
+	glCompileShaderARB(m_pObjects[1]);
+	m_eBuildStep = E_BUILD_COMPILING;
 	return true;
 }
 
+void Shader::Link(ShaderCache const* pCache)
+{
+	if(m_eBuildStep != E_BUILD_COMPILING)
+		return;
+
+	m_oProgram = glCreateProgramObjectARB();
+	glAttachObjectARB(m_oProgram, m_pObjects[0]);
+	glAttachObjectARB(m_oProgram, m_pObjects[1]);
+	///Same location in every program, the batches set up its array once
+	glBindAttribLocationARB(m_oProgram, TransformBuffer::s_iObjectIndexAttribute, TransformBuffer::s_sObjectIndexName);
+	if(pCache)
+		pCache->PrepareProgram(m_oProgram);
+
+	glLinkProgramARB(m_oProgram);
+	m_eBuildStep = E_BUILD_LINKING;
+}
+
+bool Shader::Finish(ShaderCache const* pCache)
+{
+	if(m_eBuildStep == E_BUILD_COMPILING)
+		Link(pCache);
+	if(m_eBuildStep != E_BUILD_LINKING)
+		return m_bIsReady;
+
+	m_eBuildStep = E_BUILD_DONE;
+	if(!checkCompileStatus(m_pObjects[0])){ 
+		std::cerr << "compiling shader "+m_sVertexName+" failed" << std::endl;
+	}
+	else if(!checkCompileStatus(m_pObjects[1])){
+		std::cerr << "compiling shader "+m_sFragmentName+" failed " << std::endl;
+	}
+	else if(!checkLinkStatus(m_oProgram)){
+		std::cerr << "linking shaders "+m_sVertexName+" - "+m_sFragmentName+" failed " << std::endl;
+	}
+	else{
+		m_bIsReady = true;
+	}
+
+	if(!m_bIsReady){
+		glDeleteObjectARB(m_oProgram);
+		m_oProgram = 0;
+	}
+	///The program keeps its own copy once linked
+	_ReleaseObjects();
+
+	if( m_bIsReady && pCache && !m_sCacheKey.empty() )
+	{
+		pCache->SaveProgram( m_oProgram, m_sCacheKey );
+	}
+	return m_bIsReady;
+}
+
+void Shader::_ReleaseObjects()
+{
+	for(unsigned int i = 0; i < 2; ++i){
+		if(m_pObjects[i]!=0){
+			if(m_oProgram!=0)
+				glDetachObjectARB(m_oProgram, m_pObjects[i]);
+			glDeleteObjectARB(m_pObjects[i]);
+			m_pObjects[i] = 0;
+		}
+	}
+}
+
 void Shader::Activate()
 {
 	if (m_bIsReady)
-		glUseProgramObjectARB(m_oProgram);
+		OpenGLContext::UseProgram(m_oProgram);
 }
 
 void Shader::Deactivate()
 {
-	glUseProgramObjectARB(0);
+	OpenGLContext::UseProgram(0);
 }
 
 void Shader::setUniformf(const std::string& sName, float fValue)
@@ -139,76 +237,117 @@ GLhandleARB	Shader::getHandle()
 
 void Shader::QueryStdUniforms()
 {
-	m_oStdUniformsMap[ E_STD_INV_VIEWPORT ] = glGetUniformLocation( m_oProgram, "vInvViewport" );
-	m_oStdUniformsMap[ E_STD_DOF_PARAMS ] = glGetUniformLocation( m_oProgram, "vDofParams" );
-	m_oStdUniformsMap[ E_STD_MVP ] = glGetUniformLocation( m_oProgram, "mMVP" );
-	m_oStdUniformsMap[ E_STD_INV_MVP ] = glGetUniformLocation( m_oProgram, "mInvMVP" );
-	m_oStdUniformsMap[ E_STD_MODEL_VIEW ] = glGetUniformLocation( m_oProgram, "mModelView" );
-	m_oStdUniformsMap[ E_STD_NORMAL_MATRIX ] = glGetUniformLocation( m_oProgram, "mNormalMatrix" );
-	//m_oStdUniformsMap[ E_STD_INV_PROJECTION ] = glGetUniformLocation( m_oProgram, "vInProj" );
-	m_oStdUniformsMap[ E_STD_TIME ] = glGetUniformLocation( m_oProgram, "fTime" );
+	static const char* s_pNames[ E_STD_COUNT ] =
+	{
+		"mPassViewProjection", "mModelView", "mNormalMatrix", "fObjectIndex", "mWorld", "mMVP",
+		"mView", "mProjection", "mInvView", "mInvProj", "mViewProjection", "mInvViewProjection",
+		"vDofParams", "vCameraPosition", "vViewport", "vInvViewport", "fTime", "fDeltaTime"
+	};
+
+	//The members of a block have no location, they are left to the buffer
+	m_bFrameUniforms = false;
+	for( unsigned int i = 0; i < E_STD_COUNT; ++i )
+	{
+		m_piStdUniforms[i] = glGetUniformLocation( m_oProgram, s_pNames[i] );
+		m_bFrameUniforms |= ( i >= E_STD_FIRST_FRAME_UNIFORM && m_piStdUniforms[i] != -1 );
+	}
+	//The object index is an attribute, so a DrawBatch can give one per instance
+	m_piStdUniforms[ E_STD_OBJECT_INDEX ] = glGetAttribLocationARB( m_oProgram, TransformBuffer::s_sObjectIndexName );
+	m_iCommittedMatrixSerial = 0xFFFFFFFF;
+
+	int iBlockIndex = UniformBuffer::GetBlockIndex( m_oProgram, FrameConstants::s_sBlockName );
+	if( iBlockIndex >= 0 )
+	{
+		UniformBuffer::SetBlockBinding( m_oProgram, iBlockIndex, FrameConstants::s_iBindingPoint );
+	}
+
+	//The shader is active, as for the other samplers
+	int iTransforms = glGetUniformLocation( m_oProgram, TransformBuffer::s_sSamplerName );
+	if( iTransforms != -1 )
+	{
+		glUniform1i( iTransforms, TransformBuffer::s_iTextureUnit );
+	}
 }
 
 void Shader::CommitStdUniforms()
 {
-	Engine & rEngine = Engine::GrabInstance();
-	RenderingContext& rRenderContext = rEngine.GrabRenderContext();
+	RenderingContext& rRenderContext = Engine::GrabInstance().GrabRenderContext();
 	
 	int iHandle;
-	
-	iHandle = m_oStdUniformsMap[ E_STD_INV_VIEWPORT ];
-	if( iHandle != -1 )
-	{
-		vec2 vViewPort = vec2( 1.0f / (float)rEngine.GetWindowWidth(), 1.0f / (float)rEngine.GetWindowHeight() );
-		glUniform2fv( iHandle, 1, (float*)vViewPort );
-	}
 
-	iHandle = m_oStdUniformsMap[ E_STD_DOF_PARAMS ];
-	if( iHandle != -1 )
+	//The matrices of the pass only change with the stacks
+	if( m_iCommittedMatrixSerial != rRenderContext.GetMatrixSerial() )
 	{
-		vec4 vDofParams = rEngine.GetCurrentCamera().GetDofParams();
-		glUniform4fv( iHandle, 1, (float*)vDofParams );
+		m_iCommittedMatrixSerial = rRenderContext.GetMatrixSerial();
+
+		iHandle = m_piStdUniforms[ E_STD_PASS_VIEW_PROJECTION ];
+		if( iHandle != -1 )
+		{
+			glUniformMatrix4fv( iHandle, 1, true, (float*)rRenderContext.GetMVP() );
+		}
+
+		iHandle = m_piStdUniforms[ E_STD_NORMAL_MATRIX ];
+		if( iHandle != -1 )
+		{
+			glUniformMatrix4fv( iHandle, 1, true, (float*)rRenderContext.GetNormalMatrix() );
+		}
+
+		iHandle = m_piStdUniforms[ E_STD_MODEL_VIEW ];
+		if( iHandle != -1 )
+		{
+			glUniformMatrix4fv( iHandle, 1, true, (float*)rRenderContext.GetModelView() );
+		}
 	}
 
-	iHandle = m_oStdUniformsMap[ E_STD_MVP ];
+	//The object, its matrix is already in the TransformBuffer. The attribute array is disabled
+	//outside of the batches, every vertex reads this current value
+	iHandle = m_piStdUniforms[ E_STD_OBJECT_INDEX ];
 	if( iHandle != -1 )
 	{
-		glUniformMatrix4fv( iHandle, 1, true, (float*)rRenderContext.GetMVP() );
+		glVertexAttrib1fARB( iHandle, (float)rRenderContext.GetCurrentObject() );
 	}
 
-	iHandle = m_oStdUniformsMap[ E_STD_INV_MVP ];
+	const float4x4* pWorld = rRenderContext.GetCurrentWorld();
+	iHandle = m_piStdUniforms[ E_STD_WORLD ];
 	if( iHandle != -1 )
 	{
-		unsigned int iWindowWidth = rEngine.GetWindowWidth();
-		unsigned int iWindowHeight = rEngine.GetWindowHeight();
-
-		AbstractCamera & rCamera = rEngine.GetCurrentCamera();
-		float4x4 mProjection = GlperspectiveMatrix( rCamera.GetFOV(), (float)iWindowWidth/(float)iWindowHeight,rCamera.GetNear(), rCamera.GetFar() );
-
-		float4x4 mView =  rCamera.GetViewMatrix();
-
-		mat4 m4InvMVP = !(transpose(mProjection)*(mView)) ;
-		//mat4 m4MVP = mProjection * ;
-		glUniformMatrix4fv( iHandle, 1, false, (float*)m4InvMVP );
+		glUniformMatrix4fv( iHandle, 1, true, pWorld ? (float*)*pWorld : (float*)identity4() );
 	}
 
-	iHandle = m_oStdUniformsMap[ E_STD_NORMAL_MATRIX ];
+	//Shaders without the object transforms get the whole product
+	iHandle = m_piStdUniforms[ E_STD_MVP ];
 	if( iHandle != -1 )
 	{
-		glUniformMatrix4fv( iHandle, 1, true, (float*)rRenderContext.GetNormalMatrix() );
+		glUniformMatrix4fv( iHandle, 1, true, pWorld ? (float*)( rRenderContext.GetMVP() * *pWorld ) : (float*)rRenderContext.GetMVP() );
 	}
 
-	iHandle = m_oStdUniformsMap[ E_STD_MODEL_VIEW ];
-	if( iHandle != -1 )
+	if( !m_bFrameUniforms )
 	{
-		glUniformMatrix4fv( iHandle, 1, true, (float*)rRenderContext.GetModelView() );
+		return;
 	}
 
-	iHandle = m_oStdUniformsMap[ E_STD_TIME ];
-	if( iHandle != -1 )
+	//Values of the frame outside of the block, from the copy kept by the FrameConstants
+	FrameConstants::sData const& rFrame = rRenderContext.GetFrameConstants().GetData();
+	float const* pMatrices[] = { rFrame.m_pView, rFrame.m_pProjection, rFrame.m_pInvView, rFrame.m_pInvProjection, rFrame.m_pViewProjection, rFrame.m_pInvViewProjection };
+	for( unsigned int i = 0; i < 6; ++i )
 	{
-		float fTime = rEngine.GetTimeContext().GetElapsedTime();
-		glUniform1f( iHandle, fTime );
+		iHandle = m_piStdUniforms[ E_STD_VIEW + i ];
+		if( iHandle != -1 )
+		{
+			glUniformMatrix4fv( iHandle, 1, false, pMatrices[i] );
+		}
 	}
 
+	if( ( iHandle = m_piStdUniforms[ E_STD_DOF_PARAMS ] ) != -1 )
+		glUniform4fv( iHandle, 1, rFrame.m_pDofParams );
+	if( ( iHandle = m_piStdUniforms[ E_STD_CAMERA_POSITION ] ) != -1 )
+		glUniform4fv( iHandle, 1, rFrame.m_pCameraPosition );
+	if( ( iHandle = m_piStdUniforms[ E_STD_VIEWPORT ] ) != -1 )
+		glUniform2fv( iHandle, 1, rFrame.m_pViewport );
+	if( ( iHandle = m_piStdUniforms[ E_STD_INV_VIEWPORT ] ) != -1 )
+		glUniform2fv( iHandle, 1, rFrame.m_pInvViewport );
+	if( ( iHandle = m_piStdUniforms[ E_STD_TIME ] ) != -1 )
+		glUniform1f( iHandle, rFrame.m_fTime );
+	if( ( iHandle = m_piStdUniforms[ E_STD_DELTA_TIME ] ) != -1 )
+		glUniform1f( iHandle, rFrame.m_fDeltaTime );
 }
\ No newline at end of file
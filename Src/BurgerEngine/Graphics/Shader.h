@@ -17,19 +17,36 @@
 #include "BurgerEngine/Graphics/CommonGraphics.h"
 #include <map>
 
+class ShaderCache;
+
 class Shader
 {
 	public:
 	
+		/// The values of the pass and of the object first, then the values of the frame. Those are read from the
+		/// FrameConstants block when the shader declares it, and only set one by one without ARB_uniform_buffer_object
 		enum StandardUniforms
 		{
-			E_STD_INV_VIEWPORT,
-			E_STD_DOF_PARAMS,
-			E_STD_MVP,
-			E_STD_INV_MVP,
+			E_STD_PASS_VIEW_PROJECTION,
 			E_STD_MODEL_VIEW,
 			E_STD_NORMAL_MATRIX,
-			E_STD_TIME
+			E_STD_OBJECT_INDEX,
+			E_STD_WORLD,
+			E_STD_MVP,
+			E_STD_FIRST_FRAME_UNIFORM,
+			E_STD_VIEW = E_STD_FIRST_FRAME_UNIFORM,
+			E_STD_PROJECTION,
+			E_STD_INV_VIEW,
+			E_STD_INV_PROJECTION,
+			E_STD_VIEW_PROJECTION,
+			E_STD_INV_VIEW_PROJECTION,
+			E_STD_DOF_PARAMS,
+			E_STD_CAMERA_POSITION,
+			E_STD_VIEWPORT,
+			E_STD_INV_VIEWPORT,
+			E_STD_TIME,
+			E_STD_DELTA_TIME,
+			E_STD_COUNT
 		};
 
 		Shader();
@@ -38,8 +55,19 @@ class Shader
 		void Activate();
 		void Deactivate();
 
-		///Load/Compile and link the shader;
-		bool LoadAndCompile(const std::string& sVert, const std::string& sFrag);
+		///Load/Compile and link the shader, or load its binary from the cache when the sources did not change.
+		///sDefines is put before both sources, it selects a permutation
+		bool LoadAndCompile(const std::string& sVert, const std::string& sFrag, ShaderCache const* pCache = NULL, const std::string& sDefines = std::string());
+
+		///The same build in three steps, so the driver can work on many shaders at once:
+		///submit the compilations (or load the cached binary), then submit the link, then wait for the result.
+		///Nothing waits for the driver before Finish
+		bool Compile(const std::string& sVert, const std::string& sFrag, ShaderCache const* pCache = NULL, const std::string& sDefines = std::string());
+		void Link(ShaderCache const* pCache = NULL);
+		bool Finish(ShaderCache const* pCache = NULL);
+
+		///Linked and usable, false while building or when the build failed
+		bool IsReady() const { return m_bIsReady; }
 
 		//To communicate with the shader, but we should use some math class
 		void setUniformf(const std::string& sName, float fValue);
@@ -63,11 +91,37 @@ class Shader
 		void QueryStdUniforms();
 		void CommitStdUniforms();
 
+		/// \brief The vertex stage fetches its world matrix from the object index attribute
+		bool ReadsObjectIndex() const { return m_piStdUniforms[ E_STD_OBJECT_INDEX ] != -1; }
+
 private:
+		enum BuildStep
+		{
+			E_BUILD_NONE,
+			E_BUILD_COMPILING,
+			E_BUILD_LINKING,
+			E_BUILD_DONE,
+		};
+
+		void _ReleaseObjects();
+
 		GLhandleARB		m_oProgram;
 		bool			m_bIsReady;
 
-		std::map< StandardUniforms, int > m_oStdUniformsMap;
+		BuildStep		m_eBuildStep;
+		///Vertex and fragment objects, until the link is checked
+		GLhandleARB		m_pObjects[2];
+		std::string		m_sVertexName;
+		std::string		m_sFragmentName;
+		///Key of the cached binary, empty when the cache is not used
+		std::string		m_sCacheKey;
+
+		/// Locations of the standard uniforms, -1 when the program does not use them
+		int m_piStdUniforms[ E_STD_COUNT ];
+		/// Some value of the frame is set one by one
+		bool m_bFrameUniforms;
+		/// RenderingContext::GetMatrixSerial when the matrices of the pass were last uploaded
+		unsigned int m_iCommittedMatrixSerial;
 };
 
 
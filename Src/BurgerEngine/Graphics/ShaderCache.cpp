@@ -0,0 +1,265 @@
+#include "BurgerEngine/Graphics/ShaderCache.h"
+#include "BurgerEngine/Graphics/ShaderTool.h"
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+#ifdef WIN32
+	#include <direct.h>
+#else
+	#include <sys/stat.h>
+	#include <sys/types.h>
+#endif
+
+//ARB_get_program_binary (core in GL 4.1) is newer than GLee, the entry points are loaded by hand
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+	#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT	0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+	#define GL_PROGRAM_BINARY_LENGTH			0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+	#define GL_NUM_PROGRAM_BINARY_FORMATS		0x87FE
+#endif
+
+typedef void (APIENTRY * GetProgramBinaryFunction)( GLuint iProgram, GLsizei iBufferSize, GLsizei* pLength, GLenum* pFormat, GLvoid* pBinary );
+typedef void (APIENTRY * ProgramBinaryFunction)( GLuint iProgram, GLenum eFormat, GLvoid const* pBinary, GLsizei iLength );
+typedef void (APIENTRY * ProgramParameteriFunction)( GLuint iProgram, GLenum eName, GLint iValue );
+
+static GetProgramBinaryFunction		s_pGetProgramBinary = NULL;
+static ProgramBinaryFunction		s_pProgramBinary = NULL;
+static ProgramParameteriFunction	s_pProgramParameteri = NULL;
+
+/// Header of a cached program, followed by the binary
+struct sProgramHeader
+{
+	char			m_pMagic[4];
+	unsigned int	m_iVersion;
+	unsigned int	m_iFormat;
+	unsigned int	m_iLength;
+};
+
+static const char s_pProgramMagic[4] = { 'B', 'P', 'R', 'G' };
+static const unsigned int s_iProgramVersion = 1;
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static void MakeDirectory( const std::string& sDirectory )
+{
+	//Every parent is created first, the ones already there just fail
+	for( unsigned int i = 1; i <= sDirectory.size(); ++i )
+	{
+		if( i == sDirectory.size() || sDirectory[i] == '/' || sDirectory[i] == '\\' )
+		{
+			std::string sParent = sDirectory.substr( 0, i );
+#ifdef WIN32
+			_mkdir( sParent.c_str() );
+#else
+			mkdir( sParent.c_str(), 0755 );
+#endif
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static void HashString( const std::string& sString, unsigned long long& iHash )
+{
+	//FNV-1a, the terminating zero is hashed too so "ab"+"c" and "a"+"bc" differ
+	for( unsigned int i = 0; i <= sString.size(); ++i )
+	{
+		iHash ^= (unsigned char)sString.c_str()[i];
+		iHash *= 1099511628211ULL;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+ShaderCache::ShaderCache()
+	: m_bEnabled( false )
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool ShaderCache::Initialize( const std::string& sDirectory )
+{
+	m_bEnabled = false;
+	if( !isExtensionSupported( "GL_ARB_get_program_binary" ) )
+	{
+		std::cerr << "WARNING : GL_ARB_get_program_binary not supported, shaders are compiled on every launch" << std::endl;
+		return false;
+	}
+
+	s_pGetProgramBinary = (GetProgramBinaryFunction)getExtensionFunction( "glGetProgramBinary" );
+	s_pProgramBinary = (ProgramBinaryFunction)getExtensionFunction( "glProgramBinary" );
+	s_pProgramParameteri = (ProgramParameteriFunction)getExtensionFunction( "glProgramParameteri" );
+	if( !s_pGetProgramBinary || !s_pProgramBinary || !s_pProgramParameteri )
+	{
+		return false;
+	}
+
+	//Some drivers expose the extension without any binary format
+	GLint iFormatCount = 0;
+	glGetIntegerv( GL_NUM_PROGRAM_BINARY_FORMATS, &iFormatCount );
+	if( iFormatCount <= 0 )
+	{
+		std::cerr << "WARNING : no program binary format, shaders are compiled on every launch" << std::endl;
+		return false;
+	}
+
+	m_sDriver = std::string( (char const*)glGetString( GL_VENDOR ) ) + "|"
+		+ std::string( (char const*)glGetString( GL_RENDERER ) ) + "|"
+		+ std::string( (char const*)glGetString( GL_VERSION ) );
+
+	m_sDirectory = sDirectory;
+	if( !m_sDirectory.empty() && m_sDirectory[ m_sDirectory.size() - 1 ] != '/' )
+	{
+		m_sDirectory += '/';
+	}
+	MakeDirectory( m_sDirectory.substr( 0, m_sDirectory.size() - 1 ) );
+
+	m_bEnabled = true;
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+std::string ShaderCache::ComputeKey( const std::string& sVertexSource, const std::string& sFragmentSource ) const
+{
+	unsigned long long iHash = 14695981039346656037ULL;
+	HashString( m_sDriver, iHash );
+	HashString( sVertexSource, iHash );
+	HashString( sFragmentSource, iHash );
+
+	char sKey[17];
+	sprintf( sKey, "%08x%08x", (unsigned int)( iHash >> 32 ), (unsigned int)( iHash & 0xffffffff ) );
+	return std::string( sKey );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+std::string ShaderCache::GetFileName( const std::string& sKey ) const
+{
+	return m_sDirectory + sKey + ".bprg";
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool ShaderCache::LoadProgram( GLhandleARB oProgram, const std::string& sKey ) const
+{
+	if( !m_bEnabled )
+	{
+		return false;
+	}
+
+	std::string sFileName = GetFileName( sKey );
+	std::vector< char > vBinary;
+	sProgramHeader oHeader;
+	{
+		std::ifstream oFile( sFileName.c_str(), std::ios::binary );
+		if( !oFile )
+		{
+			return false;
+		}
+
+		oFile.read( (char*)&oHeader, sizeof( oHeader ) );
+		if( !oFile || memcmp( oHeader.m_pMagic, s_pProgramMagic, 4 ) != 0 || oHeader.m_iVersion != s_iProgramVersion || oHeader.m_iLength == 0 )
+		{
+			return false;
+		}
+
+		vBinary.resize( oHeader.m_iLength );
+		oFile.read( &vBinary[0], oHeader.m_iLength );
+		if( !oFile )
+		{
+			return false;
+		}
+	}
+
+	s_pProgramBinary( (GLuint)oProgram, (GLenum)oHeader.m_iFormat, &vBinary[0], (GLsizei)oHeader.m_iLength );
+
+	//The driver may still refuse a binary with a matching key (same version string, different build)
+	GLint iStatus = GL_FALSE;
+	glGetProgramiv( (GLuint)oProgram, GL_LINK_STATUS, &iStatus );
+	if( iStatus != GL_TRUE )
+	{
+		remove( sFileName.c_str() );
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ShaderCache::PrepareProgram( GLhandleARB oProgram ) const
+{
+	if( m_bEnabled )
+	{
+		s_pProgramParameteri( (GLuint)oProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void ShaderCache::SaveProgram( GLhandleARB oProgram, const std::string& sKey ) const
+{
+	if( !m_bEnabled )
+	{
+		return;
+	}
+
+	GLint iLength = 0;
+	glGetProgramiv( (GLuint)oProgram, GL_PROGRAM_BINARY_LENGTH, &iLength );
+	if( iLength <= 0 )
+	{
+		return;
+	}
+
+	std::vector< char > vBinary( iLength );
+	GLenum eFormat = 0;
+	s_pGetProgramBinary( (GLuint)oProgram, iLength, &iLength, &eFormat, &vBinary[0] );
+	if( iLength <= 0 )
+	{
+		return;
+	}
+
+	sProgramHeader oHeader;
+	memcpy( oHeader.m_pMagic, s_pProgramMagic, 4 );
+	oHeader.m_iVersion = s_iProgramVersion;
+	oHeader.m_iFormat = eFormat;
+	oHeader.m_iLength = iLength;
+
+	//Written aside then renamed, so a crash never leaves a truncated binary behind
+	std::string sFileName = GetFileName( sKey );
+	std::string sTemporaryName = sFileName + ".tmp";
+	{
+		std::ofstream oFile( sTemporaryName.c_str(), std::ios::binary | std::ios::trunc );
+		if( !oFile )
+		{
+			std::cerr << "WARNING : cannot write the program cache " << sTemporaryName << std::endl;
+			return;
+		}
+		oFile.write( (char const*)&oHeader, sizeof( oHeader ) );
+		oFile.write( &vBinary[0], iLength );
+		if( !oFile )
+		{
+			return;
+		}
+	}
+
+	remove( sFileName.c_str() );
+	rename( sTemporaryName.c_str(), sFileName.c_str() );
+}
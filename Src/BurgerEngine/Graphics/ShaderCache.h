@@ -0,0 +1,56 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __SHADERCACHE_H__
+#define __SHADERCACHE_H__
+
+#include <string>
+
+#include "BurgerEngine/Graphics/CommonGraphics.h"
+
+/// \class	ShaderCache
+/// \brief	Linked programs saved on disk with ARB_get_program_binary, reloaded on the next launches instead of
+///			compiling the sources again. The key hashes both sources and the driver strings, so an edited shader
+///			or a driver update misses the cache and falls back on the compilation
+class ShaderCache
+{
+public:
+
+	ShaderCache();
+
+	/// \brief Check the driver can give back program binaries and create the cache directory, GL thread only
+	bool Initialize( const std::string& sDirectory );
+
+	bool IsEnabled() const { return m_bEnabled; }
+
+	/// \brief Key of a program, from the sources of its shaders
+	std::string ComputeKey( const std::string& sVertexSource, const std::string& sFragmentSource ) const;
+
+	/// \brief Load the binary saved under a key in a new program, false when there is none or the driver refuses it
+	bool LoadProgram( GLhandleARB oProgram, const std::string& sKey ) const;
+
+	/// \brief Ask the driver to keep the binary of a program, must be called before linking it
+	void PrepareProgram( GLhandleARB oProgram ) const;
+
+	/// \brief Save the binary of a linked program under a key
+	void SaveProgram( GLhandleARB oProgram, const std::string& sKey ) const;
+
+private:
+
+	std::string GetFileName( const std::string& sKey ) const;
+
+	std::string	m_sDirectory;
+	/// Vendor, renderer and version, part of every key
+	std::string	m_sDriver;
+	bool		m_bEnabled;
+};
+
+#endif //__SHADERCACHE_H__
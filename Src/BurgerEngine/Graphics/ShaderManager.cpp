@@ -1,19 +1,53 @@
 #include "shaderManager.h"
 #include "shader.h"
+#include "BurgerEngine/Graphics/FrameConstants.h"
+#include "BurgerEngine/Graphics/TransformBuffer.h"
 
 #include "BurgerEngine/External/TinyXml/TinyXml.h"
 
 #include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cassert>
+
+//KHR_parallel_shader_compile is newer than GLee, the entry point is loaded by hand
+typedef void (APIENTRY * MaxShaderCompilerThreadsFunction)( GLuint iCount );
 
 ShaderManager::ShaderManager()
 {
 }
 
+void ShaderManager::Initialize( const std::string& sProgramCacheDirectory )
+{
+	//Without it some drivers compile on the calling thread, inside glCompileShader
+	MaxShaderCompilerThreadsFunction pMaxShaderCompilerThreads = NULL;
+	if( isExtensionSupported( "GL_KHR_parallel_shader_compile" ) )
+	{
+		pMaxShaderCompilerThreads = (MaxShaderCompilerThreadsFunction)getExtensionFunction( "glMaxShaderCompilerThreadsKHR" );
+	}
+	else if( isExtensionSupported( "GL_ARB_parallel_shader_compile" ) )
+	{
+		pMaxShaderCompilerThreads = (MaxShaderCompilerThreadsFunction)getExtensionFunction( "glMaxShaderCompilerThreadsARB" );
+	}
+	if( pMaxShaderCompilerThreads )
+	{
+		//As many threads as the driver wants
+		pMaxShaderCompilerThreads( 0xFFFFFFFF );
+	}
+
+	if( !sProgramCacheDirectory.empty() )
+	{
+		m_oProgramCache.Initialize( sProgramCacheDirectory );
+	}
+}
+
 void ShaderManager::clear()
 {
+	m_vPendingShaders.clear();
 	for (std::map<std::string,Shader*>::iterator iter = m_mShaders.begin(); iter != m_mShaders.end() ; ++iter)
 		delete (*iter).second;
 	m_mShaders.clear();
+	m_mDescriptions.clear();
 }
 
 Shader*	ShaderManager::GetShader(const std::string& name)
@@ -27,42 +61,211 @@ Shader*	ShaderManager::GetShader(const std::string& name)
 	return (*iter).second;
 }
 
-Shader * ShaderManager::AddShader(const char * sName )
+Shader * ShaderManager::AddShader(const char * sName, unsigned int iFeatures )
+{
+	Shader* pShader = RequestShader( sName, iFeatures );
+	BuildPendingShaders();
+	return pShader;
+}
+
+//#extension lines must come before any declaration, so they are pulled out of the shared declarations
+static void AppendDeclaration( const std::string& sDeclaration, std::string& sExtensions, std::string& sDeclarations )
+{
+	std::istringstream oStream( sDeclaration );
+	std::string sLine;
+	while( std::getline( oStream, sLine ) )
+	{
+		if( sLine.compare( 0, 10, "#extension" ) == 0 )
+		{
+			if( sExtensions.find( sLine ) == std::string::npos )
+			{
+				sExtensions += sLine + "\n";
+			}
+		}
+		else
+		{
+			sDeclarations += sLine + "\n";
+		}
+	}
+}
+
+Shader * ShaderManager::RequestShader(const char * sName, unsigned int iFeatures )
 {
-	std::map<std::string,Shader*>::iterator iter = m_mShaders.find( sName );
+	sShaderDescription const* pDescription = _GetDescription( sName );
+	if( !pDescription )
+	{
+		return NULL;
+	}
+
+	//The defines of the permutation, disabled features are dropped from the mask
+	std::string sKey( sName ), sDefines;
+	unsigned int iMask = 0;
+	for( unsigned int i = 0; i < pDescription->m_vFeatures.size(); ++i )
+	{
+		std::string const& sFeature = pDescription->m_vFeatures[i];
+		if( ( iFeatures & ( 1u << i ) ) && m_oDisabledFeatures.find( sFeature ) == m_oDisabledFeatures.end() )
+		{
+			iMask |= 1u << i;
+			sDefines += "#define " + sFeature + "\n";
+		}
+	}
+	//The declarations go in both sources, so the two stages declare them the same way
+	std::string sExtensions, sDeclarations;
+	if( pDescription->m_bFrameConstants )
+	{
+		AppendDeclaration( FrameConstants::GetDeclaration(), sExtensions, sDeclarations );
+	}
+	if( pDescription->m_bObjectTransforms )
+	{
+		AppendDeclaration( TransformBuffer::GetDeclaration(), sExtensions, sDeclarations );
+	}
+	sDefines += sExtensions + sDeclarations;
+	if( iMask != 0 )
+	{
+		std::stringstream oKey;
+		oKey << sName << "#" << std::hex << iMask;
+		sKey = oKey.str();
+	}
+
+	std::map<std::string,Shader*>::iterator iter = m_mShaders.find( sKey );
 	if ( iter == m_mShaders.end() )
 	{
-		TiXmlDocument * pDocument = new TiXmlDocument( sName );
+		Shader* pShader	 =	new Shader();
+		std::cout << "LOADING SHADER : "<< pDescription->m_sVertexShader <<" - "<< pDescription->m_sPixelShader;
+		if( iMask != 0 )
+		{
+			std::cout << " (" << sKey << ")";
+		}
+		std::cout << std::endl << std::endl;
+		if( pShader->Compile( pDescription->m_sVertexShader, pDescription->m_sPixelShader, &m_oProgramCache, sDefines ) )
+		{
+			m_vPendingShaders.push_back( pShader );
+		}
+		else
+		{
+			std::cerr << "WARNING : cannot build shader : " << sKey << std::endl;
+		}
+		return m_mShaders[ sKey ] = pShader;
+	}
+	return (*iter).second;
+}
 
-		if(!pDocument->LoadFile())
+unsigned int ShaderManager::GetFeatureMask( const char* sName, const std::string& sFeatures )
+{
+	sShaderDescription const* pDescription = _GetDescription( sName );
+	if( !pDescription )
+	{
+		return 0;
+	}
+
+	unsigned int iMask = 0;
+	std::istringstream oFeatures( sFeatures );
+	std::string sFeature;
+	while( oFeatures >> sFeature )
+	{
+		std::vector< std::string >::const_iterator it = std::find( pDescription->m_vFeatures.begin(), pDescription->m_vFeatures.end(), sFeature );
+		if( it == pDescription->m_vFeatures.end() )
 		{
-  			std::cerr << "[ReadXML] Loading Error : " << pDocument->ErrorDesc() << std::endl;
-			return NULL;
+			std::cerr << "WARNING : shader " << sName << " has no feature " << sFeature << std::endl;
+			continue;
 		}
-	
-		TiXmlElement * pRoot = pDocument->FirstChildElement( "shader" );	
-		if( pRoot )
+		iMask |= 1 << ( it - pDescription->m_vFeatures.begin() );
+	}
+	return iMask;
+}
+
+void ShaderManager::DisableFeatures( const std::string& sFeatures )
+{
+	std::istringstream oFeatures( sFeatures );
+	std::string sFeature;
+	while( oFeatures >> sFeature )
+	{
+		m_oDisabledFeatures.insert( sFeature );
+	}
+}
+
+ShaderManager::sShaderDescription const* ShaderManager::_GetDescription( const char* sName )
+{
+	std::map<std::string,sShaderDescription>::iterator iter = m_mDescriptions.find( sName );
+	if( iter != m_mDescriptions.end() )
+	{
+		return &(*iter).second;
+	}
+
+	TiXmlDocument oDocument( sName );
+	if(!oDocument.LoadFile())
+	{
+		std::cerr << "[ReadXML] Loading Error : " << oDocument.ErrorDesc() << std::endl;
+		return NULL;
+	}
+
+	TiXmlElement * pRoot = oDocument.FirstChildElement( "shader" );	
+	if( !pRoot )
+	{
+		return NULL;
+	}
+
+	sShaderDescription oDescription;
+	oDescription.m_bFrameConstants = false;
+	oDescription.m_bObjectTransforms = false;
+	//loads shader program
+	TiXmlElement * pXmlVertex = pRoot->FirstChildElement( "vertexshader" );
+	if( pXmlVertex )
+	{
+		oDescription.m_sVertexShader = std::string( pXmlVertex->GetText() );
+	}
+
+	TiXmlElement * pXmlPixel = pRoot->FirstChildElement( "pixelshader" );
+	if( pXmlPixel )
+	{
+		oDescription.m_sPixelShader = std::string( pXmlPixel->GetText() );
+	}
+
+	//Feature switches of both sources, in the order they are declared, and the shared declarations
+	std::string const* pSources[2] = { &oDescription.m_sVertexShader, &oDescription.m_sPixelShader };
+	for( unsigned int i = 0; i < 2; ++i )
+	{
+		std::string sSource;
+		if( !readShaderSource( pSources[i]->c_str(), sSource ) )
+		{
+			continue;
+		}
+		std::istringstream oSource( sSource );
+		std::string sLine;
+		while( std::getline( oSource, sLine ) )
 		{
-			std::string sShaderName, sVertexShader, sPixelShader;
-			//loads shader program
-			TiXmlElement * pXmlVertex = pRoot->FirstChildElement( "vertexshader" );
-			if( pXmlVertex )
+			std::istringstream oLine( sLine );
+			std::string sPragma, sDirective, sFeature;
+			if( oLine >> sPragma >> sDirective && sPragma == "#pragma" && sDirective == "frameconstants" )
 			{
-				sVertexShader = std::string( pXmlVertex->GetText() );
+				oDescription.m_bFrameConstants = true;
 			}
-
-			TiXmlElement * pXmlPixel = pRoot->FirstChildElement( "pixelshader" );
-			if( pXmlPixel )
+			else if( sPragma == "#pragma" && sDirective == "objecttransforms" )
 			{
-				sPixelShader = std::string( pXmlPixel->GetText() );
+				oDescription.m_bObjectTransforms = true;
+			}
+			else if( oLine >> sFeature && sPragma == "#pragma" && sDirective == "feature"
+				&& std::find( oDescription.m_vFeatures.begin(), oDescription.m_vFeatures.end(), sFeature ) == oDescription.m_vFeatures.end() )
+			{
+				oDescription.m_vFeatures.push_back( sFeature );
 			}
-
-			Shader* pShader	 =	new Shader();
-			std::cout << "LOADING SHADER : "<< sVertexShader <<" - "<< sPixelShader << std::endl << std::endl;
-			assert(pShader->LoadAndCompile( sVertexShader, sPixelShader ) );
-			return m_mShaders[ sName ] = pShader;
 		}
-		return NULL;
 	}
-	return m_mShaders[ sName ];
-}
\ No newline at end of file
+	assert( oDescription.m_vFeatures.size() <= 32 );
+
+	return &( m_mDescriptions[ sName ] = oDescription );
+}
+
+void ShaderManager::BuildPendingShaders()
+{
+	//Every link is submitted before waiting for the first one
+	for( unsigned int i = 0; i < m_vPendingShaders.size(); ++i )
+	{
+		m_vPendingShaders[i]->Link( &m_oProgramCache );
+	}
+	for( unsigned int i = 0; i < m_vPendingShaders.size(); ++i )
+	{
+		m_vPendingShaders[i]->Finish( &m_oProgramCache );
+	}
+	m_vPendingShaders.clear();
+}
@@ -14,9 +14,12 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include <set>
 
 #include "BurgerEngine/Base/Singleton.h"
 #include "shaderTool.h"
+#include "ShaderCache.h"
 
 ///Forward declaration
 class Shader;
@@ -26,15 +29,58 @@ class ShaderManager:public Singleton<ShaderManager>
 	friend class Singleton<ShaderManager>;
 
 	public:
+		/// \brief Set the driver up for parallel compilation and, when a directory is given, save the linked
+		///			programs there to reload them on the next launches. GL thread only, before the first shader
+		void Initialize( const std::string& sProgramCacheDirectory );
+
 		Shader* GetShader(const std::string& name);
-		Shader* AddShader(const char* sName );
+
+		/// \brief Load a shader and wait until it can be used, the pending shaders are built with it.
+		///			iFeatures selects the permutation, see GetFeatureMask
+		Shader* AddShader(const char* sName, unsigned int iFeatures = 0 );
+
+		/// \brief Submit the compilation of a shader without waiting for the driver.
+		///			It is not usable (IsReady) before BuildPendingShaders
+		Shader* RequestShader(const char* sName, unsigned int iFeatures = 0 );
+
+		/// \brief Mask of features named in sFeatures (separated by spaces). The sources of a shader declare
+		///			its switches with "#pragma feature NAME" lines, the first one declared is bit 0, and each
+		///			permutation is compiled with a #define for every feature of its mask
+		unsigned int GetFeatureMask( const char* sName, const std::string& sFeatures );
+
+		/// \brief Features never compiled in, whatever is requested, to strip the costly ones on a small platform
+		void DisableFeatures( const std::string& sFeatures );
+		bool IsFeatureDisabled( const std::string& sFeature ) const { return m_oDisabledFeatures.find( sFeature ) != m_oDisabledFeatures.end(); }
+
+		/// \brief Link every requested shader, then wait for all of them. Compiles and links are all
+		///			submitted before the first wait, so the driver overlaps them
+		void BuildPendingShaders();
 
 		void clear();
 		inline bool isSupported(const std::string& ext){
 				return isExtensionSupported((char*)ext.c_str());};
 
 	protected:
+		/// \brief Sources of a shader xml and the features they declare
+		struct sShaderDescription
+		{
+			std::string m_sVertexShader;
+			std::string m_sPixelShader;
+			std::vector< std::string > m_vFeatures;
+			/// A source has "#pragma frameconstants"
+			bool m_bFrameConstants;
+			/// A source has "#pragma objecttransforms"
+			bool m_bObjectTransforms;
+		};
+
+		sShaderDescription const* _GetDescription( const char* sName );
+
 		std::map<std::string,Shader*> m_mShaders;
+		std::map<std::string,sShaderDescription> m_mDescriptions;
+		std::set<std::string> m_oDisabledFeatures;
+		/// Requested, not built yet
+		std::vector<Shader*> m_vPendingShaders;
+		ShaderCache m_oProgramCache;
 
 		ShaderManager();
 		virtual ~ShaderManager(){clear();};
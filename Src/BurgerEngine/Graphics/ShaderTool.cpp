@@ -5,6 +5,7 @@
 #include <string>
 
 #include "shaderTool.h"
+#include "ShaderCache.h"
 
 #undef min
 #undef max
@@ -13,7 +14,22 @@
 const int MAX_LOG_STRING = 1024;
 char logstring[MAX_LOG_STRING];
 
-GLhandleARB loadShader(const char * filename)
+bool readShaderSource(const char * filename, std::string& source)
+{
+  if(filename==0)
+    return false;
+
+  std::ifstream file(filename); 
+  if(!file)
+    return false;
+
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  source = buffer.str();
+  return true;
+}
+
+GLhandleARB loadShader(const char * filename, const std::string& defines)
 {
 
   if(filename==0)
@@ -49,22 +65,36 @@ GLhandleARB loadShader(const char * filename)
      )
     return 0;
 
-  std::ifstream file(filename); 
-  if(!file)
+  std::string s;
+  if(!readShaderSource(filename, s))
     return 0;
-  
-  std::stringstream buffer;
-  buffer << file.rdbuf();
-  file.close();
 
-  std::string s = buffer.str();
+  // Declarations shared by both stages tell them apart with it
+  std::string stagedefines = vertexshader ? "#define VERTEX_SHADER\n" + defines : defines;
+
+  if(!stagedefines.empty()){
+    // #version has to stay the first statement, and the #extension lines before any declaration
+    std::string::size_type insert = 0;
+    std::string::size_type next = s.find_first_not_of(" \t\r\n");
+    if(next != std::string::npos && s.compare(next, 8, "#version") == 0){
+      insert = s.find('\n', next);
+      insert = (insert == std::string::npos) ? s.size() : insert + 1;
+      next = s.find_first_not_of(" \t\r\n", insert);
+    }
+    while(next != std::string::npos && s.compare(next, 10, "#extension") == 0){
+      insert = s.find('\n', next);
+      insert = (insert == std::string::npos) ? s.size() : insert + 1;
+      next = s.find_first_not_of(" \t\r\n", insert);
+    }
+    s.insert(insert, stagedefines);
+  }
 
-  GLcharARB * source = new GLcharARB[4*(buffer.str().size()/4+1)];
+  GLcharARB * source = new GLcharARB[4*(s.size()/4+1)];
   if(source == 0)
     return 0;
 
   unsigned int i;
-  for(i =0; i < buffer.str().size(); ++i){
+  for(i =0; i < s.size(); ++i){
    source[i] = s[i];
   }
   source[i] = '\0';
@@ -92,7 +122,14 @@ bool compileShader(GLhandleARB object)
     return false;
 
   glCompileShaderARB(object);
-  
+  return checkCompileStatus(object);
+}
+
+bool checkCompileStatus(GLhandleARB object)
+{
+  if(object==0)
+    return false;
+
   int status;
   glGetObjectParameterivARB(object, GL_OBJECT_COMPILE_STATUS_ARB, &status);
   if(status==0){
@@ -109,7 +146,7 @@ bool compileShader(GLhandleARB object)
 }
 
 
-GLhandleARB linkShaders(GLhandleARB* object, const unsigned int& nb)
+GLhandleARB linkShaders(GLhandleARB* object, const unsigned int& nb, const ShaderCache* cache)
 {
   if(object==0)
     return 0;
@@ -121,22 +158,35 @@ GLhandleARB linkShaders(GLhandleARB* object, const unsigned int& nb)
     if(object[i]>0)
       glAttachObjectARB(po,object[i]);
   }
+
+  if(cache)
+    cache->PrepareProgram(po);
   
   glLinkProgramARB(po);
 
+  if(!checkLinkStatus(po))
+    return 0;
+  return po;
+}
+
+bool checkLinkStatus(GLhandleARB object)
+{
+  if(object==0)
+    return false;
+
   int status;
-  glGetObjectParameterivARB(po, GL_OBJECT_LINK_STATUS_ARB, &status);
+  glGetObjectParameterivARB(object, GL_OBJECT_LINK_STATUS_ARB, &status);
   if(status==0){
     int length = 0;
-    glGetObjectParameterivARB(po, GL_OBJECT_INFO_LOG_LENGTH_ARB, &length);
+    glGetObjectParameterivARB(object, GL_OBJECT_INFO_LOG_LENGTH_ARB, &length);
     if(length>0){
       GLsizei minlength = std::min(MAX_LOG_STRING,length);
-      glGetInfoLogARB(po, minlength, 0, logstring);
+      glGetInfoLogARB(object, minlength, 0, logstring);
       std::cerr << logstring << std::endl;
     }
-    return 0;
+    return false;
   }
-  return po;
+  return true;
 }
 
 bool isExtensionSupported(char * ext)
@@ -146,3 +196,12 @@ bool isExtensionSupported(char * ext)
     return true;
   return false;
 }
+
+void * getExtensionFunction(const char * name)
+{
+#ifdef WIN32
+  return (void*)wglGetProcAddress(name);
+#else
+  return (void*)glXGetProcAddressARB((const GLubyte*)name);
+#endif
+}
@@ -5,20 +5,43 @@
 
 #include "BurgerEngine/Graphics/CommonGraphics.h"
 
+#include <string>
+
+class ShaderCache;
+
+// filename : name of the file contening a shader
+// source : receives the text of the shader
+// return : true if the file could be read
+bool readShaderSource(const char * filename, std::string& source);
+
 // filename : name of the file contening a shader
+// defines : #define lines inserted before the source, after its #version line
 // return : a program object
-GLhandleARB loadShader(const char * filename);
+GLhandleARB loadShader(const char * filename, const std::string& defines = std::string());
 
 // object : program object
 // return : true if compilation is a success
 bool compileShader(GLhandleARB object);
 
+// object : a shader object, glCompileShaderARB already called
+// return : true if compilation is a success, waits for the driver
+bool checkCompileStatus(GLhandleARB object);
+
+// object : a program object, glLinkProgramARB already called
+// return : true if link is a success, waits for the driver
+bool checkLinkStatus(GLhandleARB object);
+
 // object : a list of program objects
 // nb : the number of program objects
+// cache : when given, the driver is asked to keep the binary of the program
 // return : shader object
-GLhandleARB linkShaders(GLhandleARB* object, const unsigned int& nb);
+GLhandleARB linkShaders(GLhandleARB* object, const unsigned int& nb, const ShaderCache* cache = 0);
 
 // ext : the name of the extension
 // return : true if the extension is supoerted, false otherwise
 bool isExtensionSupported(char * ext);
+
+// name : a GL function unknown to GLee
+// return : its address, 0 if the driver does not have it
+void * getExtensionFunction(const char * name);
 #endif
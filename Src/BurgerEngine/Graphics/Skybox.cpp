@@ -2,6 +2,7 @@
 #include "BurgerEngine/Graphics/RenderingContext.h"
 
 #include "BurgerEngine/Graphics/SkyBox.h"
+#include "BurgerEngine/Graphics/OpenGLContext.h"
 #include "BurgerEngine/Graphics/Material.h"
 #include "BurgerEngine/External/Math/Vector.h"
 
@@ -82,11 +83,11 @@ void SkyBox::BuildCube( float fSize )
 
 	pVertex[23] = vec3( fSize, fSize,- fSize );
 	
-	glBindBuffer(GL_ARRAY_BUFFER, m_iBufferID);
+	OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, m_iBufferID);
 	
 	glBufferData( GL_ARRAY_BUFFER, iSizeVec3, pVertex, GL_STATIC_DRAW);
 	
-	glBindBuffer(GL_ARRAY_BUFFER, 0 );
+	OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, 0 );
 
 	delete [] pVertex;
 }
@@ -125,11 +126,11 @@ void SkyBox::BuildSphere( float fSize, unsigned int iSlices, unsigned int iStack
 		}
 	}
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_iBufferID2 );
+	OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, m_iBufferID2 );
 	
 	glBufferData( GL_ARRAY_BUFFER, iSizeVertex, pVertex, GL_STATIC_DRAW);
 	
-	glBindBuffer(GL_ARRAY_BUFFER, 0 );
+	OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, 0 );
 
 	delete [] pVertex;
 }
@@ -150,26 +151,26 @@ void SkyBox::Draw( const vec3& f3Position, unsigned int iFlag ) const
 	{
 		//if( iFlag )
 		{
-			glBindBuffer(GL_ARRAY_BUFFER, m_iBufferID );
+			OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, m_iBufferID );
 	
 			glEnableClientState(GL_VERTEX_ARRAY);
 			glVertexPointer(3, GL_FLOAT, 0, 0);
 			glDrawArrays(GL_QUADS, 0, I_VERTEX_COUNT );
 			glDisableClientState(GL_VERTEX_ARRAY); 
 	
-			glBindBuffer(GL_ARRAY_BUFFER, 0 );
+			OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, 0 );
 		}
 		//we might want to use a sphere for the sky, I keep this code just in case.
 		/*
 		else
 		{
-			glBindBuffer(GL_ARRAY_BUFFER, m_iBufferID2 );
+			OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, m_iBufferID2 );
 	
 			glEnableClientState(GL_VERTEX_ARRAY);
 			glVertexPointer(3, GL_FLOAT, 0, 0);
 			glDrawArrays( GL_TRIANGLE_STRIP, 0, m_iVertexCount );
 			glDisableClientState(GL_VERTEX_ARRAY); 
-			glBindBuffer(GL_ARRAY_BUFFER, 0 );
+			OpenGLContext::BindBuffer(GL_ARRAY_BUFFER, 0 );
 		}
 		*/
 		m_pMaterial->Deactivate( EffectTechnique::E_RENDER_OPAQUE );
@@ -29,19 +29,12 @@ void SpotLight::ComputeBoundingBox()
 	m_pFarPlanePoints[2] = f3FarPos + f3Right - f3Up;
 	m_pFarPlanePoints[3] = f3FarPos - f3Right - f3Up;
 	
-	m_pBoundingBox[0] = m_pBoundingBox[1] = m_f3Position.x;
-	m_pBoundingBox[2] = m_pBoundingBox[3] = m_f3Position.y;
-	m_pBoundingBox[4] = m_pBoundingBox[5] = m_f3Position.z;
-
-	for( unsigned int i = 0; i < 4; ++i )
+	//The far plane is centered on f3FarPos, its half size on each axis is what right and up add together,
+	//the box then grows to hold the light position
+	for( unsigned int i = 0; i < 3; ++i )
 	{
-		m_pBoundingBox[0] = min(m_pBoundingBox[0], m_pFarPlanePoints[i].x);
-		m_pBoundingBox[1] = max(m_pBoundingBox[1], m_pFarPlanePoints[i].x);
-
-		m_pBoundingBox[2] = min(m_pBoundingBox[2], m_pFarPlanePoints[i].y);
-		m_pBoundingBox[3] = max(m_pBoundingBox[3], m_pFarPlanePoints[i].y);
-
-		m_pBoundingBox[4] = min(m_pBoundingBox[4], m_pFarPlanePoints[i].z);
-		m_pBoundingBox[5] = max(m_pBoundingBox[5], m_pFarPlanePoints[i].z);
+		float fHalfSize = fabsf( f3Right[i] ) + fabsf( f3Up[i] );
+		m_pBoundingBox[ i * 2 ] = min( f3FarPos[i] - fHalfSize, m_f3Position[i] );
+		m_pBoundingBox[ i * 2 + 1 ] = max( f3FarPos[i] + fHalfSize, m_f3Position[i] );
 	}
 }
\ No newline at end of file
@@ -1,4 +1,8 @@
 #include "StaticMesh.h"
+#include "BurgerEngine/Graphics/MeshManager.h"
+#include "BurgerEngine/Graphics/DrawBatch.h"
+
+#include "BurgerEngine/External/Math/Frustum.h"
 
 #include <sstream>
 #include <fstream>
@@ -9,17 +13,27 @@
 /// \todo put those in a separate file 
 #define NEXT_INDICE do{i++;}while((cBuffer[i]<'0')&&(cBuffer[i]>'9'));
 
+/// \brief Insert two zero bits between each of the 10 lower bits, used to build morton codes
+static unsigned int SpreadBits( unsigned int i )
+{
+	i &= 0x000003ff;
+	i = (i | (i << 16)) & 0xff0000ff;
+	i = (i | (i <<  8)) & 0x0300f00f;
+	i = (i | (i <<  4)) & 0x030c30c3;
+	i = (i | (i <<  2)) & 0x09249249;
+	return i;
+}
+
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
 StaticMesh::StaticMesh()
-	: m_iBufferId(0)
-	, m_iSizeVertex(0)
-	, m_iSizeNormal(0)
-	, m_iSizeTexture(0)
-	, m_iSizeTangent(0)
+	: m_bResident(false)
+	, m_bLoadFailed(false)
+	, m_bHasPrecomputedBoundingBox(false)
 	, m_pBoundingBox( NULL )
+	, m_iIndexCount(0)
 {
 }
 
@@ -29,13 +43,26 @@ StaticMesh::StaticMesh()
 //--------------------------------------------------------------------------------------------------------------------
 bool StaticMesh::LoadMesh(std::string const& a_sFilename)
 {
-	
+	if( !LoadMeshData(a_sFilename) )
+	{
+		return false;
+	}
+
+	return BuildBuffer();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool StaticMesh::LoadMeshData(std::string const& a_sFilename)
+{
 	if(a_sFilename.find(".obj") != std::string::npos) 
 	{
-		// \todo Create a macro ASSERT with message
-		assert(LoadFromFile(a_sFilename));
-		//std::cerr << "[ERROR]: " << a_sFilename << " couldn't be loaded" << std::endl;
-		//return false;
+		if( !LoadFromFile(a_sFilename) )
+		{
+			std::cerr << "[ERROR]: " << a_sFilename << " couldn't be loaded" << std::endl;
+			return false;
+		}
 	}
 	else 
 	{
@@ -43,12 +70,9 @@ bool StaticMesh::LoadMesh(std::string const& a_sFilename)
 		return false;
 	}
 
-
 	ComputeTangents();
-	
-	BuildBuffer();
-
 
+	BuildClusters();
 
 	return true;
 }
@@ -288,6 +312,62 @@ bool StaticMesh::LoadFromFile(std::string const& a_sFilename)
 	return true;
 }
 
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void StaticMesh::SetPrecomputedBoundingBox( const float* pBoundingBox )
+{
+	for( unsigned int i = 0; i < 6; ++i )
+	{
+		m_pPrecomputedBoundingBox[i] = pBoundingBox[i];
+	}
+	m_bHasPrecomputedBoundingBox = true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool StaticMesh::ReadBoundingBox( std::string const& a_sFilename, float* pBoundingBox )
+{
+	std::ifstream pFile(a_sFilename.c_str(), std::ios::binary);
+	if(!pFile)
+	{
+		return false;
+	}
+
+	//Only the vertex lines are read, as LoadFromFile does
+	bool bFound = false;
+	vec3 f3Vertex;
+	std::string sBuffer;
+	while(std::getline(pFile, sBuffer))
+	{
+		if( sBuffer.size() < 2 || sBuffer[0] != 'v' || ( sBuffer[1] != ' ' && sBuffer[1] != '\t' ) )
+		{
+			continue;
+		}
+		if( sscanf(&sBuffer[2],"%f%f%f",&f3Vertex.x,&f3Vertex.y,&f3Vertex.z) != 3 )
+		{
+			continue;
+		}
+
+		if( !bFound )
+		{
+			pBoundingBox[0] = pBoundingBox[1] = f3Vertex.x;
+			pBoundingBox[2] = pBoundingBox[3] = f3Vertex.y;
+			pBoundingBox[4] = pBoundingBox[5] = f3Vertex.z;
+			bFound = true;
+			continue;
+		}
+		pBoundingBox[0] = min( pBoundingBox[0], f3Vertex.x );
+		pBoundingBox[1] = max( pBoundingBox[1], f3Vertex.x );
+		pBoundingBox[2] = min( pBoundingBox[2], f3Vertex.y );
+		pBoundingBox[3] = max( pBoundingBox[3], f3Vertex.y );
+		pBoundingBox[4] = min( pBoundingBox[4], f3Vertex.z );
+		pBoundingBox[5] = max( pBoundingBox[5], f3Vertex.z );
+	}
+	return bFound;
+}
+
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
@@ -386,57 +466,237 @@ void StaticMesh::ComputeTangents()
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-bool StaticMesh::BuildBuffer()
+void StaticMesh::BuildClusters()
 {
-	glGenBuffers(1,  &m_iBufferId);
-	assert(m_iBufferId);
+	for(std::vector<sMeshGroup>::iterator itG=m_vGroup.begin(); itG!=m_vGroup.end(); itG++) 
+	{
+		std::vector<sMeshTriangle>& vsTriangle = (*itG).m_vsTriangle;
+		(*itG).m_vsCluster.clear();
 
-	Bind();
+		for( unsigned int i = 0; i < 6; ++i )
+		{
+			(*itG).m_pBoundingBox[i] = 0.0f;
+		}
+
+		if( vsTriangle.empty() )
+		{
+			continue;
+		}
+
+		//Centroid bounds, used to quantize the triangle positions
+		std::vector<vec3> vf3Centroid( vsTriangle.size() );
+		vec3 f3Min, f3Max;
+		for( unsigned int i = 0; i < vsTriangle.size(); ++i )
+		{
+			vf3Centroid[i] = ( m_vf3Position[vsTriangle[i].ind[0]] + m_vf3Position[vsTriangle[i].ind[1]] + m_vf3Position[vsTriangle[i].ind[2]] ) / 3.0f;
+			if( i == 0 )
+			{
+				f3Min = f3Max = vf3Centroid[i];
+			}
+			f3Min = vec3( min( f3Min.x, vf3Centroid[i].x ), min( f3Min.y, vf3Centroid[i].y ), min( f3Min.z, vf3Centroid[i].z ) );
+			f3Max = vec3( max( f3Max.x, vf3Centroid[i].x ), max( f3Max.y, vf3Centroid[i].y ), max( f3Max.z, vf3Centroid[i].z ) );
+		}
+		vec3 f3Extent = f3Max - f3Min;
+		vec3 f3InvExtent( f3Extent.x > 0.0f ? 1023.0f / f3Extent.x : 0.0f, f3Extent.y > 0.0f ? 1023.0f / f3Extent.y : 0.0f, f3Extent.z > 0.0f ? 1023.0f / f3Extent.z : 0.0f );
+
+		//Sort the triangles along a morton curve, so consecutive triangles are spatially close
+		std::vector< std::pair<unsigned int, unsigned int> > vKeys( vsTriangle.size() );
+		for( unsigned int i = 0; i < vsTriangle.size(); ++i )
+		{
+			vec3 f3Cell = ( vf3Centroid[i] - f3Min ) * f3InvExtent;
+			vKeys[i].first = SpreadBits( (unsigned int)f3Cell.x ) | ( SpreadBits( (unsigned int)f3Cell.y ) << 1 ) | ( SpreadBits( (unsigned int)f3Cell.z ) << 2 );
+			vKeys[i].second = i;
+		}
+		std::sort( vKeys.begin(), vKeys.end() );
+
+		std::vector<sMeshTriangle> vsSortedTriangle( vsTriangle.size() );
+		for( unsigned int i = 0; i < vKeys.size(); ++i )
+		{
+			vsSortedTriangle[i] = vsTriangle[ vKeys[i].second ];
+		}
+		vsTriangle.swap( vsSortedTriangle );
+
+		//Split in clusters and compute their bounds and normal cone
+		for( unsigned int iFirst = 0; iFirst < vsTriangle.size(); iFirst += iClusterTriangleCount )
+		{
+			sMeshCluster sCluster;
+			sCluster.m_iFirstTriangle = iFirst;
+			sCluster.m_iTriangleCount = min( iClusterTriangleCount, (unsigned int)vsTriangle.size() - iFirst );
+
+			vec3 const& f3First = m_vf3Position[vsTriangle[iFirst].ind[0]];
+			sCluster.m_pBoundingBox[0] = sCluster.m_pBoundingBox[1] = f3First.x;
+			sCluster.m_pBoundingBox[2] = sCluster.m_pBoundingBox[3] = f3First.y;
+			sCluster.m_pBoundingBox[4] = sCluster.m_pBoundingBox[5] = f3First.z;
+
+			vec3 f3NormalSum( 0.0f, 0.0f, 0.0f );
+			std::vector<vec3> vf3FaceNormal;
+			vf3FaceNormal.reserve( sCluster.m_iTriangleCount );
 
-	//Build the VBO
-	if(!m_vf3Position.empty()) 
+			for( unsigned int i = iFirst; i < iFirst + sCluster.m_iTriangleCount; ++i )
+			{
+				for( unsigned int v = 0; v < 3; ++v )
+				{
+					vec3 const& f3Pos = m_vf3Position[vsTriangle[i].ind[v]];
+					sCluster.m_pBoundingBox[0] = min( sCluster.m_pBoundingBox[0], f3Pos.x );
+					sCluster.m_pBoundingBox[1] = max( sCluster.m_pBoundingBox[1], f3Pos.x );
+					sCluster.m_pBoundingBox[2] = min( sCluster.m_pBoundingBox[2], f3Pos.y );
+					sCluster.m_pBoundingBox[3] = max( sCluster.m_pBoundingBox[3], f3Pos.y );
+					sCluster.m_pBoundingBox[4] = min( sCluster.m_pBoundingBox[4], f3Pos.z );
+					sCluster.m_pBoundingBox[5] = max( sCluster.m_pBoundingBox[5], f3Pos.z );
+				}
+
+				//Geometric normal, front faces are counter clockwise
+				vec3 f3Normal = cross( m_vf3Position[vsTriangle[i].ind[1]] - m_vf3Position[vsTriangle[i].ind[0]], m_vf3Position[vsTriangle[i].ind[2]] - m_vf3Position[vsTriangle[i].ind[0]] );
+				float fLength = length( f3Normal );
+				if( fLength > 0.0f )
+				{
+					f3Normal = f3Normal / fLength;
+					f3NormalSum = f3NormalSum + f3Normal;
+					vf3FaceNormal.push_back( f3Normal );
+				}
+			}
+
+			sCluster.m_f3Center = vec3( sCluster.m_pBoundingBox[0] + sCluster.m_pBoundingBox[1], sCluster.m_pBoundingBox[2] + sCluster.m_pBoundingBox[3], sCluster.m_pBoundingBox[4] + sCluster.m_pBoundingBox[5] ) * 0.5f;
+			sCluster.m_fRadius = 0.0f;
+			for( unsigned int i = iFirst; i < iFirst + sCluster.m_iTriangleCount; ++i )
+			{
+				for( unsigned int v = 0; v < 3; ++v )
+				{
+					float fDistance = distance( sCluster.m_f3Center, m_vf3Position[vsTriangle[i].ind[v]] );
+					sCluster.m_fRadius = max( sCluster.m_fRadius, fDistance );
+				}
+			}
+
+			//The cone is only usable if every face normal is within 90 degrees of the axis
+			sCluster.m_f3ConeAxis = vec3( 0.0f, 0.0f, 1.0f );
+			sCluster.m_fConeCutoff = 1.0f;
+			float fSumLength = length( f3NormalSum );
+			if( fSumLength > 0.0f )
+			{
+				sCluster.m_f3ConeAxis = f3NormalSum / fSumLength;
+				float fMinDot = 1.0f;
+				for( std::vector<vec3>::const_iterator itN = vf3FaceNormal.begin(); itN != vf3FaceNormal.end(); ++itN )
+				{
+					float fDot = dot( sCluster.m_f3ConeAxis, *itN );
+					fMinDot = min( fMinDot, fDot );
+				}
+				if( fMinDot > 0.0f )
+				{
+					//sin of the cone half angle, the back facing region is the cone widened by 90 degrees
+					sCluster.m_fConeCutoff = sqrtf( 1.0f - fMinDot * fMinDot );
+				}
+			}
+
+			//The group box is the union of its clusters
+			float* pGroupBox = (*itG).m_pBoundingBox;
+			for( unsigned int i = 0; i < 6; i += 2 )
+			{
+				pGroupBox[i] = ( iFirst == 0 ) ? sCluster.m_pBoundingBox[i] : min( pGroupBox[i], sCluster.m_pBoundingBox[i] );
+				pGroupBox[i+1] = ( iFirst == 0 ) ? sCluster.m_pBoundingBox[i+1] : max( pGroupBox[i+1], sCluster.m_pBoundingBox[i+1] );
+			}
+
+			(*itG).m_vsCluster.push_back( sCluster );
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void StaticMesh::GatherVisibleClusters( GLuint group, Frustum const& a_rFrustum, vec3 const* a_pf3ViewPosition )
+{
+	m_viDrawCount.clear();
+	m_viDrawFirst.clear();
+
+	sMeshGroup const& rGroup = m_vGroup[group];
+	GLuint iNextTriangle = 0;
+
+	//Whole group out of the frustum
+	if( !a_rFrustum.cubeInFrustum( rGroup.m_pBoundingBox[0], rGroup.m_pBoundingBox[1], rGroup.m_pBoundingBox[2], rGroup.m_pBoundingBox[3], rGroup.m_pBoundingBox[4], rGroup.m_pBoundingBox[5] ) )
 	{
-		m_iSizeVertex = m_vf3Position.size()*sizeof(vec3);
+		return;
 	}
-	else
+
+	for(std::vector<sMeshCluster>::const_iterator it=rGroup.m_vsCluster.begin(); it!=rGroup.m_vsCluster.end(); ++it)
+	{
+		sMeshCluster const& rCluster = *it;
+
+		if( !a_rFrustum.sphereInFrustum( rCluster.m_f3Center, rCluster.m_fRadius ) )
+		{
+			continue;
+		}
+		if( !a_rFrustum.cubeInFrustum( rCluster.m_pBoundingBox[0], rCluster.m_pBoundingBox[1], rCluster.m_pBoundingBox[2], rCluster.m_pBoundingBox[3], rCluster.m_pBoundingBox[4], rCluster.m_pBoundingBox[5] ) )
+		{
+			continue;
+		}
+		if( a_pf3ViewPosition && rCluster.m_fConeCutoff < 1.0f )
+		{
+			vec3 f3ViewToCenter = rCluster.m_f3Center - *a_pf3ViewPosition;
+			if( dot( f3ViewToCenter, rCluster.m_f3ConeAxis ) >= rCluster.m_fConeCutoff * length( f3ViewToCenter ) + rCluster.m_fRadius )
+			{
+				continue;
+			}
+		}
+
+		//Merge with the previous range when contiguous
+		if( !m_viDrawCount.empty() && iNextTriangle == rCluster.m_iFirstTriangle )
+		{
+			m_viDrawCount.back() += (GLsizei)rCluster.m_iTriangleCount * 3;
+		}
+		else
+		{
+			m_viDrawCount.push_back( (GLsizei)rCluster.m_iTriangleCount * 3 );
+			m_viDrawFirst.push_back( rGroup.m_iFirstIndex + rCluster.m_iFirstTriangle * 3 );
+		}
+		iNextTriangle = rCluster.m_iFirstTriangle + rCluster.m_iTriangleCount;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool StaticMesh::BuildBuffer()
+{
+	if(m_vf3Position.empty()) 
 	{
 		std::cerr << "[ERROR] No position data !" << std::endl;
 		return false;
 	}
 
-	// build normal
-	if(!m_vf3Normal.empty())
+	//Interleaved, the layout of every mesh of the pool
+	std::vector<Vertex> vVertices( m_vf3Position.size() );
+	for( unsigned int i = 0; i < vVertices.size(); ++i )
 	{
-		m_iSizeNormal	= m_vf3Normal.size()*sizeof(vec3);
+		vVertices[i].f3Position = m_vf3Position[i];
+		vVertices[i].f3Normal = i < m_vf3Normal.size() ? m_vf3Normal[i] : vec3( 0.0f, 0.0f, 1.0f );
+		vVertices[i].f2Texcoord = i < m_vf3Texcoord.size() ? m_vf3Texcoord[i] : vec2( 0.0f, 0.0f );
+		vVertices[i].f3Tangent = i < m_vf3Tangent.size() ? m_vf3Tangent[i] : vec3( 1.0f, 0.0f, 0.0f );
 	}
 
-	// build TextCoord
-	if(!m_vf3Texcoord.empty())
+	//The groups follow each other, so the whole mesh is a single range
+	std::vector<GLuint> viIndices;
+	for(std::vector<sMeshGroup>::iterator it=m_vGroup.begin(); it!=m_vGroup.end(); ++it)
 	{
-		m_iSizeTexture = m_vf3Texcoord.size()*sizeof(vec2);
+		(*it).m_iFirstIndex = (unsigned int)viIndices.size();
+		for(std::vector<sMeshTriangle>::const_iterator itF=(*it).m_vsTriangle.begin(); itF!=(*it).m_vsTriangle.end(); ++itF)
+		{
+			viIndices.insert( viIndices.end(), (*itF).ind, (*itF).ind + 3 );
+		}
 	}
-		
-	// build tangent
-	if(!m_vf3Tangent.empty())
+	m_iIndexCount = (unsigned int)viIndices.size();
+
+	if( viIndices.empty() || !MeshManager::GrabInstance().GrabGeometryPool().Add( &vVertices[0], (unsigned int)vVertices.size(), &viIndices[0], m_iIndexCount, m_sAllocation ) )
 	{
-		m_iSizeTangent = m_vf3Tangent.size()*sizeof(vec3);
+		std::cerr << "[ERROR] The mesh could not be added to the geometry pool" << std::endl;
+		return false;
 	}
 
-	//Link the buffer
-	glBufferData(GL_ARRAY_BUFFER, m_iSizeVertex + m_iSizeNormal + m_iSizeTexture + m_iSizeTangent, 0, GL_STATIC_DRAW);
-	glBufferSubData(GL_ARRAY_BUFFER_ARB, 0,	m_iSizeVertex,	(const GLvoid*)(&m_vf3Position[0]));
-
-	if(m_vf3Normal.size())
-		glBufferSubData(GL_ARRAY_BUFFER_ARB, m_iSizeVertex,	m_iSizeNormal,	(const GLvoid*)(&m_vf3Normal[0]));
-
-	if(m_vf3Texcoord.size())
-		glBufferSubData(GL_ARRAY_BUFFER_ARB, m_iSizeVertex + m_iSizeNormal,	m_iSizeTexture,	(const GLvoid*)(&m_vf3Texcoord[0]));
-
-	if(m_vf3Tangent.size())
-		glBufferSubData(GL_ARRAY_BUFFER_ARB, m_iSizeVertex + m_iSizeNormal + m_iSizeTexture,	m_iSizeTangent,	(const GLvoid*)(&m_vf3Tangent[0]));
-
-	Unbind();
+	for(std::vector<sMeshGroup>::iterator it=m_vGroup.begin(); it!=m_vGroup.end(); ++it)
+	{
+		(*it).m_iFirstIndex += m_sAllocation.m_iFirstIndex;
+	}
 
+	m_bResident = true;
 	return true;
 }
 
@@ -445,103 +705,100 @@ bool StaticMesh::BuildBuffer()
 //--------------------------------------------------------------------------------------------------------------------
 void StaticMesh::Bind()
 {
-	//\todo better binder, better array (interleaved)
-	glBindBuffer(GL_ARRAY_BUFFER, m_iBufferId);
+	MeshManager::GrabInstance().GrabGeometryPool().Bind( m_sAllocation.m_iPage );
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void StaticMesh::Unbind()
+void StaticMesh::Render()
 {
+	Bind();
 	
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glDrawElements(GL_TRIANGLES, (GLsizei)m_iIndexCount, GL_UNSIGNED_INT, BUFFER_OFFSET(m_sAllocation.m_iFirstIndex * sizeof(GLuint)));
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void StaticMesh::Render()
+
+void StaticMesh::Render( GLuint group )
 {
+	assert(group < (GLuint)m_vGroup.size());
 	Bind();
+	
+	glDrawElements(GL_TRIANGLES, (GLsizei)m_vGroup[group].m_vsTriangle.size()*3, GL_UNSIGNED_INT, BUFFER_OFFSET(m_vGroup[group].m_iFirstIndex * sizeof(GLuint)));
+}
 
-	//Enable GL option
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glEnableClientState(GL_NORMAL_ARRAY);
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-
-	glVertexPointer(3, GL_FLOAT, 0, 0);
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void StaticMesh::Render( Frustum const& a_rFrustum, vec3 const* a_pf3ViewPosition )
+{
+	Bind();
 
-	if(!m_vf3Normal.empty()) 
-	{
-		glNormalPointer( GL_FLOAT, 0, BUFFER_OFFSET(m_iSizeVertex));
-	}
-	if (!m_vf3Texcoord.empty()) 
+	for( GLuint group = 0; group < (GLuint)m_vGroup.size(); ++group )
 	{
-		glClientActiveTexture(GL_TEXTURE0);
-		glTexCoordPointer( 2,GL_FLOAT, 0, BUFFER_OFFSET(m_iSizeVertex+m_iSizeNormal));
+		GatherVisibleClusters( group, a_rFrustum, a_pf3ViewPosition );
+		DrawVisibleClusters();
 	}
-	//Tangent
-	if (!m_vf3Tangent.empty()) 
-	{
-		glClientActiveTexture(GL_TEXTURE1);
-		glTexCoordPointer( 3,GL_FLOAT, 0, BUFFER_OFFSET(m_iSizeVertex+m_iSizeNormal+m_iSizeTexture));
-	}
-	
-	for(std::vector<sMeshGroup>::iterator it=m_vGroup.begin(); it!=m_vGroup.end(); ++it)
-	{
-		glDrawElements(GL_TRIANGLES, (GLsizei)(*it).m_vsTriangle.size()*3, GL_UNSIGNED_INT, &((*it).m_vsTriangle[0].ind[0]));
-		//glDrawElements(GL_TRIANGLES, 5, GL_UNSIGNED_INT, &((*it).m_vsTriangle[0].ind[0]));
-	}
-	
-	//Disable GLOption
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-	glDisableClientState(GL_NORMAL_ARRAY);
-	glDisableClientState(GL_VERTEX_ARRAY); 
-
-	Unbind();
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-
-void StaticMesh::Render( GLuint group )
+void StaticMesh::Render( GLuint group, Frustum const& a_rFrustum, vec3 const* a_pf3ViewPosition )
 {
 	assert(group < (GLuint)m_vGroup.size());
-	Bind();
 
-	//Enable GL option
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glEnableClientState(GL_NORMAL_ARRAY);
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	GatherVisibleClusters( group, a_rFrustum, a_pf3ViewPosition );
+	if( m_viDrawCount.empty() )
+	{
+		return;
+	}
 
-	glVertexPointer(3, GL_FLOAT, 0, 0);
+	Bind();
+	DrawVisibleClusters();
+}
 
-	if(!m_vf3Normal.empty()) 
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void StaticMesh::DrawVisibleClusters()
+{
+	if( m_viDrawCount.empty() )
 	{
-		glNormalPointer( GL_FLOAT, 0, BUFFER_OFFSET(m_iSizeVertex));
+		return;
 	}
-	if (!m_vf3Texcoord.empty()) 
+
+	m_vpDrawIndices.resize( m_viDrawFirst.size() );
+	for( unsigned int i = 0; i < m_viDrawFirst.size(); ++i )
 	{
-		glClientActiveTexture(GL_TEXTURE0);
-		glTexCoordPointer( 2,GL_FLOAT, 0, BUFFER_OFFSET(m_iSizeVertex+m_iSizeNormal));
+		m_vpDrawIndices[i] = BUFFER_OFFSET( m_viDrawFirst[i] * sizeof(GLuint) );
 	}
-	//Tangent
-	if (!m_vf3Tangent.empty()) 
+
+	glMultiDrawElements(GL_TRIANGLES, &m_viDrawCount[0], GL_UNSIGNED_INT, &m_vpDrawIndices[0], (GLsizei)m_viDrawCount.size());
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void StaticMesh::GatherDraws( DrawBatch& a_rBatch, unsigned int a_iObjectIndex, const float4x4* a_pWorld, Frustum const* a_pFrustum, vec3 const* a_pf3ViewPosition )
+{
+	if( !a_pFrustum )
 	{
-		glClientActiveTexture(GL_TEXTURE1);
-		glTexCoordPointer( 3,GL_FLOAT, 0, BUFFER_OFFSET(m_iSizeVertex+m_iSizeNormal+m_iSizeTexture));
+		a_rBatch.Add( m_sAllocation.m_iPage, m_sAllocation.m_iFirstIndex, m_iIndexCount, a_iObjectIndex, a_pWorld );
+		return;
 	}
-	
-	glDrawElements(GL_TRIANGLES, (GLsizei)m_vGroup[group].m_vsTriangle.size()*3, GL_UNSIGNED_INT, &(m_vGroup[group].m_vsTriangle[0].ind[0]));
-	
-	//Disable GLOption
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-	glDisableClientState(GL_NORMAL_ARRAY);
-	glDisableClientState(GL_VERTEX_ARRAY); 
 
-	Unbind();
+	for( GLuint group = 0; group < (GLuint)m_vGroup.size(); ++group )
+	{
+		GatherVisibleClusters( group, *a_pFrustum, a_pf3ViewPosition );
+		for( unsigned int i = 0; i < m_viDrawCount.size(); ++i )
+		{
+			a_rBatch.Add( m_sAllocation.m_iPage, m_viDrawFirst[i], (unsigned int)m_viDrawCount[i], a_iObjectIndex, a_pWorld );
+		}
+	}
 }
 
 //--------------------------------------------------------------------------------------------------------------------
@@ -549,8 +806,12 @@ void StaticMesh::Render( GLuint group )
 //--------------------------------------------------------------------------------------------------------------------
 void StaticMesh::Destroy()
 {
-	glDeleteBuffersARB(1, &m_iBufferId);
-	m_iBufferId = 0;
+	if( m_bResident )
+	{
+		MeshManager::GrabInstance().GrabGeometryPool().Remove( m_sAllocation );
+	}
+	m_bResident = false;
+	m_iIndexCount = 0;
 
 	m_vf3Position.clear();
 	m_vf3Normal.clear();
@@ -563,6 +824,10 @@ void StaticMesh::Destroy()
 	}
 	m_vGroup.clear();
 
+	m_viDrawCount.clear();
+	m_viDrawFirst.clear();
+	m_vpDrawIndices.clear();
+
 	delete [] m_pBoundingBox;
 	m_pBoundingBox = NULL;
 }
@@ -13,13 +13,17 @@
 #define __STATICMESH_H__
 
 #include "AbstractMesh.h"
+#include "BurgerEngine/Graphics/GeometryPool.h"
 #include "BurgerEngine/External/Math/Vector.h"
 
 #include <vector>
 #include <hash_set>
 
+class Frustum;
+class DrawBatch;
+
 /// \class StaticMesh
-/// \brief Static Mesh, so far .obj
+/// \brief Static Mesh, so far .obj. Its vertices and indices live in the GeometryPool of the MeshManager
 class StaticMesh: public AbstractMesh 
 {
 
@@ -34,17 +38,61 @@ public:
 	/// \brief Load a mesh and store value in the buffer
 	bool LoadMesh(std::string const& a_sFilename);
 
+	/// \brief Load the file and build the CPU data, does not call OpenGL so it can run on a loader thread
+	bool LoadMeshData(std::string const& a_sFilename);
+
+	/// \brief Copy the CPU data in the GeometryPool, GL thread only
+	bool UploadMesh(){ return BuildBuffer(); }
+
+	/// \brief The mesh can only be rendered once it is in the pool
+	bool IsResident() const { return m_bResident; }
+
+	/// \brief The loading is over and the mesh did not make it to the pool, it never will
+	bool HasLoadFailed() const { return m_bLoadFailed; }
+	void SetLoadFailed(){ m_bLoadFailed = true; }
+
 	/// \brief Render the mesh
+	/// The geometry page is left bound, the renderer unbinds it once its pass is over
 	void Render();
 
 	/// \brief Render a sub-part of the mesh
 	void Render(GLuint group);
 
+	/// \brief Render only the clusters of every group which are visible
+	/// \param[in] a_rFrustum Frustum expressed in the mesh (object) space
+	/// \param[in] a_pf3ViewPosition Viewer position in object space, NULL to disable back-face cluster culling
+	void Render(Frustum const& a_rFrustum, vec3 const* a_pf3ViewPosition);
+
+	/// \brief Render only the clusters of a sub-part which are visible
+	void Render(GLuint group, Frustum const& a_rFrustum, vec3 const* a_pf3ViewPosition);
+
+	/// \brief Add the index ranges of the mesh to a batch instead of drawing them
+	/// \param[in] a_pFrustum Frustum in object space to keep only the visible clusters, NULL for the whole mesh
+	void GatherDraws(DrawBatch& a_rBatch, unsigned int a_iObjectIndex, const float4x4* a_pWorld, Frustum const* a_pFrustum, vec3 const* a_pf3ViewPosition);
+
+	/// Max number of triangles in a cluster
+	static const unsigned int iClusterTriangleCount = 128;
+
 	/// \brief Free buffer
 	void Destroy();
 
 	const float* GetBoundingBox() const { return m_pBoundingBox; };
 
+	/// \brief Bounds read by the scene compiler, used until the mesh is resident. Main thread only,
+	///			the loader thread writes the other box
+	void SetPrecomputedBoundingBox( const float* pBoundingBox );
+	/// \return NULL if the scene did not give any
+	const float* GetPrecomputedBoundingBox() const { return m_bHasPrecomputedBoundingBox ? m_pPrecomputedBoundingBox : NULL; }
+
+	/// \brief Bounds of the positions of a mesh file, without loading the rest of the mesh
+	/// \param[out] pBoundingBox xmin, xmax, ymin, ymax, zmin, zmax
+	/// \return false if the file cannot be read or has no vertex
+	static bool ReadBoundingBox( std::string const& a_sFilename, float* pBoundingBox );
+
+	/// \brief Per group bounds, in object space
+	unsigned int GetGroupCount() const { return (unsigned int)m_vGroup.size(); }
+	const float* GetGroupBoundingBox( GLuint group ) const { return m_vGroup[group].m_pBoundingBox; }
+
 	//const std::vector<vec3>& GetVertex() const { return m_vf3Position; };
 
 private:
@@ -59,16 +107,30 @@ private:
 	/// \brief Compute trangent from the model
 	void ComputeTangents();
 
+	/// \brief Sort the triangles of each group spatially and split them into clusters
+	void BuildClusters();
+
+	/// \brief Gather the index ranges of the visible clusters of a group
+	void GatherVisibleClusters(GLuint group, Frustum const& a_rFrustum, vec3 const* a_pf3ViewPosition);
+
+	/// \brief Draw the ranges gathered last, the mesh must be bound
+	void DrawVisibleClusters();
+
 	/// \brief Fill buffer
 	bool BuildBuffer();
 
+	/// \brief Bind the page of the mesh, kept bound for the next meshes of the same page
 	void Bind();
-	void Unbind();
 
 	void FindSignificantVertex();
 
-	/// Id of the buffer
-	unsigned int		m_iBufferId;
+	/// Place of the mesh in the GeometryPool
+	GeometryPool::sAllocation	m_sAllocation;
+	bool				m_bResident;
+	bool				m_bLoadFailed;
+
+	float				m_pPrecomputedBoundingBox[6];
+	bool				m_bHasPrecomputedBoundingBox;
 
 	/// Vertex buffer
 	std::vector<vec3>	m_vf3Position;
@@ -84,12 +146,6 @@ private:
 
 	float*				m_pBoundingBox;
 
-	/// Size of those buffer
-	GLsizeiptr m_iSizeVertex;
-	GLsizeiptr m_iSizeNormal;
-	GLsizeiptr m_iSizeTexture;
-	GLsizeiptr m_iSizeTangent;
-
 private:
 
 	/// Triangle structure
@@ -98,12 +154,38 @@ private:
 		unsigned int ind[3];
 	};
 
+	/// Small set of spatially close triangles of a group, culled as a whole
+	struct sMeshCluster
+	{
+		/// First triangle of the cluster in the group triangle array
+		unsigned int	m_iFirstTriangle;
+		unsigned int	m_iTriangleCount;
+
+		/// xmin, xmax, ymin, ymax, zmin, zmax
+		float			m_pBoundingBox[6];
+
+		/// Bounding sphere
+		vec3			m_f3Center;
+		float			m_fRadius;
+
+		/// Normal cone, the cluster is back facing for every viewer verifying
+		/// dot(center - viewer, axis) >= cutoff * |center - viewer| + radius
+		/// A cutoff of 1 means the cone is too wide to ever be culled
+		vec3			m_f3ConeAxis;
+		float			m_fConeCutoff;
+	};
+
 	/// Group of triangle structure
 	struct sMeshGroup 
 	{
 		std::string					m_sName;
 		long						m_lMaterial;
 		std::vector<sMeshTriangle>	m_vsTriangle;
+		std::vector<sMeshCluster>	m_vsCluster;
+		/// xmin, xmax, ymin, ymax, zmin, zmax
+		float						m_pBoundingBox[6];
+		/// First index of the group in the index buffer of the pool page
+		unsigned int				m_iFirstIndex;
 	};
 
 private:
@@ -111,6 +193,14 @@ private:
 	/// Mesh group Collection
 	std::vector<sMeshGroup>		m_vGroup;
 
+	/// Index count of every group
+	unsigned int				m_iIndexCount;
+
+	/// Scratch buffers for the multi draw of visible clusters, the first index of each range in the pool page
+	std::vector<GLsizei>		m_viDrawCount;
+	std::vector<unsigned int>	m_viDrawFirst;
+	std::vector<const GLvoid*>	m_vpDrawIndices;
+
 };
 
 #endif //__STATICMESH_H__
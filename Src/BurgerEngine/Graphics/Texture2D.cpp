@@ -1,60 +1,308 @@
 #include "texture2D.h"
+#include "BurgerEngine/Graphics/OpenGLContext.h"
+#include "BurgerEngine/Graphics/TextureArray.h"
+#include "BurgerEngine/Graphics/TextureManager.h"
 
 Texture2D::Texture2D()
 	: AbstractTexture()
+	, m_pCompressedImage( NULL )
+	, m_eCompression( TextureCompressor::E_COMPRESSION_NONE )
+	, m_bStreamed( false )
+	, m_bPacked( false )
+	, m_pArray( NULL )
+	, m_iLayer( 0 )
+	, m_iLevelCount( 0 )
+	, m_iResidentLevel( 0 )
+	, m_fRequestedSize( 0.0f )
 {
 }
 
 Texture2D::Texture2D ( bool bUseMipMaps, bool bLinearFiltering, bool bClampS, bool bClampT )
 	: AbstractTexture( bUseMipMaps, bLinearFiltering, bClampS, bClampT )
+	, m_pCompressedImage( NULL )
+	, m_eCompression( TextureCompressor::E_COMPRESSION_NONE )
+	, m_bStreamed( false )
+	, m_bPacked( false )
+	, m_pArray( NULL )
+	, m_iLayer( 0 )
+	, m_iLevelCount( 0 )
+	, m_iResidentLevel( 0 )
+	, m_fRequestedSize( 0.0f )
 {
 }
 
+Texture2D::~Texture2D ()
+{
+	delete m_pCompressedImage;
+	if( m_pArray )
+	{
+		TextureManager::GrabInstance().RemoveArrayLayer( m_pArray, m_iLayer );
+	}
+}
+
 bool Texture2D::LoadTexture( const std::string &name )
 {
 	m_sName = name;
-    GLubyte *data = NULL; 
-	data = AbstractTexture::LoadData();
-
-	if (data == NULL)
+	if( !DecodeImage() )
 	{
 		return false;
 	}
-	
+
 	///Create a new ID
 	destroyID();
 	generateID();
 
+	UploadImage();
+
+	return true;
+}
+
+void Texture2D::CreatePlaceholder( const std::string &name )
+{
+	m_sName = name;
+
+	if( m_bPacked )
+	{
+		m_pArray = TextureManager::GrabInstance().GetPlaceholderArray();
+		m_iLayer = 0;
+		return;
+	}
+
+	destroyID();
+	generateID();
+
+	Activate();
+
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+
+	const GLubyte pGrey[3] = { 128, 128, 128 };
+	glTexImage2D( GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, pGrey );
+
+	Deactivate();
+}
+
+bool Texture2D::DecodeImage()
+{
+	m_vDecodedLevels.clear();
+	delete m_pCompressedImage;
+	m_pCompressedImage = NULL;
+
+	if( m_eCompression != TextureCompressor::E_COMPRESSION_NONE )
+	{
+		m_pCompressedImage = new TextureCompressor::sCompressedImage();
+		if( TextureCompressor::LoadCompressedImage( m_sName, m_eCompression, m_bUseMipMaps, m_oMipmapSettings, *m_pCompressedImage ) )
+		{
+			m_iWidth = m_pCompressedImage->m_iWidth;
+			m_iHeight = m_pCompressedImage->m_iHeight;
+			return true;
+		}
+		//Not compressible (unusual channel count...), keep it uncompressed
+		delete m_pCompressedImage;
+		m_pCompressedImage = NULL;
+	}
+
+	GLubyte* pData = AbstractTexture::LoadData();
+	if( pData == NULL )
+	{
+		return false;
+	}
+
+	if( m_bUseMipMaps )
+	{
+		MipmapGenerator::Generate( pData, m_iWidth, m_iHeight, m_iChanel, m_oMipmapSettings, m_vDecodedLevels );
+	}
+	else
+	{
+		m_vDecodedLevels.resize( 1 );
+		m_vDecodedLevels[0].assign( pData, pData + m_iWidth * m_iHeight * m_iChanel );
+	}
+	delete[] pData;
+	return true;
+}
+
+void Texture2D::UploadImage()
+{
+	assert( !m_vDecodedLevels.empty() || m_pCompressedImage );
+
+	m_iLevelCount = m_pCompressedImage ? m_pCompressedImage->GetLevelCount() : m_vDecodedLevels.size();
+
+	if( m_bPacked )
+	{
+		_UploadToArray();
+		m_vDecodedLevels.clear();
+		delete m_pCompressedImage;
+		m_pCompressedImage = NULL;
+		return;
+	}
+
 	Activate();
 	
 	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_eFilteringMin );
-	glTexParameteri( GL_TEXTURE_2D, GL_GENERATE_MIPMAP, m_eGenerateMipMap );
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_eFilteringMag );
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_eWrapS );
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_eWrapT );
 
-	//RGB or RGBA
-	if (m_iChanel == 4)
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_iWidth, m_iHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE , data );
+	//The mip chain is built on the CPU, nothing left for the driver to generate
+	glTexParameteri( GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE );
+
+	Deactivate();
+
+	//Nothing resident in the new texture yet
+	m_iResidentLevel = m_iLevelCount;
+
+	if( m_bStreamed )
+	{
+		//Only the small levels to begin with, the levels are kept in memory for the streaming
+		SetResidentLevel( GetLevelForSize( s_iStreamingBaseSize ) );
+		return;
+	}
+
+	SetResidentLevel( 0 );
+	m_vDecodedLevels.clear();
+	delete m_pCompressedImage;
+	m_pCompressedImage = NULL;
+}
+
+void Texture2D::_UploadToArray()
+{
+	TextureArray::sFormat oFormat;
+	oFormat.m_iWidth = m_iWidth;
+	oFormat.m_iHeight = m_iHeight;
+	oFormat.m_iLevelCount = m_iLevelCount;
+	oFormat.m_bCompressed = m_pCompressedImage != NULL;
+	oFormat.m_eInternalFormat = m_pCompressedImage ? m_pCompressedImage->GetGLFormat() : ( m_iChanel == 4 ? GL_RGBA : ( m_iChanel == 1 ? GL_LUMINANCE : GL_RGB ) );
+	oFormat.m_eFilteringMin = m_eFilteringMin;
+	oFormat.m_eFilteringMag = m_eFilteringMag;
+	oFormat.m_eWrapS = m_eWrapS;
+	oFormat.m_eWrapT = m_eWrapT;
+
+	//The materials bind the placeholder until here, they pick the new layer up on their next activation
+	if( m_pArray )
+	{
+		TextureManager::GrabInstance().RemoveArrayLayer( m_pArray, m_iLayer );
+	}
+	m_pArray = TextureManager::GrabInstance().AddArrayLayer( oFormat, m_iLayer );
+	m_pArray->Activate();
+
+	if( m_pCompressedImage )
+	{
+		for( unsigned int iLevel = 0; iLevel < m_iLevelCount; ++iLevel )
+		{
+			glCompressedTexSubImage3D( GL_TEXTURE_2D_ARRAY_EXT, iLevel, 0, 0, m_iLayer,
+				m_pCompressedImage->GetLevelWidth( iLevel ), m_pCompressedImage->GetLevelHeight( iLevel ), 1,
+				oFormat.m_eInternalFormat, m_pCompressedImage->GetLevelSize( iLevel ), m_pCompressedImage->GetLevelData( iLevel ) );
+		}
+	}
+	else
+	{
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+		for( unsigned int iLevel = 0; iLevel < m_iLevelCount; ++iLevel )
+		{
+			glTexSubImage3D( GL_TEXTURE_2D_ARRAY_EXT, iLevel, 0, 0, m_iLayer,
+				MipmapGenerator::GetLevelSize( m_iWidth, iLevel ), MipmapGenerator::GetLevelSize( m_iHeight, iLevel ), 1,
+				oFormat.m_eInternalFormat, GL_UNSIGNED_BYTE, &m_vDecodedLevels[ iLevel ][0] );
+		}
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+	}
+
+	TextureArray::Deactivate();
+}
+
+void Texture2D::SetResidentLevel( unsigned int iFirstLevel )
+{
+	assert( iFirstLevel < m_iLevelCount );
+
+	Activate();
+
+	//The GL levels match the levels of the chain, the base level hides the ones not resident
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_iLevelCount - 1 );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, iFirstLevel );
+
+	//Dropped levels are given an empty image to free them
+	for( unsigned int iLevel = m_iResidentLevel; iLevel < iFirstLevel; ++iLevel )
+	{
+		glTexImage2D( GL_TEXTURE_2D, iLevel, GL_RGBA, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+	}
+
+	//Only the levels larger than the resident ones are uploaded
+	if( m_pCompressedImage )
+	{
+		for( unsigned int iLevel = iFirstLevel; iLevel < m_iResidentLevel; ++iLevel )
+		{
+			glCompressedTexImage2D( GL_TEXTURE_2D, iLevel, m_pCompressedImage->GetGLFormat(),
+				m_pCompressedImage->GetLevelWidth( iLevel ), m_pCompressedImage->GetLevelHeight( iLevel ), 0,
+				m_pCompressedImage->GetLevelSize( iLevel ), m_pCompressedImage->GetLevelData( iLevel ) );
+		}
+	}
 	else
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, m_iWidth, m_iHeight, 0, GL_RGB, GL_UNSIGNED_BYTE , data );
+	{
+		//RGB, RGBA or grey
+		GLenum eFormat = m_iChanel == 4 ? GL_RGBA : ( m_iChanel == 1 ? GL_LUMINANCE : GL_RGB );
+
+		//Rows of the small RGB levels are not 4 bytes aligned
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+		for( unsigned int iLevel = iFirstLevel; iLevel < m_iResidentLevel; ++iLevel )
+		{
+			glTexImage2D( GL_TEXTURE_2D, iLevel, eFormat, MipmapGenerator::GetLevelSize( m_iWidth, iLevel ), MipmapGenerator::GetLevelSize( m_iHeight, iLevel ), 0, eFormat, GL_UNSIGNED_BYTE, &m_vDecodedLevels[ iLevel ][0] );
+		}
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+	}
 	
 	Deactivate();
-	delete[] data;
+	m_iResidentLevel = iFirstLevel;
+}
 
-	return true;
+unsigned int Texture2D::GetLevelForSize( float fSize ) const
+{
+	unsigned int iLevel = 0;
+	unsigned int iSize = m_iWidth > m_iHeight ? m_iWidth : m_iHeight;
+	while( iLevel + 1 < m_iLevelCount && ( iSize >> ( iLevel + 1 ) ) >= fSize )
+	{
+		++iLevel;
+	}
+	return iLevel;
+}
 
+unsigned int Texture2D::GetMemorySize( unsigned int iFirstLevel ) const
+{
+	unsigned int iSize = 0;
+	for( unsigned int iLevel = iFirstLevel; iLevel < m_iLevelCount; ++iLevel )
+	{
+		if( m_pCompressedImage )
+		{
+			iSize += m_pCompressedImage->GetLevelSize( iLevel );
+		}
+		else
+		{
+			//Drivers store RGB as RGBA
+			iSize += MipmapGenerator::GetLevelSize( m_iWidth, iLevel ) * MipmapGenerator::GetLevelSize( m_iHeight, iLevel ) * ( m_iChanel == 3 ? 4 : m_iChanel );
+		}
+	}
+	return iSize;
 }
 
 void Texture2D::Activate()
 {
+	if( m_pArray )
+	{
+		//Shared with the other textures of the array, the context skips the bind when it is already there
+		m_pArray->Activate();
+		return;
+	}
+
 	//OpenGL Bind
-	glBindTexture(GL_TEXTURE_2D,m_iId);
+	OpenGLContext::BindTexture(GL_TEXTURE_2D,m_iId);
+}
+
+GLenum Texture2D::GetTarget() const
+{
+	return m_bPacked ? GL_TEXTURE_2D_ARRAY_EXT : GL_TEXTURE_2D;
 }
 
 void Texture2D::Deactivate()
 {
-	glBindTexture(GL_TEXTURE_2D,0);
+	OpenGLContext::BindTexture(GL_TEXTURE_2D,0);
 }
\ No newline at end of file
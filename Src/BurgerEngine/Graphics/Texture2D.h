@@ -13,6 +13,9 @@
 #define __TEXTURE2D_H__
 
 #include "abstractTexture.h"
+#include "BurgerEngine/Graphics/TextureCompressor.h"
+
+class TextureArray;
 
 class Texture2D: public AbstractTexture
 {
@@ -21,13 +24,90 @@ class Texture2D: public AbstractTexture
 
 		Texture2D ();
 		Texture2D ( bool bUseMipMaps, bool bLinearFiltering, bool bClampS, bool bClampT );
-		virtual ~Texture2D () {};
+		virtual ~Texture2D ();
 
 		virtual bool LoadTexture(const std::string &name);
 		virtual void Activate();	
+		virtual GLenum GetTarget() const;
+		virtual unsigned int GetLayer() const { return m_iLayer; }
+
+		/// \brief Create the texture with a 1x1 grey image, used until the real image is uploaded
+		void CreatePlaceholder( const std::string &name );
+
+		/// \brief Block compression used for the image, set before loading it (E_COMPRESSION_NONE by default)
+		void SetCompression( TextureCompressor::CompressionFormat eFormat ){ m_eCompression = eFormat; }
+
+		/// \brief Decode the image in memory, does not call OpenGL so it can run on a loader thread.
+		///			Compressed textures are read from their .btex container, which is built on first use
+		bool DecodeImage();
+
+		/// \brief Upload the decoded image, GL thread only
+		void UploadImage();
 		//virtual void Deactivate();	
 
 		static void Deactivate();
+
+		/// \brief Pack the image in a layer of a TextureArray shared with the textures of the same size and format,
+		///			set before loading. The placeholder is a layer too, so the shaders always sample an array
+		void SetArrayPacking( bool bPacked ){ m_bPacked = bPacked; }
+		bool IsPacked() const { return m_bPacked; }
+
+		/// \brief Array of the packed texture, the placeholder array until the image is uploaded
+		TextureArray* GetArray() const { return m_pArray; }
+
+		/// \name Streaming, driven by the TextureManager
+		/// \{
+
+		/// \brief Stream the mip levels instead of keeping them all in video memory, set before loading
+		/// The packed textures are never streamed, the levels of an array are shared by all its layers
+		void SetStreaming( bool bStreamed ){ m_bStreamed = bStreamed && m_bUseMipMaps && !m_bPacked; }
+		bool IsStreamed() const { return m_bStreamed; }
+
+		/// \brief Size on screen, in pixels, of an object using the texture this frame
+		virtual void RequestResolution( float fScreenSize ){ m_fRequestedSize = fScreenSize > m_fRequestedSize ? fScreenSize : m_fRequestedSize; }
+		float GetRequestedSize() const { return m_fRequestedSize; }
+		void ResetRequest(){ m_fRequestedSize = 0.0f; }
+
+		/// \brief Number of levels of the image, 0 until it is uploaded
+		unsigned int GetLevelCount() const { return m_iLevelCount; }
+
+		/// \brief Largest level in video memory
+		unsigned int GetResidentLevel() const { return m_iResidentLevel; }
+
+		/// \brief Make the levels from iFirstLevel resident, dropping the larger ones
+		/// Only the levels not resident yet are uploaded
+		void SetResidentLevel( unsigned int iFirstLevel );
+
+		/// \brief Smallest level still at least fSize pixels wide
+		unsigned int GetLevelForSize( float fSize ) const;
+
+		/// \brief Video memory used when the levels from iFirstLevel are resident, in bytes
+		unsigned int GetMemorySize( unsigned int iFirstLevel ) const;
+
+		/// \}
+
+		/// Largest level loaded when a streamed texture is uploaded
+		static const unsigned int s_iStreamingBaseSize = 64;
+
+	private:
+		/// \brief Copy the levels in a free layer of an array of the same format
+		void _UploadToArray();
+
+		/// Levels decoded and not uploaded yet, kept for the streaming
+		MipmapGenerator::MipChain	m_vDecodedLevels;
+		/// Compressed mip chain not uploaded yet, replaces m_vDecodedLevels for compressed textures
+		TextureCompressor::sCompressedImage*	m_pCompressedImage;
+		TextureCompressor::CompressionFormat	m_eCompression;
+
+		bool			m_bStreamed;
+		bool			m_bPacked;
+		/// Array holding the image when it is packed, NULL otherwise
+		TextureArray*	m_pArray;
+		unsigned int	m_iLayer;
+		unsigned int	m_iLevelCount;
+		unsigned int	m_iResidentLevel;
+		/// Largest screen size requested since the last streaming update
+		float			m_fRequestedSize;
 };
 
 #endif //__TEXTURE2D_H__
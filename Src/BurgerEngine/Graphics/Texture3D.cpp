@@ -1,5 +1,7 @@
 #include "BurgerEngine/Graphics/Texture3D.h"
 #include "BurgerEngine/Graphics/ImageTool.h"
+#include "BurgerEngine/Graphics/MipmapGenerator.h"
+#include "BurgerEngine/Graphics/OpenGLContext.h"
 
 Texture3D::Texture3D()
 	: AbstractTexture()
@@ -34,6 +36,18 @@ bool Texture3D::LoadTexture( const std::string &name )
 	{
 		return false;
 	}
+
+	MipmapGenerator::MipChain vLevels;
+	if( m_bUseMipMaps )
+	{
+		MipmapGenerator::Generate3D( data, m_iWidth, m_iHeight, m_iDepth, m_iChanel, m_oMipmapSettings, vLevels );
+	}
+	else
+	{
+		vLevels.resize( 1 );
+		vLevels[0].assign( data, data + m_iWidth * m_iHeight * m_iDepth * m_iChanel );
+	}
+	delete[] data;
 	
 	///Create a new ID
 	destroyID();
@@ -41,7 +55,8 @@ bool Texture3D::LoadTexture( const std::string &name )
 
 	Activate();
 
-	glTexParameteri( GL_TEXTURE_3D, GL_GENERATE_MIPMAP, m_eGenerateMipMap );
+	glTexParameteri( GL_TEXTURE_3D, GL_GENERATE_MIPMAP, GL_FALSE );
+	glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MAX_LEVEL, vLevels.size() - 1 );
 
 	glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, m_eFilteringMin );
 	glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, m_eFilteringMag );
@@ -50,10 +65,14 @@ bool Texture3D::LoadTexture( const std::string &name )
 	glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, m_eWrapT );
 	glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, m_eWrapR );
 
-	glTexImage3D(GL_TEXTURE_3D, 0, GL_RGB8, m_iWidth, m_iHeight, m_iDepth, 0, GL_RGB, GL_UNSIGNED_BYTE , data );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	for( unsigned int iLevel = 0; iLevel < vLevels.size(); ++iLevel )
+	{
+		glTexImage3D( GL_TEXTURE_3D, iLevel, GL_RGB8, MipmapGenerator::GetLevelSize( m_iWidth, iLevel ), MipmapGenerator::GetLevelSize( m_iHeight, iLevel ), MipmapGenerator::GetLevelSize( m_iDepth, iLevel ), 0, GL_RGB, GL_UNSIGNED_BYTE, &vLevels[ iLevel ][0] );
+	}
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
 	
 	Deactivate();
-	delete[] data;
 
 	return true;
 
@@ -62,10 +81,10 @@ bool Texture3D::LoadTexture( const std::string &name )
 void Texture3D::Activate()
 {
 	//OpenGL Bind
-	glBindTexture(GL_TEXTURE_3D,m_iId);
+	OpenGLContext::BindTexture(GL_TEXTURE_3D,m_iId);
 }
 
 void Texture3D::Deactivate()
 {
-	glBindTexture(GL_TEXTURE_3D,0);
+	OpenGLContext::BindTexture(GL_TEXTURE_3D,0);
 }
\ No newline at end of file
@@ -24,7 +24,8 @@ class Texture3D: public AbstractTexture
 		virtual ~Texture3D () {};
 
 		virtual bool LoadTexture(const std::string &name);
-		virtual void Activate();	
+		virtual void Activate();
+		virtual GLenum GetTarget() const { return GL_TEXTURE_3D; }	
 		
 		virtual GLubyte* LoadData();
 		
@@ -0,0 +1,168 @@
+#include "BurgerEngine/Graphics/TextureArray.h"
+#include "BurgerEngine/Graphics/MipmapGenerator.h"
+#include "BurgerEngine/Graphics/OpenGLContext.h"
+
+#include <assert.h>
+#include <vector>
+
+const char* TextureArray::s_sShaderFeature = "TEXTURE_ARRAY";
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool TextureArray::sFormat::operator==( sFormat const& rOther ) const
+{
+	return m_iWidth == rOther.m_iWidth && m_iHeight == rOther.m_iHeight && m_iLevelCount == rOther.m_iLevelCount
+		&& m_eInternalFormat == rOther.m_eInternalFormat && m_bCompressed == rOther.m_bCompressed
+		&& m_eFilteringMin == rOther.m_eFilteringMin && m_eFilteringMag == rOther.m_eFilteringMag
+		&& m_eWrapS == rOther.m_eWrapS && m_eWrapT == rOther.m_eWrapT;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+TextureArray::TextureArray( sFormat const& oFormat, unsigned int iMaxLayerCount )
+	: m_oFormat( oFormat )
+	, m_iId( 0 )
+	, m_iLayerCount( 0 )
+	, m_iMaxLayerCount( iMaxLayerCount )
+	, m_iUsedLayerCount( 0 )
+{
+	_Allocate( 1 );
+	Deactivate();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void TextureArray::_Allocate( unsigned int iLayerCount )
+{
+	m_iLayerCount = iLayerCount;
+	glGenTextures( 1, &m_iId );
+	Activate();
+
+	glTexParameteri( GL_TEXTURE_2D_ARRAY_EXT, GL_TEXTURE_MIN_FILTER, m_oFormat.m_eFilteringMin );
+	glTexParameteri( GL_TEXTURE_2D_ARRAY_EXT, GL_TEXTURE_MAG_FILTER, m_oFormat.m_eFilteringMag );
+	glTexParameteri( GL_TEXTURE_2D_ARRAY_EXT, GL_TEXTURE_WRAP_S, m_oFormat.m_eWrapS );
+	glTexParameteri( GL_TEXTURE_2D_ARRAY_EXT, GL_TEXTURE_WRAP_T, m_oFormat.m_eWrapT );
+	glTexParameteri( GL_TEXTURE_2D_ARRAY_EXT, GL_TEXTURE_MAX_LEVEL, m_oFormat.m_iLevelCount - 1 );
+
+	//Storage only, the layers are filled by the textures. The driver compresses nothing since there is no data,
+	//so the compressed formats are allocated the same way
+	GLenum eDataFormat = m_oFormat.m_bCompressed ? GL_RGBA : m_oFormat.m_eInternalFormat;
+	for( unsigned int iLevel = 0; iLevel < m_oFormat.m_iLevelCount; ++iLevel )
+	{
+		glTexImage3D( GL_TEXTURE_2D_ARRAY_EXT, iLevel, m_oFormat.m_eInternalFormat,
+			MipmapGenerator::GetLevelSize( m_oFormat.m_iWidth, iLevel ), MipmapGenerator::GetLevelSize( m_oFormat.m_iHeight, iLevel ),
+			m_iLayerCount, 0, eDataFormat, GL_UNSIGNED_BYTE, NULL );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void TextureArray::_Grow( unsigned int iLayerCount )
+{
+	//Read back level by level, only when the array grows while the textures load
+	GLuint iOldId = m_iId;
+	unsigned int iUsedLayerCount = m_iUsedLayerCount;
+	std::vector< std::vector< unsigned char > > vLevels( m_oFormat.m_iLevelCount );
+	std::vector< GLint > viLevelSizes( m_oFormat.m_iLevelCount );
+
+	//Every layer of the old texture is used, its levels are read whole
+	Activate();
+	glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+	for( unsigned int iLevel = 0; iLevel < m_oFormat.m_iLevelCount; ++iLevel )
+	{
+		GLint iWidth = MipmapGenerator::GetLevelSize( m_oFormat.m_iWidth, iLevel );
+		GLint iHeight = MipmapGenerator::GetLevelSize( m_oFormat.m_iHeight, iLevel );
+		if( m_oFormat.m_bCompressed )
+		{
+			glGetTexLevelParameteriv( GL_TEXTURE_2D_ARRAY_EXT, iLevel, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &viLevelSizes[ iLevel ] );
+			vLevels[ iLevel ].resize( viLevelSizes[ iLevel ] );
+			glGetCompressedTexImage( GL_TEXTURE_2D_ARRAY_EXT, iLevel, &vLevels[ iLevel ][0] );
+		}
+		else
+		{
+			GLint iChannelCount = m_oFormat.m_eInternalFormat == GL_RGBA ? 4 : ( m_oFormat.m_eInternalFormat == GL_LUMINANCE ? 1 : 3 );
+			vLevels[ iLevel ].resize( iWidth * iHeight * iUsedLayerCount * iChannelCount );
+			glGetTexImage( GL_TEXTURE_2D_ARRAY_EXT, iLevel, m_oFormat.m_eInternalFormat, GL_UNSIGNED_BYTE, &vLevels[ iLevel ][0] );
+		}
+	}
+	glPixelStorei( GL_PACK_ALIGNMENT, 4 );
+
+	_Allocate( iLayerCount );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	for( unsigned int iLevel = 0; iLevel < m_oFormat.m_iLevelCount; ++iLevel )
+	{
+		GLint iWidth = MipmapGenerator::GetLevelSize( m_oFormat.m_iWidth, iLevel );
+		GLint iHeight = MipmapGenerator::GetLevelSize( m_oFormat.m_iHeight, iLevel );
+		if( m_oFormat.m_bCompressed )
+		{
+			glCompressedTexSubImage3D( GL_TEXTURE_2D_ARRAY_EXT, iLevel, 0, 0, 0, iWidth, iHeight, iUsedLayerCount,
+				m_oFormat.m_eInternalFormat, viLevelSizes[ iLevel ], &vLevels[ iLevel ][0] );
+		}
+		else
+		{
+			glTexSubImage3D( GL_TEXTURE_2D_ARRAY_EXT, iLevel, 0, 0, 0, iWidth, iHeight, iUsedLayerCount,
+				m_oFormat.m_eInternalFormat, GL_UNSIGNED_BYTE, &vLevels[ iLevel ][0] );
+		}
+	}
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+	Deactivate();
+
+	//The materials hold the array, not its texture, they bind the new one on their next activation
+	OpenGLContext::DeleteTexture( iOldId );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+TextureArray::~TextureArray()
+{
+	OpenGLContext::DeleteTexture( m_iId );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+unsigned int TextureArray::AddLayer()
+{
+	assert( !IsFull() );
+	if( !m_viFreeLayers.empty() )
+	{
+		unsigned int iLayer = m_viFreeLayers.back();
+		m_viFreeLayers.pop_back();
+		return iLayer;
+	}
+	if( m_iUsedLayerCount == m_iLayerCount )
+	{
+		_Grow( 2 * m_iLayerCount < m_iMaxLayerCount ? 2 * m_iLayerCount : m_iMaxLayerCount );
+	}
+	return m_iUsedLayerCount++;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void TextureArray::RemoveLayer( unsigned int iLayer )
+{
+	assert( iLayer < m_iUsedLayerCount );
+	m_viFreeLayers.push_back( iLayer );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void TextureArray::Activate()
+{
+	OpenGLContext::BindTexture( GL_TEXTURE_2D_ARRAY_EXT, m_iId );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void TextureArray::Deactivate()
+{
+	OpenGLContext::BindTexture( GL_TEXTURE_2D_ARRAY_EXT, 0 );
+}
@@ -0,0 +1,94 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __TEXTUREARRAY_H__
+#define __TEXTUREARRAY_H__
+
+#include "BurgerEngine/Graphics/CommonGraphics.h"
+
+#include <vector>
+
+/// \class	TextureArray
+/// \brief	A 2D texture array (EXT_texture_array) the material textures of the same size and format are packed in,
+///			one texture per layer. The materials sharing an array keep it bound between their draws, the shaders
+///			read the layer of their texture from a uniform.
+///			An array starts with a single layer and doubles when a texture does not fit, up to its maximum.
+///			A removed layer is given to the next texture, the TextureManager releases an array once it is empty
+class TextureArray
+{
+public:
+
+	/// Layers an array grows to, the next textures of the format go in another array
+	static const unsigned int s_iMaxLayerCount = 16;
+
+	/// Shader feature selecting the sampler2DArray of the material shaders
+	static const char* s_sShaderFeature;
+
+	static bool IsSupported(){ return GLEE_EXT_texture_array != 0; }
+
+	/// What the textures of an array share
+	struct sFormat
+	{
+		unsigned int	m_iWidth;
+		unsigned int	m_iHeight;
+		unsigned int	m_iLevelCount;
+		/// Internal format, compressed or not
+		GLenum			m_eInternalFormat;
+		bool			m_bCompressed;
+
+		GLenum			m_eFilteringMin;
+		GLenum			m_eFilteringMag;
+		GLenum			m_eWrapS;
+		GLenum			m_eWrapT;
+
+		bool operator==( sFormat const& rOther ) const;
+	};
+
+	/// \brief Allocate the levels of a first layer, GL thread only
+	/// \param iMaxLayerCount Layers the array may grow to
+	TextureArray( sFormat const& oFormat, unsigned int iMaxLayerCount );
+	~TextureArray();
+
+	sFormat const& GetFormat() const { return m_oFormat; }
+	bool IsFull() const { return m_iUsedLayerCount == m_iMaxLayerCount && m_viFreeLayers.empty(); }
+	bool IsEmpty() const { return m_iUsedLayerCount == m_viFreeLayers.size(); }
+
+	/// \brief Reserve a removed layer or the next free one, the array grows if needed, GL thread only
+	unsigned int AddLayer();
+
+	/// \brief Give back the layer of a released texture, its content is left as is
+	void RemoveLayer( unsigned int iLayer );
+
+	/// \brief Bind on the active unit
+	void Activate();
+
+	/// \brief Unbind the arrays from the active unit
+	static void Deactivate();
+
+private:
+
+	/// \brief Create the texture with room for a number of layers, left bound
+	void _Allocate( unsigned int iLayerCount );
+
+	/// \brief Move the used layers to a larger texture
+	void _Grow( unsigned int iLayerCount );
+
+	sFormat			m_oFormat;
+	GLuint			m_iId;
+	/// Layers allocated
+	unsigned int	m_iLayerCount;
+	unsigned int	m_iMaxLayerCount;
+	unsigned int	m_iUsedLayerCount;
+	/// Layers below m_iUsedLayerCount whose texture was released
+	std::vector< unsigned int >	m_viFreeLayers;
+};
+
+#endif //__TEXTUREARRAY_H__
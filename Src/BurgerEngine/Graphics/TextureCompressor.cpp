@@ -0,0 +1,518 @@
+#include "BurgerEngine/Graphics/TextureCompressor.h"
+#include "BurgerEngine/Graphics/ImageTool.h"
+
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+
+/// Header of the .btex container, followed by the data of every level, from the largest
+struct sContainerHeader
+{
+	char			m_pMagic[4];
+	unsigned int	m_iVersion;
+	unsigned int	m_iFormat;
+	unsigned int	m_iWidth;
+	unsigned int	m_iHeight;
+	unsigned int	m_iLevelCount;
+	unsigned int	m_iMipmapKey;
+};
+
+static const char s_pContainerMagic[4] = { 'B', 'T', 'E', 'X' };
+static const unsigned int s_iContainerVersion = 2;
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static unsigned short ToRGB565( int const pColor[3] )
+{
+	return (unsigned short)( ( ( pColor[0] * 31 + 127 ) / 255 ) << 11 | ( ( pColor[1] * 63 + 127 ) / 255 ) << 5 | ( ( pColor[2] * 31 + 127 ) / 255 ) );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static void FromRGB565( unsigned short iColor, int pColorOut[3] )
+{
+	int iRed = ( iColor >> 11 ) & 31;
+	int iGreen = ( iColor >> 5 ) & 63;
+	int iBlue = iColor & 31;
+	pColorOut[0] = ( iRed << 3 ) | ( iRed >> 2 );
+	pColorOut[1] = ( iGreen << 2 ) | ( iGreen >> 4 );
+	pColorOut[2] = ( iBlue << 3 ) | ( iBlue >> 2 );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// BC1 block from 16 RGBA pixels: the end points are the bounding box of the colors,
+// its diagonal following the correlation of the channels, slightly inset to lower the error
+//--------------------------------------------------------------------------------------------------------------------
+static void EncodeColorBlock( GLubyte const pBlock[64], GLubyte* pOut )
+{
+	int pMin[3] = { 255, 255, 255 };
+	int pMax[3] = { 0, 0, 0 };
+	int pMean[3] = { 0, 0, 0 };
+	for( unsigned int i = 0; i < 16; ++i )
+	{
+		for( unsigned int c = 0; c < 3; ++c )
+		{
+			int iValue = pBlock[ i * 4 + c ];
+			pMin[c] = iValue < pMin[c] ? iValue : pMin[c];
+			pMax[c] = iValue > pMax[c] ? iValue : pMax[c];
+			pMean[c] += iValue;
+		}
+	}
+
+	//Flip the channels that decrease when the widest one increases
+	unsigned int iReference = 0;
+	for( unsigned int c = 1; c < 3; ++c )
+	{
+		if( pMax[c] - pMin[c] > pMax[iReference] - pMin[iReference] )
+		{
+			iReference = c;
+		}
+	}
+	int pStart[3], pEnd[3];
+	for( unsigned int c = 0; c < 3; ++c )
+	{
+		int iCovariance = 0;
+		for( unsigned int i = 0; i < 16; ++i )
+		{
+			iCovariance += ( pBlock[ i * 4 + iReference ] * 16 - pMean[iReference] ) * ( pBlock[ i * 4 + c ] * 16 - pMean[c] );
+		}
+		pStart[c] = iCovariance < 0 ? pMin[c] : pMax[c];
+		pEnd[c] = iCovariance < 0 ? pMax[c] : pMin[c];
+
+		int iInset = ( pStart[c] - pEnd[c] ) / 16;
+		pStart[c] -= iInset;
+		pEnd[c] += iInset;
+	}
+
+	//Four colors mode needs the first end point to be the greatest
+	unsigned short iColor0 = ToRGB565( pStart );
+	unsigned short iColor1 = ToRGB565( pEnd );
+	if( iColor0 < iColor1 )
+	{
+		unsigned short iTemp = iColor0;
+		iColor0 = iColor1;
+		iColor1 = iTemp;
+	}
+
+	unsigned int iIndices = 0;
+	if( iColor0 != iColor1 )
+	{
+		int pPalette[4][3];
+		FromRGB565( iColor0, pPalette[0] );
+		FromRGB565( iColor1, pPalette[1] );
+		for( unsigned int c = 0; c < 3; ++c )
+		{
+			pPalette[2][c] = ( 2 * pPalette[0][c] + pPalette[1][c] + 1 ) / 3;
+			pPalette[3][c] = ( pPalette[0][c] + 2 * pPalette[1][c] + 1 ) / 3;
+		}
+
+		for( unsigned int i = 0; i < 16; ++i )
+		{
+			unsigned int iBest = 0;
+			int iBestDistance = 0x7fffffff;
+			for( unsigned int p = 0; p < 4; ++p )
+			{
+				int iDistance = 0;
+				for( unsigned int c = 0; c < 3; ++c )
+				{
+					int iDelta = pBlock[ i * 4 + c ] - pPalette[p][c];
+					iDistance += iDelta * iDelta;
+				}
+				if( iDistance < iBestDistance )
+				{
+					iBestDistance = iDistance;
+					iBest = p;
+				}
+			}
+			iIndices |= iBest << ( 2 * i );
+		}
+	}
+
+	pOut[0] = (GLubyte)( iColor0 & 0xff );
+	pOut[1] = (GLubyte)( iColor0 >> 8 );
+	pOut[2] = (GLubyte)( iColor1 & 0xff );
+	pOut[3] = (GLubyte)( iColor1 >> 8 );
+	pOut[4] = (GLubyte)( iIndices & 0xff );
+	pOut[5] = (GLubyte)( ( iIndices >> 8 ) & 0xff );
+	pOut[6] = (GLubyte)( ( iIndices >> 16 ) & 0xff );
+	pOut[7] = (GLubyte)( iIndices >> 24 );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// BC4 block (alpha of BC3, each channel of BC5) from one channel of 16 RGBA pixels, eight values mode
+//--------------------------------------------------------------------------------------------------------------------
+static void EncodeChannelBlock( GLubyte const pBlock[64], unsigned int iChannel, GLubyte* pOut )
+{
+	int iMin = 255;
+	int iMax = 0;
+	for( unsigned int i = 0; i < 16; ++i )
+	{
+		int iValue = pBlock[ i * 4 + iChannel ];
+		iMin = iValue < iMin ? iValue : iMin;
+		iMax = iValue > iMax ? iValue : iMax;
+	}
+
+	pOut[0] = (GLubyte)iMax;
+	pOut[1] = (GLubyte)iMin;
+
+	int pPalette[8];
+	pPalette[0] = iMax;
+	pPalette[1] = iMin;
+	for( unsigned int p = 2; p < 8; ++p )
+	{
+		pPalette[p] = ( ( 8 - p ) * iMax + ( p - 1 ) * iMin + 3 ) / 7;
+	}
+
+	//3 bits per pixel, written as two groups of 8 pixels
+	for( unsigned int iGroup = 0; iGroup < 2; ++iGroup )
+	{
+		unsigned int iIndices = 0;
+		for( unsigned int j = 0; j < 8 && iMax != iMin; ++j )
+		{
+			int iValue = pBlock[ ( iGroup * 8 + j ) * 4 + iChannel ];
+			unsigned int iBest = 0;
+			int iBestDistance = 256;
+			for( unsigned int p = 0; p < 8; ++p )
+			{
+				int iDistance = iValue > pPalette[p] ? iValue - pPalette[p] : pPalette[p] - iValue;
+				if( iDistance < iBestDistance )
+				{
+					iBestDistance = iDistance;
+					iBest = p;
+				}
+			}
+			iIndices |= iBest << ( 3 * j );
+		}
+		pOut[ 2 + iGroup * 3 ] = (GLubyte)( iIndices & 0xff );
+		pOut[ 3 + iGroup * 3 ] = (GLubyte)( ( iIndices >> 8 ) & 0xff );
+		pOut[ 4 + iGroup * 3 ] = (GLubyte)( iIndices >> 16 );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static unsigned int GetBlockSize( TextureCompressor::CompressionFormat eFormat )
+{
+	return eFormat == TextureCompressor::E_COMPRESSION_BC1 ? 8 : 16;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+unsigned int TextureCompressor::sCompressedImage::GetLevelWidth( unsigned int iLevel ) const
+{
+	return MipmapGenerator::GetLevelSize( m_iWidth, iLevel );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+unsigned int TextureCompressor::sCompressedImage::GetLevelHeight( unsigned int iLevel ) const
+{
+	return MipmapGenerator::GetLevelSize( m_iHeight, iLevel );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+unsigned int TextureCompressor::sCompressedImage::GetLevelSize( unsigned int iLevel ) const
+{
+	return ( ( GetLevelWidth( iLevel ) + 3 ) / 4 ) * ( ( GetLevelHeight( iLevel ) + 3 ) / 4 ) * GetBlockSize( m_eFormat );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+GLenum TextureCompressor::sCompressedImage::GetGLFormat() const
+{
+	switch( m_eFormat )
+	{
+	case E_COMPRESSION_BC1:
+		return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	case E_COMPRESSION_BC3:
+		return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	case E_COMPRESSION_BC5:
+		return GL_COMPRESSED_RG_RGTC2;
+	default:
+		assert( false );
+		return GL_RGBA;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+TextureCompressor::CompressionFormat TextureCompressor::GetFormatFromName( const char* sName )
+{
+	if( sName == NULL )
+	{
+		return E_COMPRESSION_AUTO;
+	}
+	std::string sFormat( sName );
+	if( sFormat == "none" )
+	{
+		return E_COMPRESSION_NONE;
+	}
+	if( sFormat == "bc1" )
+	{
+		return E_COMPRESSION_BC1;
+	}
+	if( sFormat == "bc3" )
+	{
+		return E_COMPRESSION_BC3;
+	}
+	if( sFormat == "bc5" )
+	{
+		return E_COMPRESSION_BC5;
+	}
+	return E_COMPRESSION_AUTO;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool TextureCompressor::IsFormatSupported( CompressionFormat eFormat )
+{
+	switch( eFormat )
+	{
+	case E_COMPRESSION_NONE:
+		return true;
+	case E_COMPRESSION_BC5:
+		return GLEE_VERSION_3_0 || GLEE_ARB_texture_compression_rgtc || GLEE_EXT_texture_compression_rgtc;
+	default:
+		return GLEE_EXT_texture_compression_s3tc == GL_TRUE;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+std::string TextureCompressor::GetContainerName( const std::string& sImageName )
+{
+	std::string::size_type iDot = sImageName.find_last_of( '.' );
+	std::string::size_type iSlash = sImageName.find_last_of( "/\\" );
+	if( iDot == std::string::npos || ( iSlash != std::string::npos && iDot < iSlash ) )
+	{
+		return sImageName + ".btex";
+	}
+	return sImageName.substr( 0, iDot ) + ".btex";
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool TextureCompressor::Compress( GLubyte const* pData, unsigned int iWidth, unsigned int iHeight, unsigned int iChannel, CompressionFormat eFormat, bool bMipmaps, MipmapGenerator::sSettings const& oMipmapSettings, sCompressedImage& oImageOut )
+{
+	if( eFormat == E_COMPRESSION_NONE || ( iChannel != 1 && iChannel != 3 && iChannel != 4 ) || iWidth == 0 || iHeight == 0 )
+	{
+		return false;
+	}
+
+	if( eFormat == E_COMPRESSION_AUTO )
+	{
+		bool bOpaque = true;
+		for( unsigned int i = 0; i < iWidth * iHeight && bOpaque && iChannel == 4; ++i )
+		{
+			bOpaque = pData[ i * 4 + 3 ] == 255;
+		}
+		eFormat = bOpaque ? E_COMPRESSION_BC1 : E_COMPRESSION_BC3;
+	}
+
+	MipmapGenerator::MipChain vLevels;
+	if( bMipmaps )
+	{
+		MipmapGenerator::Generate( pData, iWidth, iHeight, iChannel, oMipmapSettings, vLevels );
+	}
+	else
+	{
+		vLevels.resize( 1 );
+		vLevels[0].assign( pData, pData + iWidth * iHeight * iChannel );
+	}
+
+	oImageOut.m_eFormat = eFormat;
+	oImageOut.m_iWidth = iWidth;
+	oImageOut.m_iHeight = iHeight;
+	oImageOut.m_iMipmapKey = oMipmapSettings.GetKey();
+	oImageOut.m_viLevelOffset.clear();
+	oImageOut.m_vData.clear();
+
+	for( unsigned int iLevel = 0; iLevel < vLevels.size(); ++iLevel )
+	{
+		unsigned int iOffset = oImageOut.m_vData.size();
+		oImageOut.m_viLevelOffset.push_back( iOffset );
+		oImageOut.m_vData.resize( iOffset + oImageOut.GetLevelSize( iLevel ) );
+		GLubyte* pOut = &oImageOut.m_vData[ iOffset ];
+
+		unsigned int iLevelWidth = oImageOut.GetLevelWidth( iLevel );
+		unsigned int iLevelHeight = oImageOut.GetLevelHeight( iLevel );
+		GLubyte const* pLevel = &vLevels[ iLevel ][0];
+
+		for( unsigned int iBlockY = 0; iBlockY < iLevelHeight; iBlockY += 4 )
+		{
+			for( unsigned int iBlockX = 0; iBlockX < iLevelWidth; iBlockX += 4 )
+			{
+				//Gather the block as RGBA, clamping on the border of the image
+				GLubyte pBlock[64];
+				for( unsigned int y = 0; y < 4; ++y )
+				{
+					unsigned int iY = iBlockY + y < iLevelHeight ? iBlockY + y : iLevelHeight - 1;
+					for( unsigned int x = 0; x < 4; ++x )
+					{
+						unsigned int iX = iBlockX + x < iLevelWidth ? iBlockX + x : iLevelWidth - 1;
+						GLubyte const* pPixel = pLevel + ( iY * iLevelWidth + iX ) * iChannel;
+						GLubyte* pBlockPixel = pBlock + ( y * 4 + x ) * 4;
+						pBlockPixel[0] = pPixel[0];
+						pBlockPixel[1] = iChannel == 1 ? pPixel[0] : pPixel[1];
+						pBlockPixel[2] = iChannel == 1 ? pPixel[0] : pPixel[2];
+						pBlockPixel[3] = iChannel == 4 ? pPixel[3] : 255;
+					}
+				}
+
+				switch( eFormat )
+				{
+				case E_COMPRESSION_BC1:
+					EncodeColorBlock( pBlock, pOut );
+					pOut += 8;
+					break;
+				case E_COMPRESSION_BC3:
+					EncodeChannelBlock( pBlock, 3, pOut );
+					EncodeColorBlock( pBlock, pOut + 8 );
+					pOut += 16;
+					break;
+				default:
+					EncodeChannelBlock( pBlock, 0, pOut );
+					EncodeChannelBlock( pBlock, 1, pOut + 8 );
+					pOut += 16;
+					break;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool TextureCompressor::ReadContainer( const std::string& sFileName, sCompressedImage& oImageOut )
+{
+	std::ifstream oFile( sFileName.c_str(), std::ios::binary );
+	if( !oFile )
+	{
+		return false;
+	}
+
+	sContainerHeader oHeader;
+	if( !oFile.read( (char*)&oHeader, sizeof( oHeader ) )
+		|| memcmp( oHeader.m_pMagic, s_pContainerMagic, 4 ) != 0
+		|| oHeader.m_iVersion != s_iContainerVersion
+		|| oHeader.m_iFormat < E_COMPRESSION_BC1 || oHeader.m_iFormat > E_COMPRESSION_BC5
+		|| oHeader.m_iLevelCount == 0 || oHeader.m_iLevelCount > MipmapGenerator::GetLevelCount( oHeader.m_iWidth, oHeader.m_iHeight ) )
+	{
+		std::cerr << "WARNING: invalid texture container: " << sFileName << std::endl;
+		return false;
+	}
+
+	oImageOut.m_eFormat = (CompressionFormat)oHeader.m_iFormat;
+	oImageOut.m_iWidth = oHeader.m_iWidth;
+	oImageOut.m_iHeight = oHeader.m_iHeight;
+	oImageOut.m_iMipmapKey = oHeader.m_iMipmapKey;
+	oImageOut.m_viLevelOffset.clear();
+	unsigned int iSize = 0;
+	for( unsigned int iLevel = 0; iLevel < oHeader.m_iLevelCount; ++iLevel )
+	{
+		oImageOut.m_viLevelOffset.push_back( iSize );
+		iSize += oImageOut.GetLevelSize( iLevel );
+	}
+
+	oImageOut.m_vData.resize( iSize );
+	if( !oFile.read( (char*)&oImageOut.m_vData[0], iSize ) )
+	{
+		std::cerr << "WARNING: truncated texture container: " << sFileName << std::endl;
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool TextureCompressor::WriteContainer( const std::string& sFileName, sCompressedImage const& oImage )
+{
+	//Written aside then renamed, so a crash never leaves a truncated container behind
+	std::string sTemporaryName = sFileName + ".tmp";
+	{
+		std::ofstream oFile( sTemporaryName.c_str(), std::ios::binary | std::ios::trunc );
+		if( !oFile )
+		{
+			return false;
+		}
+
+		sContainerHeader oHeader;
+		memcpy( oHeader.m_pMagic, s_pContainerMagic, 4 );
+		oHeader.m_iVersion = s_iContainerVersion;
+		oHeader.m_iFormat = oImage.m_eFormat;
+		oHeader.m_iWidth = oImage.m_iWidth;
+		oHeader.m_iHeight = oImage.m_iHeight;
+		oHeader.m_iLevelCount = oImage.GetLevelCount();
+		oHeader.m_iMipmapKey = oImage.m_iMipmapKey;
+
+		oFile.write( (char const*)&oHeader, sizeof( oHeader ) );
+		oFile.write( (char const*)&oImage.m_vData[0], oImage.m_vData.size() );
+		if( !oFile )
+		{
+			return false;
+		}
+	}
+
+	remove( sFileName.c_str() );
+	return rename( sTemporaryName.c_str(), sFileName.c_str() ) == 0;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool TextureCompressor::LoadCompressedImage( const std::string& sImageName, CompressionFormat eFormat, bool bMipmaps, MipmapGenerator::sSettings const& oMipmapSettings, sCompressedImage& oImageOut )
+{
+	std::string sContainerName = GetContainerName( sImageName );
+
+	struct stat oImageStat;
+	struct stat oContainerStat;
+	bool bImageFound = stat( sImageName.c_str(), &oImageStat ) == 0;
+	bool bContainerFound = stat( sContainerName.c_str(), &oContainerStat ) == 0;
+
+	//Use the container if it is newer than the image and was built with the same settings
+	if( bContainerFound && ( !bImageFound || oContainerStat.st_mtime >= oImageStat.st_mtime )
+		&& ReadContainer( sContainerName, oImageOut ) )
+	{
+		bool bFormatMatch = eFormat == E_COMPRESSION_AUTO ? oImageOut.m_eFormat != E_COMPRESSION_BC5 : oImageOut.m_eFormat == eFormat;
+		unsigned int iLevelCount = bMipmaps ? MipmapGenerator::GetLevelCount( oImageOut.m_iWidth, oImageOut.m_iHeight ) : 1;
+		bool bMipmapMatch = !bMipmaps || oImageOut.m_iMipmapKey == oMipmapSettings.GetKey();
+		if( bFormatMatch && bMipmapMatch && oImageOut.GetLevelCount() == iLevelCount )
+		{
+			return true;
+		}
+	}
+
+	unsigned int iWidth, iHeight, iChannel;
+	GLubyte* pData = ImageTool::LoadImage( sImageName, iWidth, iHeight, iChannel );
+	if( pData == NULL )
+	{
+		return false;
+	}
+
+	std::cout << "COMPRESSING : " << sImageName << std::endl;
+	bool bCompressed = Compress( pData, iWidth, iHeight, iChannel, eFormat, bMipmaps, oMipmapSettings, oImageOut );
+	delete[] pData;
+
+	if( bCompressed && !WriteContainer( sContainerName, oImageOut ) )
+	{
+		std::cerr << "WARNING: cannot write texture container: " << sContainerName << std::endl;
+	}
+	return bCompressed;
+}
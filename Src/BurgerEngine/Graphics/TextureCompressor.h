@@ -0,0 +1,82 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __TEXTURECOMPRESSOR_H__
+#define __TEXTURECOMPRESSOR_H__
+
+#include <string>
+#include <vector>
+
+#include "BurgerEngine/Graphics/CommonGraphics.h"
+#include "BurgerEngine/Graphics/MipmapGenerator.h"
+
+/// \class	TextureCompressor
+/// \brief	CPU block compression (BC1/BC3/BC5) and the .btex container holding the compressed mip chain.
+///			The container is built next to the source image the first time the image is used,
+///			and rebuilt when the source image is newer than it
+class TextureCompressor
+{
+public:
+
+	enum CompressionFormat
+	{
+		E_COMPRESSION_NONE = 0,
+		/// BC1 for opaque images, BC3 when the image has an alpha channel
+		E_COMPRESSION_AUTO,
+		/// RGB, 4 bits per pixel
+		E_COMPRESSION_BC1,
+		/// RGBA, 8 bits per pixel
+		E_COMPRESSION_BC3,
+		/// Two channels (RG), 8 bits per pixel, meant for normal maps: z has to be rebuilt in the shader
+		E_COMPRESSION_BC5,
+	};
+
+	/// \brief A compressed image and all its mip levels
+	struct sCompressedImage
+	{
+		CompressionFormat			m_eFormat;
+		unsigned int				m_iWidth;
+		unsigned int				m_iHeight;
+		/// Key of the settings the mip chain was built with
+		unsigned int				m_iMipmapKey;
+		/// Offset of each level in m_vData
+		std::vector< unsigned int >	m_viLevelOffset;
+		std::vector< GLubyte >		m_vData;
+
+		unsigned int GetLevelCount() const { return m_viLevelOffset.size(); }
+		unsigned int GetLevelWidth( unsigned int iLevel ) const;
+		unsigned int GetLevelHeight( unsigned int iLevel ) const;
+		unsigned int GetLevelSize( unsigned int iLevel ) const;
+		GLubyte const* GetLevelData( unsigned int iLevel ) const { return &m_vData[ m_viLevelOffset[ iLevel ] ]; }
+		GLenum GetGLFormat() const;
+	};
+
+	/// \brief Read the compression attribute of a texture xml ("none", "bc1", "bc3", "bc5", anything else is auto)
+	static CompressionFormat GetFormatFromName( const char* sName );
+
+	/// \brief Check the GL extension needed by a format, GL thread only
+	static bool IsFormatSupported( CompressionFormat eFormat );
+
+	/// \brief Load the compressed image of a source image, from its container when it is up to date,
+	///			otherwise decode the source, compress it and write the container. Does not call OpenGL
+	static bool LoadCompressedImage( const std::string& sImageName, CompressionFormat eFormat, bool bMipmaps, MipmapGenerator::sSettings const& oMipmapSettings, sCompressedImage& oImageOut );
+
+	/// \brief Compress an 8 bits image (1, 3 or 4 channels), with its full mip chain if bMipmaps is set
+	static bool Compress( GLubyte const* pData, unsigned int iWidth, unsigned int iHeight, unsigned int iChannel, CompressionFormat eFormat, bool bMipmaps, MipmapGenerator::sSettings const& oMipmapSettings, sCompressedImage& oImageOut );
+
+	/// \brief Container file of a source image, the extension is replaced by .btex
+	static std::string GetContainerName( const std::string& sImageName );
+
+	static bool ReadContainer( const std::string& sFileName, sCompressedImage& oImageOut );
+	static bool WriteContainer( const std::string& sFileName, sCompressedImage const& oImage );
+};
+
+#endif //__TEXTURECOMPRESSOR_H__
@@ -1,4 +1,6 @@
 #include "BurgerEngine/Graphics/TextureCubeMap.h"
+#include "BurgerEngine/Graphics/MipmapGenerator.h"
+#include "BurgerEngine/Graphics/OpenGLContext.h"
 
 const std::string oTextureName[6] = { "PosX", "NegX", "PosY", "NegY", "PosZ", "NegZ" };
 /*
@@ -27,14 +29,49 @@ TextureCubeMap::TextureCubeMap(  bool bUseMipMaps, bool bLinearFiltering, bool b
 
 bool TextureCubeMap::LoadTexture( const std::string &sName )
 {
-	GLubyte *data = NULL; 
+	//Decode the six faces first, so their mip chains can be built in parallel
+	GLubyte* pFaces[6] = { NULL, NULL, NULL, NULL, NULL, NULL };
+	bool bLoaded = true;
+	for( unsigned int i = 0; i < 6 && bLoaded; ++i )
+	{
+		m_sName = sName + oTextureName[i] + ".png";
+		pFaces[i] = AbstractTexture::LoadData();
+		bLoaded = pFaces[i] != NULL;
+	}
+	if( !bLoaded )
+	{
+		for( unsigned int i = 0; i < 6; ++i )
+		{
+			delete[] pFaces[i];
+		}
+		return false;
+	}
+
+	MipmapGenerator::MipChain pLevels[6];
+	if( m_bUseMipMaps )
+	{
+		MipmapGenerator::GenerateCubeFaces( pFaces, m_iWidth, m_iChanel, m_oMipmapSettings, pLevels );
+	}
+	else
+	{
+		for( unsigned int i = 0; i < 6; ++i )
+		{
+			pLevels[i].resize( 1 );
+			pLevels[i][0].assign( pFaces[i], pFaces[i] + m_iWidth * m_iHeight * m_iChanel );
+		}
+	}
+	for( unsigned int i = 0; i < 6; ++i )
+	{
+		delete[] pFaces[i];
+	}
 	
 	///Create a new ID
 	generateID();
 
 	Activate();
 
-	glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_GENERATE_MIPMAP, m_eGenerateMipMap );
+	glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_GENERATE_MIPMAP, GL_FALSE );
+	glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, pLevels[0].size() - 1 );
 	glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, m_eFilteringMin );
 	glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, m_eFilteringMag );
 
@@ -42,21 +79,20 @@ bool TextureCubeMap::LoadTexture( const std::string &sName )
 	glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, m_eWrapT );
 	glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, m_eWrapR );
 
+	GLenum eFormat = m_iChanel == 4 ? GL_RGBA : GL_RGB;
 	GLenum eTarget = GL_TEXTURE_CUBE_MAP_POSITIVE_X;
 
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
 	for( unsigned int i = 0; i < 6; ++i )
 	{
-		m_sName = sName + oTextureName[i] + ".png";
-		data = AbstractTexture::LoadData();
-		if (data != NULL)
+		for( unsigned int iLevel = 0; iLevel < pLevels[i].size(); ++iLevel )
 		{
-			glTexImage2D ( eTarget, 0, GL_RGB,m_iWidth, m_iHeight, 0, GL_RGB,GL_UNSIGNED_BYTE, data );
-			delete[] data;
-			eTarget++;
+			unsigned int iSize = MipmapGenerator::GetLevelSize( m_iWidth, iLevel );
+			glTexImage2D ( eTarget, iLevel, eFormat, iSize, iSize, 0, eFormat, GL_UNSIGNED_BYTE, &pLevels[i][ iLevel ][0] );
 		}
-		else
-			return false;
+		eTarget++;
 	}
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
 	
 	Deactivate();
 
@@ -66,10 +102,10 @@ bool TextureCubeMap::LoadTexture( const std::string &sName )
 void TextureCubeMap::Activate()
 {
 	//OpenGL Bind
-	glBindTexture ( GL_TEXTURE_CUBE_MAP, m_iId );
+	OpenGLContext::BindTexture( GL_TEXTURE_CUBE_MAP, m_iId );
 }
 
 void TextureCubeMap::Deactivate()
 {
-	glBindTexture (GL_TEXTURE_CUBE_MAP, 0);
+	OpenGLContext::BindTexture(GL_TEXTURE_CUBE_MAP, 0);
 }
\ No newline at end of file
@@ -29,6 +29,7 @@ class TextureCubeMap: public AbstractTexture
 		*/
 		virtual bool LoadTexture( const std::string &name );
 		virtual void Activate();	
+		virtual GLenum GetTarget() const { return GL_TEXTURE_CUBE_MAP; }
 		virtual void Deactivate();	
 
 
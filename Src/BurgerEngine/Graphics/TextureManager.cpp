@@ -4,10 +4,53 @@
 #include "BurgerEngine/Graphics/Texture2D.h"
 #include "BurgerEngine/Graphics/TextureCubeMap.h"
 #include "BurgerEngine/Graphics/Texture3D.h"
+#include "BurgerEngine/Graphics/ResourceLoader.h"
 
 #include "BurgerEngine/External/TinyXml/TinyXml.h"
 
+#include <algorithm>
+
+/// \brief Decode the image on a loader thread and upload it on the GL thread,
+/// the texture shows its placeholder meanwhile
+class Texture2DLoadingJob: public ResourceLoader::AbstractJob
+{
+public:
+	Texture2DLoadingJob( Texture2D* pTexture, const std::string& sName ): m_pTexture( pTexture ), m_sName( sName ){}
+
+	/// The texture may have been released while it was loading
+	~Texture2DLoadingJob()
+	{
+		TextureManager::GrabInstance()._OnLoadingDone( m_pTexture );
+	}
+
+	bool Load()
+	{
+		if( !m_pTexture->DecodeImage() )
+		{
+			std::cerr << "WARNING: cannot load texture: " << m_sName << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	void Upload()
+	{
+		m_pTexture->UploadImage();
+	}
+
+private:
+	Texture2D*	m_pTexture;
+	std::string	m_sName;
+};
+
 TextureManager::TextureManager()
+	: m_bStreaming( false )
+	, m_iStreamingMemoryBudget( 0 )
+	, m_iStreamingUploadBudget( 0 )
+	, m_iStreamingMemory( 0 )
+	, m_iFrame( 0 )
+	, m_bArrayPacking( false )
+	, m_pPlaceholderArray( NULL )
 {
 	//Devil initialization
 	ilInit();
@@ -25,34 +68,202 @@ TextureManager::TextureManager()
 //--------------------------------------------------------------------------------------------------------------------
 void TextureManager::clear()
 {
-	for (std::map<std::string , AbstractTexture*>::iterator iter = m_mTextures.begin() ; iter != m_mTextures.end() ; ++iter)
+	for (std::map<std::string , sTexture>::iterator iter = m_mTextures.begin() ; iter != m_mTextures.end() ; ++iter)
 	{
-		delete (*iter).second;
+		delete (*iter).second.m_pTexture;
 	}
 	m_mTextures.clear();
+	m_mTextureKeys.clear();
+	m_mLoadingTextures.clear();
+	m_vStreamedTextures.clear();
+	m_iStreamingMemory = 0;
+
+	for( std::vector< TextureArray* >::iterator it = m_vTextureArrays.begin(); it != m_vTextureArrays.end(); ++it )
+	{
+		delete *it;
+	}
+	m_vTextureArrays.clear();
+	delete m_pPlaceholderArray;
+	m_pPlaceholderArray = NULL;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+TextureArray* TextureManager::AddArrayLayer( const TextureArray::sFormat& oFormat, unsigned int& iLayerOut )
+{
+	TextureArray* pArray = NULL;
+	for( unsigned int i = 0; i < m_vTextureArrays.size() && !pArray; ++i )
+	{
+		if( !m_vTextureArrays[i]->IsFull() && m_vTextureArrays[i]->GetFormat() == oFormat )
+		{
+			pArray = m_vTextureArrays[i];
+		}
+	}
+
+	if( !pArray )
+	{
+		pArray = new TextureArray( oFormat, TextureArray::s_iMaxLayerCount );
+		m_vTextureArrays.push_back( pArray );
+	}
+
+	iLayerOut = pArray->AddLayer();
+	return pArray;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void TextureManager::RemoveArrayLayer( TextureArray* pArray, unsigned int iLayer )
+{
+	if( pArray == m_pPlaceholderArray )
+	{
+		return;
+	}
+
+	pArray->RemoveLayer( iLayer );
+	if( pArray->IsEmpty() )
+	{
+		m_vTextureArrays.erase( std::find( m_vTextureArrays.begin(), m_vTextureArrays.end(), pArray ) );
+		delete pArray;
+	}
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-AbstractTexture* TextureManager::GetTexture2D( const char * sName , const bool bUseMipmap, const bool bLinearFiltering, const bool bClampS, const bool bClampT )
+void TextureManager::ReleaseTexture( AbstractTexture* pTexture )
+{
+	std::map<AbstractTexture* , std::string>::iterator itKey = m_mTextureKeys.find( pTexture );
+	if( itKey == m_mTextureKeys.end() )
+	{
+		return;
+	}
+	std::map<std::string , sTexture>::iterator iter = m_mTextures.find( (*itKey).second );
+	assert( iter != m_mTextures.end() );
+
+	assert( (*iter).second.m_iRefCount > 0 );
+	--(*iter).second.m_iRefCount;
+	if( (*iter).second.m_iRefCount > 0 )
+	{
+		return;
+	}
+	m_mTextures.erase( iter );
+	m_mTextureKeys.erase( itKey );
+
+	//Only the 2D textures are loaded by a job
+	std::map< AbstractTexture*, bool >::iterator itLoading = m_mLoadingTextures.find( pTexture );
+	if( itLoading != m_mLoadingTextures.end() )
+	{
+		(*itLoading).second = true;
+		return;
+	}
+	_DestroyTexture( pTexture );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void TextureManager::_OnLoadingDone( Texture2D* pTexture )
+{
+	std::map< AbstractTexture*, bool >::iterator iter = m_mLoadingTextures.find( pTexture );
+	if( iter == m_mLoadingTextures.end() )
+	{
+		return;
+	}
+
+	bool bReleased = (*iter).second;
+	m_mLoadingTextures.erase( iter );
+	if( bReleased )
+	{
+		_DestroyTexture( pTexture );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void TextureManager::_DestroyTexture( AbstractTexture* pTexture )
+{
+	for( unsigned int i = 0; i < m_vStreamedTextures.size(); ++i )
+	{
+		if( m_vStreamedTextures[i].m_pTexture == pTexture )
+		{
+			m_vStreamedTextures.erase( m_vStreamedTextures.begin() + i );
+			break;
+		}
+	}
+	//The texture gives its array layer back itself
+	delete pTexture;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+TextureArray* TextureManager::GetPlaceholderArray()
+{
+	if( !m_pPlaceholderArray )
+	{
+		TextureArray::sFormat oFormat;
+		oFormat.m_iWidth = 1;
+		oFormat.m_iHeight = 1;
+		oFormat.m_iLevelCount = 1;
+		oFormat.m_eInternalFormat = GL_RGB;
+		oFormat.m_bCompressed = false;
+		oFormat.m_eFilteringMin = GL_NEAREST;
+		oFormat.m_eFilteringMag = GL_NEAREST;
+		oFormat.m_eWrapS = GL_REPEAT;
+		oFormat.m_eWrapT = GL_REPEAT;
+		m_pPlaceholderArray = new TextureArray( oFormat, 1 );
+		m_pPlaceholderArray->AddLayer();
+
+		const GLubyte pGrey[3] = { 128, 128, 128 };
+		m_pPlaceholderArray->Activate();
+		glTexSubImage3D( GL_TEXTURE_2D_ARRAY_EXT, 0, 0, 0, 0, 1, 1, 1, GL_RGB, GL_UNSIGNED_BYTE, pGrey );
+		TextureArray::Deactivate();
+	}
+	return m_pPlaceholderArray;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+AbstractTexture* TextureManager::GetTexture2D( const char * sName , MipmapGenerator::sSettings const& oMipmapSettings, const bool bUseMipmap, const bool bLinearFiltering, const bool bClampS, const bool bClampT, const char * sCompression, const bool bPacked )
 {
 	Texture2D* pTex = new Texture2D( bUseMipmap, bLinearFiltering, bClampS, bClampT );
-	if ( !pTex->LoadTexture( sName ) )
+
+	//Compressed from the .btex container when the hardware can sample it, the container is built by the loading job
+	TextureCompressor::CompressionFormat eCompression = TextureCompressor::GetFormatFromName( sCompression );
+	if( !TextureCompressor::IsFormatSupported( eCompression ) )
 	{
-		std::cerr << "WARNING: cannot load texture: " << sName << std::endl;
-		delete pTex;
-		return NULL;
+		std::cerr << "WARNING: texture compression not supported, " << sName << " is loaded uncompressed" << std::endl;
+		eCompression = TextureCompressor::E_COMPRESSION_NONE;
 	}
+	pTex->SetCompression( eCompression );
+	pTex->SetMipmapSettings( oMipmapSettings );
+	pTex->SetArrayPacking( bPacked );
+
+	pTex->SetStreaming( m_bStreaming );
+	if( pTex->IsStreamed() )
+	{
+		sStreamedTexture oStreamedTexture = { pTex, m_iFrame, 0.0f, 0 };
+		m_vStreamedTextures.push_back( oStreamedTexture );
+	}
+
+	pTex->CreatePlaceholder( sName );
+	//Registered before the job, without loader thread the job is done and deleted in AddJob
+	m_mLoadingTextures[ pTex ] = false;
+	ResourceLoader::GrabInstance().AddJob( new Texture2DLoadingJob( pTex, sName ) );
 	return pTex;
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-AbstractTexture* TextureManager::GetTextureCubeMap( const char * sName , const bool bUseMipmap, const bool bLinearFiltering, const bool bClampS, const bool bClampT, const bool bClampR )
+AbstractTexture* TextureManager::GetTextureCubeMap( const char * sName , MipmapGenerator::sSettings const& oMipmapSettings, const bool bUseMipmap, const bool bLinearFiltering, const bool bClampS, const bool bClampT, const bool bClampR )
 {
 	TextureCubeMap* pTex = new TextureCubeMap( bUseMipmap, bLinearFiltering, bClampS, bClampT, bClampR );
+	pTex->SetMipmapSettings( oMipmapSettings );
 	if ( !pTex->LoadTexture( sName ) )
 	{
 		std::cerr << "WARNING: cannot load texture: " << sName << std::endl;
@@ -65,9 +276,10 @@ AbstractTexture* TextureManager::GetTextureCubeMap( const char * sName , const b
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-AbstractTexture* TextureManager::GetTexture3DFrom2DFile( const char * sName, unsigned int iWidth, unsigned int iHeight, unsigned int iDepth, const bool bUseMipmap, const bool bLinearFiltering, const bool bClampS, const bool bClampT, const bool bClampR )
+AbstractTexture* TextureManager::GetTexture3DFrom2DFile( const char * sName, MipmapGenerator::sSettings const& oMipmapSettings, unsigned int iWidth, unsigned int iHeight, unsigned int iDepth, const bool bUseMipmap, const bool bLinearFiltering, const bool bClampS, const bool bClampT, const bool bClampR )
 {
 	Texture3D* pTex = new Texture3D( iWidth, iHeight, iDepth, bUseMipmap, bLinearFiltering, bClampS, bClampT, bClampR );
+	pTex->SetMipmapSettings( oMipmapSettings );
 	if ( !pTex->LoadTexture( sName ) )
 	{
 		std::cerr << "WARNING: cannot load texture: " << sName << std::endl;
@@ -80,23 +292,31 @@ AbstractTexture* TextureManager::GetTexture3DFrom2DFile( const char * sName, uns
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-AbstractTexture* TextureManager::AddTexture( const char * sName )
+AbstractTexture* TextureManager::AddTexture( const char * sName, bool bPacked )
 {
-	std::map<std::string , AbstractTexture*>::iterator iter = m_mTextures.find( sName );
+	//A file used both packed and alone is loaded twice, the two textures are not bound the same way
+	bPacked = bPacked && m_bArrayPacking;
+	std::string sKey = bPacked ? std::string( sName ) + "#array" : std::string( sName );
+	std::map<std::string , sTexture>::iterator iter = m_mTextures.find( sKey );
 	
 	if ( iter == m_mTextures.end() )
 	{
-		TiXmlDocument * pDocument = new TiXmlDocument( sName );
+		TiXmlDocument oDocument( sName );
 
-		if( !pDocument->LoadFile() )
+		if( !oDocument.LoadFile() )
 		{
-  			std::cerr << "[ReadXML] Loading Error : " << pDocument->ErrorDesc() << std::endl;
+  			std::cerr << "[ReadXML] Loading Error : " << oDocument.ErrorDesc() << std::endl;
 			return NULL;
 		}
 	
-		TiXmlElement * pRoot = pDocument->FirstChildElement( "texture" );
+		TiXmlElement * pRoot = oDocument.FirstChildElement( "texture" );
+		const char * sType = pRoot ? pRoot->Attribute( "type" ) : NULL;
+		if( pRoot && !sType )
+		{
+			std::cerr << "WARNING: no type for texture: " << sName << std::endl;
+		}
 
-		if( pRoot )
+		if( sType )
 		{
 			int iUseMipMap = 0, iLinearFiltering = 0, iClampS = 0, iClampT = 0;
 			pRoot->QueryIntAttribute( "mipmap", &iUseMipMap );
@@ -104,7 +324,20 @@ AbstractTexture* TextureManager::AddTexture( const char * sName )
 			pRoot->QueryIntAttribute( "clamps", &iClampS );
 			pRoot->QueryIntAttribute( "clampt", &iClampT );
 
-			std::string sTextureType = pRoot->Attribute("type");
+			//Mip chain built on the CPU: filter ("box" or "kaiser"), gamma correct filtering for color textures,
+			//alpha reference of cut-out textures whose coverage must be kept
+			MipmapGenerator::sSettings oMipmapSettings;
+			const char * sMipFilter = pRoot->Attribute( "mipfilter" );
+			if( sMipFilter && std::string( sMipFilter ) == "box" )
+			{
+				oMipmapSettings.m_eFilter = MipmapGenerator::E_FILTER_BOX;
+			}
+			int iGammaCorrect = 1;
+			pRoot->QueryIntAttribute( "gamma", &iGammaCorrect );
+			oMipmapSettings.m_bGammaCorrect = iGammaCorrect != 0;
+			pRoot->QueryFloatAttribute( "alphacoverage", &oMipmapSettings.m_fAlphaCoverage );
+
+			std::string sTextureType( sType );
 		
 			TiXmlElement * pXmlFileName = pRoot->FirstChildElement( "filename" );
 			if( pXmlFileName )
@@ -112,15 +345,15 @@ AbstractTexture* TextureManager::AddTexture( const char * sName )
 				AbstractTexture * pTexture = NULL;
 				if( sTextureType == "texture2D" )
 				{
-					pTexture = GetTexture2D( pXmlFileName->GetText(), iUseMipMap != 0 , iLinearFiltering != 0, iClampS != 0, iClampT != 0 );
+					pTexture = GetTexture2D( pXmlFileName->GetText(), oMipmapSettings, iUseMipMap != 0 , iLinearFiltering != 0, iClampS != 0, iClampT != 0, pRoot->Attribute( "compression" ), bPacked );
 				}
 				else
 				{
-					int iClampR;
+					int iClampR = 0;
 					pRoot->QueryIntAttribute( "clampr", &iClampR );
 					if(sTextureType == "texturecube")
 					{
-						pTexture = GetTextureCubeMap( pXmlFileName->GetText(), iUseMipMap != 0 , iLinearFiltering != 0, iClampS != 0, iClampT != 0, iClampR != 0 );
+						pTexture = GetTextureCubeMap( pXmlFileName->GetText(), oMipmapSettings, iUseMipMap != 0 , iLinearFiltering != 0, iClampS != 0, iClampT != 0, iClampR != 0 );
 					}
 					else if(sTextureType == "texture3D")
 					{
@@ -128,16 +361,159 @@ AbstractTexture* TextureManager::AddTexture( const char * sName )
 						pRoot->QueryIntAttribute( "width", &iWidth );
 						pRoot->QueryIntAttribute( "height", &iHeight );
 						pRoot->QueryIntAttribute( "depth", &iDepth );
-						pTexture = GetTexture3DFrom2DFile( pXmlFileName->GetText(), iWidth, iHeight, iDepth,iUseMipMap != 0 , iLinearFiltering != 0, iClampS != 0, iClampT != 0, iClampR != 0 );
+						pTexture = GetTexture3DFrom2DFile( pXmlFileName->GetText(), oMipmapSettings, iWidth, iHeight, iDepth,iUseMipMap != 0 , iLinearFiltering != 0, iClampS != 0, iClampT != 0, iClampR != 0 );
 					}
 				}
 				if( pTexture )
 				{
-					return m_mTextures[ sName ] = pTexture;
+					sTexture& rTexture = m_mTextures[ sKey ];
+					rTexture.m_pTexture = pTexture;
+					rTexture.m_iRefCount = 1;
+					m_mTextureKeys[ pTexture ] = sKey;
+					return pTexture;
 				}
 			}
 		}
 		return NULL;
 	}
-	return m_mTextures[ sName ];
-}
\ No newline at end of file
+	++(*iter).second.m_iRefCount;
+	return (*iter).second.m_pTexture;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void TextureManager::InitializeStreaming( unsigned int iMemoryBudget, unsigned int iUploadBudget )
+{
+	m_bStreaming = true;
+	m_iStreamingMemoryBudget = iMemoryBudget;
+	m_iStreamingUploadBudget = iUploadBudget;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool TextureManager::IsLargerOnScreen( sStreamedTexture const* pFirst, sStreamedTexture const* pSecond )
+{
+	return pFirst->m_fRequestedSize > pSecond->m_fRequestedSize;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool TextureManager::IsLessRecentlyUsed( sStreamedTexture const* pFirst, sStreamedTexture const* pSecond )
+{
+	return pFirst->m_iLastUsedFrame < pSecond->m_iLastUsedFrame;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void TextureManager::UpdateStreaming()
+{
+	if( !m_bStreaming )
+	{
+		return;
+	}
+	++m_iFrame;
+
+	//Gather the requests of the last frame
+	m_iStreamingMemory = 0;
+	std::vector< sStreamedTexture* > vUpgrades;
+	FOR_EACH_IT( std::vector< sStreamedTexture >, m_vStreamedTextures, itTexture )
+	{
+		Texture2D* pTexture = (*itTexture).m_pTexture;
+		if( pTexture->GetLevelCount() == 0 )
+		{
+			//Not uploaded yet
+			continue;
+		}
+
+		m_iStreamingMemory += pTexture->GetMemorySize( pTexture->GetResidentLevel() );
+		(*itTexture).m_fRequestedSize = pTexture->GetRequestedSize();
+		if( (*itTexture).m_fRequestedSize > 0.0f )
+		{
+			(*itTexture).m_iLastUsedFrame = m_iFrame;
+			(*itTexture).m_iWantedLevel = pTexture->GetLevelForSize( (*itTexture).m_fRequestedSize );
+			if( (*itTexture).m_iWantedLevel < pTexture->GetResidentLevel() )
+			{
+				vUpgrades.push_back( &(*itTexture) );
+			}
+		}
+		pTexture->ResetRequest();
+	}
+
+	//Largest on screen first, at least one upload per frame
+	std::sort( vUpgrades.begin(), vUpgrades.end(), &TextureManager::IsLargerOnScreen );
+	unsigned int iUploaded = 0;
+	for( unsigned int i = 0; i < vUpgrades.size() && iUploaded < m_iStreamingUploadBudget; ++i )
+	{
+		Texture2D* pTexture = vUpgrades[i]->m_pTexture;
+		unsigned int iWantedMemory = pTexture->GetMemorySize( vUpgrades[i]->m_iWantedLevel );
+		unsigned int iExtraMemory = iWantedMemory - pTexture->GetMemorySize( pTexture->GetResidentLevel() );
+
+		if( m_iStreamingMemory + iExtraMemory > m_iStreamingMemoryBudget )
+		{
+			m_iStreamingMemory -= EvictLevels( m_iStreamingMemory + iExtraMemory - m_iStreamingMemoryBudget );
+			if( m_iStreamingMemory + iExtraMemory > m_iStreamingMemoryBudget )
+			{
+				//Does not fit, a smaller one may
+				continue;
+			}
+		}
+
+		pTexture->SetResidentLevel( vUpgrades[i]->m_iWantedLevel );
+		m_iStreamingMemory += iExtraMemory;
+		iUploaded += iExtraMemory;
+	}
+
+	//The budget may be exceeded by the textures just loaded
+	if( m_iStreamingMemory > m_iStreamingMemoryBudget )
+	{
+		m_iStreamingMemory -= EvictLevels( m_iStreamingMemory - m_iStreamingMemoryBudget );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+unsigned int TextureManager::EvictLevels( unsigned int iMemoryNeeded )
+{
+	//The textures not used last frame down to their base level, then the used ones down to what they need
+	std::vector< sStreamedTexture* > vCandidates;
+	FOR_EACH_IT( std::vector< sStreamedTexture >, m_vStreamedTextures, itTexture )
+	{
+		Texture2D* pTexture = (*itTexture).m_pTexture;
+		if( pTexture->GetLevelCount() == 0 )
+		{
+			continue;
+		}
+		if( (*itTexture).m_iLastUsedFrame != m_iFrame )
+		{
+			(*itTexture).m_iWantedLevel = pTexture->GetLevelForSize( (float)Texture2D::s_iStreamingBaseSize );
+		}
+		if( pTexture->GetResidentLevel() < (*itTexture).m_iWantedLevel )
+		{
+			vCandidates.push_back( &(*itTexture) );
+		}
+	}
+	std::sort( vCandidates.begin(), vCandidates.end(), &TextureManager::IsLessRecentlyUsed );
+
+	unsigned int iFreed = 0;
+	for( unsigned int i = 0; i < vCandidates.size() && iFreed < iMemoryNeeded; ++i )
+	{
+		Texture2D* pTexture = vCandidates[i]->m_pTexture;
+		unsigned int iResidentMemory = pTexture->GetMemorySize( pTexture->GetResidentLevel() );
+
+		//Drop one level at a time until enough is freed
+		unsigned int iLevel = pTexture->GetResidentLevel() + 1;
+		while( iLevel < vCandidates[i]->m_iWantedLevel && iFreed + iResidentMemory - pTexture->GetMemorySize( iLevel ) < iMemoryNeeded )
+		{
+			++iLevel;
+		}
+
+		iFreed += iResidentMemory - pTexture->GetMemorySize( iLevel );
+		pTexture->SetResidentLevel( iLevel );
+	}
+	return iFreed;
+}
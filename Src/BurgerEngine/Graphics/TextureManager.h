@@ -13,9 +13,12 @@
 #define __TEXTUREMANAGER_H__
 
 #include "BurgerEngine/Base/Singleton.h"
+#include "BurgerEngine/Graphics/MipmapGenerator.h"
+#include "BurgerEngine/Graphics/TextureArray.h"
 #include "BurgerEngine/External/IL/il.h"
 
 #include <map>
+#include <vector>
 #include <string>
 #include <assert.h>
 
@@ -38,7 +41,13 @@ class TextureManager: public Singleton<TextureManager>
 		*	@brief	get a texture from a 2D file (unwrapped 3D texture), and load it if we need to.
 		*/
 
-		AbstractTexture* AddTexture( const char * sName );
+		/// \param bPacked The 2D texture goes in a TextureArray when the packing is enabled, see Texture2D::SetArrayPacking
+		/// Each texture returned must be given back with ReleaseTexture
+		AbstractTexture* AddTexture( const char * sName, bool bPacked = false );
+
+		/// \brief Drop a reference taken by AddTexture, the texture is freed with the last one.
+		///			A texture still loading is freed once its job is done, the other pointers are ignored
+		void ReleaseTexture( AbstractTexture* pTexture );
 
 		/**
 		*	@name	void clear();
@@ -46,33 +55,115 @@ class TextureManager: public Singleton<TextureManager>
 		*/
 		void clear();
 
+		/// \brief Stream the mip levels of the mipmapped 2D textures loaded from now on:
+		///			they start with their small levels, the larger ones are loaded when drawn large enough on screen,
+		///			and the least recently used levels are evicted to stay within the budget
+		/// \param iMemoryBudget Video memory of the streamed textures, in bytes
+		/// \param iUploadBudget Bytes uploaded per frame by the streaming
+		void InitializeStreaming( unsigned int iMemoryBudget, unsigned int iUploadBudget );
+
+		bool IsStreaming() const { return m_bStreaming; }
+
+		/// \brief Load the levels requested during the last frame and evict the ones over the budget, once per frame
+		void UpdateStreaming();
+
+		/// \brief Video memory used by the streamed textures, in bytes
+		unsigned int GetStreamingMemory() const { return m_iStreamingMemory; }
+
+		/// \name Texture arrays of the packed textures
+		/// \{
+
+		/// \brief Set by the engine from the settings and the GL support, the textures are left alone when disabled
+		void SetArrayPackingEnabled( bool bEnabled ){ m_bArrayPacking = bEnabled; }
+		bool IsArrayPackingEnabled() const { return m_bArrayPacking; }
+
+		/// \brief Reserve a layer in the first array of this format with room left, a new array is created when none has, GL thread only
+		TextureArray* AddArrayLayer( const TextureArray::sFormat& oFormat, unsigned int& iLayerOut );
+
+		/// \brief Give back the layer of a texture, the array is released once empty. The placeholder is kept
+		void RemoveArrayLayer( TextureArray* pArray, unsigned int iLayer );
+
+		/// \brief Array holding a 1x1 grey layer, shown by the packed textures until their image is uploaded
+		TextureArray* GetPlaceholderArray();
+
+		unsigned int GetArrayCount() const { return m_vTextureArrays.size(); }
+
+		/// \}
+
 	protected:
-		std::map<std::string,AbstractTexture*>		m_mTextures;
+		struct sTexture
+		{
+			AbstractTexture*	m_pTexture;
+			unsigned int		m_iRefCount;
+		};
+
+		std::map<std::string,sTexture>		m_mTextures;
+		/// Key of each texture in m_mTextures, so that a release does not walk all the textures
+		std::map<AbstractTexture*,std::string>	m_mTextureKeys;
 		//std::map<std::string,int/*TextureCUBE* class*/>	m_mTexturesCubeMap;
 
 		TextureManager();
 		virtual ~TextureManager(){ clear(); };
 
 	private:
+
+		friend class Texture2DLoadingJob;
+
+		/// \brief Called when the loading job of a texture is deleted, whether it succeeded or not
+		void _OnLoadingDone( Texture2D* pTexture );
+
+		/// \brief Delete a texture nothing uses anymore
+		void _DestroyTexture( AbstractTexture* pTexture );
+
+		/// Textures whose job is not done, true once released: the job still holds them
+		std::map< AbstractTexture*, bool >	m_mLoadingTextures;
+
+		/// A streamed texture and what the streaming knows about it
+		struct sStreamedTexture
+		{
+			Texture2D*		m_pTexture;
+			unsigned int	m_iLastUsedFrame;
+			float			m_fRequestedSize;
+			unsigned int	m_iWantedLevel;
+		};
+
+		static bool IsLargerOnScreen( sStreamedTexture const* pFirst, sStreamedTexture const* pSecond );
+		static bool IsLessRecentlyUsed( sStreamedTexture const* pFirst, sStreamedTexture const* pSecond );
+
+		/// \brief Drop levels of the least recently used textures
+		/// \return Memory freed, in bytes
+		unsigned int EvictLevels( unsigned int iMemoryNeeded );
+
+		std::vector< sStreamedTexture >	m_vStreamedTextures;
+		bool							m_bStreaming;
+		unsigned int					m_iStreamingMemoryBudget;
+		unsigned int					m_iStreamingUploadBudget;
+		unsigned int					m_iStreamingMemory;
+		unsigned int					m_iFrame;
+
+		bool							m_bArrayPacking;
+		std::vector< TextureArray* >	m_vTextureArrays;
+		TextureArray*					m_pPlaceholderArray;
+
 		AbstractTexture* LoadTextureXML( const char * sName );
 		
 		/**
 		*	@name	Texture2D* getTexture2D(const &std::string name);
 		*	@brief	get the texture2D, and load it if we need to.
 		*/
-		AbstractTexture* GetTexture2D( const char * sName , const bool bUseMipmap =  false, const bool bLinearFiltering = false, const bool bClampS = false, const bool bClampT = false );
+		AbstractTexture* GetTexture2D( const char * sName , MipmapGenerator::sSettings const& oMipmapSettings, const bool bUseMipmap =  false, const bool bLinearFiltering = false, const bool bClampS = false, const bool bClampT = false, const char * sCompression = NULL, const bool bPacked = false );
 
 		/**
 		*	@name	TextureCubeMap& getTextureCubeMap(const &std::string name);
 		*	@brief	get the texture for a Cube Map, and load it if we need to.
 		*/
-		AbstractTexture* GetTextureCubeMap( const char * sName , const bool bUseMipmap =  false, const bool bLinearFiltering = false, const bool bClampS = false, const bool bClampT = false, const bool bClampR = false );
+		AbstractTexture* GetTextureCubeMap( const char * sName , MipmapGenerator::sSettings const& oMipmapSettings, const bool bUseMipmap =  false, const bool bLinearFiltering = false, const bool bClampS = false, const bool bClampT = false, const bool bClampR = false );
 		
 		/**
 		*	@name	Texture3D* getTexture3DFrom2DFile(const std::string &name);
 		*	@brief	get a 3D texture from a 2D file (unwrapped 3D texture), and load it if we need to.
 		*/
-		AbstractTexture* GetTexture3DFrom2DFile( const char * sName , unsigned int iWidth, unsigned int iHeight, unsigned int iDepth, const bool bUseMipmap =  false, const bool bLinearFiltering = false, const bool bClampS = false, const bool bClampT = false, const bool bClampR = false );
+		AbstractTexture* GetTexture3DFrom2DFile( const char * sName , MipmapGenerator::sSettings const& oMipmapSettings, unsigned int iWidth, unsigned int iHeight, unsigned int iDepth, const bool bUseMipmap =  false, const bool bLinearFiltering = false, const bool bClampS = false, const bool bClampT = false, const bool bClampR = false );
 
 };
 
@@ -0,0 +1,119 @@
+#include "BurgerEngine/Graphics/TransformBuffer.h"
+#include "BurgerEngine/Graphics/OpenGLContext.h"
+
+const char* const TransformBuffer::s_sSamplerName = "sObjectTransforms";
+const char* const TransformBuffer::s_sObjectIndexName = "fObjectIndex";
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool TransformBuffer::IsSupported()
+{
+	//texelFetchBuffer comes with EXT_gpu_shader4
+	return GLEE_EXT_texture_buffer_object && GLEE_EXT_gpu_shader4;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+std::string TransformBuffer::GetDeclaration()
+{
+	if( IsSupported() )
+	{
+		//Attributes only exist in the vertex stage
+		return std::string( "#extension GL_EXT_gpu_shader4 : enable\n" )
+			+ "#ifdef VERTEX_SHADER\n"
+			"uniform samplerBuffer " + s_sSamplerName + ";\n"
+			"attribute float " + s_sObjectIndexName + ";\n"
+			"mat4 GetWorldMatrix()\n"
+			"{\n"
+			"	int i = int( " + s_sObjectIndexName + " + 0.5 ) * 4;\n"
+			"	return mat4( texelFetchBuffer( " + s_sSamplerName + ", i ), texelFetchBuffer( " + s_sSamplerName + ", i + 1 ),\n"
+			"		texelFetchBuffer( " + s_sSamplerName + ", i + 2 ), texelFetchBuffer( " + s_sSamplerName + ", i + 3 ) );\n"
+			"}\n"
+			"#endif\n";
+	}
+
+	return "uniform mat4 mWorld;\n"
+		"mat4 GetWorldMatrix()\n"
+		"{\n"
+		"	return mWorld;\n"
+		"}\n";
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+TransformBuffer::TransformBuffer()
+	: m_iBuffer( 0 )
+	, m_iTexture( 0 )
+	, m_iCapacity( 0 )
+{
+	Clear();
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+TransformBuffer::~TransformBuffer()
+{
+	OpenGLContext::DeleteTexture( m_iTexture );
+	OpenGLContext::DeleteBuffer( m_iBuffer );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void TransformBuffer::Clear()
+{
+	m_vMatrices.clear();
+	Add( identity4() );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+unsigned int TransformBuffer::Add( const float4x4& mWorld )
+{
+	unsigned int iIndex = GetCount();
+
+	//The engine matrices are row major
+	float4x4 mColumns = transpose( mWorld );
+	const float* pMatrix = mColumns;
+	m_vMatrices.insert( m_vMatrices.end(), pMatrix, pMatrix + 16 );
+	return iIndex;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void TransformBuffer::Upload()
+{
+	if( !IsSupported() )
+	{
+		return;
+	}
+
+	if( m_iBuffer == 0 )
+	{
+		glGenBuffers( 1, &m_iBuffer );
+		glGenTextures( 1, &m_iTexture );
+	}
+
+	unsigned int iSize = m_vMatrices.size() * sizeof( float );
+	OpenGLContext::BindBuffer( GL_TEXTURE_BUFFER_EXT, m_iBuffer );
+	if( iSize > m_iCapacity )
+	{
+		//Room for some more objects, so a growing scene does not reallocate every frame
+		m_iCapacity = iSize + iSize / 2;
+	}
+	//Orphaned, the draws of the previous frame keep their copy
+	glBufferData( GL_TEXTURE_BUFFER_EXT, m_iCapacity, NULL, GL_STREAM_DRAW );
+	glBufferSubData( GL_TEXTURE_BUFFER_EXT, 0, iSize, &m_vMatrices[0] );
+	OpenGLContext::BindBuffer( GL_TEXTURE_BUFFER_EXT, 0 );
+
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 + s_iTextureUnit );
+	OpenGLContext::BindTexture( GL_TEXTURE_BUFFER_EXT, m_iTexture );
+	glTexBufferEXT( GL_TEXTURE_BUFFER_EXT, GL_RGBA32F_ARB, m_iBuffer );
+	OpenGLContext::ActiveTexture( GL_TEXTURE0 );
+}
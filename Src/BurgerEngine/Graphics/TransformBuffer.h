@@ -0,0 +1,70 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __TRANSFORMBUFFER_H__
+#define __TRANSFORMBUFFER_H__
+
+#include <string>
+#include <vector>
+
+#include "BurgerEngine/Graphics/CommonGraphics.h"
+#include "BurgerEngine/External/Math/Vector.h"
+
+/// \class	TransformBuffer
+/// \brief	World matrices of the scene meshes, written once per frame in a texture buffer and read by every pass.
+///			A draw only sets the index of its object, shaders fetch the matrix with GetWorldMatrix() once they ask
+///			for it with "#pragma objecttransforms". Index 0 is the identity, for the draws that are not objects.
+///			The index is a vertex attribute: a constant for a single draw, one per instance for a DrawBatch.
+///			Without EXT_texture_buffer_object the declaration falls back on a mWorld uniform set at each draw
+class TransformBuffer
+{
+public:
+
+	/// Unit of the buffer texture, above the units of the materials
+	static const unsigned int s_iTextureUnit = 15;
+	static const char* const s_sSamplerName;
+
+	/// Location of the object index attribute, away from the ones the conventional attributes alias
+	static const unsigned int s_iObjectIndexAttribute = 7;
+	static const char* const s_sObjectIndexName;
+
+	/// \brief The matrices can be fetched by the shaders, GL thread only
+	static bool IsSupported();
+
+	/// \brief GLSL declaration of GetWorldMatrix, for the sources that ask for it
+	static std::string GetDeclaration();
+
+	TransformBuffer();
+	~TransformBuffer();
+
+	/// \brief Forget the objects of the previous frame
+	void Clear();
+
+	/// \brief Add the world matrix of an object
+	/// \return Index of the object for the shaders
+	unsigned int Add( const float4x4& mWorld );
+
+	/// \brief Copy every matrix of the frame at once and bind the buffer on its unit, GL thread only
+	void Upload();
+
+	unsigned int GetCount() const { return m_vMatrices.size() / 16; }
+
+private:
+
+	/// Column major matrices, as the shaders fetch them
+	std::vector< float >	m_vMatrices;
+	GLuint					m_iBuffer;
+	GLuint					m_iTexture;
+	/// Size of the GL buffer in bytes
+	unsigned int			m_iCapacity;
+};
+
+#endif //__TRANSFORMBUFFER_H__
@@ -0,0 +1,170 @@
+#include "BurgerEngine/Graphics/UniformBuffer.h"
+#include "BurgerEngine/Graphics/ShaderTool.h"
+#include "BurgerEngine/Graphics/OpenGLContext.h"
+
+#ifndef GL_UNIFORM_BUFFER
+	#define GL_UNIFORM_BUFFER				0x8A11
+#endif
+#ifndef GL_UNIFORM_OFFSET
+	#define GL_UNIFORM_OFFSET				0x8A3B
+#endif
+#ifndef GL_UNIFORM_BLOCK_INDEX
+	#define GL_UNIFORM_BLOCK_INDEX			0x8A3A
+#endif
+#ifndef GL_UNIFORM_BLOCK_DATA_SIZE
+	#define GL_UNIFORM_BLOCK_DATA_SIZE		0x8A40
+#endif
+#ifndef GL_INVALID_INDEX
+	#define GL_INVALID_INDEX				0xFFFFFFFFu
+#endif
+
+typedef GLuint (APIENTRY * GetUniformBlockIndexFunction)( GLuint iProgram, GLchar const* sBlockName );
+typedef void (APIENTRY * UniformBlockBindingFunction)( GLuint iProgram, GLuint iBlockIndex, GLuint iBindingPoint );
+typedef void (APIENTRY * GetActiveUniformBlockivFunction)( GLuint iProgram, GLuint iBlockIndex, GLenum eName, GLint* pParams );
+typedef void (APIENTRY * GetUniformIndicesFunction)( GLuint iProgram, GLsizei iCount, GLchar const* const* pNames, GLuint* pIndices );
+typedef void (APIENTRY * GetActiveUniformsivFunction)( GLuint iProgram, GLsizei iCount, GLuint const* pIndices, GLenum eName, GLint* pParams );
+
+static GetUniformBlockIndexFunction		s_pGetUniformBlockIndex = NULL;
+static UniformBlockBindingFunction		s_pUniformBlockBinding = NULL;
+static GetActiveUniformBlockivFunction	s_pGetActiveUniformBlockiv = NULL;
+static GetUniformIndicesFunction		s_pGetUniformIndices = NULL;
+static GetActiveUniformsivFunction		s_pGetActiveUniformsiv = NULL;
+
+bool UniformBuffer::s_bSupported = false;
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+bool UniformBuffer::InitializeExtension()
+{
+	s_bSupported = false;
+	if( !isExtensionSupported( "GL_ARB_uniform_buffer_object" ) )
+	{
+		return false;
+	}
+
+	s_pGetUniformBlockIndex = (GetUniformBlockIndexFunction)getExtensionFunction( "glGetUniformBlockIndex" );
+	s_pUniformBlockBinding = (UniformBlockBindingFunction)getExtensionFunction( "glUniformBlockBinding" );
+	s_pGetActiveUniformBlockiv = (GetActiveUniformBlockivFunction)getExtensionFunction( "glGetActiveUniformBlockiv" );
+	s_pGetUniformIndices = (GetUniformIndicesFunction)getExtensionFunction( "glGetUniformIndices" );
+	s_pGetActiveUniformsiv = (GetActiveUniformsivFunction)getExtensionFunction( "glGetActiveUniformsiv" );
+
+	//glBindBufferBase is part of the extension too, GLee already knows it from GL 3.0
+	s_bSupported = s_pGetUniformBlockIndex && s_pUniformBlockBinding && s_pGetActiveUniformBlockiv
+		&& s_pGetUniformIndices && s_pGetActiveUniformsiv;
+	return s_bSupported;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+int UniformBuffer::GetBlockIndex( GLhandleARB oProgram, const char* sBlockName )
+{
+	if( !s_bSupported )
+	{
+		return -1;
+	}
+	GLuint iIndex = s_pGetUniformBlockIndex( (GLuint)oProgram, sBlockName );
+	return iIndex == GL_INVALID_INDEX ? -1 : (int)iIndex;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+unsigned int UniformBuffer::GetBlockSize( GLhandleARB oProgram, int iBlockIndex )
+{
+	GLint iSize = 0;
+	s_pGetActiveUniformBlockiv( (GLuint)oProgram, (GLuint)iBlockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &iSize );
+	return (unsigned int)iSize;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void UniformBuffer::SetBlockBinding( GLhandleARB oProgram, int iBlockIndex, unsigned int iBindingPoint )
+{
+	s_pUniformBlockBinding( (GLuint)oProgram, (GLuint)iBlockIndex, iBindingPoint );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+int UniformBuffer::GetUniformOffset( GLhandleARB oProgram, const char* sName )
+{
+	if( !s_bSupported )
+	{
+		return -1;
+	}
+
+	GLuint iIndex = GL_INVALID_INDEX;
+	s_pGetUniformIndices( (GLuint)oProgram, 1, &sName, &iIndex );
+	if( iIndex == GL_INVALID_INDEX )
+	{
+		return -1;
+	}
+
+	//Uniforms out of any block have no offset
+	GLint iBlock = -1;
+	s_pGetActiveUniformsiv( (GLuint)oProgram, 1, &iIndex, GL_UNIFORM_BLOCK_INDEX, &iBlock );
+	if( iBlock < 0 )
+	{
+		return -1;
+	}
+
+	GLint iOffset = -1;
+	s_pGetActiveUniformsiv( (GLuint)oProgram, 1, &iIndex, GL_UNIFORM_OFFSET, &iOffset );
+	return iOffset;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+UniformBuffer::UniformBuffer()
+	: m_iBuffer( 0 )
+	, m_iSize( 0 )
+{
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+UniformBuffer::~UniformBuffer()
+{
+	if( m_iBuffer != 0 )
+	{
+		OpenGLContext::DeleteBuffer( m_iBuffer );
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void UniformBuffer::Create( unsigned int iSize, void const* pData, GLenum eUsage )
+{
+	if( m_iBuffer == 0 )
+	{
+		glGenBuffers( 1, &m_iBuffer );
+	}
+	m_iSize = iSize;
+	OpenGLContext::BindBuffer( GL_UNIFORM_BUFFER, m_iBuffer );
+	glBufferData( GL_UNIFORM_BUFFER, iSize, pData, eUsage );
+	OpenGLContext::BindBuffer( GL_UNIFORM_BUFFER, 0 );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void UniformBuffer::Update( void const* pData, unsigned int iSize, unsigned int iOffset )
+{
+	OpenGLContext::BindBuffer( GL_UNIFORM_BUFFER, m_iBuffer );
+	glBufferSubData( GL_UNIFORM_BUFFER, iOffset, iSize, pData );
+	OpenGLContext::BindBuffer( GL_UNIFORM_BUFFER, 0 );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+void UniformBuffer::Bind( unsigned int iBindingPoint ) const
+{
+	OpenGLContext::BindBufferBase( GL_UNIFORM_BUFFER, iBindingPoint, m_iBuffer );
+}
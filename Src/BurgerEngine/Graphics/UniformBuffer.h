@@ -0,0 +1,62 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+#ifndef __UNIFORMBUFFER_H__
+#define __UNIFORMBUFFER_H__
+
+#include "BurgerEngine/Graphics/CommonGraphics.h"
+
+/// \class	UniformBuffer
+/// \brief	A uniform buffer object (ARB_uniform_buffer_object), and the queries on the uniform blocks of a program.
+///			The extension is newer than GLee, its entry points are loaded by InitializeExtension
+class UniformBuffer
+{
+public:
+
+	/// \brief Load the entry points, GL thread only. Everything else needs IsSupported
+	static bool InitializeExtension();
+	static bool IsSupported(){ return s_bSupported; }
+
+	/// \brief Index of a uniform block in a linked program, -1 when the program does not declare it
+	static int GetBlockIndex( GLhandleARB oProgram, const char* sBlockName );
+
+	/// \brief Size of a block in bytes, with the padding of its layout
+	static unsigned int GetBlockSize( GLhandleARB oProgram, int iBlockIndex );
+
+	/// \brief Read the block from the buffer bound at iBindingPoint
+	static void SetBlockBinding( GLhandleARB oProgram, int iBlockIndex, unsigned int iBindingPoint );
+
+	/// \brief Offset of a uniform in its block, -1 when the uniform is not in a block
+	static int GetUniformOffset( GLhandleARB oProgram, const char* sName );
+
+	UniformBuffer();
+	~UniformBuffer();
+
+	/// \brief Allocate the buffer, pData may be NULL
+	void Create( unsigned int iSize, void const* pData, GLenum eUsage = GL_STATIC_DRAW );
+
+	void Update( void const* pData, unsigned int iSize, unsigned int iOffset = 0 );
+
+	/// \brief Bind the whole buffer to a binding point of GL_UNIFORM_BUFFER
+	void Bind( unsigned int iBindingPoint ) const;
+
+	unsigned int GetSize() const { return m_iSize; }
+	bool IsCreated() const { return m_iBuffer != 0; }
+
+private:
+
+	static bool	s_bSupported;
+
+	GLuint			m_iBuffer;
+	unsigned int	m_iSize;
+};
+
+#endif //__UNIFORMBUFFER_H__
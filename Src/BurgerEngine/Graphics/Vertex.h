@@ -13,13 +13,20 @@
 
 #include "BurgerEngine/External/Math/Vector.h"
 
+/// \brief Interleaved vertex of the GeometryPool, every static mesh shares this layout
 struct Vertex
 {
 	///Position
+	vec3 f3Position;
+
+	///Normal
+	vec3 f3Normal;
 
 	///Texture coord 1
+	vec2 f2Texcoord;
 
-	///Texture coord 2
+	///Texture coord 2, the tangent
+	vec3 f3Tangent;
 };
 
 #endif //__VERTEX_H__
@@ -0,0 +1,402 @@
+/*************************************
+*
+*		BurgerEngine Project
+*		
+*		Created :	19/10/26
+*		Authors :	Franck Letellier
+*					Baptiste Malaga
+*		Contact :   shadervalouf@googlegroups.com
+*
+**************************************/
+
+/// Checks of the engine pieces that run without a window or a GL context:
+/// the compiled scene documents, the block compression, the mip chains and the component ids.
+/// Run from the Bin folder, prints every failure and returns their count
+
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+
+#include "BurgerEngine/Core/ObjectFactory.h"
+#include "BurgerEngine/Core/SceneDocument.h"
+#include "BurgerEngine/Graphics/MipmapGenerator.h"
+#include "BurgerEngine/Graphics/TextureCompressor.h"
+
+#include "BurgerEngine/External/TinyXml/TinyXml.h"
+
+static unsigned int s_iCheckCount = 0;
+static unsigned int s_iFailureCount = 0;
+
+#define CHECK( bCondition ) Check( ( bCondition ), #bCondition, __LINE__ )
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static void Check( bool bCondition, const char* sCondition, int iLine )
+{
+	++s_iCheckCount;
+	if( !bCondition )
+	{
+		++s_iFailureCount;
+		std::cerr << "FAILED line " << iLine << ": " << sCondition << std::endl;
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static bool IsSameText( const char* sFirst, const char* sSecond )
+{
+	if( !sFirst || !sSecond )
+	{
+		return sFirst == sSecond;
+	}
+	return strcmp( sFirst, sSecond ) == 0;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// FNV-1a, the ids of the scene files must keep their types from one build to the next
+//--------------------------------------------------------------------------------------------------------------------
+static void CheckHashID()
+{
+	CHECK( ObjectFactory::HashID( "" ) == 0x811c9dc5u );
+	CHECK( ObjectFactory::HashID( "a" ) == 0xe40c292cu );
+	CHECK( ObjectFactory::HashID( "foobar" ) == 0xbf9cf968u );
+	CHECK( ObjectFactory::HashID( "render" ) != ObjectFactory::HashID( "light" ) );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// A node and its children hold what the XML element had
+//--------------------------------------------------------------------------------------------------------------------
+static void CompareNode( TiXmlElement const& rElement, SceneNode const* pNode )
+{
+	CHECK( pNode != NULL );
+	if( !pNode )
+	{
+		return;
+	}
+
+	CHECK( IsSameText( rElement.Value(), pNode->Value() ) );
+	CHECK( IsSameText( rElement.GetText(), pNode->GetText() ) );
+	for( TiXmlAttribute const* pAttribute = rElement.FirstAttribute(); pAttribute; pAttribute = pAttribute->Next() )
+	{
+		CHECK( IsSameText( pAttribute->Value(), pNode->Attribute( pAttribute->Name() ) ) );
+	}
+
+	SceneNode const* pChildNode = pNode->FirstChildElement();
+	for( TiXmlElement const* pChild = rElement.FirstChildElement(); pChild; pChild = pChild->NextSiblingElement() )
+	{
+		CompareNode( *pChild, pChildNode );
+		pChildNode = pChildNode ? pChildNode->NextSiblingElement() : NULL;
+	}
+	CHECK( pChildNode == NULL );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static void CheckSceneDocument()
+{
+	TiXmlDocument oScene;
+	oScene.Parse( "<scene><object name=\"crate\" x=\"1.5\" count=\"3\"><mesh file=\"crate.obj\"/><text>hello</text></object>"
+		"<object name=\"lamp\"/><object name=\"crate\"/></scene>" );
+	TiXmlDocument oSources;
+	oSources.Parse( "<sources><source file=\"scene.xml\"/></sources>" );
+	CHECK( !oScene.Error() && !oSources.Error() );
+
+	std::vector< TiXmlElement const* > vRoots;
+	vRoots.push_back( oScene.RootElement() );
+	vRoots.push_back( oSources.RootElement() );
+
+	SceneDocument oDocument;
+	oDocument.Build( vRoots );
+	CompareNode( *oScene.RootElement(), oDocument.FirstChildElement( "scene" ) );
+	CompareNode( *oSources.RootElement(), oDocument.FirstChildElement( "sources" ) );
+	CHECK( oDocument.FirstChildElement( "missing" ) == NULL );
+
+	SceneNode const* pObject = oDocument.FirstChildElement( "scene" )->FirstChildElement( "object" );
+	float fX = 0.0f;
+	int iCount = 0;
+	int iMissing = 7;
+	CHECK( pObject->QueryFloatAttribute( "x", &fX ) && fX == 1.5f );
+	CHECK( pObject->QueryIntAttribute( "count", &iCount ) && iCount == 3 );
+	CHECK( !pObject->QueryIntAttribute( "missing", &iMissing ) && iMissing == 7 );
+	CHECK( !pObject->QueryIntAttribute( "name", &iMissing ) && iMissing == 7 );
+	CHECK( IsSameText( pObject->NextSiblingElement( "object" )->Attribute( "name" ), "lamp" ) );
+
+	//Round trip through a file
+	const char* sFileName = "BurgerEngineChecks.bscn";
+	CHECK( oDocument.SaveFile( sFileName ) );
+	SceneDocument oLoaded;
+	CHECK( oLoaded.LoadFile( sFileName ) );
+	CHECK( oLoaded.GetSize() == oDocument.GetSize() );
+	CompareNode( *oScene.RootElement(), oLoaded.FirstChildElement( "scene" ) );
+	CompareNode( *oSources.RootElement(), oLoaded.FirstChildElement( "sources" ) );
+
+	//Anything else is refused
+	FILE* pFile = fopen( sFileName, "wb" );
+	if( pFile )
+	{
+		fputs( "not a scene document", pFile );
+		fclose( pFile );
+	}
+	SceneDocument oInvalid;
+	CHECK( !oInvalid.LoadFile( sFileName ) );
+	remove( sFileName );
+	CHECK( !oInvalid.LoadFile( sFileName ) );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Colors of the 16 pixels of a BC1 block
+//--------------------------------------------------------------------------------------------------------------------
+static void DecodeColorBlock( GLubyte const* pBlock, int pColorsOut[16][3] )
+{
+	unsigned int pEndPoints[2] = { pBlock[0] | pBlock[1] << 8, pBlock[2] | pBlock[3] << 8 };
+	int pPalette[4][3];
+	for( unsigned int p = 0; p < 2; ++p )
+	{
+		int iRed = ( pEndPoints[p] >> 11 ) & 31;
+		int iGreen = ( pEndPoints[p] >> 5 ) & 63;
+		int iBlue = pEndPoints[p] & 31;
+		pPalette[p][0] = ( iRed << 3 ) | ( iRed >> 2 );
+		pPalette[p][1] = ( iGreen << 2 ) | ( iGreen >> 4 );
+		pPalette[p][2] = ( iBlue << 3 ) | ( iBlue >> 2 );
+	}
+	for( unsigned int c = 0; c < 3; ++c )
+	{
+		if( pEndPoints[0] > pEndPoints[1] )
+		{
+			pPalette[2][c] = ( 2 * pPalette[0][c] + pPalette[1][c] ) / 3;
+			pPalette[3][c] = ( pPalette[0][c] + 2 * pPalette[1][c] ) / 3;
+		}
+		else
+		{
+			pPalette[2][c] = ( pPalette[0][c] + pPalette[1][c] ) / 2;
+			pPalette[3][c] = 0;
+		}
+	}
+
+	unsigned int iIndices = pBlock[4] | pBlock[5] << 8 | pBlock[6] << 16 | (unsigned int)pBlock[7] << 24;
+	for( unsigned int i = 0; i < 16; ++i )
+	{
+		unsigned int iIndex = ( iIndices >> ( 2 * i ) ) & 3;
+		for( unsigned int c = 0; c < 3; ++c )
+		{
+			pColorsOut[i][c] = pPalette[ iIndex ][c];
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// Values of the 16 pixels of a BC4 block
+//--------------------------------------------------------------------------------------------------------------------
+static void DecodeChannelBlock( GLubyte const* pBlock, int pValuesOut[16] )
+{
+	int pPalette[8];
+	pPalette[0] = pBlock[0];
+	pPalette[1] = pBlock[1];
+	if( pPalette[0] > pPalette[1] )
+	{
+		for( unsigned int p = 2; p < 8; ++p )
+		{
+			pPalette[p] = ( ( 8 - p ) * pPalette[0] + ( p - 1 ) * pPalette[1] ) / 7;
+		}
+	}
+	else
+	{
+		for( unsigned int p = 2; p < 6; ++p )
+		{
+			pPalette[p] = ( ( 6 - p ) * pPalette[0] + ( p - 1 ) * pPalette[1] ) / 5;
+		}
+		pPalette[6] = 0;
+		pPalette[7] = 255;
+	}
+
+	for( unsigned int iGroup = 0; iGroup < 2; ++iGroup )
+	{
+		unsigned int iIndices = pBlock[ 2 + iGroup * 3 ] | pBlock[ 3 + iGroup * 3 ] << 8 | pBlock[ 4 + iGroup * 3 ] << 16;
+		for( unsigned int j = 0; j < 8; ++j )
+		{
+			pValuesOut[ iGroup * 8 + j ] = pPalette[ ( iIndices >> ( 3 * j ) ) & 7 ];
+		}
+	}
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static int Distance( int iFirst, int iSecond )
+{
+	return iFirst > iSecond ? iFirst - iSecond : iSecond - iFirst;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// A solid image comes back within the 565 rounding, a ramp within half a step of the palette
+//--------------------------------------------------------------------------------------------------------------------
+static void CheckTextureCompressor()
+{
+	MipmapGenerator::sSettings oSettings;
+
+	//Solid BC1, 8x8 so that every block is checked
+	std::vector< GLubyte > vSolid( 8 * 8 * 3 );
+	for( unsigned int i = 0; i < 8 * 8; ++i )
+	{
+		vSolid[ i * 3 ] = 200;
+		vSolid[ i * 3 + 1 ] = 100;
+		vSolid[ i * 3 + 2 ] = 50;
+	}
+	TextureCompressor::sCompressedImage oImage;
+	CHECK( TextureCompressor::Compress( &vSolid[0], 8, 8, 3, TextureCompressor::E_COMPRESSION_BC1, false, oSettings, oImage ) );
+	CHECK( oImage.GetLevelCount() == 1 && oImage.GetLevelSize( 0 ) == 4 * 8 );
+	for( unsigned int iBlock = 0; iBlock < 4 && oImage.GetLevelCount() == 1; ++iBlock )
+	{
+		int pColors[16][3];
+		DecodeColorBlock( oImage.GetLevelData( 0 ) + iBlock * 8, pColors );
+		for( unsigned int i = 0; i < 16; ++i )
+		{
+			CHECK( Distance( pColors[i][0], 200 ) <= 4 && Distance( pColors[i][1], 100 ) <= 2 && Distance( pColors[i][2], 50 ) <= 4 );
+		}
+	}
+
+	//Grey ramp in BC1, the end points are inset by 1/16 of the range
+	std::vector< GLubyte > vRamp( 4 * 4 );
+	for( unsigned int i = 0; i < 16; ++i )
+	{
+		vRamp[i] = (GLubyte)( i * 17 );
+	}
+	CHECK( TextureCompressor::Compress( &vRamp[0], 4, 4, 1, TextureCompressor::E_COMPRESSION_BC1, false, oSettings, oImage ) );
+	if( oImage.GetLevelCount() == 1 )
+	{
+		int pColors[16][3];
+		DecodeColorBlock( oImage.GetLevelData( 0 ), pColors );
+		for( unsigned int i = 0; i < 16; ++i )
+		{
+			CHECK( Distance( pColors[i][0], vRamp[i] ) <= 48 && Distance( pColors[i][1], vRamp[i] ) <= 48 );
+		}
+	}
+
+	//BC5 is two BC4 blocks: a ramp in red, a constant in green
+	std::vector< GLubyte > vChannels( 4 * 4 * 3 );
+	for( unsigned int i = 0; i < 16; ++i )
+	{
+		vChannels[ i * 3 ] = (GLubyte)( i * 17 );
+		vChannels[ i * 3 + 1 ] = 77;
+		vChannels[ i * 3 + 2 ] = 0;
+	}
+	CHECK( TextureCompressor::Compress( &vChannels[0], 4, 4, 3, TextureCompressor::E_COMPRESSION_BC5, false, oSettings, oImage ) );
+	CHECK( oImage.GetLevelCount() == 1 && oImage.GetLevelSize( 0 ) == 16 );
+	if( oImage.GetLevelCount() == 1 )
+	{
+		int pRed[16];
+		int pGreen[16];
+		DecodeChannelBlock( oImage.GetLevelData( 0 ), pRed );
+		DecodeChannelBlock( oImage.GetLevelData( 0 ) + 8, pGreen );
+		for( unsigned int i = 0; i < 16; ++i )
+		{
+			CHECK( Distance( pRed[i], i * 17 ) <= 19 );
+			CHECK( pGreen[i] == 77 );
+		}
+	}
+
+	//Every level of the chain gets its blocks
+	CHECK( TextureCompressor::Compress( &vSolid[0], 8, 8, 3, TextureCompressor::E_COMPRESSION_BC1, true, oSettings, oImage ) );
+	CHECK( oImage.GetLevelCount() == 4 );
+	CHECK( oImage.m_vData.size() == 4 * 8 + 3 * 8 );
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+//
+//--------------------------------------------------------------------------------------------------------------------
+static float ComputeAlphaCoverage( std::vector< GLubyte > const& vLevel, GLubyte iReference )
+{
+	unsigned int iPixelCount = vLevel.size() / 4;
+	unsigned int iCovered = 0;
+	for( unsigned int i = 0; i < iPixelCount; ++i )
+	{
+		iCovered += vLevel[ i * 4 + 3 ] > iReference ? 1 : 0;
+	}
+	return iCovered / (float)iPixelCount;
+}
+
+//--------------------------------------------------------------------------------------------------------------------
+// The filter weights sum to 1: a flat image stays flat. The alpha tested textures keep their coverage
+//--------------------------------------------------------------------------------------------------------------------
+static void CheckMipmapGenerator()
+{
+	CHECK( MipmapGenerator::GetLevelCount( 32, 16 ) == 6 );
+	CHECK( MipmapGenerator::GetLevelCount( 1, 1 ) == 1 );
+	CHECK( MipmapGenerator::GetLevelSize( 16, 6 ) == 1 );
+
+	std::vector< GLubyte > vFlat( 32 * 16 * 3 );
+	for( unsigned int i = 0; i < 32 * 16; ++i )
+	{
+		vFlat[ i * 3 ] = 200;
+		vFlat[ i * 3 + 1 ] = 100;
+		vFlat[ i * 3 + 2 ] = 50;
+	}
+
+	for( unsigned int iFilter = MipmapGenerator::E_FILTER_BOX; iFilter <= MipmapGenerator::E_FILTER_KAISER; ++iFilter )
+	{
+		for( unsigned int iGamma = 0; iGamma < 2; ++iGamma )
+		{
+			MipmapGenerator::sSettings oSettings;
+			oSettings.m_eFilter = (MipmapGenerator::MipmapFilter)iFilter;
+			oSettings.m_bGammaCorrect = iGamma != 0;
+
+			MipmapGenerator::MipChain vLevels;
+			MipmapGenerator::Generate( &vFlat[0], 32, 16, 3, oSettings, vLevels );
+			CHECK( vLevels.size() == 6 );
+			for( unsigned int iLevel = 0; iLevel < vLevels.size(); ++iLevel )
+			{
+				unsigned int iPixelCount = MipmapGenerator::GetLevelSize( 32, iLevel ) * MipmapGenerator::GetLevelSize( 16, iLevel );
+				CHECK( vLevels[ iLevel ].size() == iPixelCount * 3 );
+
+				bool bFlat = true;
+				for( unsigned int i = 0; i < vLevels[ iLevel ].size(); ++i )
+				{
+					bFlat = bFlat && Distance( vLevels[ iLevel ][i], vFlat[ i % 3 ] ) <= 1;
+				}
+				CHECK( bFlat );
+			}
+		}
+	}
+
+	//Sparse cut-out: one pixel in five is opaque, a plain filter would fade it out in a few levels
+	std::vector< GLubyte > vCutOut( 64 * 64 * 4 );
+	for( unsigned int y = 0; y < 64; ++y )
+	{
+		for( unsigned int x = 0; x < 64; ++x )
+		{
+			GLubyte* pPixel = &vCutOut[ ( y * 64 + x ) * 4 ];
+			pPixel[0] = pPixel[1] = pPixel[2] = 128;
+			pPixel[3] = ( x * 7 + y * 13 ) % 5 == 0 ? 255 : 0;
+		}
+	}
+
+	MipmapGenerator::sSettings oSettings;
+	oSettings.m_eFilter = MipmapGenerator::E_FILTER_KAISER;
+	oSettings.m_fAlphaCoverage = 0.5f;
+	MipmapGenerator::MipChain vLevels;
+	MipmapGenerator::Generate( &vCutOut[0], 64, 64, 4, oSettings, vLevels );
+	CHECK( vLevels.size() == 7 );
+
+	float fCoverage = ComputeAlphaCoverage( vLevels[0], 127 );
+	CHECK( fCoverage > 0.15f && fCoverage < 0.25f );
+	//From 8x8 the alpha of the pattern is almost flat, there is no threshold left to pick the coverage with
+	for( unsigned int iLevel = 1; MipmapGenerator::GetLevelSize( 64, iLevel ) >= 16; ++iLevel )
+	{
+		float fLevelCoverage = ComputeAlphaCoverage( vLevels[ iLevel ], 127 );
+		CHECK( fLevelCoverage > fCoverage - 0.02f && fLevelCoverage < fCoverage + 0.02f );
+	}
+}
+
+int main( int argc, char** argv )
+{
+	CheckHashID();
+	CheckSceneDocument();
+	CheckTextureCompressor();
+	CheckMipmapGenerator();
+
+	std::cout << s_iCheckCount - s_iFailureCount << " / " << s_iCheckCount << " checks passed" << std::endl;
+	return (int)s_iFailureCount;
+}
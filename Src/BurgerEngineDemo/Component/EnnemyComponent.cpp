@@ -3,7 +3,7 @@
 #include "BurgerEngineDemo/Manager/GameplayManager.h"
 #include "BurgerEngine/Core/CompositeComponent.h"
 
-#include "BurgerEngine/External/TinyXml/TinyXml.h"
+#include "BurgerEngine/Core/SceneDocument.h"
 #include "BurgerEngineDemo/Component/MovementComponent.h"
 
 const float ENNEMY_SPEED = 35.0f;
@@ -33,14 +33,14 @@ EnnemyComponent::~EnnemyComponent()
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void EnnemyComponent::Initialize(TiXmlElement const& a_rParameters)
+void EnnemyComponent::Initialize(SceneNode const& a_rParameters)
 {
 	//Retrieve position
 	//First we should check is there is not an desc offset
 	//to the parent node
 	float x, y, z, rX, rY, rZ, scale;
 
-	TiXmlElement const* pPositionXml = a_rParameters.FirstChildElement( "position" );
+	SceneNode const* pPositionXml = a_rParameters.FirstChildElement( "position" );
 	if(pPositionXml)
 	{
 		//gets position & bounded volume information 
@@ -12,12 +12,15 @@
 #define __ENNEMYCOMPONENT_H__
 
 #include "BurgerEngine/Core/AbstractComponent.h"
+#include "BurgerEngine/Core/ComponentPool.h"
 
 class MovementComponent;
 
 class EnnemyComponent : public AbstractComponent
 {
 public:
+	DECLARE_COMPONENT_POOL( EnnemyComponent )
+
 	/// \brief constructor
 	EnnemyComponent(CompositeComponent* a_pParent = NULL);
 
@@ -26,9 +29,12 @@ public:
 
 	/// \brief Load the component using a XML Node
 	/// override
-	void Initialize(TiXmlElement const& a_rParameters);
+	void Initialize(SceneNode const& a_rParameters);
 
 	void Update( float fFrameTime, float fElapsedTime );
+
+	/// \brief [OVERIDE] Goes through the GameplayManager, main thread only
+	bool IsUpdateParallel() const { return false; }
 private:
 
 	void Respawn();
@@ -2,7 +2,7 @@
 
 #include "BurgerEngine/Core/CompositeComponent.h"
 
-#include "BurgerEngine/External/TinyXml/TinyXml.h"
+#include "BurgerEngine/Core/SceneDocument.h"
 
 const float PLAYER_SPEED = 30.0f;
 const float ROTATION_SPEED = 12.0f;
@@ -127,6 +127,6 @@ void MovementComponent::Update( float fFrameTime, float fElapsedTime )
 	vec4 f4Direction = normalize( rotateY( m_fCurrentRotation ) * vec4(0.0f,0.0f,-1.0f,1.0f) );
 	f4Direction /= f4Direction.w;
 
-	GetParent()->SetPos(GetParent()->GetPos() + f4Direction.xyz() * m_fMovementSpeed * fFrameTime);
+	GetParent()->SetPos(GetParent()->GetLocalPos() + f4Direction.xyz() * m_fMovementSpeed * fFrameTime);
 	GetParent()->SetRotation(vec3(0.0f, m_fCurrentRotation*RAD_TO_DEG, 0.0f) );
 }
\ No newline at end of file
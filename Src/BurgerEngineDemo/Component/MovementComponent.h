@@ -12,10 +12,13 @@
 #define __MOVEMENTCOMPONENT_H__
 
 #include "BurgerEngine/Core/AbstractComponent.h"
+#include "BurgerEngine/Core/ComponentPool.h"
 
 class MovementComponent : public AbstractComponent
 {
 public:
+	DECLARE_COMPONENT_POOL( MovementComponent )
+
 	/// \brief constructor
 	MovementComponent(CompositeComponent* a_pParent = NULL);
 
@@ -25,7 +28,7 @@ public:
 	void Update( float fFrameTime, float fElapsedTime );
 	void SetValues( float fDestinationRotation, float fMovementSpeed, float fRotationSpeed);
 
-	void Initialize(TiXmlElement const& a_rParameters){};
+	void Initialize(SceneNode const& a_rParameters){};
 
 private:
 	float GetRotationDirection(float fCurrentRotation, float fDestinationRotation);
@@ -12,12 +12,15 @@
 #define __PLAYERCOMPONENT_H__
 
 #include "BurgerEngine/Core/AbstractComponent.h"
+#include "BurgerEngine/Core/ComponentPool.h"
 
 class MovementComponent;
 
 class PlayerComponent : public AbstractComponent
 {
 public:
+	DECLARE_COMPONENT_POOL( PlayerComponent )
+
 	/// \brief constructor
 	PlayerComponent(CompositeComponent* a_pParent = NULL);
 
@@ -26,7 +29,7 @@ public:
 
 	/// \brief Load the component using a XML Node
 	/// override
-	void Initialize(TiXmlElement const& a_rParameters);
+	void Initialize(SceneNode const& a_rParameters);
 
 	void SetAnalogX(float fValue){ m_fAnalogX = fValue; };
 	void SetAnalogY(float fValue){ m_fAnalogY = fValue; };
@@ -36,6 +39,9 @@ public:
 
 	void Update( float fFrameTime, float fElapsedTime );
 
+	/// \brief [OVERIDE] Reads the input and moves the camera target, main thread only
+	bool IsUpdateParallel() const { return false; }
+
 private:
 	float GetRotationDirection(float fCurrentRotation, float fDestinationRotation);
 	float GetAngleDifference(float fAngle1, float fAngle2);
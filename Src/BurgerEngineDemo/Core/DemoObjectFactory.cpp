@@ -4,31 +4,16 @@
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-void DemoObjectFactory::Terminate()
+DemoObjectFactory::DemoObjectFactory()
 {
-	ObjectFactory::Terminate();
+	RegisterComponent( "player", &_CreateComponent< PlayerComponent > );
+	RegisterComponent( "ennemy", &_CreateComponent< EnnemyComponent > );
 }
 
 //--------------------------------------------------------------------------------------------------------------------
 //
 //--------------------------------------------------------------------------------------------------------------------
-AbstractComponent* DemoObjectFactory::CreateComponentFromID( std::string& a_sID, CompositeComponent* a_pParent )
+void DemoObjectFactory::Terminate()
 {
-	AbstractComponent* pComponent;
-	
-	if ( pComponent = ObjectFactory::CreateComponentFromID( a_sID, a_pParent ) )
-	{
-		return pComponent;
-	}
-
-	if(a_sID == "player")
-	{
-		return new PlayerComponent(a_pParent);
-	}
-	else if(a_sID == "ennemy")
-	{
-		return new EnnemyComponent(a_pParent);
-	}
-
-	return NULL;
+	ObjectFactory::Terminate();
 }
\ No newline at end of file
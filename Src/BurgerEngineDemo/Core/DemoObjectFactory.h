@@ -21,10 +21,10 @@ class DemoObjectFactory : public ObjectFactory
 {
 public:
 
-	void Terminate();
+	/// \brief Register the demo components
+	DemoObjectFactory();
 
-	/// \brief Static loading method just load a single component
-	AbstractComponent* CreateComponentFromID( std::string& a_sID, CompositeComponent* a_pParent );
+	void Terminate();
 };
 
 #endif //_DEMOOBJECTFACTORY_H__
\ No newline at end of file